@@ -128,6 +128,16 @@ public:
 	virtual void			ListModels( void ) = 0;
 	// Writes a collision model file for the given map entity.
 	virtual bool			WriteCollisionModelForMapEntity( const idMapEntity *mapEnt, const char *filename, const bool testTraceModel = true ) = 0;
+
+	// Until EndParallelTraces, Translation, Rotation, Contents and SetupTrmModel may be called from several
+	// threads at once and trace models set up with SetupTrmModel are private to the calling thread.
+	// Contacts may not be used and no models may be loaded in between.
+	// Both must be called from the main thread while no other thread is using the collision model manager.
+	virtual void			BeginParallelTraces( void ) = 0;
+	virtual void			EndParallelTraces( void ) = 0;
+	// Returns false if there are too many threads tracing at once. The calling thread may not trace
+	// until EndParallelTraces then and has to leave its traces to the main thread.
+	virtual bool			CanTraceInParallel( void ) = 0;
 };
 
 extern idCollisionModelManager *		collisionModelManager;
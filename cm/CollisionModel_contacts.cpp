@@ -47,6 +47,8 @@ int idCollisionModelManagerLocal::Contacts( contactInfo_t *contacts, const int m
 	trace_t results;
 	idVec3 end;
 
+	assert( !parallelTraces );
+
 	// same as Translation but instead of storing the first collision we store all collisions as contacts
 	idCollisionModelManagerLocal::getContacts = true;
 	idCollisionModelManagerLocal::contacts = contacts;
@@ -48,10 +48,10 @@ bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t *tw, cm_b
 	float d, bestd;
 	idVec3 *p;
 
-	if ( b->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( b->checkcount == tw->checkCount ) {
 		return false;
 	}
-	b->checkcount = idCollisionModelManagerLocal::checkCount;
+	b->checkcount = tw->checkCount;
 
 	if ( !(b->contents & tw->contents) ) {
 		return false;
@@ -120,10 +120,10 @@ CM_SetTrmEdgeSidedness
 CM_SetTrmPolygonSidedness
 ================
 */
-#define CM_SetTrmPolygonSidedness( v, plane, bitNum ) {								\
+#define CM_SetTrmPolygonSidedness( v, p, plane, bitNum ) {							\
 	if ( !((v)->sideSet & (1<<bitNum)) ) {											\
 		float fl;																	\
-		fl = plane.Distance( (v)->p );												\
+		fl = plane.Distance( p );													\
 		/* cannot use float sign bit because it is undetermined when fl == 0.0f */	\
 		if ( fl < 0.0f ) {															\
 			(v)->side |= (1 << bitNum);												\
@@ -148,13 +148,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	float d, bestd;
 	cm_trmEdge_t *trmEdge;
 	cm_edge_t *edge;
-	cm_vertex_t *v, *v1, *v2;
+	cm_vertex_t *v;
+	cm_traceCache_t *ec, *vc, *v1, *v2;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( p->checkcount == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	p->checkcount = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -186,14 +187,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 			edgeNum = p->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
 			// if this edge is already tested
-			if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( CM_EdgeCache( tw, edge )->checkcount == tw->checkCount ) {
 				continue;
 			}
 
 			for ( j = 0; j < 2; j++ ) {
 				v = &tw->model->vertices[edge->vertexNum[j]];
 				// if this vertex is already tested
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( CM_VertexCache( tw, v )->checkcount == tw->checkCount ) {
 					continue;
 				}
 
@@ -228,19 +229,20 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		ec = CM_EdgeCache( tw, edge );
 		// reset sidedness cache if this is the first time we encounter this edge
-		if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			edge->sideSet = 0;
+		if ( ec->checkcount != tw->checkCount ) {
+			ec->sideSet = 0;
 		}
 		// pluecker coordinate for edge
 		tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[edge->vertexNum[0]].p,
 													tw->model->vertices[edge->vertexNum[1]].p );
-		v = &tw->model->vertices[edge->vertexNum[INTSIGNBITSET(edgeNum)]];
+		vc = CM_VertexCache( tw, &tw->model->vertices[edge->vertexNum[INTSIGNBITSET(edgeNum)]] );
 		// reset sidedness cache if this is the first time we encounter this vertex
-		if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			v->sideSet = 0;
+		if ( vc->checkcount != tw->checkCount ) {
+			vc->sideSet = 0;
 		}
-		v->checkcount = idCollisionModelManagerLocal::checkCount;
+		vc->checkcount = tw->checkCount;
 	}
 
 	// get side of polygon for each trm vertex
@@ -260,10 +262,10 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 		// test if trm edge goes through the polygon between the polygon edges
 		for ( j = 0; j < p->numEdges; j++ ) {
 			edgeNum = p->edges[j];
-			edge = tw->model->edges + abs(edgeNum);
+			ec = CM_EdgeCache( tw, tw->model->edges + abs(edgeNum) );
 #if 1
-			CM_SetTrmEdgeSidedness( edge, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
-			if ( INTSIGNBITSET(edgeNum) ^ ((edge->side >> i) & 1) ^ flip ) {
+			CM_SetTrmEdgeSidedness( ec, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
+			if ( INTSIGNBITSET(edgeNum) ^ ((ec->side >> i) & 1) ^ flip ) {
 				break;
 			}
 #else
@@ -301,17 +303,18 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		ec = CM_EdgeCache( tw, edge );
+		if ( ec->checkcount == tw->checkCount ) {
 			continue;
 		}
-		edge->checkcount = idCollisionModelManagerLocal::checkCount;
+		ec->checkcount = tw->checkCount;
 
 		for ( j = 0; j < tw->numPolys; j++ ) {
 #if 1
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			CM_SetTrmPolygonSidedness( v1, tw->polys[j].plane, j );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			CM_SetTrmPolygonSidedness( v2, tw->polys[j].plane, j );
+			v1 = CM_VertexCache( tw, tw->model->vertices + edge->vertexNum[0] );
+			CM_SetTrmPolygonSidedness( v1, tw->model->vertices[edge->vertexNum[0]].p, tw->polys[j].plane, j );
+			v2 = CM_VertexCache( tw, tw->model->vertices + edge->vertexNum[1] );
+			CM_SetTrmPolygonSidedness( v2, tw->model->vertices[edge->vertexNum[1]].p, tw->polys[j].plane, j );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( !(((v1->side ^ v2->side) >> j) & 1) ) {
 				continue;
@@ -320,10 +323,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 #else
 			float d1, d2;
 
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			d1 = tw->polys[j].plane.Distance( v1->p );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			d2 = tw->polys[j].plane.Distance( v2->p );
+			d1 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[0]].p );
+			d2 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[1]].p );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( (d1 >= 0.0f && d2 >= 0.0f) || (d1 <= 0.0f && d2 <= 0.0f) ) {
 				continue;
@@ -339,8 +340,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 				trmEdge = tw->edges + abs(trmEdgeNum);
 #if 1
 				bitNum = abs(trmEdgeNum);
-				CM_SetTrmEdgeSidedness( edge, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
-				if ( INTSIGNBITSET(trmEdgeNum) ^ ((edge->side >> bitNum) & 1) ^ flip ) {
+				CM_SetTrmEdgeSidedness( ec, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
+				if ( INTSIGNBITSET(trmEdgeNum) ^ ((ec->side >> bitNum) & 1) ^ flip ) {
 					break;
 				}
 #else
@@ -389,7 +390,7 @@ idCollisionModelManagerLocal::PointContents
 ================
 */
 int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t hModel ) {
-	cm_model_t *model = idCollisionModelManagerLocal::models[hModel];
+	cm_model_t *model = idCollisionModelManagerLocal::ModelForTrace( hModel );
 
 	cm_node_t *node = model->node;
 	while ( 1 ) {
@@ -478,7 +479,7 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 		return results->c.contents;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	tw.checkCount = ++idCollisionModelManagerLocal::checkCount;
 
 	memset(&tw.trace, 0, sizeof(tw.trace));
 	tw.trace.fraction = 1.0f;
@@ -491,7 +492,8 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 	tw.pointTrace = false;
 	tw.quickExit = false;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::ModelForTrace( model );
+	idCollisionModelManagerLocal::SetupTraceCaches( &tw );
 	tw.start = start - modelOrigin;
 	tw.end = tw.start;
 
@@ -230,10 +230,10 @@ void idCollisionModelManagerLocal::DrawPolygon( cm_model_t *model, cm_polygon_t
 		for ( i = 0; i < p->numEdges; i++ ) {
 			edgeNum = p->edges[i];
 			edge = model->edges + abs(edgeNum);
-			if ( edge->checkcount == checkCount ) {
+			if ( edge->cache.checkcount == checkCount ) {
 				continue;
 			}
-			edge->checkcount = checkCount;
+			edge->cache.checkcount = checkCount;
 			DrawEdge( model, edgeNum, origin, axis );
 		}
 	}
@@ -32,6 +32,12 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #define CM_FILEID			"CM"
 #define CM_FILEVERSION		"1.00"
 
+#define CM_BINARY_FILE_EXT		"cmb"
+#define CM_BINARY_FILEID		( ( '1' << 24 ) | ( 'B' << 16 ) | ( 'M' << 8 ) | 'C' )
+#define CM_BINARY_FILEVERSION	1
+
+static idCVar cm_binaryModels( "cm_binaryModels", "1", CVAR_BOOL | CVAR_SYSTEM, "load the collision models from the binary .cmb written on the first load of the .cm file" );
+
 
 /*
 ===============================================================================
@@ -318,9 +324,9 @@ void idCollisionModelManagerLocal::ParseVertices( idLexer *src, cm_model_t *mode
 	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
 	for ( i = 0; i < model->numVertices; i++ ) {
 		src->Parse1DMatrix( 3, model->vertices[i].p.ToFloatPtr() );
-		model->vertices[i].side = 0;
-		model->vertices[i].sideSet = 0;
-		model->vertices[i].checkcount = 0;
+		model->vertices[i].cache.side = 0;
+		model->vertices[i].cache.sideSet = 0;
+		model->vertices[i].cache.checkcount = 0;
 	}
 	src->ExpectTokenString( "}" );
 }
@@ -342,12 +348,12 @@ void idCollisionModelManagerLocal::ParseEdges( idLexer *src, cm_model_t *model )
 		model->edges[i].vertexNum[0] = src->ParseInt();
 		model->edges[i].vertexNum[1] = src->ParseInt();
 		src->ExpectTokenString( ")" );
-		model->edges[i].side = 0;
-		model->edges[i].sideSet = 0;
+		model->edges[i].cache.side = 0;
+		model->edges[i].cache.sideSet = 0;
 		model->edges[i].internal = src->ParseInt();
 		model->edges[i].numUsers = src->ParseInt();
 		model->edges[i].normal = vec3_origin;
-		model->edges[i].checkcount = 0;
+		model->edges[i].cache.checkcount = 0;
 		model->numInternalEdges += model->edges[i].internal;
 	}
 	src->ExpectTokenString( "}" );
@@ -545,35 +551,51 @@ idCollisionModelManagerLocal::LoadCollisionModelFile
 */
 bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, const unsigned int mapFileCRC ) {
 	idStr fileName;
+	idStr binaryName;
 	idToken token;
 	idLexer *src;
+	char *buffer;
 	unsigned int crc;
+	int firstModel;
 
 	// load it
 	fileName = name;
 	fileName.SetFileExtension( CM_FILE_EXT );
-	src = new idLexer( fileName );
-	src->SetFlags( LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
-	if ( !src->IsLoaded() ) {
-		delete src;
+	const int length = fileSystem->ReadFile( fileName, (void **)&buffer );
+	if ( !buffer ) {
 		return false;
 	}
 
+	// the binary copy is only used if it was written from exactly this file
+	const unsigned int checksum = MD5_BlockChecksum( buffer, length );
+	binaryName = name;
+	binaryName.SetFileExtension( CM_BINARY_FILE_EXT );
+	if ( cm_binaryModels.GetBool() && LoadBinaryCollisionModelFile( binaryName, mapFileCRC, length, checksum ) ) {
+		fileSystem->FreeFile( buffer );
+		return true;
+	}
+
+	src = new idLexer( LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
+	src->LoadMemory( buffer, length, fileName );
+
 	if ( !src->ExpectTokenString( CM_FILEID ) ) {
 		common->Warning( "%s is not an CM file.", fileName.c_str() );
 		delete src;
+		fileSystem->FreeFile( buffer );
 		return false;
 	}
 
 	if ( !src->ReadToken( &token ) || token != CM_FILEVERSION ) {
 		common->Warning( "%s has version %s instead of %s", fileName.c_str(), token.c_str(), CM_FILEVERSION );
 		delete src;
+		fileSystem->FreeFile( buffer );
 		return false;
 	}
 
 	if ( !src->ExpectTokenType( TT_NUMBER, TT_INTEGER, &token ) ) {
 		common->Warning( "%s has no map file CRC", fileName.c_str() );
 		delete src;
+		fileSystem->FreeFile( buffer );
 		return false;
 	}
 
@@ -581,10 +603,12 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, con
 	if ( mapFileCRC && crc != mapFileCRC ) {
 		common->Printf( "%s is out of date\n", fileName.c_str() );
 		delete src;
+		fileSystem->FreeFile( buffer );
 		return false;
 	}
 
 	// parse the file
+	firstModel = numModels;
 	while ( 1 ) {
 		if ( !src->ReadToken( &token ) ) {
 			break;
@@ -593,6 +617,7 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, con
 		if ( token == "collisionModel" ) {
 			if ( !ParseCollisionModel( src ) ) {
 				delete src;
+				fileSystem->FreeFile( buffer );
 				return false;
 			}
 			continue;
@@ -602,6 +627,625 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, con
 	}
 
 	delete src;
+	fileSystem->FreeFile( buffer );
+
+	if ( cm_binaryModels.GetBool() ) {
+		WriteBinaryCollisionModelsToFile( binaryName, firstModel, numModels, crc, length, checksum );
+	}
+
+	return true;
+}
+
+
+/*
+===============================================================================
+
+Binary copy of collision model file
+
+The models of a .cm file are written to a .cmb file after parsing it. Vertices
+and edges are stored as they are in memory, polygons, brushes and nodes are
+stored in flat arrays which refer to each other by index. The whole file is
+loaded with a single read and the models are set up without any parsing,
+filtering into the tree or calculating edge normals.
+
+===============================================================================
+*/
+
+typedef struct cm_binaryHeader_s {
+	int						id;
+	int						version;
+	unsigned int			mapFileCRC;			// map file crc of the .cm file
+	int						cmLength;			// length of the .cm file
+	unsigned int			cmChecksum;			// MD5_BlockChecksum of the .cm file
+	int						vertexSize;			// sizeof( cm_vertex_t )
+	int						edgeSize;			// sizeof( cm_edge_t )
+	int						numModels;
+} cm_binaryHeader_t;
+
+typedef struct cm_binaryModel_s {
+	idBounds				bounds;
+	int						contents;
+	int						numVertices;
+	int						numEdges;
+	int						numInternalEdges;
+	int						numSharpEdges;
+	int						numMaterials;
+	int						numPolygons;
+	int						numPolygonEdges;	// edge numbers of all polygons
+	int						numBrushes;
+	int						numBrushPlanes;		// planes of all brushes
+	int						numNodes;
+	int						numPolygonRefs;
+	int						numBrushRefs;
+} cm_binaryModel_t;
+
+typedef struct cm_binaryPolygon_s {
+	idBounds				bounds;
+	idPlane					plane;
+	int						material;			// index into the material names
+	int						firstEdge;			// index into the polygon edge numbers
+	int						numEdges;
+} cm_binaryPolygon_t;
+
+typedef struct cm_binaryBrush_s {
+	idBounds				bounds;
+	int						contents;
+	int						primitiveNum;
+	int						firstPlane;			// index into the brush planes
+	int						numPlanes;
+} cm_binaryBrush_t;
+
+typedef struct cm_binaryNode_s {
+	int						planeType;
+	float					planeDist;
+	int						children[2];		// indexes of the child nodes, always after their parent
+	int						firstPolygonRef;	// index into the polygon references
+	int						numPolygonRefs;
+	int						firstBrushRef;		// index into the brush references
+	int						numBrushRefs;
+} cm_binaryNode_t;
+
+// flat arrays of a model while it is written
+typedef struct cm_binaryArrays_s {
+	idList<const idMaterial *>	materials;
+	idList<const cm_polygon_t *>polygonPtrs;
+	idList<cm_binaryPolygon_t>	polygons;
+	idList<int>					polygonEdges;
+	idList<const cm_brush_t *>	brushPtrs;
+	idList<cm_binaryBrush_t>	brushes;
+	idList<idPlane>				brushPlanes;
+	idList<cm_binaryNode_t>		nodes;
+	idList<int>					polygonRefs;
+	idList<int>					brushRefs;
+	idHashIndex					polygonHash;
+	idHashIndex					brushHash;
+} cm_binaryArrays_t;
+
+/*
+================
+CM_BinaryWrite
+
+Writes the data padded to four bytes, so the arrays following it stay aligned.
+================
+*/
+static void CM_BinaryWrite( idFile *fp, const void *data, int size ) {
+	static const byte pad[4] = { 0, 0, 0, 0 };
+	fp->Write( data, size );
+	if ( size & 3 ) {
+		fp->Write( pad, 4 - ( size & 3 ) );
+	}
+}
+
+static void CM_BinaryWriteInt( idFile *fp, int value ) {
+	CM_BinaryWrite( fp, &value, sizeof( value ) );
+}
+
+static void CM_BinaryWriteString( idFile *fp, const char *string ) {
+	const int length = idStr::Length( string ) + 1;
+	CM_BinaryWriteInt( fp, length );
+	CM_BinaryWrite( fp, string, length );
+}
+
+/*
+================
+CM_BinaryRead
+
+Returns a pointer to the next size bytes of the file, or NULL past its end.
+================
+*/
+static const void *CM_BinaryRead( cm_binaryReader_t &src, int size ) {
+	if ( src.error || size < 0 || size > src.length - src.offset ) {
+		src.error = true;
+		return NULL;
+	}
+	const void *data = src.data + src.offset;
+	src.offset += ( size + 3 ) & ~3;
+	if ( src.offset > src.length ) {
+		src.offset = src.length;
+	}
+	return data;
+}
+
+// false if the count is negative or the array could not fit in the rest of the file
+static bool CM_BinaryCountFits( const cm_binaryReader_t &src, int count, size_t size ) {
+	return count >= 0 && (size_t)count <= (size_t)( src.length - src.offset ) / size;
+}
+
+static int CM_BinaryReadInt( cm_binaryReader_t &src ) {
+	const int *value = (const int *) CM_BinaryRead( src, sizeof( int ) );
+	return value ? *value : 0;
+}
+
+static const char *CM_BinaryReadString( cm_binaryReader_t &src ) {
+	const int length = CM_BinaryReadInt( src );
+	const char *string = (const char *) CM_BinaryRead( src, length );
+	if ( !string || length < 1 || string[length - 1] != '\0' ) {
+		src.error = true;
+		return "";
+	}
+	return string;
+}
+
+/*
+================
+CM_BinaryPolygonIndex
+================
+*/
+static int CM_BinaryPolygonIndex( cm_binaryArrays_t &arrays, const cm_polygon_t *p ) {
+	const int hash = arrays.polygonHash.GenerateKey( (int)( (intptr_t)p >> 3 ), 0 );
+	for ( int i = arrays.polygonHash.First( hash ); i != -1; i = arrays.polygonHash.Next( i ) ) {
+		if ( arrays.polygonPtrs[i] == p ) {
+			return i;
+		}
+	}
+
+	cm_binaryPolygon_t &polygon = arrays.polygons.Alloc();
+	polygon.bounds = p->bounds;
+	polygon.plane = p->plane;
+	polygon.material = arrays.materials.AddUnique( p->material );
+	polygon.firstEdge = arrays.polygonEdges.Num();
+	polygon.numEdges = p->numEdges;
+	for ( int i = 0; i < p->numEdges; i++ ) {
+		arrays.polygonEdges.Append( p->edges[i] );
+	}
+
+	const int index = arrays.polygonPtrs.Append( p );
+	arrays.polygonHash.Add( hash, index );
+	return index;
+}
+
+/*
+================
+CM_BinaryBrushIndex
+================
+*/
+static int CM_BinaryBrushIndex( cm_binaryArrays_t &arrays, const cm_brush_t *b ) {
+	const int hash = arrays.brushHash.GenerateKey( (int)( (intptr_t)b >> 3 ), 0 );
+	for ( int i = arrays.brushHash.First( hash ); i != -1; i = arrays.brushHash.Next( i ) ) {
+		if ( arrays.brushPtrs[i] == b ) {
+			return i;
+		}
+	}
+
+	cm_binaryBrush_t &brush = arrays.brushes.Alloc();
+	brush.bounds = b->bounds;
+	brush.contents = b->contents;
+	brush.primitiveNum = b->primitiveNum;
+	brush.firstPlane = arrays.brushPlanes.Num();
+	brush.numPlanes = b->numPlanes;
+	for ( int i = 0; i < b->numPlanes; i++ ) {
+		arrays.brushPlanes.Append( b->planes[i] );
+	}
+
+	const int index = arrays.brushPtrs.Append( b );
+	arrays.brushHash.Add( hash, index );
+	return index;
+}
+
+/*
+================
+CM_BinaryNodes_r
+
+Adds the nodes in depth first order, the polygons and brushes in the order they are first referenced.
+================
+*/
+static int CM_BinaryNodes_r( cm_binaryArrays_t &arrays, const cm_node_t *node ) {
+	const int nodeNum = arrays.nodes.Num();
+	cm_binaryNode_t &n = arrays.nodes.Alloc();
+	n.planeType = node->planeType;
+	n.planeDist = node->planeDist;
+	n.children[0] = n.children[1] = -1;
+
+	n.firstPolygonRef = arrays.polygonRefs.Num();
+	for ( const cm_polygonRef_t *pref = node->polygons; pref; pref = pref->next ) {
+		arrays.polygonRefs.Append( CM_BinaryPolygonIndex( arrays, pref->p ) );
+	}
+	n.numPolygonRefs = arrays.polygonRefs.Num() - n.firstPolygonRef;
+
+	n.firstBrushRef = arrays.brushRefs.Num();
+	for ( const cm_brushRef_t *bref = node->brushes; bref; bref = bref->next ) {
+		arrays.brushRefs.Append( CM_BinaryBrushIndex( arrays, bref->b ) );
+	}
+	n.numBrushRefs = arrays.brushRefs.Num() - n.firstBrushRef;
+
+	if ( node->planeType != -1 ) {
+		// the list may be reallocated while adding the children
+		const int child0 = CM_BinaryNodes_r( arrays, node->children[0] );
+		const int child1 = CM_BinaryNodes_r( arrays, node->children[1] );
+		arrays.nodes[nodeNum].children[0] = child0;
+		arrays.nodes[nodeNum].children[1] = child1;
+	}
+	return nodeNum;
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModel
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModel( idFile *fp, cm_model_t *model ) {
+	cm_binaryArrays_t arrays;
+	cm_binaryModel_t header;
+	int i;
+
+	if ( model->node ) {
+		CM_BinaryNodes_r( arrays, model->node );
+	}
+
+	header.bounds = model->bounds;
+	header.contents = model->contents;
+	header.numVertices = model->numVertices;
+	header.numEdges = model->numEdges;
+	header.numInternalEdges = model->numInternalEdges;
+	header.numSharpEdges = model->numSharpEdges;
+	header.numMaterials = arrays.materials.Num();
+	header.numPolygons = arrays.polygons.Num();
+	header.numPolygonEdges = arrays.polygonEdges.Num();
+	header.numBrushes = arrays.brushes.Num();
+	header.numBrushPlanes = arrays.brushPlanes.Num();
+	header.numNodes = arrays.nodes.Num();
+	header.numPolygonRefs = arrays.polygonRefs.Num();
+	header.numBrushRefs = arrays.brushRefs.Num();
+
+	CM_BinaryWriteString( fp, model->name );
+	CM_BinaryWrite( fp, &header, sizeof( header ) );
+
+	// vertices and edges without the trace caches
+	cm_vertex_t *vertices = (cm_vertex_t *) Mem_Alloc( Max( model->numVertices, 1 ) * sizeof( cm_vertex_t ) );
+	memcpy( vertices, model->vertices, model->numVertices * sizeof( cm_vertex_t ) );
+	for ( i = 0; i < model->numVertices; i++ ) {
+		memset( &vertices[i].cache, 0, sizeof( vertices[i].cache ) );
+	}
+	CM_BinaryWrite( fp, vertices, model->numVertices * sizeof( cm_vertex_t ) );
+	Mem_Free( vertices );
+
+	cm_edge_t *edges = (cm_edge_t *) Mem_Alloc( Max( model->numEdges, 1 ) * sizeof( cm_edge_t ) );
+	memcpy( edges, model->edges, model->numEdges * sizeof( cm_edge_t ) );
+	for ( i = 0; i < model->numEdges; i++ ) {
+		memset( &edges[i].cache, 0, sizeof( edges[i].cache ) );
+	}
+	CM_BinaryWrite( fp, edges, model->numEdges * sizeof( cm_edge_t ) );
+	Mem_Free( edges );
+
+	for ( i = 0; i < arrays.materials.Num(); i++ ) {
+		CM_BinaryWriteString( fp, arrays.materials[i]->GetName() );
+	}
+	CM_BinaryWrite( fp, arrays.polygons.Ptr(), arrays.polygons.Num() * sizeof( cm_binaryPolygon_t ) );
+	CM_BinaryWrite( fp, arrays.polygonEdges.Ptr(), arrays.polygonEdges.Num() * sizeof( int ) );
+	CM_BinaryWrite( fp, arrays.brushes.Ptr(), arrays.brushes.Num() * sizeof( cm_binaryBrush_t ) );
+	CM_BinaryWrite( fp, arrays.brushPlanes.Ptr(), arrays.brushPlanes.Num() * sizeof( idPlane ) );
+	CM_BinaryWrite( fp, arrays.nodes.Ptr(), arrays.nodes.Num() * sizeof( cm_binaryNode_t ) );
+	CM_BinaryWrite( fp, arrays.polygonRefs.Ptr(), arrays.polygonRefs.Num() * sizeof( int ) );
+	CM_BinaryWrite( fp, arrays.brushRefs.Ptr(), arrays.brushRefs.Num() * sizeof( int ) );
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC, int cmLength, unsigned int cmChecksum ) {
+	TRACE_CPU_SCOPE_FORMAT( "WriteBinaryCollisionFile", "filename %s\nmodels [%d .. %d)", filename, firstModel, lastModel );
+
+	idFile *fp;
+	cm_binaryHeader_t header;
+	int i;
+
+	fp = fileSystem->OpenFileWrite( filename );
+	if ( !fp ) {
+		common->Warning( "idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile: Error opening file %s", filename );
+		return;
+	}
+
+	header.id = CM_BINARY_FILEID;
+	header.version = CM_BINARY_FILEVERSION;
+	header.mapFileCRC = mapFileCRC;
+	header.cmLength = cmLength;
+	header.cmChecksum = cmChecksum;
+	header.vertexSize = sizeof( cm_vertex_t );
+	header.edgeSize = sizeof( cm_edge_t );
+	header.numModels = lastModel - firstModel;
+	CM_BinaryWrite( fp, &header, sizeof( header ) );
+
+	for ( i = firstModel; i < lastModel; i++ ) {
+		WriteBinaryCollisionModel( fp, models[i] );
+	}
+
+	fileSystem->CloseFile( fp );
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReadBinaryCollisionModel
+
+Returns NULL and sets the error of the reader if the model is damaged.
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::ReadBinaryCollisionModel( cm_binaryReader_t &src ) {
+	idList<const char *> materialNames;
+	idList<cm_polygon_t *> polygonList;
+	idList<cm_brush_t *> brushList;
+	idList<cm_node_t *> nodeList;
+	int i, j;
+
+	const char *name = CM_BinaryReadString( src );
+	const cm_binaryModel_t *header = (const cm_binaryModel_t *) CM_BinaryRead( src, sizeof( cm_binaryModel_t ) );
+	if ( src.error || header->numMaterials < 0 || header->numNodes < 1 ||
+			!CM_BinaryCountFits( src, header->numVertices, sizeof( cm_vertex_t ) ) || !CM_BinaryCountFits( src, header->numEdges, sizeof( cm_edge_t ) ) ||
+				!CM_BinaryCountFits( src, header->numPolygons, sizeof( cm_binaryPolygon_t ) ) || !CM_BinaryCountFits( src, header->numPolygonEdges, sizeof( int ) ) ||
+					!CM_BinaryCountFits( src, header->numBrushes, sizeof( cm_binaryBrush_t ) ) || !CM_BinaryCountFits( src, header->numBrushPlanes, sizeof( idPlane ) ) ||
+						!CM_BinaryCountFits( src, header->numNodes, sizeof( cm_binaryNode_t ) ) || !CM_BinaryCountFits( src, header->numPolygonRefs, sizeof( int ) ) ||
+							!CM_BinaryCountFits( src, header->numBrushRefs, sizeof( int ) ) ) {
+		src.error = true;
+		return NULL;
+	}
+
+	const cm_vertex_t *vertices = (const cm_vertex_t *) CM_BinaryRead( src, header->numVertices * sizeof( cm_vertex_t ) );
+	const cm_edge_t *edges = (const cm_edge_t *) CM_BinaryRead( src, header->numEdges * sizeof( cm_edge_t ) );
+	materialNames.SetNum( header->numMaterials );
+	for ( i = 0; i < header->numMaterials; i++ ) {
+		materialNames[i] = CM_BinaryReadString( src );
+	}
+	const cm_binaryPolygon_t *polygons = (const cm_binaryPolygon_t *) CM_BinaryRead( src, header->numPolygons * sizeof( cm_binaryPolygon_t ) );
+	const int *polygonEdges = (const int *) CM_BinaryRead( src, header->numPolygonEdges * sizeof( int ) );
+	const cm_binaryBrush_t *brushes = (const cm_binaryBrush_t *) CM_BinaryRead( src, header->numBrushes * sizeof( cm_binaryBrush_t ) );
+	const idPlane *brushPlanes = (const idPlane *) CM_BinaryRead( src, header->numBrushPlanes * sizeof( idPlane ) );
+	const cm_binaryNode_t *nodes = (const cm_binaryNode_t *) CM_BinaryRead( src, header->numNodes * sizeof( cm_binaryNode_t ) );
+	const int *polygonRefs = (const int *) CM_BinaryRead( src, header->numPolygonRefs * sizeof( int ) );
+	const int *brushRefs = (const int *) CM_BinaryRead( src, header->numBrushRefs * sizeof( int ) );
+	if ( src.error ) {
+		return NULL;
+	}
+
+	// check all index links before building anything
+	for ( i = 0; i < header->numEdges; i++ ) {
+		const cm_edge_t &e = edges[i];
+		if ( e.vertexNum[0] < 0 || e.vertexNum[0] >= header->numVertices || e.vertexNum[1] < 0 || e.vertexNum[1] >= header->numVertices ) {
+			src.error = true;
+			return NULL;
+		}
+	}
+	for ( i = 0; i < header->numPolygons; i++ ) {
+		const cm_binaryPolygon_t &p = polygons[i];
+		if ( p.material < 0 || p.material >= header->numMaterials || p.numEdges < 0 || p.firstEdge < 0 || p.firstEdge > header->numPolygonEdges - p.numEdges ) {
+			src.error = true;
+			return NULL;
+		}
+		for ( j = 0; j < p.numEdges; j++ ) {
+			// negative for reversed edges, no abs() as it is undefined for INT_MIN
+			const int edgeNum = polygonEdges[p.firstEdge + j];
+			if ( edgeNum >= header->numEdges || edgeNum <= -header->numEdges ) {
+				src.error = true;
+				return NULL;
+			}
+		}
+	}
+	for ( i = 0; i < header->numBrushes; i++ ) {
+		const cm_binaryBrush_t &b = brushes[i];
+		if ( b.numPlanes < 0 || b.firstPlane < 0 || b.firstPlane > header->numBrushPlanes - b.numPlanes ) {
+			src.error = true;
+			return NULL;
+		}
+	}
+	for ( i = 0; i < header->numNodes; i++ ) {
+		const cm_binaryNode_t &n = nodes[i];
+		if ( n.planeType < -1 || n.planeType > 2 ||
+				n.numPolygonRefs < 0 || n.firstPolygonRef < 0 || n.firstPolygonRef > header->numPolygonRefs - n.numPolygonRefs ||
+					n.numBrushRefs < 0 || n.firstBrushRef < 0 || n.firstBrushRef > header->numBrushRefs - n.numBrushRefs ) {
+			src.error = true;
+			return NULL;
+		}
+		// children after their parent also rule out cycles
+		if ( n.planeType != -1 && ( n.children[0] <= i || n.children[0] >= header->numNodes || n.children[1] <= i || n.children[1] >= header->numNodes ) ) {
+			src.error = true;
+			return NULL;
+		}
+	}
+	for ( i = 0; i < header->numPolygonRefs; i++ ) {
+		if ( polygonRefs[i] < 0 || polygonRefs[i] >= header->numPolygons ) {
+			src.error = true;
+			return NULL;
+		}
+	}
+	for ( i = 0; i < header->numBrushRefs; i++ ) {
+		if ( brushRefs[i] < 0 || brushRefs[i] >= header->numBrushes ) {
+			src.error = true;
+			return NULL;
+		}
+	}
+
+	cm_model_t *model = AllocModel();
+	model->name = name;
+	model->bounds = header->bounds;
+	model->contents = header->contents;
+
+	// vertices
+	model->numVertices = model->maxVertices = header->numVertices;
+	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
+	memcpy( model->vertices, vertices, model->numVertices * sizeof( cm_vertex_t ) );
+
+	// edges with their normals
+	model->numEdges = model->maxEdges = header->numEdges;
+	model->edges = (cm_edge_t *) Mem_Alloc( model->maxEdges * sizeof( cm_edge_t ) );
+	memcpy( model->edges, edges, model->numEdges * sizeof( cm_edge_t ) );
+	model->numInternalEdges = header->numInternalEdges;
+	model->numSharpEdges = header->numSharpEdges;
+
+	// polygons in a single block
+	const int polygonMemory = header->numPolygons * ( sizeof( cm_polygon_t ) - sizeof( int ) ) + header->numPolygonEdges * sizeof( int );
+	model->polygonBlock = (cm_polygonBlock_t *) Mem_Alloc( sizeof( cm_polygonBlock_t ) + polygonMemory );
+	model->polygonBlock->bytesRemaining = polygonMemory;
+	model->polygonBlock->next = ( (byte *) model->polygonBlock ) + sizeof( cm_polygonBlock_t );
+	polygonList.SetNum( header->numPolygons );
+	for ( i = 0; i < header->numPolygons; i++ ) {
+		const cm_binaryPolygon_t &bp = polygons[i];
+		cm_polygon_t *p = AllocPolygon( model, bp.numEdges );
+		p->numEdges = bp.numEdges;
+		memcpy( p->edges, polygonEdges + bp.firstEdge, bp.numEdges * sizeof( p->edges[0] ) );
+		p->plane = bp.plane;
+		p->bounds = bp.bounds;
+		p->material = declManager->FindMaterial( materialNames[bp.material] );
+		p->contents = p->material->GetContentFlags();
+		p->checkcount = 0;
+		polygonList[i] = p;
+	}
+
+	// brushes in a single block
+	const int brushMemory = header->numBrushes * ( sizeof( cm_brush_t ) - sizeof( idPlane ) ) + header->numBrushPlanes * sizeof( idPlane );
+	model->brushBlock = (cm_brushBlock_t *) Mem_Alloc( sizeof( cm_brushBlock_t ) + brushMemory );
+	model->brushBlock->bytesRemaining = brushMemory;
+	model->brushBlock->next = ( (byte *) model->brushBlock ) + sizeof( cm_brushBlock_t );
+	brushList.SetNum( header->numBrushes );
+	for ( i = 0; i < header->numBrushes; i++ ) {
+		const cm_binaryBrush_t &bb = brushes[i];
+		cm_brush_t *b = AllocBrush( model, bb.numPlanes );
+		b->numPlanes = bb.numPlanes;
+		memcpy( b->planes, brushPlanes + bb.firstPlane, bb.numPlanes * sizeof( b->planes[0] ) );
+		b->bounds = bb.bounds;
+		b->contents = bb.contents;
+		b->primitiveNum = bb.primitiveNum;
+		b->checkcount = 0;
+		brushList[i] = b;
+	}
+
+	// nodes in a single block
+	nodeList.SetNum( header->numNodes );
+	for ( i = 0; i < header->numNodes; i++ ) {
+		cm_node_t *node = AllocNode( model, header->numNodes );
+		node->planeType = nodes[i].planeType;
+		node->planeDist = nodes[i].planeDist;
+		node->polygons = NULL;
+		node->brushes = NULL;
+		node->children[0] = node->children[1] = NULL;
+		nodeList[i] = node;
+	}
+	model->numNodes = header->numNodes;
+	model->node = nodeList[0];
+
+	for ( i = 0; i < header->numNodes; i++ ) {
+		const cm_binaryNode_t &n = nodes[i];
+		cm_node_t *node = nodeList[i];
+		if ( n.planeType != -1 ) {
+			node->children[0] = nodeList[n.children[0]];
+			node->children[1] = nodeList[n.children[1]];
+			node->children[0]->parent = node;
+			node->children[1]->parent = node;
+		}
+		// link the references backwards to keep the order they were written in
+		for ( j = n.numPolygonRefs - 1; j >= 0; j-- ) {
+			cm_polygonRef_t *pref = AllocPolygonReference( model, header->numPolygonRefs );
+			pref->p = polygonList[polygonRefs[n.firstPolygonRef + j]];
+			pref->next = node->polygons;
+			node->polygons = pref;
+			model->numPolygonRefs++;
+		}
+		for ( j = n.numBrushRefs - 1; j >= 0; j-- ) {
+			cm_brushRef_t *bref = AllocBrushReference( model, header->numBrushRefs );
+			bref->b = brushList[brushRefs[n.firstBrushRef + j]];
+			bref->next = node->brushes;
+			node->brushes = bref;
+			model->numBrushRefs++;
+		}
+	}
+
+	// total memory used by this model
+	model->usedMemory = model->numVertices * sizeof(cm_vertex_t) +
+						model->numEdges * sizeof(cm_edge_t) +
+						model->polygonMemory +
+						model->brushMemory +
+						model->numNodes * sizeof(cm_node_t) +
+						model->numPolygonRefs * sizeof(cm_polygonRef_t) +
+						model->numBrushRefs * sizeof(cm_brushRef_t);
+
+	return model;
+}
+
+/*
+================
+idCollisionModelManagerLocal::LoadBinaryCollisionModelFile
+
+Loads the models from the binary copy of the .cm file.
+Returns false if it is missing or was not written from the given .cm file.
+================
+*/
+bool idCollisionModelManagerLocal::LoadBinaryCollisionModelFile( const char *filename, unsigned int mapFileCRC, int cmLength, unsigned int cmChecksum ) {
+	idList<cm_model_t *> loaded;
+	void *buffer;
+	int i;
+
+	const int length = fileSystem->ReadFile( filename, &buffer );
+	if ( !buffer ) {
+		return false;
+	}
+	TRACE_CPU_SCOPE_TEXT( "Load:BinaryCM", filename )
+
+	cm_binaryReader_t src;
+	src.data = (const byte *) buffer;
+	src.length = length;
+	src.offset = 0;
+	src.error = false;
+
+	const cm_binaryHeader_t *header = (const cm_binaryHeader_t *) CM_BinaryRead( src, sizeof( cm_binaryHeader_t ) );
+	if ( !header || header->id != CM_BINARY_FILEID || header->version != CM_BINARY_FILEVERSION ||
+			header->cmLength != cmLength || header->cmChecksum != cmChecksum ||
+				header->vertexSize != sizeof( cm_vertex_t ) || header->edgeSize != sizeof( cm_edge_t ) ) {
+		common->Printf( "%s is out of date\n", filename );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	// the .cm file itself is out of date, reported when parsing it
+	if ( mapFileCRC && header->mapFileCRC != mapFileCRC ) {
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	// leave running out of model slots to the .cm file
+	if ( header->numModels < 0 || header->numModels > MAX_SUBMODELS - numModels ) {
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	for ( i = 0; i < header->numModels && !src.error; i++ ) {
+		cm_model_t *model = ReadBinaryCollisionModel( src );
+		if ( model ) {
+			loaded.Append( model );
+		}
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	if ( src.error ) {
+		common->Warning( "%s is damaged, parsing the .cm file instead", filename );
+		for ( i = 0; i < loaded.Num(); i++ ) {
+			FreeModel( loaded[i] );
+		}
+		return false;
+	}
+
+	for ( i = 0; i < loaded.Num(); i++ ) {
+		AddModel( loaded[i] );
+	}
 
 	return true;
 }
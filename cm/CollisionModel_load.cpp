@@ -172,9 +172,10 @@ void idCollisionModelManagerLocal::Clear( void ) {
 	maxModels = 0;
 	numModels = 0;
 	models = NULL;
-	memset( trmPolygons, 0, sizeof( trmPolygons ) );
-	trmBrushes[0] = NULL;
+	memset( &trmModel, 0, sizeof( trmModel ) );
 	trmMaterial = NULL;
+	parallelTraces = false;
+	memset( slotTrmModels, 0, sizeof( slotTrmModels ) );
 	numProcNodes = 0;
 	procNodes = NULL;
 	getContacts = false;
@@ -384,6 +385,10 @@ void idCollisionModelManagerLocal::FreeModel( cm_model_t *model ) {
 	Mem_Free( model->edges );
 	// free vertices
 	Mem_Free( model->vertices );
+	// free caches of parallel traces
+	for ( int i = 0; i < CM_MAX_TRACE_SLOTS; i++ ) {
+		Mem_Free( model->traceCaches[i] );
+	}
 	// free the model
 	delete model;
 }
@@ -408,7 +413,13 @@ void idCollisionModelManagerLocal::FreeMap( void ) {
 		FreeModel( models[i] );
 	}
 
-	FreeTrmModelStructure();
+	FreeTrmModelStructure( trmModel );
+	for ( i = 0; i < CM_MAX_TRACE_SLOTS; i++ ) {
+		if ( slotTrmModels[i] ) {
+			FreeTrmModelStructure( *slotTrmModels[i] );
+			delete slotTrmModels[i];
+		}
+	}
 
 	Mem_Free( models );
 	modelsHash.ClearFree();
@@ -423,22 +434,22 @@ void idCollisionModelManagerLocal::FreeMap( void ) {
 idCollisionModelManagerLocal::FreeTrmModelStructure
 ================
 */
-void idCollisionModelManagerLocal::FreeTrmModelStructure( void ) {
+void idCollisionModelManagerLocal::FreeTrmModelStructure( cm_trmModel_t &trmModel ) {
 	int i;
 
-	assert( models );
-	if ( !models[MAX_SUBMODELS] ) {
+	if ( !trmModel.model ) {
 		return;
 	}
 
 	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		FreePolygon( models[MAX_SUBMODELS], trmPolygons[i]->p );
+		FreePolygon( trmModel.model, trmModel.polygons[i]->p );
 	}
-	FreeBrush( models[MAX_SUBMODELS], trmBrushes[0]->b );
+	FreeBrush( trmModel.model, trmModel.brushes[0]->b );
 
-	models[MAX_SUBMODELS]->node->polygons = NULL;
-	models[MAX_SUBMODELS]->node->brushes = NULL;
-	FreeModel( models[MAX_SUBMODELS] );
+	trmModel.model->node->polygons = NULL;
+	trmModel.model->node->brushes = NULL;
+	FreeModel( trmModel.model );
+	trmModel.model = NULL;
 }
 
 
@@ -549,6 +560,7 @@ cm_model_t *idCollisionModelManagerLocal::AllocModel( void ) {
 	model->numPolygonRefs = model->numInternalEdges =
 	model->numSharpEdges = model->numRemovedPolys =
 	model->numMergedPolys = model->usedMemory = 0;
+	memset( model->traceCaches, 0, sizeof( model->traceCaches ) );
 
 	return model;
 }
@@ -723,16 +735,15 @@ void idCollisionModelManagerLocal::AddBrushToNode( cm_model_t *model, cm_node_t
 idCollisionModelManagerLocal::SetupTrmModelStructure
 ================
 */
-void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
+void idCollisionModelManagerLocal::SetupTrmModelStructure( cm_trmModel_t &trmModel ) {
 	int i;
 	cm_node_t *node;
 	cm_model_t *model;
 
 	// setup model
 	model = AllocModel();
+	trmModel.model = model;
 
-	assert( models );
-	models[MAX_SUBMODELS] = model;
 	// create node to hold the collision data
 	node = (cm_node_t *) AllocNode( model, 1 );
 	node->planeType = -1;
@@ -745,30 +756,32 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
 	model->maxEdges = MAX_TRACEMODEL_EDGES+1;
 	model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t) );
 	// create a material for the trace model polygons
-	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
 	if ( !trmMaterial ) {
-		common->FatalError( "_tracemodel material not found" );
+		trmMaterial = declManager->FindMaterial( "_tracemodel", false );
+		if ( !trmMaterial ) {
+			common->FatalError( "_tracemodel material not found" );
+		}
 	}
 
 	// allocate polygons
 	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
-		trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
-		trmPolygons[i]->p->bounds.Clear();
-		trmPolygons[i]->p->plane.Zero();
-		trmPolygons[i]->p->checkcount = 0;
-		trmPolygons[i]->p->contents = -1;		// all contents
-		trmPolygons[i]->p->material = trmMaterial;
-		trmPolygons[i]->p->numEdges = 0;
+		trmModel.polygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
+		trmModel.polygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
+		trmModel.polygons[i]->p->bounds.Clear();
+		trmModel.polygons[i]->p->plane.Zero();
+		trmModel.polygons[i]->p->checkcount = 0;
+		trmModel.polygons[i]->p->contents = -1;		// all contents
+		trmModel.polygons[i]->p->material = trmMaterial;
+		trmModel.polygons[i]->p->numEdges = 0;
 	}
 	// allocate brush for position test
-	trmBrushes[0] = AllocBrushReference( model, 1 );
-	trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
-	trmBrushes[0]->b->primitiveNum = 0;
-	trmBrushes[0]->b->bounds.Clear();
-	trmBrushes[0]->b->checkcount = 0;
-	trmBrushes[0]->b->contents = -1;		// all contents
-	trmBrushes[0]->b->numPlanes = 0;
+	trmModel.brushes[0] = AllocBrushReference( model, 1 );
+	trmModel.brushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
+	trmModel.brushes[0]->b->primitiveNum = 0;
+	trmModel.brushes[0]->b->bounds.Clear();
+	trmModel.brushes[0]->b->checkcount = 0;
+	trmModel.brushes[0]->b->contents = -1;		// all contents
+	trmModel.brushes[0]->b->numPlanes = 0;
 }
 
 /*
@@ -776,10 +789,26 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
 idCollisionModelManagerLocal::SetupTrmModel
 
 Trace models (item boxes, etc) are converted to collision models on the fly, using the last model slot
-as a reusable temporary buffer
+as a reusable temporary buffer. During parallel traces every thread has its own buffer behind that handle.
 ================
 */
 cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm, const idMaterial *material ) {
+	assert( models );
+
+	if ( parallelTraces ) {
+		SetupTrmModel( *SlotTrmModel(), trm, material );
+	} else {
+		SetupTrmModel( trmModel, trm, material );
+	}
+	return TRACE_MODEL_HANDLE;
+}
+
+/*
+================
+idCollisionModelManagerLocal::SetupTrmModel
+================
+*/
+void idCollisionModelManagerLocal::SetupTrmModel( cm_trmModel_t &trmModel, const idTraceModel &trm, const idMaterial *material ) {
 	int i, j;
 	cm_vertex_t *vertex;
 	cm_edge_t *edge;
@@ -789,18 +818,16 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	const traceModelEdge_t *trmEdge;
 	const traceModelPoly_t *trmPoly;
 
-	assert( models );
-
 	if ( material == NULL ) {
 		material = trmMaterial;
 	}
 
-	model = models[MAX_SUBMODELS];
+	model = trmModel.model;
 	model->node->brushes = NULL;
 	model->node->polygons = NULL;
 	// if not a valid trace model
 	if ( trm.type == TRM_INVALID || !trm.numPolys ) {
-		return TRACE_MODEL_HANDLE;
+		return;
 	}
 	// vertices
 	model->numVertices = trm.numVerts;
@@ -808,7 +835,7 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	trmVert = trm.verts;
 	for ( i = 0; i < trm.numVerts; i++, vertex++, trmVert++ ) {
 		vertex->p = *trmVert;
-		vertex->sideSet = 0;
+		vertex->cache.sideSet = 0;
 	}
 	// edges
 	model->numEdges = trm.numEdges;
@@ -819,13 +846,13 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		edge->vertexNum[1] = trmEdge->v[1];
 		edge->normal = trmEdge->normal;
 		edge->internal = false;
-		edge->sideSet = 0;
+		edge->cache.sideSet = 0;
 	}
 	// polygons
 	model->numPolygons = trm.numPolys;
 	trmPoly = trm.polys;
 	for ( i = 0; i < trm.numPolys; i++, trmPoly++ ) {
-		poly = trmPolygons[i]->p;
+		poly = trmModel.polygons[i]->p;
 		poly->numEdges = trmPoly->numEdges;
 		for ( j = 0; j < trmPoly->numEdges; j++ ) {
 			poly->edges[j] = trmPoly->edges[j];
@@ -835,27 +862,25 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		poly->bounds = trmPoly->bounds;
 		poly->material = material;
 		// link polygon at node
-		trmPolygons[i]->next = model->node->polygons;
-		model->node->polygons = trmPolygons[i];
+		trmModel.polygons[i]->next = model->node->polygons;
+		model->node->polygons = trmModel.polygons[i];
 	}
 	// if the trace model is convex
 	if ( trm.isConvex ) {
 		// setup brush for position test
-		trmBrushes[0]->b->numPlanes = trm.numPolys;
+		trmModel.brushes[0]->b->numPlanes = trm.numPolys;
 		for ( i = 0; i < trm.numPolys; i++ ) {
-			trmBrushes[0]->b->planes[i] = trmPolygons[i]->p->plane;
+			trmModel.brushes[0]->b->planes[i] = trmModel.polygons[i]->p->plane;
 		}
-		trmBrushes[0]->b->bounds = trm.bounds;
+		trmModel.brushes[0]->b->bounds = trm.bounds;
 		// link brush at node
-		trmBrushes[0]->next = model->node->brushes;
-		model->node->brushes = trmBrushes[0];
+		trmModel.brushes[0]->next = model->node->brushes;
+		model->node->brushes = trmModel.brushes[0];
 	}
 	// model bounds
 	model->bounds = trm.bounds;
 	// convex
 	model->isConvex = trm.isConvex;
-
-	return TRACE_MODEL_HANDLE;
 }
 
 /*
@@ -2304,7 +2329,7 @@ int idCollisionModelManagerLocal::GetVertex( cm_model_t *model, const idVec3 &v,
 		cm_vertexHash->ResizeIndex( model->maxVertices );
 	}
 	model->vertices[model->numVertices].p = vert;
-	model->vertices[model->numVertices].checkcount = 0;
+	model->vertices[model->numVertices].cache.checkcount = 0;
 	*vertexNum = model->numVertices;
 	// add vertice to hash
 	cm_vertexHash->Add( hashKey, model->numVertices );
@@ -2388,7 +2413,7 @@ int idCollisionModelManagerLocal::GetEdge( cm_model_t *model, const idVec3 &v1,
 	model->edges[model->numEdges].vertexNum[0] = v1num;
 	model->edges[model->numEdges].vertexNum[1] = v2num;
 	model->edges[model->numEdges].internal = false;
-	model->edges[model->numEdges].checkcount = 0;
+	model->edges[model->numEdges].cache.checkcount = 0;
 	model->edges[model->numEdges].numUsers = 1; // used by one polygon atm
 	model->edges[model->numEdges].normal.Zero();
 	//
@@ -3441,7 +3466,8 @@ void idCollisionModelManagerLocal::LoadMap( const idMapFile *mapFile ) {
 	SetupHash();
 
 	// setup trace model structure
-	SetupTrmModelStructure();
+	SetupTrmModelStructure( trmModel );
+	models[MAX_SUBMODELS] = trmModel.model;
 
 	// build collision models
 	BuildModels( mapFile );
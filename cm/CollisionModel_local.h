@@ -40,6 +40,8 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #define REFERENCE_BLOCK_SIZE_SMALL			8
 #define REFERENCE_BLOCK_SIZE_LARGE			256
 
+#define CM_MAX_TRACE_SLOTS					48		// max threads running traces at once between BeginParallelTraces and EndParallelTraces
+
 #define MAX_WINDING_LIST					128		// quite a few are generated at times
 #define INTEGRAL_EPSILON					0.01f
 #define VERTEX_EPSILON						0.1f
@@ -65,19 +67,23 @@ Collision model
 ===============================================================================
 */
 
+// per trace state of a vertex or edge, parallel traces keep their own copies in cm_model_t::traceCaches
+typedef struct cm_traceCache_s {
+	int						checkcount;			// for multi-check avoidance
+	unsigned int			side;				// vertex: each bit tells at which side this vertex passes one of the trace model edges
+												// edge: each bit tells at which side of this edge one of the trace model vertices passes
+	unsigned int			sideSet;			// each bit tells if sidedness for the trace model edge or vertex has been calculated yet
+} cm_traceCache_t;
+
 typedef struct cm_vertex_s {
 	idVec3					p;					// vertex point
-	int						checkcount;			// for multi-check avoidance
-    unsigned int			side;				// each bit tells at which side this vertex passes one of the trace model edges
-    unsigned int			sideSet;			// each bit tells if sidedness for the trace model edge has been calculated yet
+	cm_traceCache_t			cache;				// multi-check avoidance and sidedness
 } cm_vertex_t;
 
 typedef struct cm_edge_s {
-	int						checkcount;			// for multi-check avoidance
+	cm_traceCache_t			cache;				// multi-check avoidance and sidedness
 	unsigned short			internal;			// a trace model can never collide with internal edges
 	unsigned short			numUsers;			// number of polygons using this edge
-    unsigned int			side;				// each bit tells at which side of this edge one of the trace model vertices passes
-    unsigned int			sideSet;			// each bit tells if sidedness for the trace model vertex has been calculated yet
 	int						vertexNum[2];		// start and end point of edge
 	idVec3					normal;				// edge normal
 } cm_edge_t;
@@ -178,8 +184,17 @@ typedef struct cm_model_s {
 	int						numRemovedPolys;
 	int						numMergedPolys;
 	int						usedMemory;
+	// vertex caches followed by edge caches for each parallel trace slot, allocated on first use
+	cm_traceCache_t *		traceCaches[CM_MAX_TRACE_SLOTS];
 } cm_model_t;
 
+// trace model converted to a collision model, see SetupTrmModel
+typedef struct cm_trmModel_s {
+	cm_model_t *			model;
+	cm_polygonRef_t *		polygons[MAX_TRACEMODEL_POLYS];
+	cm_brushRef_t *			brushes[1];
+} cm_trmModel_t;
+
 /*
 ===============================================================================
 
@@ -226,6 +241,9 @@ typedef struct cm_traceWork_s {
 	int numPolys;
 	cm_trmPolygon_t polys[MAX_TRACEMODEL_POLYS];	// trm polygons
 	cm_model_t *model;								// model colliding with
+	int checkCount;									// unique for every trace, for multi-check avoidance
+	cm_traceCache_t *vertexCache;					// per thread vertex and edge caches of the model during parallel traces,
+	cm_traceCache_t *edgeCache;						// NULL if the caches of the model itself are used
 	idVec3 start;									// start of trace
 	idVec3 end;										// end of trace
 	idVec3 dir;										// trace direction
@@ -264,6 +282,14 @@ typedef struct cm_traceWork_s {
 	idVec3 polygonRotationOriginCache[CM_MAX_POLYGON_EDGES];
 } cm_traceWork_t;
 
+ID_INLINE cm_traceCache_t *CM_VertexCache( const cm_traceWork_t *tw, cm_vertex_t *v ) {
+	return tw->vertexCache ? tw->vertexCache + ( v - tw->model->vertices ) : &v->cache;
+}
+
+ID_INLINE cm_traceCache_t *CM_EdgeCache( const cm_traceWork_t *tw, cm_edge_t *e ) {
+	return tw->edgeCache ? tw->edgeCache + ( e - tw->model->edges ) : &e->cache;
+}
+
 /*
 ===============================================================================
 
@@ -277,6 +303,14 @@ typedef struct cm_procNode_s {
 	int children[2];				// negative numbers are (-1 - areaNumber), 0 = solid
 } cm_procNode_t;
 
+// the binary .cmb file read into memory, see LoadBinaryCollisionModelFile
+typedef struct cm_binaryReader_s {
+	const byte *	data;
+	int				length;
+	int				offset;
+	bool			error;			// set when reading past the end or invalid data
+} cm_binaryReader_t;
+
 class idCollisionModelManagerLocal : public idCollisionModelManager {
 public:
 	// load collision models from a map file
@@ -331,6 +365,10 @@ public:
 	void			ListModels( void );
 	// write a collision model file for the map entity
 	bool			WriteCollisionModelForMapEntity( const idMapEntity *mapEnt, const char *filename, const bool testTraceModel = true );
+	// allow traces from several threads at once
+	void			BeginParallelTraces( void );
+	void			EndParallelTraces( void );
+	bool			CanTraceInParallel( void );
 
 private:			// CollisionMap_translate.cpp
 	int				TranslateEdgeThroughEdge( idVec3 &cross, idPluecker &l1, idPluecker &l2, float *fraction );
@@ -383,11 +421,14 @@ private:			// CollisionMap_trace.cpp
 	void			TraceTrmThroughNode( cm_traceWork_t *tw, cm_node_t *node );
 	void			TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, cm_node_t *node, float p1f, float p2f, idVec3 &p1, idVec3 &p2);
 	void			TraceThroughModel( cm_traceWork_t *tw );
+	cm_trmModel_t *	SlotTrmModel( void );
+	cm_model_t *	ModelForTrace( cmHandle_t model );
+	void			SetupTraceCaches( cm_traceWork_t *tw );
 	void			RecurseProcBSP_r( trace_t *results, int parentNodeNum, int nodeNum, float p1f, float p2f, const idVec3 &p1, const idVec3 &p2 );
 
 private:			// CollisionMap_load.cpp
 	void			Clear( void );
-	void			FreeTrmModelStructure( void );
+	void			FreeTrmModelStructure( cm_trmModel_t &trmModel );
 					// model deallocation
 	void			RemovePolygonReferences_r( cm_node_t *node, cm_polygon_t *p );
 	void			RemoveBrushReferences_r( cm_node_t *node, cm_brush_t *b );
@@ -427,7 +468,8 @@ private:			// CollisionMap_load.cpp
 	cm_brush_t *	AllocBrush( cm_model_t *model, int numPlanes );
 	void			AddPolygonToNode( cm_model_t *model, cm_node_t *node, cm_polygon_t *p );
 	void			AddBrushToNode( cm_model_t *model, cm_node_t *node, cm_brush_t *b );
-	void			SetupTrmModelStructure( void );
+	void			SetupTrmModelStructure( cm_trmModel_t &trmModel );
+	void			SetupTrmModel( cm_trmModel_t &trmModel, const idTraceModel &trm, const idMaterial *material );
 	void			R_FilterPolygonIntoTree( cm_model_t *model, cm_node_t *node, cm_polygonRef_t *pref, cm_polygon_t *p );
 	void			R_FilterBrushIntoTree( cm_model_t *model, cm_node_t *node, cm_brushRef_t *pref, cm_brush_t *b );
 	cm_node_t *		R_CreateAxialBSPTree( cm_model_t *model, cm_node_t *node, const idBounds &bounds );
@@ -476,6 +518,11 @@ private:			// CollisionMap_files.cpp
 	void			ParseBrushes( idLexer *src, cm_model_t *model );
 	bool			ParseCollisionModel( idLexer *src );
 	bool			LoadCollisionModelFile( const char *name, const unsigned int mapFileCRC );
+					// binary copy of the collision model file
+	void			WriteBinaryCollisionModel( idFile *fp, cm_model_t *model );
+	void			WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC, int cmLength, unsigned int cmChecksum );
+	cm_model_t *	ReadBinaryCollisionModel( cm_binaryReader_t &src );
+	bool			LoadBinaryCollisionModelFile( const char *filename, unsigned int mapFileCRC, int cmLength, unsigned int cmChecksum );
 	const idStr			GetSkinnedName	( const char *fileName, const idDeclSkin* skin ) const;		// #4232 SteveL
 	const idMaterial*	GetSkinnedShader( const idMaterial* shader, const idDeclSkin* skin ) const;	// #4232 SteveL
 
@@ -492,17 +539,20 @@ private:			// collision map data
 	idStr			mapName;
 	ID_TIME_T			mapFileTime;
 	int				loaded;
-					// for multi-check avoidance
-	int				checkCount;
+					// for multi-check avoidance, incremented for every trace
+	std::atomic<int>checkCount;
 					// models
 	int				maxModels;
 	int				numModels;
 	cm_model_t **	models;
 	idHashIndex		modelsHash;
 					// polygons and brush for trm model
-	cm_polygonRef_t*trmPolygons[MAX_TRACEMODEL_POLYS];
-	cm_brushRef_t *	trmBrushes[1];
+	cm_trmModel_t	trmModel;
 	const idMaterial *trmMaterial;
+					// set between BeginParallelTraces and EndParallelTraces
+	bool			parallelTraces;
+					// trm model of each thread running parallel traces
+	cm_trmModel_t *	slotTrmModels[CM_MAX_TRACE_SLOTS];
 					// for data pruning
 	int				numProcNodes;
 	cm_procNode_t *	procNodes;
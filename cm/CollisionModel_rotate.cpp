@@ -495,7 +495,7 @@ void idCollisionModelManagerLocal::RotateTrmEdgeThroughPolygon( cm_traceWork_t *
 		edge = tw->model->edges + abs(edgeNum);
 
 		// if this edge is already checked
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		if ( CM_EdgeCache( tw, edge )->checkcount == tw->checkCount ) {
 			continue;
 		}
 
@@ -1009,10 +1009,10 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 	idVec3 *rotationOrigin;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( p->checkcount == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	p->checkcount = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -1108,11 +1108,12 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
 
-			if ( e->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			cm_traceCache_t *ec = CM_EdgeCache( tw, e );
+			if ( ec->checkcount == tw->checkCount ) {
 				continue;
 			}
 			// set edge check count
-			e->checkcount = idCollisionModelManagerLocal::checkCount;
+			ec->checkcount = tw->checkCount;
 			// can never collide with internal edges
 			if ( e->internal ) {
 				continue;
@@ -1122,12 +1123,13 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 
 				v = tw->model->vertices + e->vertexNum[k ^ INTSIGNBITSET(edgeNum)];
 
+				cm_traceCache_t *vc = CM_VertexCache( tw, v );
 				// if this vertex is already checked
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( vc->checkcount == tw->checkCount ) {
 					continue;
 				}
 				// set vertex check count
-				v->checkcount = idCollisionModelManagerLocal::checkCount;
+				vc->checkcount = tw->checkCount;
 
 				// if the vertex is outside the trm rotation bounds
 				if ( !tw->bounds.ContainsPoint( v->p ) ) {
@@ -1222,7 +1224,7 @@ void idCollisionModelManagerLocal::Rotation180( trace_t *results, const idVec3 &
 		return;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	tw.checkCount = ++idCollisionModelManagerLocal::checkCount;
 
 	memset(&tw.trace, 0, sizeof(tw.trace));
 	tw.trace.fraction = 1.0f;
@@ -1237,7 +1239,8 @@ void idCollisionModelManagerLocal::Rotation180( trace_t *results, const idVec3 &
 	tw.angle = endAngle - startAngle;
 	assert( tw.angle > -180.0f && tw.angle < 180.0f );
 	tw.maxTan = initialTan = idMath::Fabs( tan( ( idMath::PI / 360.0f ) * tw.angle ) );
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::ModelForTrace( model );
+	idCollisionModelManagerLocal::SetupTraceCaches( &tw );
 	tw.start = start - modelOrigin;
 	// rotation axis, axis is assumed to be normalized
 	tw.axis = axis;
@@ -243,3 +243,140 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, tw->end );
 	}
 }
+
+/*
+===============================================================================
+
+Parallel traces
+
+===============================================================================
+*/
+
+static_assert( CM_MAX_TRACE_SLOTS <= 64, "trace slots are tracked in a 64 bit mask" );
+
+static std::atomic<uint64> cmUsedTraceSlots( 0 );
+
+// gives the slot back when the thread exits, job threads are restarted whenever jobs_numThreads changes
+struct cmThreadTraceSlot_t {
+	int slot = -1;
+	~cmThreadTraceSlot_t() {
+		if ( slot >= 0 ) {
+			cmUsedTraceSlots.fetch_and( ~( (uint64)1 << slot ) );
+		}
+	}
+};
+
+static thread_local cmThreadTraceSlot_t cmTraceSlot;
+
+/*
+================
+CM_TraceSlot
+
+  returns -1 if all slots are taken by other threads
+================
+*/
+static int CM_TraceSlot( void ) {
+	if ( cmTraceSlot.slot < 0 ) {
+		uint64 used = cmUsedTraceSlots.load();
+		int slot;
+		do {
+			for ( slot = 0; slot < CM_MAX_TRACE_SLOTS; slot++ ) {
+				if ( !( used & ( (uint64)1 << slot ) ) ) {
+					break;
+				}
+			}
+			if ( slot >= CM_MAX_TRACE_SLOTS ) {
+				return -1;
+			}
+		} while ( !cmUsedTraceSlots.compare_exchange_weak( used, used | ( (uint64)1 << slot ) ) );
+		cmTraceSlot.slot = slot;
+	}
+	return cmTraceSlot.slot;
+}
+
+/*
+================
+idCollisionModelManagerLocal::CanTraceInParallel
+================
+*/
+bool idCollisionModelManagerLocal::CanTraceInParallel( void ) {
+	return !parallelTraces || CM_TraceSlot() >= 0;
+}
+
+/*
+================
+idCollisionModelManagerLocal::SlotTrmModel
+================
+*/
+cm_trmModel_t *idCollisionModelManagerLocal::SlotTrmModel( void ) {
+	int slot = CM_TraceSlot();
+	assert( slot >= 0 );	// the caller didn't check CanTraceInParallel
+	// only ever touched by the thread owning the slot
+	if ( !slotTrmModels[slot] ) {
+		slotTrmModels[slot] = new cm_trmModel_t;
+		SetupTrmModelStructure( *slotTrmModels[slot] );
+	}
+	return slotTrmModels[slot];
+}
+
+/*
+================
+idCollisionModelManagerLocal::ModelForTrace
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::ModelForTrace( cmHandle_t model ) {
+	if ( model == TRACE_MODEL_HANDLE && parallelTraces ) {
+		return SlotTrmModel()->model;
+	}
+	return models[model];
+}
+
+/*
+================
+idCollisionModelManagerLocal::SetupTraceCaches
+
+  during parallel traces the vertex and edge caches of shared models are per thread
+================
+*/
+void idCollisionModelManagerLocal::SetupTraceCaches( cm_traceWork_t *tw ) {
+	tw->vertexCache = NULL;
+	tw->edgeCache = NULL;
+
+	if ( !parallelTraces ) {
+		return;
+	}
+	int slot = CM_TraceSlot();
+	assert( slot >= 0 );
+	cm_model_t *model = tw->model;
+	// private trace model of this thread
+	if ( slotTrmModels[slot] && model == slotTrmModels[slot]->model ) {
+		return;
+	}
+	cm_traceCache_t *cache = model->traceCaches[slot];
+	if ( !cache ) {
+		cache = (cm_traceCache_t *) Mem_ClearedAlloc( ( model->numVertices + model->numEdges + 1 ) * sizeof( cm_traceCache_t ) );
+		model->traceCaches[slot] = cache;
+	}
+	tw->vertexCache = cache;
+	tw->edgeCache = cache + model->numVertices;
+}
+
+/*
+================
+idCollisionModelManagerLocal::BeginParallelTraces
+================
+*/
+void idCollisionModelManagerLocal::BeginParallelTraces( void ) {
+	assert( !parallelTraces );
+	parallelTraces = true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::EndParallelTraces
+================
+*/
+void idCollisionModelManagerLocal::EndParallelTraces( void ) {
+	assert( parallelTraces );
+	parallelTraces = false;
+}
@@ -189,7 +189,7 @@ CM_SetVertexSidedness
   stores for the given model vertex at which side of one of the trm edges it passes
 ================
 */
-ID_INLINE void CM_SetVertexSidedness( cm_vertex_t *v, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
+ID_INLINE void CM_SetVertexSidedness( cm_traceCache_t *v, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
 	if ( !(v->sideSet & (1<<bitNum)) ) {
 		float fl;
 		fl = vpl.PermutedInnerProduct( epl );
@@ -205,7 +205,7 @@ CM_SetEdgeSidedness
   stores for the given model edge at which side one of the trm vertices
 ================
 */
-ID_INLINE void CM_SetEdgeSidedness( cm_edge_t *edge, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
+ID_INLINE void CM_SetEdgeSidedness( cm_traceCache_t *edge, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
 	if ( !(edge->sideSet & (1<<bitNum)) ) {
 		float fl;
 		fl = vpl.PermutedInnerProduct( epl );
@@ -224,15 +224,16 @@ void idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon( cm_traceWork_
 	float f1, f2, dist, d1, d2;
 	idVec3 start, end, normal;
 	cm_edge_t *edge;
-	cm_vertex_t *v1, *v2;
+	cm_traceCache_t *edgeCache, *v1, *v2;
 	idPluecker *pl, epsPl;
 
 	// check edges for a collision
 	for ( i = 0; i < poly->numEdges; i++) {
 		edgeNum = poly->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		edgeCache = CM_EdgeCache( tw, edge );
 		// if this edge is already checked
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		if ( edgeCache->checkcount == tw->checkCount ) {
 			continue;
 		}
 		// can never collide with internal edges
@@ -241,16 +242,16 @@ void idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon( cm_traceWork_
 		}
 		pl = &tw->polygonEdgePlueckerCache[i];
 		// get the sides at which the trm edge vertices pass the polygon edge
-		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[0]].pl, trmEdge->vertexNum[0] );
-		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[1]].pl, trmEdge->vertexNum[1] );
+		CM_SetEdgeSidedness( edgeCache, *pl, tw->vertices[trmEdge->vertexNum[0]].pl, trmEdge->vertexNum[0] );
+		CM_SetEdgeSidedness( edgeCache, *pl, tw->vertices[trmEdge->vertexNum[1]].pl, trmEdge->vertexNum[1] );
 		// if the trm edge start and end vertex do not pass the polygon edge at different sides
-		if ( !(((edge->side >> trmEdge->vertexNum[0]) ^ (edge->side >> trmEdge->vertexNum[1])) & 1) ) {
+		if ( !(((edgeCache->side >> trmEdge->vertexNum[0]) ^ (edgeCache->side >> trmEdge->vertexNum[1])) & 1) ) {
 			continue;
 		}
 		// get the sides at which the polygon edge vertices pass the trm edge
-		v1 = tw->model->vertices + edge->vertexNum[INTSIGNBITSET(edgeNum)];
+		v1 = CM_VertexCache( tw, tw->model->vertices + edge->vertexNum[INTSIGNBITSET(edgeNum)] );
 		CM_SetVertexSidedness( v1, tw->polygonVertexPlueckerCache[i], trmEdge->pl, trmEdge->bitNum );
-		v2 = tw->model->vertices + edge->vertexNum[INTSIGNBITNOTSET(edgeNum)];
+		v2 = CM_VertexCache( tw, tw->model->vertices + edge->vertexNum[INTSIGNBITNOTSET(edgeNum)] );
 		CM_SetVertexSidedness( v2, tw->polygonVertexPlueckerCache[i+1], trmEdge->pl, trmEdge->bitNum );
 		// if the polygon edge start and end vertex do not pass the trm edge at different sides
 		if ( !((v1->side ^ v2->side) & (1<<trmEdge->bitNum)) ) {
@@ -400,14 +401,14 @@ idCollisionModelManagerLocal::TranslateTrmVertexThroughPolygon
 void idCollisionModelManagerLocal::TranslateTrmVertexThroughPolygon( cm_traceWork_t *tw, cm_polygon_t *poly, cm_trmVertex_t *v, int bitNum ) {
 	int i, edgeNum;
 	float f;
-	cm_edge_t *edge;
+	cm_traceCache_t *edge;
 
 	f = CM_TranslationPlaneFraction( poly->plane, v->p, v->endp );
 	if ( f < tw->trace.fraction ) {
 
 		for ( i = 0; i < poly->numEdges; i++ ) {
 			edgeNum = poly->edges[i];
-			edge = tw->model->edges + abs(edgeNum);
+			edge = CM_EdgeCache( tw, tw->model->edges + abs(edgeNum) );
 			CM_SetEdgeSidedness( edge, tw->polygonEdgePlueckerCache[i], v->pl, bitNum );
 			if ( INTSIGNBITSET(edgeNum) ^ ((edge->side >> bitNum) & 1) ) {
 				return;
@@ -444,6 +445,7 @@ void idCollisionModelManagerLocal::TranslatePointThroughPolygon( cm_traceWork_t
 	int i, edgeNum;
 	float f;
 	cm_edge_t *edge;
+	cm_traceCache_t *edgeCache;
 	idPluecker pl;
 
 	f = CM_TranslationPlaneFraction( poly->plane, v->p, v->endp );
@@ -452,17 +454,18 @@ void idCollisionModelManagerLocal::TranslatePointThroughPolygon( cm_traceWork_t
 		for ( i = 0; i < poly->numEdges; i++ ) {
 			edgeNum = poly->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
+			edgeCache = CM_EdgeCache( tw, edge );
 			// if we didn't yet calculate the sidedness for this edge
-			if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
+			if ( edgeCache->checkcount != tw->checkCount ) {
 				float fl;
-				edge->checkcount = idCollisionModelManagerLocal::checkCount;
+				edgeCache->checkcount = tw->checkCount;
 				pl.FromLine(tw->model->vertices[edge->vertexNum[0]].p, tw->model->vertices[edge->vertexNum[1]].p);
 				fl = v->pl.PermutedInnerProduct( pl );
-				edge->side = FLOATSIGNBITSET(fl);
+				edgeCache->side = FLOATSIGNBITSET(fl);
 			}
 			// if the point passes the edge at the wrong side
 			//if ( (edgeNum > 0) == edge->side ) {
-			if ( INTSIGNBITSET(edgeNum) ^ edge->side ) {
+			if ( INTSIGNBITSET(edgeNum) ^ edgeCache->side ) {
 				return;
 			}
 		}
@@ -501,12 +504,13 @@ void idCollisionModelManagerLocal::TranslateVertexThroughTrmPolygon( cm_traceWor
 	f = CM_TranslationPlaneFraction( trmpoly->plane, v->p, endp );
 	if ( f < tw->trace.fraction ) {
 
+		cm_traceCache_t *vertexCache = CM_VertexCache( tw, v );
 		for ( i = 0; i < trmpoly->numEdges; i++ ) {
 			edgeNum = trmpoly->edges[i];
 			edge = tw->edges + abs(edgeNum);
 
-			CM_SetVertexSidedness( v, pl, edge->pl, edge->bitNum );
-			if ( INTSIGNBITSET(edgeNum) ^ ((v->side >> edge->bitNum) & 1) ) {
+			CM_SetVertexSidedness( vertexCache, pl, edge->pl, edge->bitNum );
+			if ( INTSIGNBITSET(edgeNum) ^ ((vertexCache->side >> edge->bitNum) & 1) ) {
 				return;
 			}
 		}
@@ -547,12 +551,13 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 	cm_trmPolygon_t *bp;
 	cm_vertex_t *v;
 	cm_edge_t *e;
+	cm_traceCache_t *vc, *ec;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( p->checkcount == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	p->checkcount = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -605,18 +610,20 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 		for ( i = 0; i < p->numEdges; i++ ) {
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
+			ec = CM_EdgeCache( tw, e );
 			// reset sidedness cache if this is the first time we encounter this edge during this trace
-			if ( e->checkcount != idCollisionModelManagerLocal::checkCount ) {
-				e->sideSet = 0;
+			if ( ec->checkcount != tw->checkCount ) {
+				ec->sideSet = 0;
 			}
 			// pluecker coordinate for edge
 			tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[e->vertexNum[0]].p,
 														tw->model->vertices[e->vertexNum[1]].p );
 
 			v = &tw->model->vertices[e->vertexNum[INTSIGNBITSET(edgeNum)]];
+			vc = CM_VertexCache( tw, v );
 			// reset sidedness cache if this is the first time we encounter this vertex during this trace
-			if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-				v->sideSet = 0;
+			if ( vc->checkcount != tw->checkCount ) {
+				vc->sideSet = 0;
 			}
 			// pluecker coordinate for vertex movement vector
 			tw->polygonVertexPlueckerCache[i].FromRay( v->p, -tw->dir );
@@ -644,12 +651,13 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 		for ( i = 0; i < p->numEdges; i++ ) {
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
+			ec = CM_EdgeCache( tw, e );
 
-			if ( e->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( ec->checkcount == tw->checkCount ) {
 				continue;
 			}
 			// set edge check count
-			e->checkcount = idCollisionModelManagerLocal::checkCount;
+			ec->checkcount = tw->checkCount;
 			// can never collide with internal edges
 			if ( e->internal ) {
 				continue;
@@ -658,12 +666,13 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 			for ( k = 0; k < 2; k++ ) {
 
 				v = tw->model->vertices + e->vertexNum[k ^ INTSIGNBITSET(edgeNum)];
+				vc = CM_VertexCache( tw, v );
 				// if this vertex is already checked
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( vc->checkcount == tw->checkCount ) {
 					continue;
 				}
 				// set vertex check count
-				v->checkcount = idCollisionModelManagerLocal::checkCount;
+				vc->checkcount = tw->checkCount;
 
 				// if the vertex is outside the trace bounds
 				if ( !tw->bounds.ContainsPoint( v->p ) ) {
@@ -799,7 +808,7 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 		return;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	tw.checkCount = ++idCollisionModelManagerLocal::checkCount;
 
 	memset(&tw.trace, 0, sizeof(tw.trace));
 	tw.trace.fraction = 1.0f;
@@ -814,7 +823,8 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 	tw.contacts = idCollisionModelManagerLocal::contacts;
 	tw.maxContacts = idCollisionModelManagerLocal::maxContacts;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::ModelForTrace( model );
+	idCollisionModelManagerLocal::SetupTraceCaches( &tw );
 	tw.start = start - modelOrigin;
 	tw.end = end - modelOrigin;
 	tw.dir = end - start;
@@ -877,7 +887,9 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 			results->c.point += modelOrigin;
 			results->c.dist += modelOrigin * results->c.normal;
 		}
-		idCollisionModelManagerLocal::numContacts = tw.numContacts;
+		if ( tw.getContacts ) {
+			idCollisionModelManagerLocal::numContacts = tw.numContacts;
+		}
 		return;
 	}
 
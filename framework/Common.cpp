@@ -131,6 +131,9 @@ int				time_backend;			// renderSystem backend time
 int				time_frontendLast;
 int				time_backendLast;
 
+frameTimings_t		com_frameTimings;
+std::atomic<int>	com_soundTimeMicro;
+
 int				com_frameTime;			// time moment of the current frame in milliseconds
 int				com_frameDelta;			// time elapsed since previous frame in milliseconds
 int				com_frameNumber;		// variable frame number
@@ -2402,6 +2405,7 @@ void idCommonLocal::InitCommands( void ) {
 #endif
 
 	cmdSystem->AddCommand( "printMemInfo", PrintMemInfo_f, CMD_FL_SYSTEM, "prints memory debugging data" );
+	cmdSystem->AddCommand( "timelineDump", Timeline_Dump_f, CMD_FL_SYSTEM, "writes the job and scope timeline recorded with com_timeline as Chrome trace JSON, usage: timelineDump [file] [numFrames]" );
 
 	// idLib commands
 	cmdSystem->AddCommand( "memoryDump", Mem_Dump_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "creates a memory dump" );
@@ -2479,6 +2483,10 @@ idCommonLocal::Frame
 */
 void idCommonLocal::Frame( void ) {
 	try {
+		uint64 frameStart = Sys_Microseconds();
+
+		// phases which do not run this frame must not report the time of an earlier one
+		memset( &com_frameTimings, 0, sizeof( com_frameTimings ) );
 
 		// pump all the events
 		Sys_GenerateEvents();
@@ -2496,6 +2504,8 @@ void idCommonLocal::Frame( void ) {
 
 		eventLoop->RunEventLoop();
 
+		com_frameTimings.events = (int)( Sys_Microseconds() - frameStart );
+
 		static int64_t com_frameTimeMicro = 0;		//same as com_frameTime, but in microseconds
 		static int64_t lastFrameAstroTime = Sys_Microseconds();
 		if (sessLocal.com_fixedTic.GetBool()) {
@@ -2547,6 +2557,10 @@ void idCommonLocal::Frame( void ) {
 			time_gameDraw = 0;
 		}	
 
+		com_frameTimings.sound = com_soundTimeMicro.exchange( 0 );
+		com_frameTimings.frame = (int)( Sys_Microseconds() - frameStart );
+		Auto_BenchmarkFrame();
+
 		com_frameNumber++;
 
 		// set idLib frame number for frame based memory dumps
@@ -2618,6 +2632,7 @@ void idCommonLocal::SingleAsyncTic( void ) {
 		usercmdGen->UsercmdInterrupt();
 	}
 
+	uint64 soundStart = Sys_Microseconds();
 	switch ( com_asyncSound.GetInteger() ) {
 		case 1:
 			soundSystem->AsyncUpdate( stat->milliseconds );
@@ -2626,6 +2641,7 @@ void idCommonLocal::SingleAsyncTic( void ) {
 			soundSystem->AsyncUpdateWrite( stat->milliseconds );
 			break;
 	}
+	com_soundTimeMicro += (int)( Sys_Microseconds() - soundStart );
 
 	// we update com_ticNumber after all the background tasks
 	// have completed their work for this tic
@@ -2833,6 +2849,7 @@ void idCommonLocal::Init( int argc, const char **argv, const char *cmdline )
 
 		// potentially start trace profiler if requested
 		InitTracing();
+		TimelineSetThreadName( "Main" );
 
 		// start file logging right away, before early console or whatever
 		StartupVariable( "win_outputDebugString", false );
@@ -74,6 +74,18 @@ extern int			time_frontendLast;		// renderer frontend time
 extern int			time_backend;			// renderer backend time
 extern int			time_backendLast;		// renderer backend time
 
+// CPU time of the phases of the last frame in microseconds, collected for the benchmark command
+typedef struct {
+	int				frame;					// whole frame on the main thread
+	int				events;					// system events and console commands
+	int				gameTic;				// all game tics run during the frame
+	int				frontend;				// game draw and renderer frontend
+	int				sound;					// sound system updates since the previous frame
+} frameTimings_t;
+
+extern frameTimings_t	com_frameTimings;
+extern std::atomic<int>	com_soundTimeMicro;	// accumulated by sound updates on any thread
+
 extern int			com_frameTime;			// time moment of the current frame in milliseconds
 extern int			com_frameDelta;			// time elapsed since previous frame in milliseconds
 extern std::atomic<int>	com_ticNumber;		// 60 hz tics, incremented by async function
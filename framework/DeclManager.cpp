@@ -69,6 +69,49 @@ public:
 	declType_t					defaultType;
 };
 
+/*
+Decl index cache
+
+The boundaries of all decls found in the loaded decl files are written to
+DECL_INDEX_FILENAME on shutdown. On the next start the cache is mapped and
+files with unchanged size, timestamp and checksum register their decls from
+it instead of running the lexer over the whole text.
+
+Each file record is followed by its name and its entries, each entry by the
+decl name. Names are null terminated and padded to 4 bytes, records to 8.
+*/
+
+static const char *	DECL_INDEX_FILENAME		= "declindex.dat";
+static const int	DECL_INDEX_MAGIC		= ( 'D' << 24 ) | ( 'I' << 16 ) | ( 'D' << 8 ) | 'X';
+static const int	DECL_INDEX_VERSION		= 1;
+
+struct declIndexHeader_t {
+	int							magic;
+	int							version;
+	int							numRecords;
+	int							pad;
+};
+
+struct declIndexRecord_t {
+	int64						timestamp;
+	int							recordSize;				// including the file name and all entries
+	int							typesChecksum;			// decl types registered when the file was scanned
+	int							fileSize;
+	int							checksum;
+	int							numLines;
+	int							numEntries;
+	int							nameLength;
+	int							pad;
+};
+
+struct declIndexEntry_t {
+	int							type;
+	int							offset;
+	int							length;
+	int							line;
+	int							nameLength;
+};
+
 class idDeclFile;
 
 class idDeclLocal : public idDeclBase {
@@ -111,7 +154,8 @@ protected:
 
 								// Parses the decl definition.
 								// After calling parse, a decl will be guaranteed usable.
-	void						ParseLocal( void );
+								// preparedText is the decompressed text, if it is already available.
+	void						ParseLocal( const char *preparedText = NULL );
 
 								// Does a MakeDefualt, but flags the decl so that it
 								// will Parse() the next time the decl is found.
@@ -150,7 +194,11 @@ public:
 								idDeclFile( const char *fileName, declType_t defaultType );
 
 	void						Reload( bool force );
-	int							LoadAndParse();
+	int							LoadAndParse( filePrefetch_t *prefetch = NULL, int prefetchIndex = 0 );
+
+private:
+	void						AddDecl( idLexer *src, declType_t type, const char *name, const char *buffer, int offset, int length, int line );
+	void						StoreIndexRecord( const idList<byte> &record );
 
 public:
 	idStr						fileName;
@@ -163,6 +211,7 @@ public:
 	bool						hasReloadedSubtitles;
 
 	idDeclLocal *				decls;
+	idList<byte>				indexRecords;			// one decl index record per set of registered decl types
 };
 
 class idDeclManagerLocal : public idDeclManager {
@@ -192,6 +241,7 @@ public:
 	virtual const idDecl *		DeclByIndex( declType_t type, int index, bool forceParse = true );
 
 	virtual const idDecl*		FindDeclWithoutParsing( declType_t type, const char *name, bool makeDefault = true );
+	virtual void				ParseDecls( declType_t type, const idStrList &names );
 	virtual void				ReloadFile( const char* filename, bool force );
 
 	virtual void				ListType( const idCmdArgs &args, declType_t type );
@@ -221,6 +271,10 @@ public:
 	const idDeclFile *			GetImplicitDeclFile( void ) const { return &implicitDecls; }
 	idList<idDeclFile*> &		GetLoadedFiles() { return loadedFiles; }
 
+	int							GetDeclTypesChecksum( void ) const;
+	const declIndexRecord_t *	FindDeclIndex( const char *fileName, int typesChecksum );
+	void						DeclIndexChanged( void ) { declIndexChanged = true; }
+
 private:
 	idList<idDeclType *>		declTypes;
 	idList<idDeclFolder *>		declFolders;
@@ -236,15 +290,30 @@ private:
 	bool						insideLevelLoad;
 	LoadStack					loadStack;
 
+	bool						declIndexLoaded;
+	bool						declIndexChanged;
+	const byte *				declIndexData;			// mapped decl index cache of the last run
+	size_t						declIndexLength;
+	idList<const declIndexRecord_t *> declIndexRecords;
+	idHashIndex					declIndexHash;
+
 	static idCVar				decl_show;
+	static idCVar				decl_indexCache;
+	static idCVar				decl_parseMapDecls;
 
 private:
+	void						LoadDeclIndex( void );
+	void						WriteDeclIndex( void );
+	void						FreeDeclIndex( void );
+
 	static void					ListDecls_f( const idCmdArgs &args );
 	static void					ReloadDecls_f( const idCmdArgs &args );
 	static void					TouchDecl_f( const idCmdArgs &args );
 };
 
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar idDeclManagerLocal::decl_parseMapDecls( "decl_parseMapDecls", "1", CVAR_SYSTEM | CVAR_BOOL, "parse all decls referenced by a map during level load instead of on their first use" );
+idCVar idDeclManagerLocal::decl_indexCache( "decl_indexCache", "1", CVAR_SYSTEM | CVAR_BOOL, "cache the decl boundaries of all decl files in declindex.dat to skip scanning unchanged files on the next start" );
 
 idDeclManagerLocal	declManagerLocal;
 idDeclManager *		declManager = &declManagerLocal;
@@ -598,6 +667,119 @@ void idDeclFile::Reload( bool force ) {
 	LoadAndParse();
 }
 
+/*
+================
+AppendIndexData
+================
+*/
+static void AppendIndexData( idList<byte> &record, const void *data, int size ) {
+	int offset = record.Num();
+	if ( offset + size > record.NumAllocated() ) {
+		record.Reserve( idMath::Imax( offset + size, record.NumAllocated() * 2 ) );
+	}
+	record.SetNum( offset + size, false );
+	memcpy( record.Ptr() + offset, data, size );
+}
+
+/*
+================
+AppendIndexName
+================
+*/
+static void AppendIndexName( idList<byte> &record, const char *name, int length ) {
+	static const byte zeros[4] = { 0, 0, 0, 0 };
+	AppendIndexData( record, name, length );
+	AppendIndexData( record, zeros, 4 - ( length & 3 ) );
+}
+
+/*
+================
+IndexNameSize
+================
+*/
+static int IndexNameSize( int length ) {
+	return ( length + 4 ) & ~3;
+}
+
+/*
+================
+idDeclFile::AddDecl
+
+Registers a decl found at the given offset in the text of this file,
+src is NULL for decls registered from the decl index cache.
+================
+*/
+void idDeclFile::AddDecl( idLexer *src, declType_t type, const char *name, const char *buffer, int offset, int length, int line ) {
+	bool reparse;
+	idDeclLocal *newDecl;
+
+	// look it up, possibly getting a newly created default decl
+	reparse = false;
+	newDecl = declManagerLocal.FindTypeWithoutParsing( type, name, false );
+	if ( newDecl ) {
+		// update the existing copy
+		if ( newDecl->sourceFile != this || newDecl->redefinedInReload ) {
+			if ( src ) {
+				src->Warning( "%s '%s' previously defined at %s:%i", declManagerLocal.GetDeclNameFromType( type ),
+								name, newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
+			} else {
+				common->Warning( "file %s, line %d: %s '%s' previously defined at %s:%i", fileName.c_str(), line, declManagerLocal.GetDeclNameFromType( type ),
+								name, newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
+			}
+			return;
+		}
+		if ( newDecl->declState != DS_UNPARSED ) {
+			reparse = true;
+		}
+	} else {
+		// allow it to be created as a default, then add it to the per-file list
+		newDecl = declManagerLocal.FindTypeWithoutParsing( type, name, true );
+		newDecl->nextInFile = this->decls;
+		this->decls = newDecl;
+	}
+
+	newDecl->redefinedInReload = true;
+
+	if ( newDecl->textSource ) {
+		Mem_Free( newDecl->textSource );
+		newDecl->textSource = NULL;
+	}
+
+	newDecl->SetTextLocal( buffer + offset, length );
+	newDecl->sourceFile = this;
+	newDecl->sourceTextOffset = offset;
+	newDecl->sourceTextLength = length;
+	newDecl->sourceLine = line;
+	newDecl->declState = DS_UNPARSED;
+
+	// if it is currently in use, reparse it immedaitely
+	if ( reparse ) {
+		newDecl->ParseLocal();
+	}
+}
+
+/*
+================
+idDeclFile::StoreIndexRecord
+
+Replaces the index record scanned with the same decl types.
+================
+*/
+void idDeclFile::StoreIndexRecord( const idList<byte> &record ) {
+	const declIndexRecord_t *newRecord = (const declIndexRecord_t *)record.Ptr();
+
+	idList<byte> records;
+	for ( int offset = 0; offset < indexRecords.Num(); ) {
+		const declIndexRecord_t *old = (const declIndexRecord_t *)( indexRecords.Ptr() + offset );
+		if ( old->typesChecksum != newRecord->typesChecksum ) {
+			AppendIndexData( records, old, old->recordSize );
+		}
+		offset += old->recordSize;
+	}
+	AppendIndexData( records, record.Ptr(), record.Num() );
+	indexRecords.Swap( records );
+}
+
 /*
 ================
 idDeclFile::LoadAndParse
@@ -607,7 +789,7 @@ This is used during both the initial load, and any reloads
 */
 int c_savedMemory = 0;
 
-int idDeclFile::LoadAndParse() {
+int idDeclFile::LoadAndParse( filePrefetch_t *prefetch, int prefetchIndex ) {
 	int			i, numTypes;
 	idLexer		src;
 	idToken		token;
@@ -616,12 +798,14 @@ int idDeclFile::LoadAndParse() {
 	int			length, size;
 	int			sourceLine;
 	idStr		name;
-	idDeclLocal *newDecl;
-	bool		reparse;
 
 	// load the text
 	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
-	length = fileSystem->ReadFile( fileName, (void **)&buffer, &timestamp );
+	if ( prefetch ) {
+		length = fileSystem->GetPrefetchedFile( prefetch, prefetchIndex, (void **)&buffer, &timestamp );
+	} else {
+		length = fileSystem->ReadFile( fileName, (void **)&buffer, &timestamp );
+	}
 	if ( length == -1 ) {
 		common->FatalError( "couldn't load %s", fileName.c_str() );
 		return 0;
@@ -644,8 +828,33 @@ int idDeclFile::LoadAndParse() {
 
 	fileSize = length;
 
+	// an unchanged file registers its decls from the index cache of the last run
+	int typesChecksum = declManagerLocal.GetDeclTypesChecksum();
+	const declIndexRecord_t *index = declManagerLocal.FindDeclIndex( fileName, typesChecksum );
+	if ( index && ( index->timestamp != (int64)timestamp || index->fileSize != length || index->checksum != checksum ) ) {
+		index = NULL;
+	}
+
+	idList<byte> record;
+	declIndexRecord_t header;
+	memset( &header, 0, sizeof( header ) );
+
+	if ( index ) {
+		const byte *data = (const byte *)( index + 1 ) + IndexNameSize( index->nameLength );
+		for ( i = 0; i < index->numEntries; i++ ) {
+			const declIndexEntry_t *entry = (const declIndexEntry_t *)data;
+			const char *entryName = (const char *)( entry + 1 );
+			AddDecl( NULL, (declType_t)entry->type, entryName, buffer, entry->offset, entry->length, entry->line );
+			data = (const byte *)entryName + IndexNameSize( entry->nameLength );
+		}
+		AppendIndexData( record, index, index->recordSize );
+	} else {
+		AppendIndexData( record, &header, sizeof( header ) );
+		AppendIndexName( record, fileName.c_str(), fileName.Length() );
+	}
+
 	// scan through, identifying each individual declaration
-	while( 1 ) {
+	while( !index ) {
 
 		startMarker = src.GetFileOffset();
 		sourceLine = src.GetLineNum();
@@ -732,47 +941,39 @@ int idDeclFile::LoadAndParse() {
 		src.SkipBracedSection();
 		size = src.GetFileOffset() - startMarker;
 
-		// look it up, possibly getting a newly created default decl
-		reparse = false;
-		newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, false );
-		if ( newDecl ) {
-			// update the existing copy
-			if ( newDecl->sourceFile != this || newDecl->redefinedInReload ) {
-				src.Warning( "%s '%s' previously defined at %s:%i", declManagerLocal.GetDeclNameFromType( identifiedType ),
-								name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
-				continue;
-			}
-			if ( newDecl->declState != DS_UNPARSED ) {
-				reparse = true;
-			}
-		} else {
-			// allow it to be created as a default, then add it to the per-file list
-			newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, true );
-			newDecl->nextInFile = this->decls;
-			this->decls = newDecl;
-		}
-
-		newDecl->redefinedInReload = true;
+		declIndexEntry_t entry;
+		entry.type = identifiedType;
+		entry.offset = startMarker;
+		entry.length = size;
+		entry.line = sourceLine;
+		entry.nameLength = name.Length();
+		AppendIndexData( record, &entry, sizeof( entry ) );
+		AppendIndexName( record, name.c_str(), name.Length() );
+		header.numEntries++;
 
-		if ( newDecl->textSource ) {
-			Mem_Free( newDecl->textSource );
-			newDecl->textSource = NULL;
-		}
+		AddDecl( &src, identifiedType, name, buffer, startMarker, size, sourceLine );
+	}
 
-		newDecl->SetTextLocal( buffer + startMarker, size );
-		newDecl->sourceFile = this;
-		newDecl->sourceTextOffset = startMarker;
-		newDecl->sourceTextLength = size;
-		newDecl->sourceLine = sourceLine;
-		newDecl->declState = DS_UNPARSED;
+	if ( index ) {
+		numLines = index->numLines;
+	} else {
+		numLines = src.GetLineNum();
 
-		// if it is currently in use, reparse it immedaitely
-		if ( reparse ) {
-			newDecl->ParseLocal();
+		if ( record.Num() & 7 ) {
+			static const byte zeros[8] = { 0 };
+			AppendIndexData( record, zeros, 8 - ( record.Num() & 7 ) );
 		}
-	}
-
-	numLines = src.GetLineNum();
+		header.timestamp = timestamp;
+		header.recordSize = record.Num();
+		header.typesChecksum = typesChecksum;
+		header.fileSize = fileSize;
+		header.checksum = checksum;
+		header.numLines = numLines;
+		header.nameLength = fileName.Length();
+		memcpy( record.Ptr(), &header, sizeof( header ) );
+		declManagerLocal.DeclIndexChanged();
+	}
+	StoreIndexRecord( record );
 
 	Mem_Free( buffer );
 
@@ -812,6 +1013,11 @@ void idDeclManagerLocal::Init( void ) {
 
 	checksum = 0;
 
+	declIndexLoaded = false;
+	declIndexChanged = false;
+	declIndexData = NULL;
+	declIndexLength = 0;
+
 #ifdef USE_COMPRESSED_DECLS
 	SetupHuffman();
 #endif
@@ -880,6 +1086,8 @@ void idDeclManagerLocal::Shutdown( void ) {
 
 	loadStack.Clear();
 
+	WriteDeclIndex();
+
 	// free decls
 	for ( i = 0; i < DECL_MAX_TYPES; i++ ) {
 		for ( j = 0; j < linearLists[i].Num(); j++ ) {
@@ -1042,9 +1250,16 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 	// scan for decl files
 	fileList = fileSystem->ListFiles( declFolder->folder, declFolder->extension, true );
 
+	// the files are read on the job threads while they are parsed in order
+	idStrList fileNames;
+	for ( i = 0; i < fileList->GetNumFiles(); i++ ) {
+		fileNames.Append( declFolder->folder + "/" + fileList->GetFile( i ) );
+	}
+	filePrefetch_t *prefetch = fileSystem->PrefetchFiles( fileNames );
+
 	// load and parse decl files
 	for ( i = 0; i < fileList->GetNumFiles(); i++ ) {
-		fileName = declFolder->folder + "/" + fileList->GetFile( i );
+		fileName = fileNames[i];
 
 		// check whether this file has already been loaded
 		for ( j = 0; j < loadedFiles.Num(); j++ ) {
@@ -1058,12 +1273,179 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 			df = new idDeclFile( fileName, defaultType );
 			loadedFiles.Append( df );
 		}
-		df->LoadAndParse();
+		df->LoadAndParse( prefetch, i );
 	}
 
+	fileSystem->FreePrefetch( prefetch );
 	fileSystem->FreeFileList( fileList );
 }
 
+/*
+===================
+idDeclManagerLocal::GetDeclTypesChecksum
+
+Decl index records are only valid for the decl types they were scanned with.
+===================
+*/
+int idDeclManagerLocal::GetDeclTypesChecksum( void ) const {
+	idStr types;
+	for ( int i = 0; i < declTypes.Num(); i++ ) {
+		if ( declTypes[i] ) {
+			types += va( "%d %s;", i, declTypes[i]->typeName.c_str() );
+		}
+	}
+	return MD5_BlockChecksum( types.c_str(), types.Length() );
+}
+
+/*
+===================
+idDeclManagerLocal::LoadDeclIndex
+
+Maps the decl index cache and checks all its records, a damaged cache is ignored completely.
+===================
+*/
+void idDeclManagerLocal::LoadDeclIndex( void ) {
+	declIndexLoaded = true;
+
+	idStr osPath = fileSystem->RelativePathToOSPath( DECL_INDEX_FILENAME, "fs_modSavePath" );
+	declIndexData = Sys_MapFile( osPath, &declIndexLength );
+	if ( !declIndexData ) {
+		return;
+	}
+
+	const declIndexHeader_t *header = (const declIndexHeader_t *)declIndexData;
+	const byte *end = declIndexData + declIndexLength;
+	const byte *data = declIndexData + sizeof( declIndexHeader_t );
+	bool valid = declIndexLength >= sizeof( declIndexHeader_t ) && header->magic == DECL_INDEX_MAGIC && header->version == DECL_INDEX_VERSION;
+
+	for ( int i = 0; valid && i < header->numRecords; i++ ) {
+		const declIndexRecord_t *record = (const declIndexRecord_t *)data;
+		if ( end - data < (ptrdiff_t)sizeof( declIndexRecord_t ) || record->recordSize < (int)sizeof( declIndexRecord_t ) ||
+				( record->recordSize & 7 ) != 0 || record->recordSize > end - data ) {
+			valid = false;
+			break;
+		}
+		const byte *recordEnd = data + record->recordSize;
+		const char *fileName = (const char *)( record + 1 );
+		const byte *entries = (const byte *)fileName + IndexNameSize( record->nameLength );
+		if ( record->nameLength < 0 || entries > recordEnd || fileName[record->nameLength] != '\0' ) {
+			valid = false;
+			break;
+		}
+		for ( int j = 0; j < record->numEntries; j++ ) {
+			const declIndexEntry_t *entry = (const declIndexEntry_t *)entries;
+			const char *name = (const char *)( entry + 1 );
+			if ( recordEnd - entries < (ptrdiff_t)sizeof( declIndexEntry_t ) || entry->nameLength < 0 ||
+					recordEnd - (const byte *)name < IndexNameSize( entry->nameLength ) || name[entry->nameLength] != '\0' ||
+					entry->type < 0 || entry->type >= DECL_MAX_TYPES || entry->offset < 0 || entry->length < 0 ||
+					entry->offset > record->fileSize - entry->length ) {
+				valid = false;
+				break;
+			}
+			entries = (const byte *)name + IndexNameSize( entry->nameLength );
+		}
+		if ( !valid ) {
+			break;
+		}
+
+		declIndexHash.Add( declIndexHash.GenerateKey( fileName, false ) ^ record->typesChecksum, declIndexRecords.Append( record ) );
+		data = recordEnd;
+	}
+
+	if ( !valid ) {
+		common->Warning( "Ignoring damaged decl index cache %s", osPath.c_str() );
+		FreeDeclIndex();
+		declIndexLoaded = true;
+		return;
+	}
+
+	common->Printf( "Mapped decl index cache with %d files\n", declIndexRecords.Num() );
+}
+
+/*
+===================
+idDeclManagerLocal::FreeDeclIndex
+===================
+*/
+void idDeclManagerLocal::FreeDeclIndex( void ) {
+	if ( declIndexData ) {
+		Sys_UnmapFile( declIndexData, declIndexLength );
+	}
+	declIndexData = NULL;
+	declIndexLength = 0;
+	declIndexRecords.Clear();
+	declIndexHash.Clear();
+	declIndexLoaded = false;
+}
+
+/*
+===================
+idDeclManagerLocal::FindDeclIndex
+
+Returns the cached decl boundaries of a file from the last run, the caller
+still has to check that the file hasn't changed since then.
+===================
+*/
+const declIndexRecord_t *idDeclManagerLocal::FindDeclIndex( const char *fileName, int typesChecksum ) {
+	if ( !decl_indexCache.GetBool() ) {
+		return NULL;
+	}
+	if ( !declIndexLoaded ) {
+		LoadDeclIndex();
+	}
+
+	int key = declIndexHash.GenerateKey( fileName, false ) ^ typesChecksum;
+	for ( int i = declIndexHash.First( key ); i != -1; i = declIndexHash.Next( i ) ) {
+		const declIndexRecord_t *record = declIndexRecords[i];
+		if ( record->typesChecksum == typesChecksum && idStr::Icmp( (const char *)( record + 1 ), fileName ) == 0 ) {
+			return record;
+		}
+	}
+	return NULL;
+}
+
+/*
+===================
+idDeclManagerLocal::WriteDeclIndex
+
+Writes the index records of all loaded files, unless all of them came from the cache.
+===================
+*/
+void idDeclManagerLocal::WriteDeclIndex( void ) {
+	int numRecords = 0;
+	for ( int i = 0; i < loadedFiles.Num(); i++ ) {
+		const idList<byte> &records = loadedFiles[i]->indexRecords;
+		for ( int offset = 0; offset < records.Num(); offset += ( (const declIndexRecord_t *)( records.Ptr() + offset ) )->recordSize ) {
+			numRecords++;
+		}
+	}
+
+	if ( !decl_indexCache.GetBool() || ( !declIndexChanged && numRecords == declIndexRecords.Num() ) ) {
+		FreeDeclIndex();
+		return;
+	}
+
+	// the old cache must be unmapped before it can be overwritten
+	FreeDeclIndex();
+
+	idFile *f = fileSystem->OpenFileWrite( DECL_INDEX_FILENAME, "fs_modSavePath" );
+	if ( !f ) {
+		common->Warning( "Couldn't write decl index cache %s", DECL_INDEX_FILENAME );
+		return;
+	}
+
+	declIndexHeader_t header;
+	header.magic = DECL_INDEX_MAGIC;
+	header.version = DECL_INDEX_VERSION;
+	header.numRecords = numRecords;
+	header.pad = 0;
+	f->Write( &header, sizeof( header ) );
+	for ( int i = 0; i < loadedFiles.Num(); i++ ) {
+		f->Write( loadedFiles[i]->indexRecords.Ptr(), loadedFiles[i]->indexRecords.Num() );
+	}
+	fileSystem->CloseFile( f );
+}
+
 /*
 ===================
 idDeclManagerLocal::GetChecksum
@@ -1193,6 +1575,102 @@ const idDecl* idDeclManagerLocal::FindDeclWithoutParsing( declType_t type, const
 	return NULL;
 }
 
+/*
+===============
+PrepareDeclTextJob
+===============
+*/
+struct declText_t {
+	idDeclLocal *			decl;
+	char *					text;
+};
+
+struct declTextBatch_t {
+	declText_t *			texts;
+	int						first;
+	int						last;
+};
+
+static const int MAX_DECL_TEXT_JOBS = 16;
+static const int MIN_DECL_TEXTS_PER_JOB = 64;
+
+void PrepareDeclTextJob( declTextBatch_t *batch ) {
+	for ( int i = batch->first; i < batch->last; i++ ) {
+		declText_t &text = batch->texts[i];
+		text.text = (char *)Mem_Alloc( text.decl->GetTextLength() + 1 );
+		text.decl->GetText( text.text );
+	}
+}
+
+REGISTER_PARALLEL_JOB( PrepareDeclTextJob, "PrepareDeclText" );
+
+/*
+===============
+idDeclManagerLocal::ParseDecls
+
+Decompressing the decl texts runs on the job threads, the parsing itself stays on
+the calling thread: Parse() of most decl types finds other decls and loads media.
+===============
+*/
+void idDeclManagerLocal::ParseDecls( declType_t type, const idStrList &names ) {
+	if ( !decl_parseMapDecls.GetBool() ) {
+		return;
+	}
+
+	TRACE_CPU_SCOPE( "ParseDecls" )
+
+	idList<declText_t> texts;
+	idHashIndex added( 1024, idMath::Imax( names.Num(), 1 ) );
+	for ( int i = 0; i < names.Num(); i++ ) {
+		idDeclLocal *decl = FindTypeWithoutParsing( type, names[i], false );
+		if ( !decl || decl->declState != DS_UNPARSED || !decl->textSource ) {
+			continue;
+		}
+		int j;
+		for ( j = added.First( decl->index ); j != -1; j = added.Next( j ) ) {
+			if ( texts[j].decl == decl ) {
+				break;
+			}
+		}
+		if ( j != -1 ) {
+			continue;
+		}
+		added.Add( decl->index, texts.Num() );
+		declText_t &text = texts.Alloc();
+		text.decl = decl;
+		text.text = NULL;
+	}
+	if ( texts.Num() == 0 ) {
+		return;
+	}
+
+	int numJobs = idMath::ClampInt( 1, MAX_DECL_TEXT_JOBS, texts.Num() / MIN_DECL_TEXTS_PER_JOB );
+	declTextBatch_t batches[MAX_DECL_TEXT_JOBS];
+	idParallelJobList *jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numJobs, 0, NULL );
+	for ( int i = 0; i < numJobs; i++ ) {
+		batches[i].texts = texts.Ptr();
+		batches[i].first = texts.Num() * i / numJobs;
+		batches[i].last = texts.Num() * ( i + 1 ) / numJobs;
+		jobList->AddJob( (jobRun_t)PrepareDeclTextJob, &batches[i] );
+	}
+	jobList->Submit();
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+
+	for ( int i = 0; i < texts.Num(); i++ ) {
+		idDeclLocal *decl = texts[i].decl;
+		// it may have been parsed already as a dependency of an earlier one
+		if ( decl->declState == DS_UNPARSED ) {
+			decl->AllocateSelf();
+			decl->ParseLocal( texts[i].text );
+		}
+		Mem_Free( texts[i].text );
+		FindType( type, decl->name );
+	}
+
+	MediaPrint( "parsed %d %s decls referenced by the map\n", texts.Num(), GetDeclNameFromType( type ) );
+}
+
 /*
 ===============
 idDeclManagerLocal::ReloadFile
@@ -2218,7 +2696,7 @@ static constexpr const char *GetParseLabelOfDeclType(declType_t type) {
 idDeclLocal::ParseLocal
 =================
 */
-void idDeclLocal::ParseLocal( void ) {
+void idDeclLocal::ParseLocal( const char *preparedText ) {
 	bool generatedDefaultText = false;
 
 	AllocateSelf();
@@ -2249,9 +2727,13 @@ void idDeclLocal::ParseLocal( void ) {
 	declState = DS_PARSED;
 
 	// parse
-	char *declText = (char *) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
-	GetText( declText );
-	self->Parse( declText, GetTextLength() );
+	if ( preparedText ) {
+		self->Parse( preparedText, GetTextLength() );
+	} else {
+		char *declText = (char *) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
+		GetText( declText );
+		self->Parse( declText, GetTextLength() );
+	}
 
 	// free generated text
 	if ( generatedDefaultText ) {
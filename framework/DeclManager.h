@@ -282,6 +282,11 @@ public:
 
 	virtual const idDecl*	FindDeclWithoutParsing( declType_t type, const char *name, bool makeDefault = true ) = 0;
 
+							// Parses the given decls which are defined but not parsed yet and marks them
+							// as referenced like FindType does. Used during level load to parse all decls
+							// a map refers to at once, the decl texts are prepared on the job threads.
+	virtual void			ParseDecls( declType_t type, const idStrList &names ) = 0;
+
 	virtual void			ReloadFile( const char* filename, bool force ) = 0;
 
 							// Returns the number of decls of the given type.
@@ -19,7 +19,7 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 
 #include <minizip/unzip.h>
-#include "minizip/minizip_extra.h"	//unzReOpen
+#include "minizip/minizip_extra.h"	//unzReOpenAt
 //stgatilov: for pk4 repacking
 #include <minizip/zip.h>
 
@@ -142,6 +142,20 @@ typedef struct {
 	idList<idDict *>	mapDecls;
 } addonInfo_t;
 
+// a pk4 mapped into memory, shared by its pack and the files reading from the mapping
+typedef struct {
+	const byte *		data;
+	size_t				length;
+	std::atomic<int>	refCount;
+} mappedPack_t;
+
+static void ReleaseMappedPack( mappedPack_t *mapping ) {
+	if ( mapping->refCount.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+		Sys_UnmapFile( mapping->data, mapping->length );
+		delete mapping;
+	}
+}
+
 typedef struct {
 	idStr				pakFilename;				// c:\doom\base\pak0.pk4
 	unzFile				handle;
@@ -156,6 +170,8 @@ typedef struct {
 	bool				isNew;						// for downloaded paks
 	fileInPack_t		*hashTable[FILE_HASH_SIZE];
 	fileInPack_t		*buildBuffer;
+	mappedPack_t *		mapping;					// whole pk4 mapped into memory on first use with fs_mapPaks
+	bool				mappable;					// mapping is still to be tried
 } pack_t;
 
 typedef struct {
@@ -226,6 +242,10 @@ public:
     idFile *				OpenFileReadFlags( const char *relativePath, int searchFlags, pack_t **foundInPak = NULL, const char* gamedir = NULL );	//Note: thread-unsafe!
     virtual idFile *		OpenFileRead( const char *relativePath, const char* gamedir = NULL ) override;
     virtual idFile *		OpenFileReadPrefetch( const char *relativePath, const char* gamedir = NULL ) override;
+	virtual filePrefetch_t *PrefetchFiles( const idStrList &relativePaths ) override;
+	virtual int				GetNextPrefetchedFile( filePrefetch_t *prefetch ) override;
+	virtual int				GetPrefetchedFile( filePrefetch_t *prefetch, int index, void **buffer, ID_TIME_T *timestamp = NULL ) override;
+	virtual void			FreePrefetch( filePrefetch_t *prefetch ) override;
 	virtual idFile *		OpenFileWrite( const char *relativePath, const char *basePath = "fs_modSavePath", const char *gamedir = NULL ) override;
 	virtual idFile *		OpenFileAppend( const char *relativePath, bool sync = false, const char *basePath = "fs_modSavePath", const char *gamedir = NULL ) override;
 	virtual idFile *		OpenFileByMode( const char *relativePath, fsMode_t mode ) override;
@@ -278,6 +298,8 @@ private:
 	static idCVar			fs_devpath;
 	static idCVar			fs_caseSensitiveOS;
 	static idCVar			fs_searchAddons;
+	static idCVar			fs_prefetch;
+	static idCVar			fs_mapPaks;
 
     // taaaki: fs_game and fs_game_base have been removed as TDM is no longer a mod and these fs cvars were causing
     // confusion due to inconsistent usage. fs_mod has been added to allow for mods of TDM.
@@ -331,7 +353,8 @@ private:
 	pack_t *				GetPackForChecksum( int checksum, bool searchAddons = false ); //note: thread-unsafe!
 							// searches all the paks
 	pack_t *				FindPakForFileChecksum( const char *relativePath, int fileChecksum, bool bReference ); //note: thread-unsafe!
-	idFile_InZip *			ReadFileFromZip( pack_t *pak, fileInPack_t *pakFile, const char *relativePath ); //note: thread-unsafe!
+	idFile_InZip *			ReadFileFromZip( pack_t *pak, fileInPack_t *pakFile, const char *relativePath );
+	idFile *				OpenMappedFileFromZip( pack_t *pak, fileInPack_t *pakFile, const char *relativePath );
 	static int				GetFileChecksum( idFile *file );
 	static addonInfo_t *	ParseAddonDef( const char *buf, const int len );
 	void					FollowAddonDependencies( pack_t *pak );
@@ -355,6 +378,8 @@ idCVar	idFileSystemLocal::fs_caseSensitiveOS( "fs_caseSensitiveOS", "0", CVAR_SY
 idCVar	idFileSystemLocal::fs_caseSensitiveOS( "fs_caseSensitiveOS", "1", CVAR_SYSTEM | CVAR_BOOL, "" );
 #endif
 idCVar	idFileSystemLocal::fs_searchAddons( "fs_searchAddons", "0", CVAR_SYSTEM | CVAR_BOOL, "search all addon pk4s ( disables addon functionality )" );
+idCVar	idFileSystemLocal::fs_mapPaks( "fs_mapPaks", "0", CVAR_SYSTEM | CVAR_BOOL, "map pk4 files into memory on first use and read uncompressed files directly from the mapping, 64 bit builds only, applies to pk4 files loaded afterwards" );
+idCVar	idFileSystemLocal::fs_prefetch( "fs_prefetch", "1", CVAR_SYSTEM | CVAR_BOOL, "read and decompress the files of PrefetchFiles on the job threads, otherwise they are read when they are taken" );
 
 // greebo: Custom savepath in darkmod/fms/
 idCVar	idFileSystemLocal::fs_modSavePath( "fs_modSavePath", "", CVAR_SYSTEM | CVAR_INIT, "This is where all screenshots and savegames will be written to." );
@@ -1287,6 +1312,9 @@ pack_t *idFileSystemLocal::LoadZipFile( const char *zipfile ) {
 	pack->addon_search = false;
 	pack->addon_info = NULL;
 	pack->isNew = false;
+	pack->mapping = NULL;
+	// a 32 bit address space can't hold the mappings of all pk4 files
+	pack->mappable = fs_mapPaks.GetBool() && sizeof( void * ) >= 8;
 
 	pack->length = len;
 
@@ -2672,6 +2700,10 @@ void idFileSystemLocal::Shutdown( bool reloading ) {
 
 			if ( sp->pack ) {
 				unzClose( sp->pack->handle );
+				if ( sp->pack->mapping ) {
+					// files still reading from it keep it mapped
+					ReleaseMappedPack( sp->pack->mapping );
+				}
 				delete [] sp->pack->buildBuffer;
 				if ( sp->pack->addon_info ) {
 					sp->pack->addon_info->mapDecls.DeleteContents( true );
@@ -2772,11 +2804,9 @@ idFile_InZip * idFileSystemLocal::ReadFileFromZip( pack_t *pak, fileInPack_t *pa
 	// relativePath == pakFile->name according to FilenameCompare()
 	// pakFile->Pos is position of that file within the zip
 
-	// set position in pk4 file to the file (in the zip/pk4) we want a handle on
-	unzSetOffset64( pak->handle, pakFile->pos );
-
-	// clone handle and assign a new internal filestream to zip file to it
-	unzFile uf = unzReOpen( pak->pakFilename, pak->handle );
+	// clone handle with a new internal filestream positioned at the file (in the zip/pk4) we want a handle on,
+	// pak->handle itself is not changed so the inflating of different files doesn't depend on each other
+	unzFile uf = unzReOpenAt( pak->pakFilename, pak->handle, pakFile->pos );
 	if ( uf == NULL ) {
 		common->FatalError( "ReadFileFromZip: Couldn't reopen %s", pak->pakFilename.c_str() );
 	}
@@ -2801,6 +2831,97 @@ idFile_InZip * idFileSystemLocal::ReadFileFromZip( pack_t *pak, fileInPack_t *pa
 	return file;
 }
 
+/*
+===========
+idFile_MappedPack
+
+A file stored without compression read directly from the mapped pk4, holds a reference to the mapping.
+===========
+*/
+class idFile_MappedPack : public idFile_Memory {
+public:
+							idFile_MappedPack( const char *name, mappedPack_t *mapping, size_t offset, int length ) :
+								idFile_Memory( name, (const char *)mapping->data + offset, length, false ), mapping( mapping ) {
+								mapping->refCount.fetch_add( 1, std::memory_order_relaxed );
+							}
+	virtual					~idFile_MappedPack( void ) { ReleaseMappedPack( mapping ); }
+
+private:
+	mappedPack_t *			mapping;
+};
+
+/*
+===========
+idFileSystemLocal::OpenMappedFileFromZip
+
+Returns a view into the mapped pk4 if the file is stored without compression, NULL otherwise.
+Everything is checked against the zip headers, any unexpected layout falls back to ReadFileFromZip.
+===========
+*/
+static ID_INLINE unsigned int ZipReadShort( const byte *p ) {
+	return p[0] | ( p[1] << 8 );
+}
+
+static ID_INLINE unsigned int ZipReadLong( const byte *p ) {
+	return p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( (unsigned int)p[3] << 24 );
+}
+
+idFile *idFileSystemLocal::OpenMappedFileFromZip( pack_t *pak, fileInPack_t *pakFile, const char *relativePath ) {
+	if ( !pak->mapping ) {
+		if ( !pak->mappable ) {
+			return NULL;
+		}
+		// mapped when the first file is opened, only tried once
+		pak->mappable = false;
+		size_t length;
+		const byte *data = Sys_MapFile( pak->pakFilename, &length );
+		if ( !data ) {
+			return NULL;
+		}
+		pak->mapping = new mappedPack_t;
+		pak->mapping->data = data;
+		pak->mapping->length = length;
+		pak->mapping->refCount = 1;
+	}
+	const byte *mappedData = pak->mapping->data;
+	const size_t mappedLength = pak->mapping->length;
+
+	// central directory entry of the file
+	if ( pakFile->pos + 46 > mappedLength ) {
+		return NULL;
+	}
+	const byte *entry = mappedData + pakFile->pos;
+	if ( ZipReadLong( entry ) != 0x02014b50 ) {
+		return NULL;
+	}
+	unsigned int flags = ZipReadShort( entry + 8 );
+	unsigned int method = ZipReadShort( entry + 10 );
+	unsigned int compressedSize = ZipReadLong( entry + 20 );
+	unsigned int uncompressedSize = ZipReadLong( entry + 24 );
+	unsigned int localHeaderPos = ZipReadLong( entry + 42 );
+	// only stored and unencrypted, zip64 sizes and offsets are in the extra field
+	if ( method != 0 || ( flags & 1 ) || compressedSize != uncompressedSize ||
+		uncompressedSize == 0xFFFFFFFF || localHeaderPos == 0xFFFFFFFF || uncompressedSize > INT_MAX ) {
+		return NULL;
+	}
+
+	// local file header, its name and extra field can differ from the central directory
+	if ( (size_t)localHeaderPos + 30 > mappedLength ) {
+		return NULL;
+	}
+	const byte *local = mappedData + localHeaderPos;
+	if ( ZipReadLong( local ) != 0x04034b50 ) {
+		return NULL;
+	}
+	size_t dataPos = (size_t)localHeaderPos + 30 + ZipReadShort( local + 26 ) + ZipReadShort( local + 28 );
+	if ( dataPos + uncompressedSize > mappedLength ) {
+		return NULL;
+	}
+
+	// the OS pages the data in when it is read, the mapping stays until the file is closed
+	return new idFile_MappedPack( relativePath, pak->mapping, dataPos, uncompressedSize );
+}
+
 /*
 ===========
 idFileSystemLocal::OpenFileReadFlags
@@ -2912,7 +3033,10 @@ idFile *idFileSystemLocal::OpenFileReadFlags( const char *relativePath, int sear
 			for ( pakFile = pak->hashTable[hash]; pakFile; pakFile = pakFile->next ) {
 				// case and separator insensitive comparisons
 				if ( !FilenameCompare( pakFile->name, relativePath ) ) {
-					idFile_InZip *file = ReadFileFromZip( pak, pakFile, relativePath );
+					idFile *file = OpenMappedFileFromZip( pak, pakFile, relativePath );
+					if ( !file ) {
+						file = ReadFileFromZip( pak, pakFile, relativePath );
+					}
 
 					if ( foundInPak ) {
 						*foundInPak = pak;
@@ -2941,7 +3065,10 @@ idFile *idFileSystemLocal::OpenFileReadFlags( const char *relativePath, int sear
 			pak = search->pack;
 			for ( pakFile = pak->hashTable[hash]; pakFile; pakFile = pakFile->next ) {
 				if ( !FilenameCompare( pakFile->name, relativePath ) ) {
-					idFile_InZip *file = ReadFileFromZip( pak, pakFile, relativePath );
+					idFile *file = OpenMappedFileFromZip( pak, pakFile, relativePath );
+					if ( !file ) {
+						file = ReadFileFromZip( pak, pakFile, relativePath );
+					}
 					if ( foundInPak ) {
 						*foundInPak = pak;
 					}
@@ -2989,6 +3116,173 @@ idFile * idFileSystemLocal::OpenFileReadPrefetch( const char *relativePath, cons
 	return res;
 }
 
+/*
+=================================================================================
+
+prefetching
+
+=================================================================================
+*/
+
+typedef struct prefetchFile_s {
+	filePrefetch_t *	prefetch;
+	idStr				relativePath;
+	void *				buffer;
+	int					length;
+	ID_TIME_T			timestamp;
+	std::atomic<bool>	done;
+	bool				taken;
+} prefetchFile_t;
+
+struct filePrefetch_s {
+	prefetchFile_t *	files;
+	int					numFiles;
+	std::atomic<int> *	completed;			// file indices in the order the reads complete, -1 until written
+	std::atomic<int>	numCompleted;
+	int					numReturned;		// completed files already returned by GetNextPrefetchedFile
+	idSysSignal			fileDone;
+	idParallelJobList *	jobList;			// NULL if the files are read when they are taken
+};
+
+/*
+===========
+PrefetchFileJob
+===========
+*/
+static void PrefetchFileJob( prefetchFile_t *file ) {
+	// ReadFile only holds the global lock while the file is opened, the decompression runs in parallel
+	file->length = fileSystem->ReadFile( file->relativePath, &file->buffer, &file->timestamp );
+
+	filePrefetch_t *prefetch = file->prefetch;
+	file->done.store( true, std::memory_order_release );
+	int slot = prefetch->numCompleted.fetch_add( 1, std::memory_order_relaxed );
+	prefetch->completed[slot].store( (int)( file - prefetch->files ), std::memory_order_release );
+	prefetch->fileDone.Raise();
+}
+
+REGISTER_PARALLEL_JOB( PrefetchFileJob, "PrefetchFileJob" );
+
+/*
+===========
+idFileSystemLocal::PrefetchFiles
+===========
+*/
+filePrefetch_t *idFileSystemLocal::PrefetchFiles( const idStrList &relativePaths ) {
+	filePrefetch_t *prefetch = new filePrefetch_t;
+	prefetch->numFiles = relativePaths.Num();
+	prefetch->files = new prefetchFile_t[idMath::Imax( prefetch->numFiles, 1 )];
+	prefetch->completed = new std::atomic<int>[idMath::Imax( prefetch->numFiles, 1 )];
+	prefetch->numCompleted = 0;
+	prefetch->numReturned = 0;
+	prefetch->jobList = NULL;
+
+	for ( int i = 0; i < prefetch->numFiles; i++ ) {
+		prefetchFile_t &file = prefetch->files[i];
+		file.prefetch = prefetch;
+		file.relativePath = relativePaths[i];
+		file.buffer = NULL;
+		file.length = -1;
+		file.timestamp = FILE_NOT_FOUND_TIMESTAMP;
+		file.done = false;
+		file.taken = false;
+		prefetch->completed[i] = -1;
+	}
+
+	if ( fs_prefetch.GetBool() && prefetch->numFiles > 0 ) {
+		prefetch->jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, prefetch->numFiles, 0, NULL );
+		for ( int i = 0; i < prefetch->numFiles; i++ ) {
+			prefetch->jobList->AddJob( (jobRun_t)PrefetchFileJob, &prefetch->files[i] );
+		}
+		prefetch->jobList->Submit();
+	}
+
+	return prefetch;
+}
+
+/*
+===========
+idFileSystemLocal::GetNextPrefetchedFile
+===========
+*/
+int idFileSystemLocal::GetNextPrefetchedFile( filePrefetch_t *prefetch ) {
+	if ( !prefetch->jobList ) {
+		// nothing runs in the background, just go through the list
+		for ( int i = 0; i < prefetch->numFiles; i++ ) {
+			if ( !prefetch->files[i].taken ) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	while ( prefetch->numReturned < prefetch->numFiles ) {
+		int index;
+		while ( ( index = prefetch->completed[prefetch->numReturned].load( std::memory_order_acquire ) ) < 0 ) {
+			prefetch->fileDone.Wait();
+		}
+		prefetch->numReturned++;
+		// skip the files already taken with GetPrefetchedFile
+		if ( !prefetch->files[index].taken ) {
+			return index;
+		}
+	}
+	return -1;
+}
+
+/*
+===========
+idFileSystemLocal::GetPrefetchedFile
+===========
+*/
+int idFileSystemLocal::GetPrefetchedFile( filePrefetch_t *prefetch, int index, void **buffer, ID_TIME_T *timestamp ) {
+	assert( index >= 0 && index < prefetch->numFiles );
+	prefetchFile_t &file = prefetch->files[index];
+
+	if ( file.taken ) {
+		common->Warning( "GetPrefetchedFile: %s was already taken", file.relativePath.c_str() );
+		*buffer = NULL;
+		return -1;
+	}
+
+	if ( !prefetch->jobList ) {
+		file.length = ReadFile( file.relativePath, &file.buffer, &file.timestamp );
+	} else {
+		while ( !file.done.load( std::memory_order_acquire ) ) {
+			prefetch->fileDone.Wait();
+		}
+	}
+
+	file.taken = true;
+	*buffer = file.buffer;
+	file.buffer = NULL;
+	if ( timestamp ) {
+		*timestamp = file.timestamp;
+	}
+	return file.length;
+}
+
+/*
+===========
+idFileSystemLocal::FreePrefetch
+===========
+*/
+void idFileSystemLocal::FreePrefetch( filePrefetch_t *prefetch ) {
+	if ( prefetch->jobList ) {
+		prefetch->jobList->Wait();
+		parallelJobManager->FreeJobList( prefetch->jobList );
+	}
+
+	for ( int i = 0; i < prefetch->numFiles; i++ ) {
+		if ( prefetch->files[i].buffer ) {
+			FreeFile( prefetch->files[i].buffer );
+		}
+	}
+
+	delete [] prefetch->files;
+	delete [] prefetch->completed;
+	delete prefetch;
+}
+
 /*
 ===========
 idFileSystemLocal::OpenFileWrite
@@ -97,6 +97,9 @@ typedef struct backgroundDownload_s {
 	volatile bool		completed;
 } backgroundDownload_t;
 
+// batch of files read by PrefetchFiles
+typedef struct filePrefetch_s filePrefetch_t;
+
 // file list for directory listings
 class idFileList {
 	friend class idFileSystemLocal;
@@ -186,6 +189,17 @@ public:
     virtual idFile *		OpenFileRead( const char *relativePath, const char* gamedir = NULL ) = 0;
 							// Prefetches the entire file to memory and returns an in-memory file object
 	virtual idFile *		OpenFileReadPrefetch( const char *relativePath, const char *gamedir = NULL ) = 0;
+							// Starts reading the given files completely on the job threads, like ReadFile.
+							// Only the thread which started the prefetch may get the files and free it.
+	virtual filePrefetch_t *PrefetchFiles( const idStrList &relativePaths ) = 0;
+							// Returns the index of the next file of the prefetch which has been read completely, in the order the files complete.
+							// Blocks until one is done, returns -1 once all files have been returned.
+	virtual int				GetNextPrefetchedFile( filePrefetch_t *prefetch ) = 0;
+							// Same as ReadFile for the file with the given index in the prefetched list, blocks until it has been read.
+							// The buffer must be freed with FreeFile, every file can only be taken once.
+	virtual int				GetPrefetchedFile( filePrefetch_t *prefetch, int index, void **buffer, ID_TIME_T *timestamp = NULL ) = 0;
+							// Waits for all reads of the prefetch and frees the buffers which have not been taken.
+	virtual void			FreePrefetch( filePrefetch_t *prefetch ) = 0;
 							// Opens a file for writing, will create any needed subdirectories.
 	virtual idFile *		OpenFileWrite( const char *relativePath, const char *basePath = "fs_modSavePath", const char *gamedir = NULL ) = 0;
 							// Opens a file for writing at the end.
@@ -1912,6 +1912,9 @@ bool idSessionLocal::SaveGame( const char *saveName, bool autosave, bool skipChe
 	descriptionFile = gameFile;
 	descriptionFile.SetFileExtension( ".txt" );
 
+	// the previous savegame may still be written to the same file
+	game->FinishSaveGame();
+
 	// Open savegame file
 	idFile *fileOut = fileSystem->OpenFileWrite( gameFile );
 	if ( fileOut == NULL ) {
@@ -2250,6 +2253,9 @@ bool idSessionLocal::ParseSavegamePreamble(const char * saveName, idFile** saveg
 	in = "savegames/";
 	in += loadFile;
 
+	// the end of the last savegame may still be written in the background
+	::game->FinishSaveGame();
+
 	// Open savegame file
 	// only allow loads from the game directory because we don't want a base game to load
 	idStr game = cvarSystem->GetCVarString("fs_currentfm");
@@ -2749,7 +2755,9 @@ idSessionLocal::Frame
 void idSessionLocal::Frame() {
 
 	if ( com_asyncSound.GetInteger() == 0 ) {
+		uint64 soundStart = Sys_Microseconds();
 		soundSystem->AsyncUpdate( Sys_Milliseconds() );
+		com_soundTimeMicro += (int)( Sys_Microseconds() - soundStart );
 	}
 
 	// Editors that completely take over the game
@@ -2836,6 +2844,11 @@ void idSessionLocal::Frame() {
 		minTic = lastGameTic + USERCMD_PER_DEMO_FRAME;		// demos are recorded at 30 hz
 	}
 
+	if ( Auto_IsBenchmarkRunning() ) {
+		// the benchmark runs exactly one tic per frame, as fast as it can
+		minTic = latchedTicNumber;
+	}
+
 	// Spin in place if needed when frame cap is active. 
 	// The game should yield the cpu if it is running over 60 hz, 
 	// because there is fundamentally nothing useful for it to do.
@@ -2943,6 +2956,13 @@ void idSessionLocal::Frame() {
 		gameTimestepTotal = USERCMD_MSEC * gameTicsToRun;
 	}
 
+	if ( Auto_IsBenchmarkRunning() ) {
+		// fixed timestep independent of the real time, so that the plan is replayed the same way every time
+		gameTicsToRun = 1;
+		gameTimestepTotal = USERCMD_MSEC;
+		lastGameTic = latchedTicNumber - 1;
+	}
+
 	// create client commands, which will be sent directly
 	// to the game
 	if ( com_showTics.GetBool() ) {
@@ -2993,7 +3013,7 @@ void idSessionLocal::RunGameTic(int timestepMs) {
 	lastGameTic++;
 
 	// stgatilov: allow automation to intercept gameplay controls
-	if (com_automation.GetBool()) {
+	if (com_automation.GetBool() || Auto_IsBenchmarkRunning()) {
 		bool automationRules = Auto_GetUsercmd(cmd);
 	}
 
@@ -3053,6 +3073,8 @@ void idSessionLocal::RunGameTic(int timestepMs) {
 }
 
 void idSessionLocal::RunGameTics() {
+	uint64 start = Sys_Microseconds();
+
 	// run game tics
 	for (int i = 0; i < gameTicsToRun; ++i) {
 		int deltaMs = gameTimestepTotal * (i+1) / gameTicsToRun - gameTimestepTotal * i / gameTicsToRun;
@@ -3064,9 +3086,13 @@ void idSessionLocal::RunGameTics() {
 			break;
 		}
 	}
+
+	com_frameTimings.gameTic = (int)( Sys_Microseconds() - start );
 }
 
 void idSessionLocal::DrawFrame() {
+	uint64 start = Sys_Microseconds();
+
 	// draw lightgem
 	if (mapSpawned && !com_skipGameDraw.GetBool() && GetLocalClientNum() >= 0) {
 		game->DrawLightgem(GetLocalClientNum());
@@ -3080,6 +3106,8 @@ void idSessionLocal::DrawFrame() {
 	// add the swapbuffers command
 	emptyCommand_t *cmd = (emptyCommand_t *)R_GetCommandBuffer( sizeof( *cmd ) );
 	cmd->commandId = RC_SWAP_BUFFERS;
+
+	com_frameTimings.frontend = (int)( Sys_Microseconds() - start );
 }
 
 /*
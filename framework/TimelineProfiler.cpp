@@ -0,0 +1,314 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "TimelineProfiler.h"
+
+idCVar com_timeline( "com_timeline", "0", CVAR_SYSTEM | CVAR_BOOL, "record job lists, jobs and trace scopes of the last frames for timelineDump" );
+
+static const int TIMELINE_MAX_EVENTS		= 1 << 17;
+static const int TIMELINE_MAX_THREADS		= 64;
+static const int TIMELINE_FRAME_TRACK		= 999;
+static const int TIMELINE_JOBLIST_TRACK		= 1000;		// + job list id
+
+struct timelineEvent_t {
+	// index + 1 of the event once it is completely written, 0 while it is written
+	std::atomic<uint64>	sequence;
+	const char *		name;
+	uint64				start;
+	uint64				end;
+	int					type;
+	int					thread;
+	int					args[7];
+};
+
+bool g_timelineEnabled = false;
+
+static timelineEvent_t *	timelineEvents = NULL;
+static std::atomic<uint64>	timelineWriteIndex( 0 );
+static uint64				timelineLastFrameEnd = 0;
+static int					timelineFrameNum = 0;
+
+static std::atomic<int>		timelineNumThreads( 0 );
+static char					timelineThreadNames[TIMELINE_MAX_THREADS][64];
+static thread_local int		timelineThread = -1;
+
+static int TimelineThreadIndex() {
+	if ( timelineThread < 0 ) {
+		timelineThread = timelineNumThreads.fetch_add( 1, std::memory_order_relaxed );
+	}
+	return timelineThread;
+}
+
+/*
+========================
+TimelineSetThreadName
+========================
+*/
+void TimelineSetThreadName( const char *name ) {
+	int thread = TimelineThreadIndex();
+	if ( thread < TIMELINE_MAX_THREADS ) {
+		idStr::Copynz( timelineThreadNames[thread], name, sizeof( timelineThreadNames[thread] ) );
+	}
+}
+
+/*
+========================
+TimelineAllocEvent
+
+Events are written by any thread, the sequence number tells the
+dump whether an event is complete and has not been overwritten.
+========================
+*/
+static timelineEvent_t & TimelineAllocEvent( uint64 & index ) {
+	index = timelineWriteIndex.fetch_add( 1, std::memory_order_relaxed );
+	timelineEvent_t & ev = timelineEvents[index & ( TIMELINE_MAX_EVENTS - 1 )];
+	ev.sequence.store( 0, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_release );
+	return ev;
+}
+
+/*
+========================
+TimelineAddEvent
+========================
+*/
+void TimelineAddEvent( timelineEventType_t type, const char *name, uint64 start, uint64 end, int arg0, int arg1 ) {
+	if ( !g_timelineEnabled ) {
+		return;
+	}
+	uint64 index;
+	timelineEvent_t & ev = TimelineAllocEvent( index );
+	ev.name = name;
+	ev.start = start;
+	ev.end = end;
+	ev.type = type;
+	ev.thread = TimelineThreadIndex();
+	ev.args[0] = arg0;
+	ev.args[1] = arg1;
+	ev.sequence.store( index + 1, std::memory_order_release );
+}
+
+/*
+========================
+TimelineAddJobList
+========================
+*/
+void TimelineAddJobList( int listId, uint64 submit, uint64 start, uint64 end, int numJobs, int numSyncs, uint64 processing, uint64 wasted, uint64 wait ) {
+	if ( !g_timelineEnabled ) {
+		return;
+	}
+	uint64 index;
+	timelineEvent_t & ev = TimelineAllocEvent( index );
+	ev.name = "JobList";
+	ev.start = start;
+	ev.end = end > start ? end : start;
+	ev.type = TIMELINE_JOBLIST;
+	ev.thread = TIMELINE_JOBLIST_TRACK + listId;
+	ev.args[0] = listId;
+	ev.args[1] = numJobs;
+	ev.args[2] = numSyncs;
+	ev.args[3] = (int)( start - submit );
+	ev.args[4] = (int)processing;
+	ev.args[5] = (int)wasted;
+	ev.args[6] = (int)wait;
+	ev.sequence.store( index + 1, std::memory_order_release );
+}
+
+/*
+========================
+TimelineEndFrame
+========================
+*/
+void TimelineEndFrame() {
+	uint64 now = Sys_Microseconds();
+
+	if ( com_timeline.GetBool() != g_timelineEnabled ) {
+		if ( com_timeline.GetBool() ) {
+			// the buffer is never freed, job threads may still be writing into it after recording stops
+			if ( timelineEvents == NULL ) {
+				timelineEvents = new timelineEvent_t[TIMELINE_MAX_EVENTS];
+			}
+			for ( int i = 0; i < TIMELINE_MAX_EVENTS; i++ ) {
+				timelineEvents[i].sequence.store( 0, std::memory_order_relaxed );
+			}
+			timelineWriteIndex = 0;
+			timelineFrameNum = 0;
+			timelineLastFrameEnd = now;
+		}
+		g_timelineEnabled = com_timeline.GetBool();
+		return;
+	}
+
+	if ( g_timelineEnabled ) {
+		TimelineAddEvent( TIMELINE_FRAME, "Frame", timelineLastFrameEnd, now, timelineFrameNum++ );
+		timelineLastFrameEnd = now;
+	}
+}
+
+/*
+========================
+TimelineWriteString
+========================
+*/
+static void TimelineWriteString( idFile *f, const char *str ) {
+	char buffer[256];
+	int len = 0;
+	for ( ; *str && len < sizeof( buffer ) - 2; str++ ) {
+		if ( *str == '"' || *str == '\\' ) {
+			buffer[len++] = '\\';
+		} else if ( (unsigned char)*str < ' ' ) {
+			continue;
+		}
+		buffer[len++] = *str;
+	}
+	buffer[len] = '\0';
+	f->Printf( "\"%s\"", buffer );
+}
+
+/*
+========================
+Timeline_Dump_f
+========================
+*/
+void Timeline_Dump_f( const idCmdArgs &args ) {
+	if ( timelineEvents == NULL ) {
+		common->Printf( "Nothing recorded, set com_timeline 1 first\n" );
+		return;
+	}
+
+	idStr fileName = args.Argc() > 1 ? args.Argv( 1 ) : "timeline.json";
+	fileName.DefaultFileExtension( ".json" );
+	int numFrames = args.Argc() > 2 ? atoi( args.Argv( 2 ) ) : 0;
+
+	// copy out all events which are complete and have not been overwritten meanwhile
+	uint64 head = timelineWriteIndex.load( std::memory_order_acquire );
+	uint64 first = head > TIMELINE_MAX_EVENTS ? head - TIMELINE_MAX_EVENTS : 0;
+
+	struct dumpEvent_t {
+		const char *	name;
+		uint64			start;
+		uint64			end;
+		int				type;
+		int				thread;
+		int				args[7];
+	};
+	idList<dumpEvent_t> events;
+	events.Resize( (int)( head - first ) );
+
+	for ( uint64 i = first; i < head; i++ ) {
+		const timelineEvent_t & ev = timelineEvents[i & ( TIMELINE_MAX_EVENTS - 1 )];
+		if ( ev.sequence.load( std::memory_order_acquire ) != i + 1 ) {
+			continue;
+		}
+		dumpEvent_t & copy = events.Alloc();
+		copy.name = ev.name;
+		copy.start = ev.start;
+		copy.end = ev.end;
+		copy.type = ev.type;
+		copy.thread = ev.thread;
+		memcpy( copy.args, ev.args, sizeof( copy.args ) );
+		std::atomic_thread_fence( std::memory_order_acquire );
+		if ( ev.sequence.load( std::memory_order_relaxed ) != i + 1 ) {
+			events.RemoveIndex( events.Num() - 1 );
+		}
+	}
+
+	// only keep the requested number of complete frames
+	uint64 minTime = 0;
+	int numDumpedFrames = 0;
+	for ( int i = events.Num() - 1; i >= 0; i-- ) {
+		if ( events[i].type == TIMELINE_FRAME ) {
+			numDumpedFrames++;
+			if ( numFrames > 0 && numDumpedFrames == numFrames ) {
+				minTime = events[i].start;
+				break;
+			}
+		}
+	}
+
+	uint64 timeBase = UINT64_MAX;
+	for ( int i = 0; i < events.Num(); i++ ) {
+		if ( events[i].end >= minTime && events[i].start < timeBase ) {
+			timeBase = events[i].start;
+		}
+	}
+
+	idFile *f = fileSystem->OpenFileWrite( fileName );
+	if ( f == NULL ) {
+		common->Warning( "Couldn't open %s for writing", fileName.c_str() );
+		return;
+	}
+
+	f->Printf( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+
+	f->Printf( "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"Frames\"}}", TIMELINE_FRAME_TRACK );
+	int numThreads = idMath::Imin( timelineNumThreads.load(), TIMELINE_MAX_THREADS );
+	for ( int i = 0; i < numThreads; i++ ) {
+		f->Printf( ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", i );
+		if ( timelineThreadNames[i][0] ) {
+			TimelineWriteString( f, timelineThreadNames[i] );
+		} else {
+			f->Printf( "\"Thread %d\"", i );
+		}
+		f->Printf( "}}" );
+	}
+	for ( int i = 0; i < MAX_JOBLISTS; i++ ) {
+		f->Printf( ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"Job list %d\"}}", TIMELINE_JOBLIST_TRACK + i, i );
+	}
+
+	int numWritten = 0;
+	for ( int i = 0; i < events.Num(); i++ ) {
+		const dumpEvent_t & ev = events[i];
+		if ( ev.end < minTime ) {
+			continue;
+		}
+
+		static const char *categories[] = { "scope", "job", "joblist", "sync", "sync", "frame" };
+		int tid = ev.type == TIMELINE_FRAME ? TIMELINE_FRAME_TRACK : ev.thread;
+		double ts = (double)( ev.start - timeBase );
+
+		f->Printf( ",\n{\"name\":" );
+		TimelineWriteString( f, ev.name );
+		f->Printf( ",\"cat\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.0f", categories[ev.type], tid, ts );
+
+		switch ( ev.type ) {
+			case TIMELINE_SYNC_SIGNAL:
+			case TIMELINE_SYNC_STALL:
+				f->Printf( ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"jobList\":%d,\"syncIndex\":%d}}", ev.args[0], ev.args[1] );
+				break;
+			case TIMELINE_JOB:
+				f->Printf( ",\"ph\":\"X\",\"dur\":%d,\"args\":{\"jobList\":%d}}", (int)( ev.end - ev.start ), ev.args[0] );
+				break;
+			case TIMELINE_JOBLIST:
+				f->Printf( ",\"ph\":\"X\",\"dur\":%d,\"args\":{\"jobList\":%d,\"jobs\":%d,\"syncs\":%d,\"startDelay\":%d,\"processing\":%d,\"wasted\":%d,\"wait\":%d}}",
+					(int)( ev.end - ev.start ), ev.args[0], ev.args[1], ev.args[2], ev.args[3], ev.args[4], ev.args[5], ev.args[6] );
+				break;
+			case TIMELINE_FRAME:
+				f->Printf( ",\"ph\":\"X\",\"dur\":%d,\"args\":{\"frame\":%d}}", (int)( ev.end - ev.start ), ev.args[0] );
+				break;
+			default:
+				f->Printf( ",\"ph\":\"X\",\"dur\":%d}", (int)( ev.end - ev.start ) );
+				break;
+		}
+		numWritten++;
+	}
+
+	f->Printf( "\n]}\n" );
+	fileSystem->CloseFile( f );
+
+	common->Printf( "Wrote %d events of %d frames to %s\n", numWritten, numDumpedFrames, fileName.c_str() );
+}
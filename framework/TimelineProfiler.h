@@ -0,0 +1,64 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#pragma once
+
+/*
+================================================
+Timeline profiler
+
+Records job lists, jobs, sync points and TRACE_CPU_SCOPE regions of the
+last frames into a ring buffer, without any external viewer attached.
+Enabled by com_timeline, the "timelineDump" command writes the recorded
+frames as Chrome trace JSON (chrome://tracing, Perfetto).
+
+All names must be string literals or otherwise outlive the recording,
+only the pointers are stored.
+================================================
+*/
+
+enum timelineEventType_t {
+	TIMELINE_SCOPE,			// TRACE_CPU_SCOPE region
+	TIMELINE_JOB,			// single job, name is the registered job name
+	TIMELINE_JOBLIST,		// job list from its first started job to its last finished one
+	TIMELINE_SYNC_SIGNAL,	// all jobs before a signal in a job list are done
+	TIMELINE_SYNC_STALL,	// a job thread stalled on a sync point
+	TIMELINE_FRAME			// end of frame marker
+};
+
+extern bool g_timelineEnabled;
+
+// called once per frame, turns recording on/off according to com_timeline
+void TimelineEndFrame();
+// names the calling thread in the dump
+void TimelineSetThreadName( const char *name );
+// records an event of the calling thread, times are from Sys_Microseconds
+void TimelineAddEvent( timelineEventType_t type, const char *name, uint64 start, uint64 end, int arg0 = 0, int arg1 = 0 );
+// job lists are shown on their own track per job list id
+void TimelineAddJobList( int listId, uint64 submit, uint64 start, uint64 end, int numJobs, int numSyncs, uint64 processing, uint64 wasted, uint64 wait );
+void Timeline_Dump_f( const idCmdArgs &args );
+
+class idTimelineScope {
+public:
+	idTimelineScope( const char *name ) : name( name ), start( g_timelineEnabled ? Sys_Microseconds() : 0 ) {}
+	~idTimelineScope() {
+		if ( start != 0 && g_timelineEnabled ) {
+			TimelineAddEvent( TIMELINE_SCOPE, name, start, Sys_Microseconds() );
+		}
+	}
+private:
+	const char *	name;
+	uint64			start;
+};
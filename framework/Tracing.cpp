@@ -67,6 +67,8 @@ void InitOpenGLTracing() {
 }
 
 void TracingEndFrame() {
+	TimelineEndFrame();
+
 #ifdef TRACY_ENABLE
 	InitTracing();
 
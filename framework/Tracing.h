@@ -18,6 +18,7 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "../renderer/qgl.h"
 #include <TracyOpenGL.hpp>
 #include <common/TracySystem.hpp>
+#include "TimelineProfiler.h"
 
 extern idCVar r_useDebugGroups;
 
@@ -32,7 +33,7 @@ extern bool g_tracingEnabled;
 extern bool g_tracingAllocStacks;
 extern bool g_glTraceInitialized;
 
-#define TRACE_THREAD_NAME( name ) if ( g_tracingEnabled ) tracy::SetThreadName( name );
+#define TRACE_THREAD_NAME( name ) { TimelineSetThreadName( name ); if ( g_tracingEnabled ) tracy::SetThreadName( name ); }
 #define TRACE_PLOT_NUMBER( name, value ) if ( g_tracingEnabled ) { TracyPlot( name, value ); TracyPlotConfig( name, tracy::PlotFormatType::Number ); }
 #define TRACE_PLOT_BYTES( name, value ) if ( g_tracingEnabled ) { TracyPlot( name, value ); TracyPlotConfig( name, tracy::PlotFormatType::Memory ); }
 #define TRACE_PLOT_FRACTION( name, value ) if ( g_tracingEnabled ) { TracyPlot( name, value*100 ); TracyPlotConfig( name, tracy::PlotFormatType::Percentage ); }
@@ -40,8 +41,9 @@ extern bool g_glTraceInitialized;
 #define TRACE_COLOR_IDLE 0x808080
 
 //zones/scopes to measure and display as interval task
-#define TRACE_CPU_SCOPE( section ) ZoneNamedN( __tracy_scoped_zone, section, g_tracingEnabled )
-#define TRACE_CPU_SCOPE_COLOR( section, color ) ZoneNamedNC( __tracy_scoped_zone, section, color, g_tracingEnabled )
+//they are also recorded by the timeline profiler (see com_timeline)
+#define TRACE_CPU_SCOPE( section ) ZoneNamedN( __tracy_scoped_zone, section, g_tracingEnabled ) idTimelineScope __timeline_scope( section );
+#define TRACE_CPU_SCOPE_COLOR( section, color ) ZoneNamedNC( __tracy_scoped_zone, section, color, g_tracingEnabled ) idTimelineScope __timeline_scope( section );
 
 //set text of the currently active zone (overwrite)
 #define TRACE_ATTACH_TEXT( text ) if ( g_tracingEnabled ) { \
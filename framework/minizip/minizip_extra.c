@@ -49,6 +49,43 @@ extern unzFile unzReOpen (const char* path, unzFile file)
 	return (unzFile)s;
 }
 
+extern unzFile unzReOpenAt (const char* path, unzFile file, ZPOS64_T pos)
+{
+	unz64_s* s;
+	unz64_s* zFile = (unz64_s*)file;
+
+	if(zFile == NULL)
+		return NULL;
+
+	// only read from "file", it may be cloned by other threads at the same time
+	s=(unz64_s*)ALLOC(sizeof(unz64_s));
+	if(s == NULL)
+		return NULL;
+
+	memcpy(s, zFile, sizeof(unz64_s));
+	s->pfile_in_zip_read = NULL;
+
+	voidp fin = ZOPEN64(s->z_filefunc,
+						path,
+						ZLIB_FILEFUNC_MODE_READ | ZLIB_FILEFUNC_MODE_EXISTING);
+
+	if( fin == NULL ) {
+		TRYFREE(s);
+		return NULL;
+	}
+
+	s->filestream = fin;
+
+	// the file info is read through the new filestream
+	if( unzSetOffset64( s, pos ) != UNZ_OK || unzOpenCurrentFile( s ) != UNZ_OK ) {
+		ZCLOSE64(s->z_filefunc, s->filestream);
+		TRYFREE(s);
+		return NULL;
+	}
+
+	return (unzFile)s;
+}
+
 extern int ZEXPORT unzseek(unzFile file, z_off_t offset, int origin)
 {
 	return unzseek64(file, (ZPOS64_T)offset, origin);
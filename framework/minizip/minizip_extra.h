@@ -23,6 +23,10 @@ extern "C" {
 extern unzFile unzReOpen( const char* path, unzFile file );
 /* Re-Open a Zip file, i.e. clone an existing one and give it a new file descriptor. */
 
+extern unzFile unzReOpenAt( const char* path, unzFile file, ZPOS64_T pos );
+/* Same as unzReOpen, but opens the file at pos (see unzGetOffset64) without changing "file",
+   so it can be called from several threads for the same zip file. */
+
 extern int ZEXPORT unzseek OF((unzFile file, z_off_t offset, int origin));
 extern int ZEXPORT unzseek64 OF((unzFile file, ZPOS64_T offset, int origin));
 /* Seek within the uncompressed data if compression method is storage. */
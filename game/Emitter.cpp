@@ -139,6 +139,11 @@ idFuncEmitter::Present
 */
 void idFuncEmitter::Present( void ) 
 {
+	if ( DeferPresent() )
+	{
+		return;
+	}
+
 	if( m_bFrobable )
 	{
 		UpdateFrobState();
@@ -304,6 +309,16 @@ void idFuncEmitter::Think( void )
 	Present();
 }
 
+/*
+================
+idFuncEmitter::IsParallelThinkSafe
+================
+*/
+bool idFuncEmitter::IsParallelThinkSafe( void )
+{
+	return GetTeamMaster() == NULL;
+}
+
 /*
 ===============
 idFuncEmitter::Restore
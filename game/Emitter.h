@@ -55,6 +55,7 @@ public:
 	virtual void		ReadFromSnapshot( const idBitMsgDelta &msg );
 
 	virtual void		Think( void );
+	virtual bool		IsParallelThinkSafe( void );
 	virtual void		Present( void );
 
 	// switch to a new model
@@ -989,6 +989,7 @@ idEntity::idEntity()
 
 	spawnNode.SetOwner( this );
 	activeIdx = -1;
+	thinkInParallel = false;
 	lodIdx = -1;
 
 	snapshotNode.SetOwner( this );
@@ -2309,6 +2310,30 @@ void idEntity::Think( void )
 	}
 }
 
+/*
+================
+idEntity::IsParallelThinkSafe
+================
+*/
+bool idEntity::IsParallelThinkSafe( void )
+{
+	return false;
+}
+
+/*
+================
+idEntity::CanThinkInParallel
+================
+*/
+bool idEntity::CanThinkInParallel( void )
+{
+	// decals are restored through the render world
+	if ( needsDecalRestore ) {
+		return false;
+	}
+	return IsParallelThinkSafe();
+}
+
 /*
 ================
 idEntity::DoDormantTests
@@ -2582,6 +2607,14 @@ idEntity::BecomeActive
 */
 void idEntity::BecomeActive( int flags )
 {
+	if ( ParallelThinkBatch *batch = ParallelThinkBatch::Current() ) {
+		if ( batch->Thinker() != this ) {
+			// the entity may be thinking in another job, or not be in the active list yet
+			batch->BecomeActive( this, flags );
+			return;
+		}
+	}
+
 	if ( ( flags & TH_PHYSICS ) ) {
 		// enable the team master if this entity is part of a physics team
 		if ( teamMaster && teamMaster != this ) {
@@ -2598,7 +2631,11 @@ void idEntity::BecomeActive( int flags )
 			gameLocal.activeEntities.AddToEnd( this );
 		} else if ( !oldFlags ) {
 			// we became inactive this frame, so we have to decrease the count of entities to deactivate
-			gameLocal.numEntitiesToDeactivate--;
+			if ( ParallelThinkBatch *batch = ParallelThinkBatch::Current() ) {
+				batch->AddEntitiesToDeactivate( -1 );
+			} else {
+				gameLocal.numEntitiesToDeactivate--;
+			}
 		}
 	}
 }
@@ -2625,7 +2662,11 @@ void idEntity::BecomeInactive( int flags )
 	if ( thinkFlags ) {
 		thinkFlags &= ~flags;
 		if ( !thinkFlags && IsActive() ) {
-			gameLocal.numEntitiesToDeactivate++;
+			if ( ParallelThinkBatch *batch = ParallelThinkBatch::Current() ) {
+				batch->AddEntitiesToDeactivate( 1 );
+			} else {
+				gameLocal.numEntitiesToDeactivate++;
+			}
 		}
 	}
 
@@ -3565,6 +3606,25 @@ void idEntity::SaveDecalInfo( const idVec3 &origin, const idVec3 &dir, float dep
 	decals_list.push_back( di );
 }
 
+/*
+================
+idEntity::DeferPresent
+
+The render world is not thread-safe, so presenting from a parallel think job
+is replayed on the main thread once the job has finished.
+================
+*/
+bool idEntity::DeferPresent( void )
+{
+	ParallelThinkBatch *batch = ParallelThinkBatch::Current();
+	if ( batch == NULL )
+	{
+		return false;
+	}
+	batch->Present( this );
+	return true;
+}
+
 /*
 ================
 idEntity::Present
@@ -3574,6 +3634,11 @@ Present is called to allow entities to generate refEntities, lights, etc for the
 */
 void idEntity::Present(void)
 {
+	if ( DeferPresent() )
+	{
+		return;
+	}
+
 /*
 	if( m_bFrobable )
 	{
@@ -3983,6 +4048,13 @@ void idEntity::UpdateSound( void ) // grayman #4130
 {
 	if ( refSound.referenceSound )
 	{
+		if ( ParallelThinkBatch *batch = ParallelThinkBatch::Current() )
+		{
+			// sound emitters are shared with the sound thread
+			batch->UpdateSound( this );
+			return;
+		}
+
 		idVec3 origin;
 		idMat3 axis;
 
@@ -5368,7 +5440,10 @@ bool idEntity::RunPhysics( void ) {
 	}
 	endTime = gameLocal.time;
 
-	gameLocal.push.InitSavingPushedEntityPositions();
+	// pushers never think in parallel, so the shared push state is left alone there
+	if ( !ParallelThinkBatch::Current() ) {
+		gameLocal.push.InitSavingPushedEntityPositions();
+	}
 	blockedPart = NULL;
 
 	// save the physics state of the whole team and disable the team for collision detection
@@ -250,6 +250,7 @@ public:
 
 	idLinkList<idEntity>	spawnNode;				// for being linked into spawnedEntities list
 	int						activeIdx;				// for being linked into activeEntities list
+	bool					thinkInParallel;		// thought in a job this frame, see idGameLocal::RunParallelThink
 	int						lodIdx;					// for being linked into lodSystem
 
 	idLinkList<idEntity>	snapshotNode;			// for being linked into snapshotEntities list
@@ -508,6 +509,11 @@ public:
 
 	// thinking
 	virtual void			Think( void );
+	// True if Think() may run in a job this frame, see ParallelThinkBatch for the rules.
+	// Called on the main thread right before the think phase. Team members move
+	// each other, so classes that run physics should only allow lone entities.
+	virtual bool			IsParallelThinkSafe( void );
+	bool					CanThinkInParallel( void );
 
 	bool					CheckDormant( void );	//!< dormant == on the active list, but out of PVS
 	virtual	void			DormantBegin( void );	//!< called when entity becomes dormant
@@ -520,6 +526,8 @@ public:
 
 	// visuals
 	virtual void			Present( void );
+	// queues Present() for the main thread if called from a parallel think job
+	bool					DeferPresent( void );
 	virtual renderEntity_t *GetRenderEntity( void );
 	virtual int				GetModelDefHandle( void );
 	virtual void			SetModel( const char *modelname );
@@ -109,6 +109,9 @@ public:
 	// Saves the current game state, the session may have written some data to the file already.
 	virtual void				SaveGame( idFile *saveGameFile ) = 0;
 
+	// Waits until the last savegame is completely written, the end of it may still be written in the background after SaveGame.
+	virtual void				FinishSaveGame( void ) = 0;
+
 	// Shut down the current map.
 	virtual void				MapShutdown( void ) = 0;
 
@@ -229,7 +229,10 @@ idGameLocal::idGameLocal() :
 	m_MissionResult(MISSION_NOTEVENSTARTED),
 	m_HighestSRId(0),
 	m_searchManager(NULL), // grayman #3857
-	activeEntities(&idEntity::activeIdx)
+	activeEntities(&idEntity::activeIdx),
+	thinkJobList(NULL),
+	afSolverJobList(NULL),
+	animJobList(NULL)
 {
 	entities.SetNum( MAX_GENTITIES );
 	spawnIds.SetNum( MAX_GENTITIES );
@@ -257,6 +260,7 @@ void idGameLocal::Clear( void )
 	m_Timer.Clear();
 	m_StimEntity.Clear();
 	m_RespEntity.Clear();
+	m_StimBroadphase.Clear();
 
 	m_sndPropLoader = &g_SoundPropLoader;
 	m_sndProp = &g_SoundProp;
@@ -507,6 +511,12 @@ void idGameLocal::Init( void ) {
 	
 	smokeParticles = new idSmokeParticles;
 
+	thinkJobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_PARALLEL_THINK_BATCHES, 0, NULL );
+	afSolverJobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_AF_SOLVER_JOBS, 0, NULL );
+	animJobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_ANIM_FRAME_JOBS, 0, NULL );
+	rigidBodyIslands.Init();
+	m_StimBroadphase.Init();
+
 	// set up the aas
 	dict = FindEntityDefDict( "aas_types" );
 	if ( !dict ) {
@@ -725,6 +735,17 @@ void idGameLocal::Shutdown( void ) {
 	delete smokeParticles;
 	smokeParticles = NULL;
 
+	parallelJobManager->FreeJobList( thinkJobList );
+	thinkJobList = NULL;
+	parallelJobManager->FreeJobList( afSolverJobList );
+	afSolverJobList = NULL;
+	parallelJobManager->FreeJobList( animJobList );
+	animJobList = NULL;
+	animFrameAnimators.Clear();
+	rigidBodyIslands.Shutdown();
+	m_StimBroadphase.Shutdown();
+	idSaveGame::Shutdown();
+
 	idClass::Shutdown();
 
 	// clear list with forces
@@ -1095,6 +1116,15 @@ void idGameLocal::SaveGame( idFile *f ) {
 	GetLocalPlayer()->SendHUDMessage("#str_02916");	// "Game Saved"
 }
 
+/*
+===========
+idGameLocal::FinishSaveGame
+============
+*/
+void idGameLocal::FinishSaveGame( void ) {
+	idSaveGame::FinishWrite();
+}
+
 /*
 ===========
 idGameLocal::GetPersistentPlayerInfo
@@ -1375,6 +1405,48 @@ void idGameLocal::SetServerInfo( const idDict &_serverInfo ) {
 	serverInfo = _serverInfo;
 }
 
+/*
+===================
+ParseMapDecls
+
+Parses the entityDefs, skins, sound shaders and materials the map refers to
+at once, instead of on their first use while spawning or during gameplay.
+===================
+*/
+static void ParseMapDecls( idMapFile *map ) {
+	idStrList entityDefs, skins, sounds, materials;
+
+	for ( int e = 0; e < map->GetNumEntities(); e++ ) {
+		idMapEntity *ent = map->GetEntity( e );
+		const char *value;
+		if ( ent->epairs.GetString( "classname", "", &value ) ) {
+			entityDefs.Append( value );
+		}
+		if ( ent->epairs.GetString( "skin", "", &value ) ) {
+			skins.Append( value );
+		}
+		if ( ent->epairs.GetString( "s_shader", "", &value ) ) {
+			sounds.Append( value );
+		}
+		for ( int p = 0; p < ent->GetNumPrimitives(); p++ ) {
+			idMapPrimitive *prim = ent->GetPrimitive( p );
+			if ( prim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
+				idMapBrush *brush = static_cast<idMapBrush *>( prim );
+				for ( int s = 0; s < brush->GetNumSides(); s++ ) {
+					materials.Append( brush->GetSide( s )->GetMaterial() );
+				}
+			} else if ( prim->GetType() == idMapPrimitive::TYPE_PATCH ) {
+				materials.Append( static_cast<idMapPatch *>( prim )->GetMaterial() );
+			}
+		}
+	}
+
+	declManager->ParseDecls( DECL_ENTITYDEF, entityDefs );
+	declManager->ParseDecls( DECL_SKIN, skins );
+	declManager->ParseDecls( DECL_SOUND, sounds );
+	declManager->ParseDecls( DECL_MATERIAL, materials );
+}
+
 /*
 ===================
 idGameLocal::LoadMap
@@ -1437,6 +1509,8 @@ void idGameLocal::LoadMap( const char *mapName, int randseed ) {
 	}
 	mapFileName = mapFile->GetName();
 
+	ParseMapDecls( mapFile );
+
 	// load the collision map
 	collisionModelManager->LoadMap( mapFile );
 
@@ -1507,6 +1581,7 @@ void idGameLocal::LoadMap( const char *mapName, int randseed ) {
 
 	clip.Init();
 	pvs.Init();
+	m_StimBroadphase.SetWorldBounds( clip.GetWorldBounds() );
 
 
 	// this will always fail for now, have not yet written the map compile
@@ -2332,9 +2407,14 @@ bool idGameLocal::InitFromSaveGame( const char *mapName, idRenderWorld *renderWo
 
 	savegame.ReadInt(num);
 	m_RespEntity.SetNum(num);
+	m_StimBroadphase.Clear();
 	for (int i = 0; i < num; i++)
 	{
 		m_RespEntity[i].Restore(&savegame);
+		if (m_RespEntity[i].GetEntity() != NULL)
+		{
+			m_StimBroadphase.AddResponder(m_RespEntity[i].GetEntity());
+		}
 	}
 
 	m_EscapePointManager->Restore(&savegame);
@@ -2516,8 +2596,11 @@ void idGameLocal::MapShutdown( void ) {
 	// greebo: Don't clear the shop - MapShutdown() is called right before loading a map
 	// m_Shop->Clear();
 
+	// the predictions hold copies of clip models
+	rigidBodyIslands.Clear();
 	clip.Shutdown();
 	idClipModel::ClearTraceModelCache();
+	m_StimBroadphase.Clear();
 
 	mapFileName.Clear();
 
@@ -3327,8 +3410,20 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds, int timestepMs
 				TRACE_CPU_SCOPE( "ThinkAllEntities" )
 				num = 0;
 				bool timeentities = (g_timeentities.GetFloat() > 0.0);
+				if ( g_parallelThink.GetBool() && !timeentities && !( inCinematic && g_cinematic.GetBool() ) ) {
+					// parallel-safe entities think first, the serial loop below skips them
+					num += RunParallelThink();
+				}
+				if ( !( inCinematic && g_cinematic.GetBool() ) ) {
+					// the moving rigid bodies get their collision traces ahead of their think
+					rigidBodyIslands.Predict();
+				}
 				for ( auto iter = activeEntities.Begin(); iter; activeEntities.Next(iter) ) {
 					ent = iter.entity;
+					if ( ent->thinkInParallel ) {
+						ent->thinkInParallel = false;
+						continue;
+					}
 					if ( inCinematic && g_cinematic.GetBool() && !ent->cinematic ) {
 						ent->GetPhysics()->UpdateTime( time );
 						// grayman #2654 - update m_lastThinkTime to keep non-cinematic AI from dying at CrashLand()
@@ -3393,6 +3488,11 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds, int timestepMs
 			// grayman #3857 - Process the active searches
 			m_searchManager->ProcessSearches();
 
+			// the poses the renderer will ask for, before the player pvs is gone
+			if ( g_parallelAnim.GetBool() ) {
+				CreateAnimationFrames();
+			}
+
 			// free the player pvs
 			FreePlayerPVS();
 
@@ -6311,7 +6411,9 @@ void idGameLocal::RadiusDouse( const idVec3 &origin, const float radius, const b
 	idClip_EntityList entityList;
 	numListedEntities = clip.EntitiesTouchingBounds( bounds, -1, entityList );
 
-	// douse all flames that have a LOS from them to the origin
+	// collect the flames that could be doused, with a trace from the origin to each of them
+	idList<idLight *> lights;
+	idList<clipTrace_t> traces;
 	for ( int i = 0 ; i < numListedEntities ; i++ )
 	{
 		ent = entityList[i];
@@ -6356,17 +6458,29 @@ void idGameLocal::RadiusDouse( const idVec3 &origin, const float radius, const b
 					// test LOS between origin of force and light origin
 
 					// Light center is not just the light origin. There's an offset called "light_center", and there's orientation.
-					idVec3 trueOrigin = light->GetPhysics()->GetOrigin() + light->GetPhysics()->GetAxis()*light->GetRenderLight()->lightCenter;
-					trace_t result;
-					if ( !clip.TracePoint(result, origin, trueOrigin, MASK_OPAQUE, ignoreMe) )
-					{
-						// trace completed, so LOS exists
-						light->CallScriptFunctionArgs("frob_extinguish", true, 0, "e", light);
-					}
+					clipTrace_t &trace = traces.Alloc();
+					trace.start = origin;
+					trace.end = light->GetPhysics()->GetOrigin() + light->GetPhysics()->GetAxis()*light->GetRenderLight()->lightCenter;
+					trace.mdl = NULL;
+					trace.trmAxis = mat3_identity;
+					trace.contentMask = MASK_OPAQUE;
+					trace.passEntity = ignoreMe;
+					lights.Append(light);
 				}
 			}
 		}
 	}
+
+	// douse all flames that have a LOS from them to the origin
+	clip.TranslationBatch( traces.Ptr(), traces.Num(), true );
+	for ( int i = 0 ; i < lights.Num() ; i++ )
+	{
+		if ( traces[i].results.fraction >= 1.0f )
+		{
+			// trace completed, so LOS exists
+			lights[i]->CallScriptFunctionArgs("frob_extinguish", true, 0, "e", lights[i]);
+		}
+	}
 }
 
 /*
@@ -6997,6 +7111,7 @@ bool idGameLocal::AddResponse(idEntity *e)
 		idEntityPtr<idEntity> entPtr;
 		entPtr = e;
 		m_RespEntity.Append(entPtr);
+		m_StimBroadphase.AddResponder(e);
 	}
 
 	return rc;
@@ -7010,6 +7125,7 @@ void idGameLocal::RemoveResponse(idEntity *e)
 	if (i != -1)
 	{
 		m_RespEntity.RemoveIndex(i);
+		m_StimBroadphase.RemoveResponder(e);
 	}
 }
 
@@ -7508,11 +7624,19 @@ void idGameLocal::ProcessStimResponse(unsigned int ticks)
 		}
 	}
 
-	int n;
 	idBounds bounds;
 
 	idClip_EntityList srEntities;
 
+	// With the broadphase, stims are only collected by this loop.
+	// The entities they reach are found all at once afterwards and the responses
+	// are done in the same order as the stims were collected.
+	const bool batched = cv_sr_broadphase.GetInteger() > 0;
+	if (batched)
+	{
+		m_StimBroadphase.Update();
+	}
+
 	// Now check the rest of the stims.
 	for (int i = 0; i < m_StimEntity.Num(); i++)
 	{
@@ -7606,8 +7730,6 @@ void idGameLocal::ProcessStimResponse(unsigned int ticks)
 			if (radius != 0.0 || stim->m_bCollisionBased ||
 				stim->m_bUseEntBounds || stim->m_Bounds.GetVolume() > 0)
 			{
-				int numResponses = 0;
-
 				// Check if we have fixed bounds to work with (sr_bounds_mins & maxs set)
 				if (stim->m_Bounds.GetVolume() > 0) {
 					bounds = idBounds(stim->m_Bounds[0] + origin, stim->m_Bounds[1] + origin);
@@ -7628,10 +7750,20 @@ void idGameLocal::ProcessStimResponse(unsigned int ticks)
 					bounds.ExpandSelf(radius);
 				}
 
+				if (batched)
+				{
+					stimQuery_t& query = m_StimBroadphase.AddQuery();
+					query.stim = stim;
+					query.owner = entity;
+					query.origin = origin;
+					query.bounds = bounds;
+					query.collision = stim->m_bCollisionBased;
+				}
+
 				// Collision-based stims
 				if (stim->m_bCollisionBased)
 				{
-					n = stim->m_CollisionEnts.Num();
+					int n = stim->m_CollisionEnts.Num();
 
 					srEntities.SetNum(n);
 					for (int n2 = 0; n2 < n; n2++)
@@ -7639,42 +7771,95 @@ void idGameLocal::ProcessStimResponse(unsigned int ticks)
 						srEntities[n2] = stim->m_CollisionEnts[n2];
 					}
 
+					if (batched)
+					{
+						stimQuery_t& query = m_StimBroadphase.GetQuery(m_StimBroadphase.NumQueries() - 1);
+						query.entities.SetNum(n, false);
+						for (int n2 = 0; n2 < n; n2++)
+						{
+							query.entities[n2] = stim->m_CollisionEnts[n2];
+						}
+					}
+
 					// clear the collision vars for the next frame
 					stim->m_bCollisionFired = false;
 					stim->m_CollisionEnts.Clear();
 				}
-				else 
+				else if (!batched)
 				{
 					// Radius based stims
-					n = clip.EntitiesTouchingBounds(bounds, CONTENTS_RESPONSE, srEntities);
+					clip.EntitiesTouchingBounds(bounds, CONTENTS_RESPONSE, srEntities);
 					//DM_LOG(LC_STIM_RESPONSE, LT_INFO)LOGSTRING("Entities touching bounds: %d\r", n);
 				}
-				
-				if (n > 0)
-				{
-					if (cv_sr_show.GetInteger() > 1)
-					{
-						for (int n2 = 0; n2 < n; ++n2)
-						{
-							// Show failed S/R
-							gameRenderWorld->DebugArrow( colorRed, bounds.GetCenter(), srEntities[n2]->GetPhysics()->GetOrigin(), 1, 4 * USERCMD_MSEC );
-						}
-					}
 
-					// Do responses for entities within the radius of the stim
-					numResponses = DoResponseAction(stim, srEntities, entity, origin);
+				if (!batched)
+				{
+					FireStim(stim, entity, origin, bounds, srEntities);
 				}
+			}
+		}
+	}
 
-				// The stim has fired, let it do any post-firing activity it may have
-				stim->PostFired(numResponses);
+	if (batched)
+	{
+		m_StimBroadphase.RunQueries(cv_sr_broadphase.GetInteger() > 1);
+
+		for (int i = 0; i < m_StimBroadphase.NumQueries(); i++)
+		{
+			const stimQuery_t& query = m_StimBroadphase.GetQuery(i);
+
+			// an earlier response may have removed the stim, its owner or the entities it reached
+			idEntity* entity = query.owner.GetEntity();
+			if (entity == NULL || query.stim->m_State == SS_DISABLED ||
+				entity->GetStimResponseCollection()->GetStimByType(query.stim->m_StimTypeId) != query.stim)
+			{
+				continue;
+			}
+
+			srEntities.Clear();
+			for (int j = 0; j < query.entities.Num(); j++)
+			{
+				idEntity* ent = query.entities[j].GetEntity();
+				if (ent != NULL)
+				{
+					srEntities.AddGrow(ent);
+				}
 			}
+
+			FireStim(query.stim, entity, query.origin, query.bounds, srEntities);
 		}
+
+		m_StimBroadphase.ClearQueries();
 	}
 
 	srTimer.Stop();
 	DM_LOG(LC_STIM_RESPONSE, LT_INFO)LOGSTRING("Processing S/R took %lf\r", srTimer.Milliseconds());
 }
 
+void idGameLocal::FireStim(const CStimPtr& stim, idEntity* entity, const idVec3& origin, const idBounds& bounds, const idClip_EntityList& srEntities)
+{
+	int numResponses = 0;
+	int n = srEntities.Num();
+
+	if (n > 0)
+	{
+		if (cv_sr_show.GetInteger() > 1)
+		{
+			for (int n2 = 0; n2 < n; ++n2)
+			{
+				// Show failed S/R
+				gameRenderWorld->DebugArrow( colorRed, bounds.GetCenter(), srEntities[n2]->GetPhysics()->GetOrigin(), 1, 4 * USERCMD_MSEC );
+			}
+		}
+
+		// Do responses for entities within the radius of the stim
+		numResponses = DoResponseAction(stim, srEntities, entity, origin);
+	}
+
+	// The stim has fired, let it do any post-firing activity it may have
+	stim->PostFired(numResponses);
+}
+
 /*
 ===================
 Dark Mod:
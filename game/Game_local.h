@@ -104,6 +104,7 @@ void gameError( const char *fmt, ... );
 
 #include "physics/Clip.h"
 #include "physics/Push.h"
+#include "physics/RigidBodyIslands.h"
 
 #include "Pvs.h"
 
@@ -116,6 +117,7 @@ void gameError( const char *fmt, ... );
 #include "LightController.h"
 #include "ModMenu.h"
 #include "LodComponent.h"
+#include "ParallelThink.h"
 
 #ifdef __linux__
 #include "../renderer/RenderWorld.h"
@@ -372,6 +374,7 @@ private:
 // idEntityPtr Definition should be moved to lightgem.h. - J.C.Denton
 
 #include "LightGem.h"
+#include "StimResponse/StimBroadphase.h"
 //============================================================================
 
 // grayman #3424 - These are the events that are considered suspicious, in that they raise
@@ -438,6 +441,13 @@ public:
 	idLinkList<idAI>		spawnedAI;				// greebo: all spawned AI
 	LodSystem				lodSystem;				// container for all entities with LOD
 	int						numEntitiesToDeactivate;// number of entities that became inactive in current frame
+	idParallelJobList *		thinkJobList;			// runs the entities that can think in parallel, see g_parallelThink
+	idParallelJobList *		afSolverJobList;		// solves the auxiliary constraints of large articulated figures, see af_batchSolver
+	idParallelJobList *		animJobList;			// creates the poses of the animated entities, see g_parallelAnim
+	animFrameJob_t			animFrameJobs[MAX_ANIM_FRAME_JOBS];
+	idList<idAnimator *>	animFrameAnimators;
+	ParallelThinkBatch		parallelThinkBatches[MAX_PARALLEL_THINK_BATCHES];
+	idList<idEntity *>		parallelThinkers;
 	idDict					persistentLevelInfo;	// contains args that are kept around between levels
 
 	// The inventory class which keeps items safe between maps
@@ -485,6 +495,7 @@ public:
 
 	idClip					clip;					// collision detection
 	idPush					push;					// geometric pushing
+	idRigidBodyIslands		rigidBodyIslands;		// predicts the collisions of moving rigid bodies, see rb_islands
 	idPVS					pvs;					// potential visible set
 
 	idTestModel *			testmodel;				// for development testing of models
@@ -603,6 +614,7 @@ public:
 	idList<CStim *>			m_StimTimer;			// All stims that have a timer associated. 
 	idList< idEntityPtr<idEntity> >		m_StimEntity;			// all entities that currently have a stim regardless of it's state
 	idList< idEntityPtr<idEntity> >		m_RespEntity;			// all entities that currently have a response regardless of it's state
+	CStimBroadphase			m_StimBroadphase;		// finds the entities of m_RespEntity reached by stims
 
 	int						cinematicSkipTime;		// don't allow skipping cinemetics until this time has passed so player doesn't skip out accidently from a firefight
 	int						cinematicStopTime;		// cinematics have several camera changes, so keep track of when we stop them so that we don't reset cinematicSkipTime unnecessarily
@@ -692,6 +704,7 @@ public:
 	virtual void			InitFromNewMap( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, bool isServer, bool isClient, int randSeed );
 	virtual bool			InitFromSaveGame( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, idFile *saveGameFile );
 	virtual void			SaveGame( idFile *saveGameFile );
+	virtual void			FinishSaveGame( void );
 	virtual void			MapShutdown( void );
 	virtual void			CacheDictionaryMedia( const idDict *dict );
 	virtual void			SpawnPlayer( int clientNum );
@@ -922,6 +935,11 @@ public:
 	 */
 	void					ProcessStimResponse(unsigned int ticks);
 
+	/**
+	 * Lets a stim which passed all its checks act on the given entities, see ProcessStimResponse.
+	 */
+	void					FireStim(const CStimPtr& stim, idEntity* entity, const idVec3& origin, const idBounds& bounds, const idClip_EntityList& srEntities);
+
 	/**
 	 * greebo: Traverses the entities and tries to find the Stim/Response with the given ID.
 	 * This is expensive, so don't call this during map runtime, only in between maps.
@@ -1048,6 +1066,8 @@ private:
 	void					FreePlayerPVS( void );
 	void					UpdateGravity( void );
 	void					SortActiveEntityList( void );
+	int						RunParallelThink( void );
+	void					CreateAnimationFrames( void );
 	void					ShowTargets( void );
 	void					RunDebugInfo( void );
 
@@ -1101,6 +1101,10 @@ idLight::Present
 ================
 */
 void idLight::Present( void ) {
+	if ( DeferPresent() ) {
+		return;
+	}
+
 	// don't present to the renderer if the entity hasn't changed
 	if ( !( thinkFlags & TH_UPDATEVISUALS ) ) {
 		return;
@@ -1272,6 +1276,18 @@ void idLight::Think( void ) {
 	idEntity::Think();
 }
 
+/*
+================
+idLight::IsParallelThinkSafe
+
+Fading and the periodic dousing check can switch the light and run scripts,
+the remaining think only presents the light.
+================
+*/
+bool idLight::IsParallelThinkSafe( void ) {
+	return GetTeamMaster() == NULL && fadeEnd <= 0 && gameLocal.time < nextTimeVerticalCheck;
+}
+
 /*
 ================
 idLight::GetPhysicsToSoundTransform
@@ -3073,6 +3073,17 @@ void idMover_Periodic::Think( void ) {
 	Present();
 }
 
+/*
+================
+idMover_Periodic::IsParallelThinkSafe
+
+Movers that push others have to run serially, the rest only move their own clip model.
+================
+*/
+bool idMover_Periodic::IsParallelThinkSafe( void ) {
+	return GetTeamMaster() == NULL && !physicsObj.IsPusher();
+}
+
 /*
 ===============
 idMover_Periodic::Event_TeamBlocked
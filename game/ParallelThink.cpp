@@ -0,0 +1,274 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "Game_local.h"
+#include "ParallelThink.h"
+
+idSysMutex ParallelThinkBatch::eventMutex;
+thread_local ParallelThinkBatch *ParallelThinkBatch::current = NULL;
+
+/*
+================
+ParallelThinkBatch::ParallelThinkBatch
+================
+*/
+ParallelThinkBatch::ParallelThinkBatch( void ) {
+	numEntitiesToDeactivate = 0;
+	numThought = 0;
+	thinker = NULL;
+}
+
+/*
+================
+ParallelThinkBatch::Clear
+================
+*/
+void ParallelThinkBatch::Clear( void ) {
+	entities.SetNum( 0, false );
+	ops.SetNum( 0, false );
+	numEntitiesToDeactivate = 0;
+	numThought = 0;
+}
+
+/*
+================
+ParallelThinkBatch::Run
+================
+*/
+void ParallelThinkBatch::Run( void ) {
+	assert( current == NULL );
+	current = this;
+
+	for ( int i = 0; i < entities.Num(); i++ ) {
+		idEntity *ent = entities[i];
+		TRACE_CPU_SCOPE_STR( "Entity:Think", ent->name )
+		thinker = ent;
+		ent->Think();
+		numThought++;
+	}
+
+	thinker = NULL;
+	current = NULL;
+}
+
+/*
+================
+ParallelThinkBatch::Apply
+================
+*/
+int ParallelThinkBatch::Apply( void ) {
+	assert( current == NULL );
+
+	for ( int i = 0; i < ops.Num(); i++ ) {
+		const deferredOp_t &op = ops[i];
+		switch ( op.type ) {
+			case OP_POST_EVENT:
+				op.event->Schedule( static_cast<idClass *>( op.object ), static_cast<const idTypeInfo *>( op.param ), op.time );
+				break;
+			case OP_CANCEL_EVENTS:
+				idEvent::CancelEvents( static_cast<const idClass *>( op.object ), static_cast<const idEventDef *>( op.param ) );
+				break;
+			case OP_LINK_CLIP:
+				static_cast<idClipModel *>( op.object )->Link( *const_cast<idClip *>( static_cast<const idClip *>( op.param ) ) );
+				break;
+			case OP_UNLINK_CLIP:
+				static_cast<idClipModel *>( op.object )->Unlink();
+				break;
+			case OP_PRESENT:
+				static_cast<idEntity *>( op.object )->Present();
+				break;
+			case OP_UPDATE_SOUND:
+				static_cast<idEntity *>( op.object )->UpdateSound();
+				break;
+			case OP_BECOME_ACTIVE:
+				static_cast<idEntity *>( op.object )->BecomeActive( op.time );
+				break;
+		}
+	}
+	gameLocal.numEntitiesToDeactivate += numEntitiesToDeactivate;
+
+	int num = numThought;
+	Clear();
+	return num;
+}
+
+/*
+================
+ParallelThinkBatch::PostEvent
+
+The event is allocated right away, so that the arguments are copied while they are still valid,
+but it is only put into the event queue by Apply().
+================
+*/
+void ParallelThinkBatch::PostEvent( const idEventDef *ev, int numargs, va_list args, idClass *obj, const idTypeInfo *type, int time ) {
+	deferredOp_t &op = ops.Alloc();
+	op.type = OP_POST_EVENT;
+	op.object = obj;
+	op.param = type;
+	op.time = time;
+
+	idScopedCriticalSection lock( eventMutex );
+	op.event = idEvent::Alloc( ev, numargs, args );
+}
+
+/*
+================
+ParallelThinkBatch::CancelEvents
+================
+*/
+void ParallelThinkBatch::CancelEvents( const idClass *obj, const idEventDef *ev ) {
+	deferredOp_t &op = ops.Alloc();
+	op.type = OP_CANCEL_EVENTS;
+	op.object = const_cast<idClass *>( obj );
+	op.param = ev;
+	op.event = NULL;
+	op.time = 0;
+}
+
+/*
+================
+ParallelThinkBatch::LinkClipModel
+================
+*/
+void ParallelThinkBatch::LinkClipModel( idClipModel *clipModel, idClip *clip ) {
+	deferredOp_t &op = ops.Alloc();
+	op.type = OP_LINK_CLIP;
+	op.object = clipModel;
+	op.param = clip;
+	op.event = NULL;
+	op.time = 0;
+}
+
+/*
+================
+ParallelThinkBatch::UnlinkClipModel
+================
+*/
+void ParallelThinkBatch::UnlinkClipModel( idClipModel *clipModel ) {
+	deferredOp_t &op = ops.Alloc();
+	op.type = OP_UNLINK_CLIP;
+	op.object = clipModel;
+	op.param = NULL;
+	op.event = NULL;
+	op.time = 0;
+}
+
+/*
+================
+ParallelThinkBatch::Present
+================
+*/
+void ParallelThinkBatch::Present( idEntity *ent ) {
+	// classes like idFuncEmitter present more than once per think
+	if ( ops.Num() > 0 && ops[ops.Num() - 1].type == OP_PRESENT && ops[ops.Num() - 1].object == ent ) {
+		return;
+	}
+	deferredOp_t &op = ops.Alloc();
+	op.type = OP_PRESENT;
+	op.object = ent;
+	op.param = NULL;
+	op.event = NULL;
+	op.time = 0;
+}
+
+/*
+================
+ParallelThinkBatch::UpdateSound
+================
+*/
+void ParallelThinkBatch::UpdateSound( idEntity *ent ) {
+	deferredOp_t &op = ops.Alloc();
+	op.type = OP_UPDATE_SOUND;
+	op.object = ent;
+	op.param = NULL;
+	op.event = NULL;
+	op.time = 0;
+}
+
+/*
+================
+ParallelThinkBatch::BecomeActive
+
+Think flags of other entities and the active entity list are only changed by Apply().
+================
+*/
+void ParallelThinkBatch::BecomeActive( idEntity *ent, int flags ) {
+	deferredOp_t &op = ops.Alloc();
+	op.type = OP_BECOME_ACTIVE;
+	op.object = ent;
+	op.param = NULL;
+	op.event = NULL;
+	op.time = flags;
+}
+
+/*
+================
+RunParallelThinkBatch
+================
+*/
+static void RunParallelThinkBatch( ParallelThinkBatch *batch ) {
+	batch->Run();
+}
+
+REGISTER_PARALLEL_JOB( RunParallelThinkBatch, "RunParallelThinkBatch" );
+
+/*
+================
+idGameLocal::RunParallelThink
+
+Thinks the active entities that can think in parallel in jobs,
+then applies their deferred side effects in active list order.
+Returns the number of entities that thought.
+================
+*/
+int idGameLocal::RunParallelThink( void ) {
+	TRACE_CPU_SCOPE( "ParallelThink" )
+	static const int MIN_ENTITIES_PER_BATCH = 8;
+
+	idList<idEntity *> &thinkers = parallelThinkers;
+	thinkers.SetNum( 0, false );
+	for ( auto iter = activeEntities.Begin(); iter; activeEntities.Next( iter ) ) {
+		idEntity *ent = iter.entity;
+		ent->thinkInParallel = ent->CanThinkInParallel();
+		if ( ent->thinkInParallel ) {
+			thinkers.Append( ent );
+		}
+	}
+	if ( thinkers.Num() == 0 ) {
+		return 0;
+	}
+
+	int numBatches = ( thinkers.Num() + MIN_ENTITIES_PER_BATCH - 1 ) / MIN_ENTITIES_PER_BATCH;
+	numBatches = Min( numBatches, MAX_PARALLEL_THINK_BATCHES );
+	for ( int i = 0; i < numBatches; i++ ) {
+		ParallelThinkBatch &batch = parallelThinkBatches[i];
+		const int first = thinkers.Num() * i / numBatches;
+		const int last = thinkers.Num() * ( i + 1 ) / numBatches;
+		for ( int j = first; j < last; j++ ) {
+			batch.entities.Append( thinkers[j] );
+		}
+		thinkJobList->AddJob( ( jobRun_t )RunParallelThinkBatch, &batch );
+	}
+	thinkJobList->Submit();
+	thinkJobList->Wait();
+
+	int num = 0;
+	for ( int i = 0; i < numBatches; i++ ) {
+		num += parallelThinkBatches[i].Apply();
+	}
+	return num;
+}
@@ -0,0 +1,97 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+#ifndef __PARALLEL_THINK_H__
+#define __PARALLEL_THINK_H__
+
+class idEntity;
+class idEvent;
+class idEventDef;
+class idClass;
+class idTypeInfo;
+class idClipModel;
+class idClip;
+
+#define MAX_PARALLEL_THINK_BATCHES		64
+
+/*
+ * A group of entities which run Think() inside a job, see idGameLocal::RunParallelThink.
+ *
+ * Only entities whose class overrides idEntity::IsParallelThinkSafe take part.
+ * Their Think may read the world and other entities, and write its own members.
+ * Everything else that touches state shared between entities is recorded here
+ * while the batch runs, and replayed on the main thread afterward in the order
+ * it was requested:
+ *  - posting and cancelling events
+ *  - linking and unlinking clip models
+ *  - presenting the entity to the renderer and updating its sound emitter
+ *  - changes to the number of entities to deactivate
+ *  - activating entities other than the one thinking
+ */
+class ParallelThinkBatch {
+public:
+							ParallelThinkBatch( void );
+
+	// the batch running on the calling thread, NULL outside of the parallel think phase
+	static ParallelThinkBatch *	Current( void ) { return current; }
+
+	void					Clear( void );
+	// job body: thinks all entities of the batch
+	void					Run( void );
+	// main thread: replays the deferred operations, returns the number of entities that thought
+	int						Apply( void );
+
+	void					PostEvent( const idEventDef *ev, int numargs, va_list args, idClass *obj, const idTypeInfo *type, int time );
+	void					CancelEvents( const idClass *obj, const idEventDef *ev );
+	void					LinkClipModel( idClipModel *clipModel, idClip *clip );
+	void					UnlinkClipModel( idClipModel *clipModel );
+	void					Present( idEntity *ent );
+	void					UpdateSound( idEntity *ent );
+	void					BecomeActive( idEntity *ent, int flags );
+	void					AddEntitiesToDeactivate( int count ) { numEntitiesToDeactivate += count; }
+	// the entity whose Think is running
+	idEntity *				Thinker( void ) const { return thinker; }
+
+	idList<idEntity *>		entities;
+
+private:
+	typedef enum {
+		OP_POST_EVENT,
+		OP_CANCEL_EVENTS,
+		OP_LINK_CLIP,
+		OP_UNLINK_CLIP,
+		OP_PRESENT,
+		OP_UPDATE_SOUND,
+		OP_BECOME_ACTIVE
+	} opType_t;
+
+	typedef struct {
+		opType_t			type;
+		void *				object;
+		const void *		param;
+		idEvent *			event;
+		int					time;			// or think flags for OP_BECOME_ACTIVE
+	} deferredOp_t;
+
+	idList<deferredOp_t>	ops;
+	int						numEntitiesToDeactivate;
+	int						numThought;
+	idEntity *				thinker;
+
+	// events are allocated from a shared pool
+	static idSysMutex		eventMutex;
+	static thread_local ParallelThinkBatch *current;
+};
+
+#endif /* !__PARALLEL_THINK_H__ */
@@ -0,0 +1,334 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+#include "precompiled.h"
+#pragma hdrstop
+
+
+
+#include "StimBroadphase.h"
+#include "../Game_local.h"
+#include "../AFEntity.h"
+
+// queries are only split into jobs when there are at least this many per job
+static const int MIN_QUERIES_PER_JOB = 16;
+
+CStimBroadphase::CStimBroadphase() :
+	m_OctreeValid(false),
+	m_JobList(NULL)
+{}
+
+CStimBroadphase::~CStimBroadphase()
+{
+	Clear();
+}
+
+void CStimBroadphase::Init()
+{
+	m_JobList = parallelJobManager->AllocJobList(JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_STIM_QUERY_JOBS, 0, NULL);
+}
+
+void CStimBroadphase::Shutdown()
+{
+	m_OctreeValid = false;
+	Clear();
+
+	parallelJobManager->FreeJobList(m_JobList);
+	m_JobList = NULL;
+}
+
+void CStimBroadphase::SetWorldBounds(const idBounds &worldBounds)
+{
+	// same cube as the one of idClip
+	m_WorldCube = idBounds(worldBounds.GetCenter());
+	m_WorldCube.ExpandSelf((worldBounds[1] - worldBounds[0]).Max() * 0.5f);
+	m_OctreeValid = true;
+
+	Clear();
+}
+
+void CStimBroadphase::Clear()
+{
+	// the octree accesses the handles of its objects, so clear it first
+	m_Octree.Clear();
+	if (m_OctreeValid)
+	{
+		m_Octree.Init(m_WorldCube, [](idBoxOctree::Pointer ptr) -> idBoxOctreeHandle& {
+			return ((responder_t*)ptr)->octreeHandle;
+		});
+	}
+
+	for (int i = 0; i < m_Responders.Num(); i++)
+	{
+		m_Responders[i]->entity = NULL;
+		m_ResponderAllocator.Free(m_Responders[i]);
+	}
+	m_Responders.Clear();
+	ClearQueries();
+}
+
+void CStimBroadphase::AddResponder(idEntity *ent)
+{
+	// idGameLocal::AddResponse takes care of duplicates,
+	// the bounds are set by the next Update()
+	responder_t *responder = m_ResponderAllocator.Alloc();
+	responder->entity = ent;
+	responder->bounds.Clear();
+	m_Responders.Append(responder);
+}
+
+void CStimBroadphase::RemoveResponder(idEntity *ent)
+{
+	for (int i = 0; i < m_Responders.Num(); i++)
+	{
+		if (m_Responders[i]->entity.GetEntity() == ent)
+		{
+			UnlinkResponder(m_Responders[i]);
+			m_Responders[i]->entity = NULL;
+			m_ResponderAllocator.Free(m_Responders[i]);
+			m_Responders.RemoveIndex(i, false);
+			return;
+		}
+	}
+}
+
+void CStimBroadphase::UnlinkResponder(responder_t *responder)
+{
+	if (responder->octreeHandle.IsLinked())
+	{
+		m_Octree.Remove(responder);
+	}
+}
+
+void CStimBroadphase::GetClipModels(idEntity *ent, clipModelList_t &list)
+{
+	list.Clear();
+
+	idPhysics *physics = ent->GetPhysics();
+	for (int i = 0; i < physics->GetNumClipModels(); i++)
+	{
+		idClipModel *clipModel = physics->GetClipModel(i);
+		if (clipModel != NULL)
+		{
+			list.AddGrow(clipModel);
+		}
+	}
+
+	// heads and ragdolls carry the response on their combat model too
+	idClipModel *combatModel = NULL;
+	if (ent->IsType(idAFAttachment::Type))
+	{
+		combatModel = static_cast<idAFAttachment*>(ent)->GetCombatModel();
+	}
+	else if (ent->IsType(idAFEntity_Base::Type))
+	{
+		combatModel = static_cast<idAFEntity_Base*>(ent)->GetCombatModel();
+	}
+	if (combatModel != NULL)
+	{
+		list.AddGrow(combatModel);
+	}
+}
+
+void CStimBroadphase::Update()
+{
+	if (!m_OctreeValid)
+	{
+		return;
+	}
+
+	clipModelList_t clipModels;
+
+	for (int i = 0; i < m_Responders.Num(); i++)
+	{
+		responder_t *responder = m_Responders[i];
+		idEntity *ent = responder->entity.GetEntity();
+
+		if (ent == NULL)
+		{
+			// deleted without RemoveResponse
+			UnlinkResponder(responder);
+			m_ResponderAllocator.Free(responder);
+			m_Responders.RemoveIndex(i--, false);
+			continue;
+		}
+
+		// the responder covers all linked clip models of the entity,
+		// RunQuery checks their contents
+		idBounds bounds;
+		bounds.Clear();
+
+		GetClipModels(ent, clipModels);
+		for (int j = 0; j < clipModels.Num(); j++)
+		{
+			if (clipModels[j]->IsLinked())
+			{
+				bounds.AddBounds(clipModels[j]->GetAbsBounds());
+			}
+		}
+
+		if (bounds.IsCleared())
+		{
+			UnlinkResponder(responder);
+		}
+		else if (!responder->octreeHandle.IsLinked())
+		{
+			m_Octree.Add(responder, bounds);
+		}
+		else if (bounds != responder->bounds)
+		{
+			// only responders which have moved are relinked
+			m_Octree.Update(responder, bounds);
+		}
+		responder->bounds = bounds;
+	}
+}
+
+stimQuery_t &CStimBroadphase::AddQuery()
+{
+	stimQuery_t &query = m_Queries.Alloc();
+	query.stim.reset();
+	query.owner = NULL;
+	query.origin.Zero();
+	query.bounds.Clear();
+	query.collision = false;
+	query.entities.SetNum(0, false);
+	return query;
+}
+
+void CStimBroadphase::ClearQueries()
+{
+	// keep the memory of the result lists
+	for (int i = 0; i < m_Queries.Num(); i++)
+	{
+		m_Queries[i].stim.reset();
+	}
+	m_Queries.SetNum(0, false);
+}
+
+void CStimBroadphase::RunQuery(stimQuery_t &query) const
+{
+	// same as idClip::ClipModelsTouchingBounds
+	idBounds queryBox = query.bounds;
+	queryBox.ExpandSelf(CM_BOX_EPSILON);
+
+	idBoxOctree::QueryResult res;
+	m_Octree.QueryInBox(queryBox, res);
+
+	clipModelList_t clipModels;
+	idClip_EntityList found;
+
+	for (int i = 0; i < res.Num(); i++)
+	{
+		const idBoxOctree::Chunk *chunk = res[i];
+
+		for (int j = 0; j < chunk->num; j++)
+		{
+			if (!chunk->arr[j].bounds.IntersectsBounds(queryBox))
+			{
+				continue;
+			}
+
+			const responder_t *responder = (const responder_t*)chunk->arr[j].object;
+			idEntity *ent = responder->entity.GetEntity();
+			if (ent == NULL)
+			{
+				continue;
+			}
+
+			GetClipModels(ent, clipModels);
+			for (int k = 0; k < clipModels.Num(); k++)
+			{
+				const idClipModel *clipModel = clipModels[k];
+
+				if (!(clipModel->GetContents() & CONTENTS_RESPONSE) || !clipModel->IsEnabled() || !clipModel->IsLinked())
+				{
+					continue;
+				}
+
+				if (!clipModel->GetAbsBounds().IntersectsBounds(queryBox))
+				{
+					continue;
+				}
+
+				// an entity can use several clip models
+				idEntity *touched = clipModel->GetEntity();
+				int l;
+				for (l = 0; l < found.Num(); l++)
+				{
+					if (found[l] == touched)
+					{
+						break;
+					}
+				}
+				if (l >= found.Num())
+				{
+					found.AddGrow(touched);
+				}
+			}
+		}
+	}
+
+	query.entities.SetNum(found.Num(), false);
+	for (int i = 0; i < found.Num(); i++)
+	{
+		query.entities[i] = found[i];
+	}
+}
+
+void RunStimQueryBatch(CStimBroadphase::queryBatch_t *batch)
+{
+	for (int i = batch->first; i < batch->last; i++)
+	{
+		stimQuery_t &query = batch->broadphase->m_Queries[i];
+		if (!query.collision)
+		{
+			batch->broadphase->RunQuery(query);
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB(RunStimQueryBatch, "RunStimQueryBatch");
+
+void CStimBroadphase::RunQueries(bool parallel)
+{
+	TRACE_CPU_SCOPE("StimBroadphase:Query")
+
+	int numJobs = 1;
+	if (parallel && m_JobList != NULL)
+	{
+		numJobs = idMath::ClampInt(1, MAX_STIM_QUERY_JOBS, m_Queries.Num() / MIN_QUERIES_PER_JOB);
+	}
+
+	for (int i = 0; i < numJobs; i++)
+	{
+		queryBatch_t &batch = m_Batches[i];
+		batch.broadphase = this;
+		batch.first = m_Queries.Num() * i / numJobs;
+		batch.last = m_Queries.Num() * (i + 1) / numJobs;
+	}
+
+	if (numJobs == 1)
+	{
+		RunStimQueryBatch(&m_Batches[0]);
+		return;
+	}
+
+	for (int i = 0; i < numJobs; i++)
+	{
+		m_JobList->AddJob((jobRun_t)RunStimQueryBatch, &m_Batches[i]);
+	}
+	m_JobList->Submit();
+	m_JobList->Wait();
+}
@@ -0,0 +1,115 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+#ifndef SR_STIMBROADPHASE__H
+#define SR_STIMBROADPHASE__H
+
+class idParallelJobList;
+
+#define MAX_STIM_QUERY_JOBS		32
+
+/**
+ * A stim which passed all checks in idGameLocal::ProcessStimResponse this frame
+ * and waits for the entities it reaches.
+ */
+struct stimQuery_t
+{
+	CStimPtr							stim;
+	idEntityPtr<idEntity>				owner;
+	idVec3								origin;
+	idBounds							bounds;
+	// collision based stims already know their entities, they are not queried
+	bool								collision;
+	idList< idEntityPtr<idEntity> >		entities;
+};
+
+/**
+ * CStimBroadphase finds the responders touched by the stims of a frame.
+ *
+ * Only entities registered with idGameLocal::AddResponse are kept in the octree,
+ * so a query does not wade through all the clip models of the world like
+ * idClip::EntitiesTouchingBounds does. Update() refreshes the bounds of the
+ * responders once per frame and only relinks those which have moved.
+ *
+ * All queries of a frame are collected first and answered together by RunQueries(),
+ * in jobs if there are many of them. The results are the same as those of
+ * idClip::EntitiesTouchingBounds with CONTENTS_RESPONSE, except for their order.
+ */
+class CStimBroadphase
+{
+public:
+	CStimBroadphase();
+	~CStimBroadphase();
+
+	// allocates the job list, called once on game init
+	void				Init();
+	void				Shutdown();
+
+	// must be called when a map is loaded, before any responder is updated
+	void				SetWorldBounds(const idBounds &worldBounds);
+	// removes all responders and queries
+	void				Clear();
+
+	void				AddResponder(idEntity *ent);
+	void				RemoveResponder(idEntity *ent);
+
+	// brings the bounds of the responders up-to-date, call before RunQueries
+	void				Update();
+
+	stimQuery_t &		AddQuery();
+	int					NumQueries() const { return m_Queries.Num(); }
+	stimQuery_t &		GetQuery(int index) { return m_Queries[index]; }
+	void				ClearQueries();
+
+	// finds the entities for all queries which are not collision based
+	void				RunQueries(bool parallel);
+
+private:
+	struct responder_t
+	{
+		idEntityPtr<idEntity>	entity;
+		idBoxOctreeHandle		octreeHandle;
+		idBounds				bounds;			// union of the linked clip models
+	};
+
+	struct queryBatch_t
+	{
+		CStimBroadphase *		broadphase;
+		int						first;
+		int						last;
+	};
+
+	// the clip models which may carry CONTENTS_RESPONSE for this entity
+	typedef idFlexList<idClipModel *, 8> clipModelList_t;
+	static void			GetClipModels(idEntity *ent, clipModelList_t &list);
+
+	void				UnlinkResponder(responder_t *responder);
+	void				RunQuery(stimQuery_t &query) const;
+
+	idBoxOctree					m_Octree;
+	idBounds					m_WorldCube;
+	bool						m_OctreeValid;
+
+	idList<responder_t *>		m_Responders;
+	idBlockAlloc<responder_t, 256>	m_ResponderAllocator;
+
+	idList<stimQuery_t>			m_Queries;
+
+	idParallelJobList *			m_JobList;
+	queryBatch_t				m_Batches[MAX_STIM_QUERY_JOBS];
+
+	friend void RunStimQueryBatch(queryBatch_t *batch);
+};
+
+#endif /* SR_STIMBROADPHASE__H */
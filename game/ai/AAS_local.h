@@ -28,6 +28,8 @@ class idRoutingCache {
 
 public:
 								idRoutingCache( int size );
+								// precomputed cache using memory owned by idAASLocal
+								idRoutingCache( int size, unsigned short *travelTimes, byte *reachabilities );
 								~idRoutingCache( void );
 
 	int							Size( void ) const;
@@ -45,6 +47,10 @@ private:
 	unsigned short				startTravelTime;		// travel time to start with
 	unsigned char *				reachabilities;			// reachabilities used for routing
 	unsigned short *			travelTimes;			// travel time for every area
+	unsigned int *				usedClusters;			// portal cache: bit set of the clusters the cache was flooded through
+	int							numUsedClusterWords;	// number of words in usedClusters
+	bool						precomputed;			// filled by PrecomputeRoutingCache, never evicted
+	bool						invalid;				// precomputed cache which must be updated before use
 };
 
 
@@ -74,6 +80,7 @@ private:
 
 
 class CMultiStateMover;
+struct routingPrecomputeJob_t;
 namespace eas { class tdmEAS; }
 
 class idAASLocal : 
@@ -205,6 +212,9 @@ private:	// routing data
 	mutable idRoutingCache *	cacheListEnd;			// end of list with cache sorted from oldest to newest
 	mutable int					totalCacheMemory;		// total cache memory used
 	idList<idRoutingObstacle *>	obstacleList;			// list with obstacles
+	idList<idRoutingCache *>	precomputedCache;		// area and portal cache filled by PrecomputeRoutingCache
+	unsigned short *			precomputedTravelTimes;	// travel times of all precomputed cache
+	byte *						precomputedReachabilities;	// reachabilities of all precomputed cache
 
 	// greebo: This is TDM's EAS "Elevator Awareness System" :)
 	eas::tdmEAS*				elevatorSystem;
@@ -220,6 +230,8 @@ private:	// routing
 	void						SetupRoutingCache( void );
 	void						DeleteClusterCache( int clusterNum );
 	void						DeletePortalCache( void );
+	void						DeletePortalCacheUsingCluster( int clusterNum );
+	void						RemoveCacheFromIndex( idRoutingCache *cache ) const;
 	void						ShutdownRoutingCache( void );
 	void						RoutingStats( void ) const;
 	void						LinkCache( idRoutingCache *cache ) const;
@@ -227,11 +239,14 @@ private:	// routing
 	void						DeleteOldestCache( void ) const;
 	idReachability *			GetAreaReachability( int areaNum, int reachabilityNum ) const;
 	int							ClusterAreaNum( int clusterNum, int areaNum ) const;
-	void						UpdateAreaRoutingCache( idRoutingCache *areaCache ) const;
+	void						UpdateAreaRoutingCache( idRoutingCache *areaCache, idRoutingUpdate *updates ) const;
 	idRoutingCache *			GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
-	void						UpdatePortalRoutingCache( idRoutingCache *portalCache ) const;
+	void						UpdatePortalRoutingCache( idRoutingCache *portalCache, idRoutingUpdate *updates ) const;
 	idRoutingCache *			GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
 	void						RemoveRoutingCacheUsingArea( int areaNum );
+	void						PrecomputeRoutingCache( void );
+	void						FreePrecomputedRoutingCache( void );
+	friend void					PrecomputeRoutingCacheJob( routingPrecomputeJob_t *job );
 
 public:
 	void						DisableArea( int areaNum );
@@ -36,6 +36,11 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 #define LEDGE_TRAVELTIME_PENALTY	250
 
+// the travel flags of walking AI (see idAI::idAI), only cache for these is precomputed
+#define PRECOMPUTED_TRAVELFLAGS		(TFL_WALK|TFL_AIR|TFL_DOOR)
+
+#define MAX_ROUTING_PRECOMPUTE_JOBS	64
+
 /*
 ============
 idRoutingCache::idRoutingCache
@@ -54,6 +59,32 @@ idRoutingCache::idRoutingCache( int size ) {
 	memset( reachabilities, 0, size * sizeof( reachabilities[0] ) );
 	travelTimes = new unsigned short[size];
 	memset( travelTimes, 0, size * sizeof( travelTimes[0] ) );
+	usedClusters = NULL;
+	numUsedClusterWords = 0;
+	precomputed = false;
+	invalid = false;
+}
+
+/*
+============
+idRoutingCache::idRoutingCache
+============
+*/
+idRoutingCache::idRoutingCache( int size, unsigned short *travelTimes, byte *reachabilities ) {
+	areaNum = 0;
+	cluster = 0;
+	next = prev = NULL;
+	time_next = time_prev = NULL;
+	travelFlags = 0;
+	startTravelTime = 0;
+	type = 0;
+	this->size = size;
+	this->reachabilities = reachabilities;
+	this->travelTimes = travelTimes;
+	usedClusters = NULL;
+	numUsedClusterWords = 0;
+	precomputed = true;
+	invalid = false;
 }
 
 /*
@@ -62,8 +93,11 @@ idRoutingCache::~idRoutingCache
 ============
 */
 idRoutingCache::~idRoutingCache( void ) {
-	delete [] reachabilities;
-	delete [] travelTimes;
+	if ( !precomputed ) {
+		delete [] reachabilities;
+		delete [] travelTimes;
+	}
+	delete [] usedClusters;
 }
 
 /*
@@ -72,7 +106,7 @@ idRoutingCache::Size
 ============
 */
 int idRoutingCache::Size( void ) const {
-	return sizeof( idRoutingCache ) + size * sizeof( reachabilities[0] ) + size * sizeof( travelTimes[0] );
+	return sizeof( idRoutingCache ) + size * sizeof( reachabilities[0] ) + size * sizeof( travelTimes[0] ) + numUsedClusterWords * sizeof( usedClusters[0] );
 }
 
 /*
@@ -251,20 +285,30 @@ void idAASLocal::SetupRoutingCache( void ) {
 
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
+
+	precomputedTravelTimes = NULL;
+	precomputedReachabilities = NULL;
 }
 
 /*
 ============
 idAASLocal::DeleteClusterCache
+
+  precomputed cache is only invalidated, it is updated in place when used again
 ============
 */
 void idAASLocal::DeleteClusterCache( int clusterNum ) {
 	int i;
-	idRoutingCache *cache;
+	idRoutingCache *cache, *next;
 
 	for ( i = 0; i < file->GetCluster( clusterNum ).numReachableAreas; i++ ) {
-		for ( cache = areaCacheIndex[clusterNum][i]; cache; cache = areaCacheIndex[clusterNum][i] ) {
-			areaCacheIndex[clusterNum][i] = cache->next;
+		for ( cache = areaCacheIndex[clusterNum][i]; cache; cache = next ) {
+			next = cache->next;
+			if ( cache->precomputed ) {
+				cache->invalid = true;
+				continue;
+			}
+			RemoveCacheFromIndex( cache );
 			UnlinkCache( cache );
 			delete cache;
 		}
@@ -278,11 +322,44 @@ idAASLocal::DeletePortalCache
 */
 void idAASLocal::DeletePortalCache( void ) {
 	int i;
-	idRoutingCache *cache;
+	idRoutingCache *cache, *next;
+
+	for ( i = 0; i < file->GetNumAreas(); i++ ) {
+		for ( cache = portalCacheIndex[i]; cache; cache = next ) {
+			next = cache->next;
+			if ( cache->precomputed ) {
+				cache->invalid = true;
+				continue;
+			}
+			RemoveCacheFromIndex( cache );
+			UnlinkCache( cache );
+			delete cache;
+		}
+	}
+}
+
+/*
+============
+idAASLocal::DeletePortalCacheUsingCluster
+
+  only the portal cache which was flooded through the cluster can depend on it
+============
+*/
+void idAASLocal::DeletePortalCacheUsingCluster( int clusterNum ) {
+	int i;
+	idRoutingCache *cache, *next;
 
 	for ( i = 0; i < file->GetNumAreas(); i++ ) {
-		for ( cache = portalCacheIndex[i]; cache; cache = portalCacheIndex[i] ) {
-			portalCacheIndex[i] = cache->next;
+		for ( cache = portalCacheIndex[i]; cache; cache = next ) {
+			next = cache->next;
+			if ( !( cache->usedClusters[clusterNum >> 5] & ( 1u << ( clusterNum & 31 ) ) ) ) {
+				continue;
+			}
+			if ( cache->precomputed ) {
+				cache->invalid = true;
+				continue;
+			}
+			RemoveCacheFromIndex( cache );
 			UnlinkCache( cache );
 			delete cache;
 		}
@@ -297,6 +374,8 @@ idAASLocal::ShutdownRoutingCache
 void idAASLocal::ShutdownRoutingCache( void ) {
 	int i;
 
+	FreePrecomputedRoutingCache();
+
 	for ( i = 0; i < file->GetNumClusters(); i++ ) {
 		DeleteClusterCache( i );
 	}
@@ -366,6 +445,16 @@ void idAASLocal::RoutingStats( void ) const {
 	gameLocal.Printf( "%6d area cache (%d KB)\n", numAreaCache, totalAreaCacheMemory >> 10 );
 	gameLocal.Printf( "%6d portal cache (%d KB)\n", numPortalCache, totalPortalCacheMemory >> 10 );
 	gameLocal.Printf( "%6d total cache (%d KB)\n", numAreaCache + numPortalCache, totalCacheMemory >> 10 );
+
+	if ( precomputedCache.Num() ) {
+		int numInvalid = 0;
+		size_t precomputedMemory = 0;
+		for ( int i = 0; i < precomputedCache.Num(); i++ ) {
+			numInvalid += precomputedCache[i]->invalid;
+			precomputedMemory += precomputedCache[i]->Size();
+		}
+		gameLocal.Printf( "%6d precomputed cache (%d KB), %d invalidated\n", precomputedCache.Num(), (int)( precomputedMemory >> 10 ), numInvalid );
+	}
 	gameLocal.Printf( "%6d area travel times (%d KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%d KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%d KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
@@ -383,13 +472,15 @@ void idAASLocal::RemoveRoutingCacheUsingArea( int areaNum ) {
 	if ( clusterNum > 0 ) {
 		// remove all the cache in the cluster the area is in
 		DeleteClusterCache( clusterNum );
+		DeletePortalCacheUsingCluster( clusterNum );
 	}
 	else {
 		// if this is a portal remove all cache in both the front and back cluster
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[0] );
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[1] );
+		DeletePortalCacheUsingCluster( file->GetPortal( -clusterNum ).clusters[0] );
+		DeletePortalCacheUsingCluster( file->GetPortal( -clusterNum ).clusters[1] );
 	}
-	DeletePortalCache();
 }
 
 /*
@@ -647,6 +738,11 @@ idAASLocal::LinkCache
 */
 void idAASLocal::LinkCache( idRoutingCache *cache ) const {
 
+	// precomputed cache is never evicted
+	if ( cache->precomputed ) {
+		return;
+	}
+
 	// if the cache is already linked
 	if ( cache->time_next || cache->time_prev || cacheListStart == cache ) {
 		UnlinkCache( cache );
@@ -704,6 +800,17 @@ void idAASLocal::DeleteOldestCache( void ) const {
 	UnlinkCache( cache );
 
 	// unlink the oldest cache from the area or portal cache index
+	RemoveCacheFromIndex( cache );
+
+	delete cache;
+}
+
+/*
+============
+idAASLocal::RemoveCacheFromIndex
+============
+*/
+void idAASLocal::RemoveCacheFromIndex( idRoutingCache *cache ) const {
 	if ( cache->next ) {
 		cache->next->prev = cache->prev;
 	}
@@ -716,8 +823,7 @@ void idAASLocal::DeleteOldestCache( void ) const {
 	else if ( cache->type == CACHETYPE_PORTAL ) {
 		portalCacheIndex[cache->areaNum] = cache->next;
 	}
-
-	delete cache;
+	cache->next = cache->prev = NULL;
 }
 
 /*
@@ -759,7 +865,7 @@ ID_INLINE int idAASLocal::ClusterAreaNum( int clusterNum, int areaNum ) const {
 idAASLocal::UpdateAreaRoutingCache
 ============
 */
-void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
+void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache, idRoutingUpdate *updates ) const {
 	// number of reachability areas within this cluster
 	int numReachableAreas = file->GetCluster(areaCache->cluster).numReachableAreas;
 
@@ -777,7 +883,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
 	memset( startAreaTravelTimes, 0, sizeof( startAreaTravelTimes ) );
 
 	// initialize first update
-	idRoutingUpdate* curUpdate = &areaUpdate[clusterAreaNum];
+	idRoutingUpdate* curUpdate = &updates[clusterAreaNum];
 
 	curUpdate->areaNum = areaCache->areaNum;
 	curUpdate->areaTravelTimes = startAreaTravelTimes;
@@ -843,7 +949,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
 
 				areaCache->travelTimes[clusterAreaNum] = t;
 				areaCache->reachabilities[clusterAreaNum] = reach->number; // reversed reachability used to get into this area
-				idRoutingUpdate* nextUpdate = &areaUpdate[clusterAreaNum];
+				idRoutingUpdate* nextUpdate = &updates[clusterAreaNum];
 				nextUpdate->areaNum = nextAreaNum;
 				nextUpdate->tmpTravelTime = t;
 				nextUpdate->areaTravelTimes = reach->areaTravelTimes;
@@ -906,7 +1012,13 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 			clusterCache->prev = cache;
 		}
 		areaCacheIndex[clusterNum][clusterAreaNum] = cache;
-		UpdateAreaRoutingCache( cache );
+		UpdateAreaRoutingCache( cache, areaUpdate );
+	}
+	else if ( cache->invalid ) {
+		memset( cache->travelTimes, 0, cache->size * sizeof( cache->travelTimes[0] ) );
+		memset( cache->reachabilities, 0, cache->size * sizeof( cache->reachabilities[0] ) );
+		UpdateAreaRoutingCache( cache, areaUpdate );
+		cache->invalid = false;
 	}
 	LinkCache( cache );
 	return cache;
@@ -917,7 +1029,7 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 idAASLocal::UpdatePortalRoutingCache
 ============
 */
-void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
+void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache, idRoutingUpdate *updates ) const {
 	int i, portalNum, clusterAreaNum;
 	unsigned short t;
 	const aasPortal_t *portal;
@@ -925,7 +1037,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
 	idRoutingCache *cache;
 	idRoutingUpdate *updateListStart, *updateListEnd, *curUpdate, *nextUpdate;
 
-	curUpdate = &portalUpdate[ file->GetNumPortals() ];
+	curUpdate = &updates[ file->GetNumPortals() ];
 	curUpdate->cluster = portalCache->cluster;
 	curUpdate->areaNum = portalCache->areaNum;
 	curUpdate->tmpTravelTime = portalCache->startTravelTime;
@@ -953,6 +1065,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
 
 		cluster = &file->GetCluster( curUpdate->cluster );
 		cache = GetAreaRoutingCache( curUpdate->cluster, curUpdate->areaNum, portalCache->travelFlags );
+		portalCache->usedClusters[curUpdate->cluster >> 5] |= 1u << ( curUpdate->cluster & 31 );
 
 		// take all portals of the cluster
 		for ( i = 0; i < cluster->numPortals; i++ ) {
@@ -988,7 +1101,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
 			{
 				portalCache->travelTimes[portalNum] = t;
 				portalCache->reachabilities[portalNum] = cache->reachabilities[clusterAreaNum];
-				nextUpdate = &portalUpdate[portalNum];
+				nextUpdate = &updates[portalNum];
 				if ( portal->clusters[0] == curUpdate->cluster ) {
 					nextUpdate->cluster = portal->clusters[1];
 				}
@@ -1039,18 +1152,268 @@ idRoutingCache *idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 		cache->areaNum = areaNum;
 		cache->startTravelTime = 1;
 		cache->travelFlags = travelFlags;
+		cache->numUsedClusterWords = ( file->GetNumClusters() + 31 ) >> 5;
+		cache->usedClusters = new unsigned int[cache->numUsedClusterWords];
+		memset( cache->usedClusters, 0, cache->numUsedClusterWords * sizeof( cache->usedClusters[0] ) );
 		cache->prev = NULL;
 		cache->next = portalCacheIndex[areaNum];
 		if ( portalCacheIndex[areaNum] ) {
 			portalCacheIndex[areaNum]->prev = cache;
 		}
 		portalCacheIndex[areaNum] = cache;
-		UpdatePortalRoutingCache( cache );
+		UpdatePortalRoutingCache( cache, portalUpdate );
+	}
+	else if ( cache->invalid ) {
+		memset( cache->travelTimes, 0, cache->size * sizeof( cache->travelTimes[0] ) );
+		memset( cache->reachabilities, 0, cache->size * sizeof( cache->reachabilities[0] ) );
+		memset( cache->usedClusters, 0, cache->numUsedClusterWords * sizeof( cache->usedClusters[0] ) );
+		UpdatePortalRoutingCache( cache, portalUpdate );
+		cache->invalid = false;
 	}
 	LinkCache( cache );
 	return cache;
 }
 
+/*
+============
+PrecomputeRoutingCacheJob
+============
+*/
+struct routingPrecomputeJob_t {
+	const idAASLocal *		aas;
+	idRoutingCache **		caches;
+	int						numCaches;
+	int						numUpdates;
+	bool					portalCache;
+};
+
+void PrecomputeRoutingCacheJob( routingPrecomputeJob_t *job ) {
+	// every job floods with its own update memory
+	idRoutingUpdate *updates = (idRoutingUpdate *) Mem_ClearedAlloc( job->numUpdates * sizeof( idRoutingUpdate ) );
+
+	for ( int i = 0; i < job->numCaches; i++ ) {
+		if ( job->portalCache ) {
+			// only reads the precomputed area cache
+			job->aas->UpdatePortalRoutingCache( job->caches[i], updates );
+		} else {
+			job->aas->UpdateAreaRoutingCache( job->caches[i], updates );
+		}
+	}
+
+	Mem_Free( updates );
+}
+
+REGISTER_PARALLEL_JOB( PrecomputeRoutingCacheJob, "PrecomputeRoutingCacheJob" );
+
+/*
+============
+idAASLocal::PrecomputeRoutingCache
+
+  Fills the area cache of all clusters and the portal cache of all goal areas
+  for the travel flags of walking AI in parallel, so the first route queries
+  don't have to flood whole clusters. All travel times and reachabilities
+  are stored in two arrays, the cache is never evicted and is only updated
+  again after an area of a cluster it depends on changed.
+============
+*/
+void idAASLocal::PrecomputeRoutingCache( void ) {
+	int i, j;
+
+	FreePrecomputedRoutingCache();
+
+	if ( !file || !aas_precomputeRouting.GetBool() ) {
+		return;
+	}
+
+	int startTime = Sys_Milliseconds();
+
+	// start from scratch, the lazily created cache would shadow the precomputed one
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		DeleteClusterCache( i );
+	}
+	DeletePortalCache();
+
+	size_t budget = (size_t)idMath::Imax( aas_precomputeRoutingMemory.GetInteger(), 0 ) << 20;
+	size_t used = 0;
+	const size_t entrySize = sizeof( unsigned short ) + sizeof( byte );
+
+	// clusters are precomputed completely or not at all
+	idList<bool> clusterPrecomputed;
+	clusterPrecomputed.SetNum( file->GetNumClusters() );
+	int numUpdates = file->GetNumPortals() + 1;
+	int numAreaEntries = 0;
+	bool allClusters = true;
+	for ( i = 1; i < file->GetNumClusters(); i++ ) {
+		int numReachableAreas = file->GetCluster( i ).numReachableAreas;
+		size_t clusterSize = (size_t)numReachableAreas * numReachableAreas * entrySize;
+		clusterPrecomputed[i] = used + clusterSize <= budget;
+		if ( !clusterPrecomputed[i] ) {
+			allClusters = false;
+			continue;
+		}
+		used += clusterSize;
+		numAreaEntries += numReachableAreas * numReachableAreas;
+		numUpdates = idMath::Imax( numUpdates, numReachableAreas );
+	}
+	clusterPrecomputed[0] = false;
+
+	// the portal cache floods through all clusters, so it's only precomputed if all area cache is
+	int numGoalAreas = 0;
+	for ( i = 1; i < file->GetNumAreas(); i++ ) {
+		if ( file->GetArea( i ).cluster != 0 && ( file->GetArea( i ).flags & ( AREA_REACHABLE_WALK | AREA_REACHABLE_FLY ) ) ) {
+			numGoalAreas++;
+		}
+	}
+	size_t portalSize = (size_t)numGoalAreas * file->GetNumPortals() * entrySize;
+	bool precomputePortals = allClusters && used + portalSize <= budget;
+	int numEntries = numAreaEntries + ( precomputePortals ? numGoalAreas * file->GetNumPortals() : 0 );
+
+	if ( numEntries == 0 ) {
+		return;
+	}
+
+	precomputedTravelTimes = (unsigned short *) Mem_ClearedAlloc( numEntries * sizeof( unsigned short ) );
+	precomputedReachabilities = (byte *) Mem_ClearedAlloc( numEntries * sizeof( byte ) );
+	int entry = 0;
+
+	// one area cache for every reachable area of every cluster, cluster portals are part of both clusters
+	for ( i = 1; i < file->GetNumAreas(); i++ ) {
+		int areaCluster = file->GetArea( i ).cluster;
+		for ( j = 0; j < 2; j++ ) {
+			int clusterNum;
+			if ( areaCluster > 0 ) {
+				if ( j > 0 ) {
+					break;
+				}
+				clusterNum = areaCluster;
+			} else if ( areaCluster < 0 ) {
+				clusterNum = file->GetPortal( -areaCluster ).clusters[j];
+			} else {
+				break;
+			}
+			if ( clusterNum <= 0 || !clusterPrecomputed[clusterNum] ) {
+				continue;
+			}
+			int numReachableAreas = file->GetCluster( clusterNum ).numReachableAreas;
+			int clusterAreaNum = ClusterAreaNum( clusterNum, i );
+			if ( clusterAreaNum >= numReachableAreas ) {
+				continue;
+			}
+
+			idRoutingCache *cache = new idRoutingCache( numReachableAreas, precomputedTravelTimes + entry, precomputedReachabilities + entry );
+			entry += numReachableAreas;
+			cache->type = CACHETYPE_AREA;
+			cache->cluster = clusterNum;
+			cache->areaNum = i;
+			cache->startTravelTime = 1;
+			cache->travelFlags = PRECOMPUTED_TRAVELFLAGS;
+			cache->next = areaCacheIndex[clusterNum][clusterAreaNum];
+			if ( cache->next ) {
+				cache->next->prev = cache;
+			}
+			areaCacheIndex[clusterNum][clusterAreaNum] = cache;
+			precomputedCache.Append( cache );
+		}
+	}
+	int numAreaCache = precomputedCache.Num();
+
+	if ( precomputePortals ) {
+		for ( i = 1; i < file->GetNumAreas(); i++ ) {
+			int areaCluster = file->GetArea( i ).cluster;
+			if ( areaCluster == 0 || !( file->GetArea( i ).flags & ( AREA_REACHABLE_WALK | AREA_REACHABLE_FLY ) ) ) {
+				continue;
+			}
+			idRoutingCache *cache = new idRoutingCache( file->GetNumPortals(), precomputedTravelTimes + entry, precomputedReachabilities + entry );
+			entry += file->GetNumPortals();
+			cache->type = CACHETYPE_PORTAL;
+			// same as RouteToGoalArea: the goal area is part of the front cluster if it is a portal
+			cache->cluster = areaCluster > 0 ? areaCluster : file->GetPortal( -areaCluster ).clusters[0];
+			cache->areaNum = i;
+			cache->startTravelTime = 1;
+			cache->travelFlags = PRECOMPUTED_TRAVELFLAGS;
+			cache->numUsedClusterWords = ( file->GetNumClusters() + 31 ) >> 5;
+			cache->usedClusters = new unsigned int[cache->numUsedClusterWords];
+			memset( cache->usedClusters, 0, cache->numUsedClusterWords * sizeof( cache->usedClusters[0] ) );
+			cache->next = portalCacheIndex[i];
+			if ( cache->next ) {
+				cache->next->prev = cache;
+			}
+			portalCacheIndex[i] = cache;
+			precomputedCache.Append( cache );
+		}
+	}
+	assert( entry <= numEntries );
+
+	// all area cache must be done before the portal cache is flooded through it
+	idParallelJobList *jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_ROUTING_PRECOMPUTE_JOBS, 0, NULL );
+	routingPrecomputeJob_t jobs[MAX_ROUTING_PRECOMPUTE_JOBS];
+
+	for ( int pass = 0; pass < 2; pass++ ) {
+		int first = pass == 0 ? 0 : numAreaCache;
+		int last = pass == 0 ? numAreaCache : precomputedCache.Num();
+		if ( last <= first ) {
+			continue;
+		}
+		if ( pass == 1 ) {
+			// the portal flood looks up the area cache of the goal areas and of the portals in both their clusters,
+			// GetAreaRoutingCache is not thread safe when it has to create one, so all of them must exist before
+			for ( i = first; i < last; i++ ) {
+				GetAreaRoutingCache( precomputedCache[i]->cluster, precomputedCache[i]->areaNum, PRECOMPUTED_TRAVELFLAGS );
+			}
+			for ( i = 1; i < file->GetNumPortals(); i++ ) {
+				const aasPortal_t &portal = file->GetPortal( i );
+				for ( j = 0; j < 2; j++ ) {
+					if ( portal.clusters[j] > 0 && ClusterAreaNum( portal.clusters[j], portal.areaNum ) < file->GetCluster( portal.clusters[j] ).numReachableAreas ) {
+						GetAreaRoutingCache( portal.clusters[j], portal.areaNum, PRECOMPUTED_TRAVELFLAGS );
+					}
+				}
+			}
+		}
+		for ( i = 0; i < MAX_ROUTING_PRECOMPUTE_JOBS; i++ ) {
+			routingPrecomputeJob_t &job = jobs[i];
+			int jobFirst = first + ( last - first ) * i / MAX_ROUTING_PRECOMPUTE_JOBS;
+			int jobLast = first + ( last - first ) * ( i + 1 ) / MAX_ROUTING_PRECOMPUTE_JOBS;
+			if ( jobLast <= jobFirst ) {
+				continue;
+			}
+			job.aas = this;
+			job.caches = precomputedCache.Ptr() + jobFirst;
+			job.numCaches = jobLast - jobFirst;
+			job.numUpdates = numUpdates;
+			job.portalCache = pass == 1;
+			jobList->AddJob( (jobRun_t)PrecomputeRoutingCacheJob, &job );
+		}
+		jobList->Submit();
+		jobList->Wait();
+	}
+
+	parallelJobManager->FreeJobList( jobList );
+
+	common->Printf( "%s: precomputed %d area and %d portal cache (%d KB) in %d msec\n", name.c_str(),
+		numAreaCache, precomputedCache.Num() - numAreaCache, (int)( ( entry * entrySize ) >> 10 ), Sys_Milliseconds() - startTime );
+	if ( !allClusters || !precomputePortals ) {
+		common->Printf( "%s: aas_precomputeRoutingMemory too small to precompute all cache\n", name.c_str() );
+	}
+}
+
+/*
+============
+idAASLocal::FreePrecomputedRoutingCache
+============
+*/
+void idAASLocal::FreePrecomputedRoutingCache( void ) {
+	for ( int i = 0; i < precomputedCache.Num(); i++ ) {
+		RemoveCacheFromIndex( precomputedCache[i] );
+		delete precomputedCache[i];
+	}
+	precomputedCache.Clear();
+
+	Mem_Free( precomputedTravelTimes );
+	precomputedTravelTimes = NULL;
+	Mem_Free( precomputedReachabilities );
+	precomputedReachabilities = NULL;
+}
+
 /*
 ============
 idAASLocal::RouteToGoalArea
@@ -1778,6 +2141,9 @@ void idAASLocal::GetPortals(int areaNum, idList<idVec4> &portalList, idBounds se
 
 void idAASLocal::CompileEAS()
 {
+	// all doors are spawned now, the EAS setup already benefits from the precomputed cache
+	PrecomputeRoutingCache();
+
 	elevatorSystem->Compile();
 }
 
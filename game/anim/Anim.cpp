@@ -23,6 +23,9 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 bool idAnimManager::forceExport = false;
 
+// memory used by idMD5Anim::decodedFrames of all anims
+static std::atomic<size_t> decodedFramesMemory( 0 );
+
 /***********************************************************************
 
 	idMD5Anim
@@ -41,6 +44,7 @@ idMD5Anim::idMD5Anim() {
 	frameRate	= 24;
 	animLength	= 0;
 	totaldelta.Zero();
+	decodedFrames = NULL;
 }
 
 /*
@@ -58,6 +62,8 @@ idMD5Anim::Free
 ====================
 */
 void idMD5Anim::Free( void ) {
+	FreeDecodedFrames();
+
 	numFrames	= 0;
 	numJoints	= 0;
 	frameRate	= 24;
@@ -71,6 +77,35 @@ void idMD5Anim::Free( void ) {
 	componentFrames.ClearFree();
 }
 
+/*
+====================
+idMD5Anim::FreeDecodedFrames
+====================
+*/
+void idMD5Anim::FreeDecodedFrames( void ) {
+	if ( !decodedFrames ) {
+		return;
+	}
+	for ( int i = 0; i < numFrames; i++ ) {
+		idJointQuat *decoded = decodedFrames[i].load( std::memory_order_relaxed );
+		if ( decoded ) {
+			decodedFramesMemory -= baseFrame.Num() * sizeof( decoded[0] );
+			Mem_Free16( decoded );
+		}
+	}
+	delete[] decodedFrames;
+	decodedFrames = NULL;
+}
+
+/*
+====================
+idMD5Anim::DecodedFramesMemory
+====================
+*/
+size_t idMD5Anim::DecodedFramesMemory( void ) {
+	return decodedFramesMemory;
+}
+
 /*
 ====================
 idMD5Anim::NumFrames
@@ -313,6 +348,13 @@ bool idMD5Anim::LoadAnim( const char *filename ) {
 	// we don't count last frame because it would cause a 1 frame pause at the end
 	animLength = ( ( numFrames - 1 ) * 1000 + frameRate - 1 ) / frameRate;
 
+	if ( numAnimatedComponents ) {
+		decodedFrames = new std::atomic<idJointQuat *>[ numFrames ];
+		for( i = 0; i < numFrames; i++ ) {
+			decodedFrames[ i ].store( NULL, std::memory_order_relaxed );
+		}
+	}
+
 	// done
 	return true;
 }
@@ -612,6 +654,87 @@ void idMD5Anim::GetBounds( idBounds &bnds, int time, int cyclecount ) const {
 	bnds[ 1 ] -= offset;
 }
 
+/*
+====================
+idMD5Anim::DecodeFrame
+
+  Same as GetSingleFrame for all joints.
+====================
+*/
+void idMD5Anim::DecodeFrame( int framenum, idJointQuat *joints ) const {
+	const float *frame = &componentFrames[ framenum * numAnimatedComponents ];
+
+	SIMDProcessor->Memcpy( joints, baseFrame.Ptr(), baseFrame.Num() * sizeof( baseFrame[ 0 ] ) );
+
+	for ( int j = 0; j < baseFrame.Num(); j++ ) {
+		const int animBits = jointInfo[j].animBits;
+		if ( !animBits ) {
+			continue;
+		}
+		idJointQuat *jointPtr = &joints[j];
+		const float *jointframe = frame + jointInfo[j].firstComponent;
+
+		if ( animBits & ANIM_TX ) {
+			jointPtr->t.x = *jointframe++;
+		}
+		if ( animBits & ANIM_TY ) {
+			jointPtr->t.y = *jointframe++;
+		}
+		if ( animBits & ANIM_TZ ) {
+			jointPtr->t.z = *jointframe++;
+		}
+		if ( animBits & (ANIM_QX|ANIM_QY|ANIM_QZ) ) {
+			if ( animBits & ANIM_QX ) {
+				jointPtr->q.x = *jointframe++;
+			}
+			if ( animBits & ANIM_QY ) {
+				jointPtr->q.y = *jointframe++;
+			}
+			if ( animBits & ANIM_QZ ) {
+				jointPtr->q.z = *jointframe;
+			}
+			jointPtr->q.w = jointPtr->q.CalcW();
+		}
+	}
+}
+
+/*
+====================
+idMD5Anim::GetDecodedFrame
+
+  Returns the frame decoded for all joints, decoding it on first use.
+  Returns NULL if the frames of all anims would take more memory than g_animFrameCache allows.
+  May be called from several threads at once.
+====================
+*/
+const idJointQuat *idMD5Anim::GetDecodedFrame( int framenum ) const {
+	if ( !decodedFrames ) {
+		return NULL;
+	}
+
+	idJointQuat *decoded = decodedFrames[ framenum ].load( std::memory_order_acquire );
+	if ( decoded ) {
+		return decoded;
+	}
+
+	const size_t size = baseFrame.Num() * sizeof( baseFrame[ 0 ] );
+	if ( decodedFramesMemory + size > ( size_t )g_animFrameCache.GetInteger() << 20 ) {
+		return NULL;
+	}
+
+	decoded = ( idJointQuat * )Mem_Alloc16( size );
+	DecodeFrame( framenum, decoded );
+
+	// another thread may have decoded the same frame meanwhile
+	idJointQuat *expected = NULL;
+	if ( !decodedFrames[ framenum ].compare_exchange_strong( expected, decoded, std::memory_order_acq_rel ) ) {
+		Mem_Free16( decoded );
+		return expected;
+	}
+	decodedFramesMemory += size;
+	return decoded;
+}
+
 /*
 ====================
 idMD5Anim::GetInterpolatedFrame
@@ -638,10 +761,30 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints,
 		return;
 	}
 
-	blendJoints = (idJointQuat *)_alloca16( baseFrame.Num() * sizeof( blendPtr[ 0 ] ) );
 	lerpIndex = (int *)_alloca16( baseFrame.Num() * sizeof( lerpIndex[ 0 ] ) );
 	numLerpJoints = 0;
 
+	const idJointQuat *decoded1 = GetDecodedFrame( frame.frame1 );
+	const idJointQuat *decoded2 = decoded1 ? GetDecodedFrame( frame.frame2 ) : NULL;
+	if ( decoded2 ) {
+		for ( i = 0; i < numIndexes; i++ ) {
+			int j = index[i];
+			if ( jointInfo[j].animBits ) {
+				lerpIndex[numLerpJoints++] = j;
+				joints[j] = decoded1[j];
+			}
+		}
+
+		SIMDProcessor->BlendJoints( joints, decoded2, frame.backlerp, lerpIndex, numLerpJoints );
+
+		if ( frame.cycleCount ) {
+			joints[ 0 ].t += totaldelta * ( float )frame.cycleCount;
+		}
+		return;
+	}
+
+	blendJoints = (idJointQuat *)_alloca16( baseFrame.Num() * sizeof( blendPtr[ 0 ] ) );
+
 	frame1 = &componentFrames[ frame.frame1 * numAnimatedComponents ];
 	frame2 = &componentFrames[ frame.frame2 * numAnimatedComponents ];
 
@@ -823,6 +966,17 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat *joints, const int *in
 		return;
 	}
 
+	const idJointQuat *decoded = GetDecodedFrame( framenum );
+	if ( decoded ) {
+		for ( i = 0; i < numIndexes; i++ ) {
+			int j = index[i];
+			if ( jointInfo[j].animBits ) {
+				joints[j] = decoded[j];
+			}
+		}
+		return;
+	}
+
 	frame = &componentFrames[ framenum * numAnimatedComponents ];
 
 	for ( i = 0; i < numIndexes; i++ ) {
@@ -1064,6 +1218,7 @@ void idAnimManager::ListAnims( void ) const {
 	}
 
 	gameLocal.Printf( "\n%d memory used in %d anims\n", size, num );
+	gameLocal.Printf( "%d memory used in decoded frames\n", ( int )idMD5Anim::DecodedFramesMemory() );
 	gameLocal.Printf( "%d memory used in %d joint names\n", namesize, jointnames.Num() );
 }
 
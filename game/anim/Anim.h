@@ -282,6 +282,13 @@ private:
 	idVec3					totaldelta;
 	mutable int				ref_count;
 
+	// frames decoded on first use, shared by all animators playing the anim, see g_animFrameCache
+	mutable std::atomic<idJointQuat *> *decodedFrames;
+
+	void					DecodeFrame( int framenum, idJointQuat *joints ) const;
+	const idJointQuat *		GetDecodedFrame( int framenum ) const;
+	void					FreeDecodedFrames( void );
+
 public:
 							idMD5Anim();
 							~idMD5Anim();
@@ -316,6 +323,9 @@ public:
 	* DarkMod: Set the framerate to something different from what's in the file.
 	**/
 	void					SetFrameRate( int frRate );
+
+	// memory used by the decoded frames of all anims
+	static size_t			DecodedFramesMemory( void );
 };
 
 /*
@@ -596,6 +606,10 @@ public:
 	void						ForceUpdate( void );
 	void						ClearForceUpdate( void );
 	bool						CreateFrame( int animtime, bool force );
+	// CreateFrame split for idGameLocal::CreateAnimationFrames, the checks run on the main thread and
+	// the joints of different animators may be created in parallel, the next CreateFrame at the same time takes them
+	bool						BeginFrameAhead( int animtime );
+	void						CreateFrameAhead( int animtime );
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3 &delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3 &delta ) const;
@@ -643,6 +657,8 @@ public:
 private:
 	void						FreeData( void );
 	void						PushAnims( int channel, int currentTime, int blendTime );
+	bool						StartFrame( int currentTime, bool force, bool &debugInfo );
+	bool						BlendFrame( int currentTime, bool debugInfo );
 
 private:
 	const idDeclModelDef *		modelDef;
@@ -657,6 +673,9 @@ private:
 	mutable bool				stoppedAnimatingUpdate;
 	bool						removeOriginOffset;
 	bool						forceUpdate;
+	int							aheadFrameTime;			// time of the frame created by CreateFrameAhead, -1 once taken
+	bool						aheadFrameCreated;
+	int							lastRequestTime;		// time of the last CreateFrame call, frames are only created ahead while they are asked for
 
 	idBounds					frameBounds;
 
@@ -668,6 +687,15 @@ private:
 	int							AFPoseTime;
 };
 
+#define MAX_ANIM_FRAME_JOBS		32
+
+// animators whose frames are created by one job of idGameLocal::CreateAnimationFrames
+typedef struct animFrameJob_s {
+	idAnimator **				animators;
+	int							numAnimators;
+	int							time;
+} animFrameJob_t;
+
 /*
 ==============================================================================================
 
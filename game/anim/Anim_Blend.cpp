@@ -3953,6 +3953,9 @@ idAnimator::idAnimator() {
 	joints					= NULL;
 	lastTransformTime		= -1;
 	stoppedAnimatingUpdate	= false;
+	aheadFrameTime			= -1;
+	aheadFrameCreated		= false;
+	lastRequestTime			= -1;
 	removeOriginOffset		= false;
 	forceUpdate				= false;
 
@@ -5176,26 +5179,135 @@ bool idAnimator::FrameHasChanged( int currentTime ) const {
 	return false;
 }
 
+static idCVar r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+
 /*
 =====================
 idAnimator::CreateFrame
 =====================
 */
 bool idAnimator::CreateFrame( int currentTime, bool force ) {
-	int					i, j;
-	int					numJoints;
-	int					parentNum;
-	bool				hasAnim;
 	bool				debugInfo;
-	float				baseBlend;
-	float				blendWeight;
-	const idAnimBlend *	blend;
-	const int *			jointParent;
-	const jointMod_t *	jointMod;
-	const idJointQuat *	defaultPose;
 
-	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+	// someone still needs the pose, keep creating it ahead
+	lastRequestTime = currentTime;
+
+	// take the frame created ahead unless anything changed since
+	if ( aheadFrameTime != -1 ) {
+		const bool taken = !force && aheadFrameCreated && aheadFrameTime == currentTime && lastTransformTime == currentTime;
+		aheadFrameTime = -1;
+		if ( taken ) {
+			return true;
+		}
+	}
+
+	if ( !StartFrame( currentTime, force, debugInfo ) ) {
+		return false;
+	}
+	return BlendFrame( currentTime, debugInfo );
+}
+
+/*
+=====================
+idAnimator::BeginFrameAhead
+
+  Returns true if the animator would create a frame at the given time, and a frame was asked for on the previous game frame.
+=====================
+*/
+bool idAnimator::BeginFrameAhead( int currentTime ) {
+	bool				debugInfo;
+
+	aheadFrameTime = -1;
+	if ( lastRequestTime != gameLocal.previousTime || lastTransformTime == currentTime ) {
+		return false;
+	}
+	if ( !StartFrame( currentTime, false, debugInfo ) ) {
+		return false;
+	}
+	aheadFrameTime = currentTime;
+	aheadFrameCreated = false;
+	return true;
+}
+
+/*
+=====================
+idAnimator::CreateFrameAhead
+=====================
+*/
+void idAnimator::CreateFrameAhead( int currentTime ) {
+	assert( aheadFrameTime == currentTime );
+	aheadFrameCreated = BlendFrame( currentTime, false );
+}
+
+/*
+=====================
+CreateAnimationFramesJob
+=====================
+*/
+static void CreateAnimationFramesJob( animFrameJob_t *job ) {
+	for ( int i = 0; i < job->numAnimators; i++ ) {
+		job->animators[i]->CreateFrameAhead( job->time );
+	}
+}
+
+REGISTER_PARALLEL_JOB( CreateAnimationFramesJob, "CreateAnimationFramesJob" );
+
+/*
+=====================
+idGameLocal::CreateAnimationFrames
+
+Creates the frames of the visible animated entities in jobs once all entities
+have thought, instead of one by one when the renderer calls back for them.
+=====================
+*/
+void idGameLocal::CreateAnimationFrames( void ) {
+	TRACE_CPU_SCOPE( "CreateAnimationFrames" )
+	static const int MIN_ANIMATORS_PER_JOB = 4;
+
+	// the debug output of CreateFrame is not thread-safe
+	if ( g_debugAnim.GetInteger() != -1 ) {
+		return;
+	}
 
+	idList<idAnimator *> &animators = animFrameAnimators;
+	animators.SetNum( 0, false );
+	for ( auto iter = activeEntities.Begin(); iter; activeEntities.Next( iter ) ) {
+		idEntity *ent = iter.entity;
+		if ( ent->IsHidden() || ent->GetModelDefHandle() == -1 || !InPlayerPVS( ent ) ) {
+			continue;
+		}
+		idAnimator *animator = ent->GetAnimator();
+		if ( animator && animator->BeginFrameAhead( time ) ) {
+			animators.Append( animator );
+		}
+	}
+	if ( animators.Num() == 0 ) {
+		return;
+	}
+
+	int numJobs = ( animators.Num() + MIN_ANIMATORS_PER_JOB - 1 ) / MIN_ANIMATORS_PER_JOB;
+	numJobs = Min( numJobs, MAX_ANIM_FRAME_JOBS );
+	for ( int i = 0; i < numJobs; i++ ) {
+		animFrameJob_t &job = animFrameJobs[i];
+		const int first = animators.Num() * i / numJobs;
+		const int last = animators.Num() * ( i + 1 ) / numJobs;
+		job.animators = animators.Ptr() + first;
+		job.numAnimators = last - first;
+		job.time = time;
+		animJobList->AddJob( ( jobRun_t )CreateAnimationFramesJob, &job );
+	}
+	animJobList->Submit();
+	animJobList->Wait();
+}
+
+/*
+=====================
+idAnimator::StartFrame
+
+  The checks of CreateFrame, returns false if the frame does not need to be created.
+=====================
+*/
+bool idAnimator::StartFrame( int currentTime, bool force, bool &debugInfo ) {
 	if ( gameLocal.inCinematic && gameLocal.skipCinematic ) {
 		return false;
 	}
@@ -5227,6 +5339,28 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 		debugInfo = false;
 	}
 
+	return true;
+}
+
+/*
+=====================
+idAnimator::BlendFrame
+
+  Blends the anims into the joints, only touches the animator itself.
+=====================
+*/
+bool idAnimator::BlendFrame( int currentTime, bool debugInfo ) {
+	int					i, j;
+	int					numJoints;
+	int					parentNum;
+	bool				hasAnim;
+	float				baseBlend;
+	float				blendWeight;
+	const idAnimBlend *	blend;
+	const int *			jointParent;
+	const jointMod_t *	jointMod;
+	const idJointQuat *	defaultPose;
+
 	// init the joint buffer
 	if ( AFPoseJoints.Num() ) {
 		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
@@ -5431,6 +5565,7 @@ idAnimator::ForceUpdate
 */
 void idAnimator::ForceUpdate( void ) {
 	lastTransformTime = -1;
+	aheadFrameTime = -1;
 	forceUpdate = true;
 }
 
@@ -237,7 +237,9 @@ bool Automation::GetUsercmd(usercmd_t &cmd) {
 			player->cmdAngles = idAngles();
 		}
 
-		WriteGameControlResponse("finished");
+		//benchmark plans are not posted by automation script
+		if (gameControlPlan_seqno >= 0)
+			WriteGameControlResponse("finished");
 		return false;	//no valid plan now: return control to human
 	}
 
@@ -357,90 +359,10 @@ void Automation::ParseAction(ParseIn &parseIn) {
 			WriteGameControlResponse("interrupted");
 		gameControlPlan_seqno = parseIn.seqno;
 		gameControlPlan_time = -1;
-		GameplayControlPlan &plan = gameControlPlan;
-		plan.Clear();
-
-		while (!parseIn.lexer.EndOfFile()) {
-			parseIn.lexer.ExpectTokenType(TT_NAME, 0, &token);
-
-			if (token == "timemode") {
-				parseIn.lexer.ExpectTokenType(TT_STRING, 0, &token);
-				if (token.Left(5) == "astro")
-					plan.timeMode = GameplayControlPlan::tmAstronomical;
-				else if (token.Left(4) == "game")
-					plan.timeMode = GameplayControlPlan::tmGamePhysics;
-				else
-					parseIn.lexer.Error("Expected time mode, found '%s'", token.c_str());
-				continue;
-			}
-
-			if (token == "anglemode") {
-				parseIn.lexer.ExpectTokenType(TT_STRING, 0, &token);
-				if (token.Left(3) == "abs")
-					plan.angleMode = GameplayControlPlan::amAbsolute;
-				else if (token.Left(3) == "rel")
-					plan.angleMode = GameplayControlPlan::amRelative;
-				else if (token == "smooth")
-					plan.angleMode = GameplayControlPlan::amSmooth;
-				else
-					parseIn.lexer.Error("Expected angle mode, found '%s'", token.c_str());
-				continue;
-			}
 
-			if (token == "impulse") {
-				while (parseIn.lexer.PeekTokenType(TT_PUNCTUATION, 0, &token) && token == "(") {
-					parseIn.lexer.ExpectTokenString("(");
-					ImpulseMoment imp;
-					imp.impulse = parseIn.lexer.ParseInt();
-					imp.param = parseIn.lexer.ParseFloat();
-					plan.impulse.Append(imp);
-					parseIn.lexer.ExpectTokenString(")");
-				}
-				plan.impulse.Reverse();
-				continue;
-			}
-
-			idList<CubicSpan> *series = 0;
-			int len = -1;
-			idStr suffix;
-			if (token.Left(6) == "button") {
-				series = plan.buttons;  len = 8;
-				suffix = token.Right(token.Length() - 6);
-			}
-			if (token.Left(4) == "move") {
-				series = plan.moves;  len = 3;
-				suffix = token.Right(token.Length() - 4);
-			}
-			if (token.Left(5) == "angle") {
-				series = plan.angles;  len = 3;
-				suffix = token.Right(token.Length() - 5);
-			}
-
-			if (series == 0)
-				parseIn.lexer.Error("Expected signal or impulses, found '%s'", token.c_str());
-			int index = -1;
-			sscanf(suffix.c_str(), "%d", &index);
-			if (index < 0 || index >= len)
-				parseIn.lexer.Error("Signal index is too large: %d", index);
-			idList<CubicSpan> &signal = series[index];
-
-			while (parseIn.lexer.PeekTokenType(TT_PUNCTUATION, 0, &token) && token == "(") {
-				parseIn.lexer.ExpectTokenString("(");
-				CubicSpan span;
-				span.startValue = parseIn.lexer.ParseFloat();
-				span.endValue = parseIn.lexer.ParseFloat();
-				span.startDeriv = parseIn.lexer.ParseFloat();
-				span.endDeriv = parseIn.lexer.ParseFloat();
-				span.startParam = parseIn.lexer.ParseFloat();
-				span.endParam = parseIn.lexer.ParseFloat();
-				signal.Append(span);
-				parseIn.lexer.ExpectTokenString(")");
-			}
-			signal.Reverse();
-		}
-
-		plan.Finalize();
-		gameControlPlan_time = plan.GetTimeNow();
+		ParseGameControlPlan(parseIn.lexer);
+		gameControlPlan.Finalize();
+		gameControlPlan_time = gameControlPlan.GetTimeNow();
 
 		return;
 	}
@@ -456,6 +378,99 @@ void Automation::ParseAction(ParseIn &parseIn) {
 	}
 }
 
+bool Automation::ParseGameControlPlan(idLexer &lexer) {
+	idToken token;
+	GameplayControlPlan &plan = gameControlPlan;
+	plan.Clear();
+
+	while (!lexer.EndOfFile()) {
+		//lexers with LEXFL_NOFATALERRORS return from errors
+		if (lexer.HadError())
+			return false;
+		lexer.ExpectTokenType(TT_NAME, 0, &token);
+
+		if (token == "timemode") {
+			lexer.ExpectTokenType(TT_STRING, 0, &token);
+			if (token.Left(5) == "astro")
+				plan.timeMode = GameplayControlPlan::tmAstronomical;
+			else if (token.Left(4) == "game")
+				plan.timeMode = GameplayControlPlan::tmGamePhysics;
+			else
+				lexer.Error("Expected time mode, found '%s'", token.c_str());
+			continue;
+		}
+
+		if (token == "anglemode") {
+			lexer.ExpectTokenType(TT_STRING, 0, &token);
+			if (token.Left(3) == "abs")
+				plan.angleMode = GameplayControlPlan::amAbsolute;
+			else if (token.Left(3) == "rel")
+				plan.angleMode = GameplayControlPlan::amRelative;
+			else if (token == "smooth")
+				plan.angleMode = GameplayControlPlan::amSmooth;
+			else
+				lexer.Error("Expected angle mode, found '%s'", token.c_str());
+			continue;
+		}
+
+		if (token == "impulse") {
+			while (lexer.PeekTokenType(TT_PUNCTUATION, 0, &token) && token == "(") {
+				lexer.ExpectTokenString("(");
+				ImpulseMoment imp;
+				imp.impulse = lexer.ParseInt();
+				imp.param = lexer.ParseFloat();
+				plan.impulse.Append(imp);
+				lexer.ExpectTokenString(")");
+			}
+			plan.impulse.Reverse();
+			continue;
+		}
+
+		idList<CubicSpan> *series = 0;
+		int len = -1;
+		idStr suffix;
+		if (token.Left(6) == "button") {
+			series = plan.buttons;  len = 8;
+			suffix = token.Right(token.Length() - 6);
+		}
+		if (token.Left(4) == "move") {
+			series = plan.moves;  len = 3;
+			suffix = token.Right(token.Length() - 4);
+		}
+		if (token.Left(5) == "angle") {
+			series = plan.angles;  len = 3;
+			suffix = token.Right(token.Length() - 5);
+		}
+
+		if (series == 0) {
+			lexer.Error("Expected signal or impulses, found '%s'", token.c_str());
+			return false;
+		}
+		int index = -1;
+		sscanf(suffix.c_str(), "%d", &index);
+		if (index < 0 || index >= len) {
+			lexer.Error("Signal index is too large: %d", index);
+			return false;
+		}
+		idList<CubicSpan> &signal = series[index];
+
+		while (lexer.PeekTokenType(TT_PUNCTUATION, 0, &token) && token == "(") {
+			lexer.ExpectTokenString("(");
+			CubicSpan span;
+			span.startValue = lexer.ParseFloat();
+			span.endValue = lexer.ParseFloat();
+			span.startDeriv = lexer.ParseFloat();
+			span.endDeriv = lexer.ParseFloat();
+			span.startParam = lexer.ParseFloat();
+			span.endParam = lexer.ParseFloat();
+			signal.Append(span);
+			lexer.ExpectTokenString(")");
+		}
+		signal.Reverse();
+	}
+	return !lexer.HadError();
+}
+
 void Automation::WriteGameControlResponse(const char *message) {
 	WriteResponse(gameControlPlan_seqno, message);
 	gameControlPlan_seqno = -1;
@@ -576,6 +591,173 @@ void Automation::Think() {
 		ParseMessage(message.Ptr(), message.Num());
 }
 
+void Automation::StartBenchmark(const idCmdArgs &args) {
+	if (args.Argc() < 3) {
+		common->Printf(
+			"usage: benchmark <map> <plan file> [report file] [quit]\n"
+			"Loads the map and replays the gameplay plan (same syntax as automation \"gamectrl\" action)\n"
+			"with one fixed tic per frame and backend rendering disabled, then writes timings report as JSON.\n"
+		);
+		return;
+	}
+	if (benchmark.state != Benchmark::bsNone) {
+		common->Warning("Benchmark is already running");
+		return;
+	}
+
+	benchmark.mapName = args.Argv(1);
+	benchmark.planName = args.Argv(2);
+	benchmark.reportName = (args.Argc() > 3 ? args.Argv(3) : "benchmark.json");
+	benchmark.quitWhenDone = (args.Argc() > 4 && idStr::Icmp(args.Argv(4), "quit") == 0);
+
+	//parse plan now, so that syntax errors are reported before map is loaded
+	char *text = nullptr;
+	int len = fileSystem->ReadFile(benchmark.planName, (void**)&text);
+	if (len < 0) {
+		common->Warning("Benchmark cannot read plan file %s", benchmark.planName.c_str());
+		return;
+	}
+	idLexer lexer(text, len, benchmark.planName, LEXFL_NOFATALERRORS);
+	if (gameControlPlan_seqno >= 0)
+		WriteGameControlResponse("interrupted");
+	bool parsed = ParseGameControlPlan(lexer);
+	fileSystem->FreeFile(text);
+	if (!parsed) {
+		common->Warning("Benchmark cannot parse plan file %s", benchmark.planName.c_str());
+		gameControlPlan.Clear();
+		return;
+	}
+
+	//plans with astronomical time depend on frame rate, which is the very thing being measured
+	if (gameControlPlan.timeMode != GameplayControlPlan::tmGamePhysics) {
+		common->Printf("Benchmark: plan time mode changed to game time\n");
+		gameControlPlan.timeMode = GameplayControlPlan::tmGamePhysics;
+	}
+
+	benchmark.state = Benchmark::bsLoading;
+	benchmark.loadStartTime = Sys_GetTimeMicroseconds();
+	benchmark.frames.Clear();
+	common->Printf("Benchmark: loading map %s\n", benchmark.mapName.c_str());
+	cmdSystem->BufferCommandText(CMD_EXEC_APPEND, va("map %s\n", benchmark.mapName.c_str()));
+}
+
+void Automation::BenchmarkFrame() {
+	if (benchmark.state == Benchmark::bsLoading) {
+		idPlayer *player = gameLocal.GetLocalPlayer();
+		idStr loadedMap = gameLocal.GetMapName();
+		idStr wantedMap = benchmark.mapName;
+		bool mapLoaded = loadedMap.StripPath().StripFileExtension().Icmp(wantedMap.StripPath().StripFileExtension()) == 0;
+
+		if (!mapLoaded || !player || gameLocal.GameState() != GAMESTATE_ACTIVE || session->GetGui(idSession::gtActive)) {
+			//give up if map does not start within a minute
+			if (Sys_GetTimeMicroseconds() - benchmark.loadStartTime > 60 * 1000000ULL) {
+				common->Warning("Benchmark: map %s did not start", benchmark.mapName.c_str());
+				FinishBenchmark(false);
+			}
+			return;
+		}
+
+		gameControlPlan.Finalize();
+		gameControlPlan_time = gameControlPlan.GetTimeNow();
+
+		//backend only consumes GPU time, which is not measured
+		benchmark.oldSkipBackEnd = cvarSystem->GetCVarBool("r_skipBackEnd");
+		cvarSystem->SetCVarBool("r_skipBackEnd", true);
+
+		benchmark.state = Benchmark::bsRunning;
+		benchmark.runStartTime = Sys_GetTimeMicroseconds();
+		benchmark.runStartGameTime = gameLocal.time;
+		common->Printf("Benchmark: replaying %s\n", benchmark.planName.c_str());
+		//timings of this frame were collected before the plan started
+		return;
+	}
+
+	if (benchmark.state == Benchmark::bsRunning) {
+		benchmark.frames.Append(com_frameTimings);
+
+		if (!gameLocal.GetLocalPlayer()) {
+			common->Warning("Benchmark: map was unloaded during replay");
+			FinishBenchmark(false);
+		}
+		else if (!gameControlPlan.IsAlive()) {
+			FinishBenchmark(true);
+		}
+	}
+}
+
+void Automation::FinishBenchmark(bool completed) {
+	if (benchmark.state == Benchmark::bsRunning) {
+		cvarSystem->SetCVarBool("r_skipBackEnd", benchmark.oldSkipBackEnd);
+		gameControlPlan.Kill();
+		WriteBenchmarkReport(completed);
+	}
+	benchmark.state = Benchmark::bsNone;
+	benchmark.frames.ClearFree();
+
+	if (benchmark.quitWhenDone)
+		cmdSystem->BufferCommandText(CMD_EXEC_APPEND, "quit\n");
+}
+
+void Automation::WriteBenchmarkReport(bool completed) {
+	static const struct {
+		const char *name;
+		int frameTimings_t::*member;
+	} phases[] = {
+		{"frame", &frameTimings_t::frame},
+		{"events", &frameTimings_t::events},
+		{"gameTic", &frameTimings_t::gameTic},
+		{"frontend", &frameTimings_t::frontend},
+		{"sound", &frameTimings_t::sound},
+	};
+	static const int percentiles[] = {50, 90, 95, 99};
+
+	int numFrames = benchmark.frames.Num();
+	double wallTime = (Sys_GetTimeMicroseconds() - benchmark.runStartTime) * 1e-3;
+	int gameTime = gameLocal.time - benchmark.runStartGameTime;
+
+	idFile *f = fileSystem->OpenFileWrite(benchmark.reportName);
+	if (!f) {
+		common->Warning("Benchmark cannot write report to %s", benchmark.reportName.c_str());
+		return;
+	}
+	f->Printf("{\n");
+	f->Printf("\t\"map\": \"%s\",\n", benchmark.mapName.c_str());
+	f->Printf("\t\"plan\": \"%s\",\n", benchmark.planName.c_str());
+	f->Printf("\t\"completed\": %s,\n", completed ? "true" : "false");
+	f->Printf("\t\"frames\": %d,\n", numFrames);
+	f->Printf("\t\"gameTimeMs\": %d,\n", gameTime);
+	f->Printf("\t\"wallTimeMs\": %.3f,\n", wallTime);
+	f->Printf("\t\"phasesMs\": {\n");
+
+	common->Printf("Benchmark %s: %d frames in %.0f ms\n", (completed ? "finished" : "aborted"), numFrames, wallTime);
+	idList<int> values;
+	for (int p = 0; p < sizeof(phases) / sizeof(phases[0]); p++) {
+		values.SetNum(numFrames);
+		double sum = 0.0;
+		for (int i = 0; i < numFrames; i++) {
+			values[i] = benchmark.frames[i].*phases[p].member;
+			sum += values[i];
+		}
+		std::sort(values.begin(), values.end());
+
+		idStr line = va("\t\t\"%s\": { \"mean\": %.3f", phases[p].name, numFrames ? sum / numFrames * 1e-3 : 0.0);
+		for (int q = 0; q < sizeof(percentiles) / sizeof(percentiles[0]); q++) {
+			//nearest-rank percentile
+			int rank = (percentiles[q] * numFrames + 99) / 100 - 1;
+			int value = numFrames ? values[idMath::ClampInt(0, numFrames - 1, rank)] : 0;
+			line += va(", \"p%d\": %.3f", percentiles[q], value * 1e-3);
+		}
+		line += va(", \"max\": %.3f }", numFrames ? values[numFrames - 1] * 1e-3 : 0.0);
+		f->Printf("%s%s\n", line.c_str(), (p + 1 < sizeof(phases) / sizeof(phases[0]) ? "," : ""));
+		common->Printf("  %s\n", line.c_str() + 2);
+	}
+
+	f->Printf("\t}\n");
+	f->Printf("}\n");
+	fileSystem->CloseFile(f);
+	common->Printf("Benchmark report written to %s\n", benchmark.reportName.c_str());
+}
+
 void Auto_Think() {
 	automation->Think();
 }
@@ -583,3 +765,15 @@ void Auto_Think() {
 bool Auto_GetUsercmd(usercmd_t &cmd) {
 	return automation->GetUsercmd(cmd);
 }
+
+void Auto_BenchmarkFrame() {
+	automation->BenchmarkFrame();
+}
+
+bool Auto_IsBenchmarkRunning() {
+	return automation->IsBenchmarkRunning();
+}
+
+void Auto_Benchmark_f(const idCmdArgs &args) {
+	automation->StartBenchmark(args);
+}
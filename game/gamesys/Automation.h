@@ -29,4 +29,11 @@ void Auto_Think();
 //check if automation locks user's gameplay input, and return that input if it does
 bool Auto_GetUsercmd(usercmd_t &cmd);
 
+//called at the end of every frame: drives the built-in benchmark and collects its timings
+void Auto_BenchmarkFrame();
+//true while benchmark replays its plan: session must run exactly one fixed tic per frame
+bool Auto_IsBenchmarkRunning();
+//"benchmark" console command
+void Auto_Benchmark_f(const idCmdArgs &args);
+
 #endif
@@ -81,6 +81,10 @@ public:
 
 	void Think();
 
+	void StartBenchmark(const idCmdArgs &args);
+	void BenchmarkFrame();
+	bool IsBenchmarkRunning() const { return benchmark.state == Benchmark::bsRunning; }
+
 private:
 	//low-level TCP socket connection with automation script
 	//we can get/put bytes from/to it =)
@@ -96,6 +100,26 @@ private:
 	//time moment when the current plan was started (used to understand where we are in the plan)
 	int gameControlPlan_time = -1;
 
+	//built-in benchmark: loads a map and replays a plan from file without external tool
+	struct Benchmark {
+		enum State {
+			bsNone = 0,		//not running
+			bsLoading,		//map change issued, waiting until player can play
+			bsRunning,		//replaying the plan with fixed timestep
+		};
+		State state = bsNone;
+		idStr mapName;
+		idStr planName;
+		idStr reportName;
+		bool quitWhenDone = false;
+		bool oldSkipBackEnd = false;
+		uint64_t loadStartTime = 0;
+		uint64_t runStartTime = 0;
+		int runStartGameTime = 0;
+		idList<frameTimings_t> frames;
+	};
+	Benchmark benchmark;
+
 	//info about current input message being parsed
 	struct ParseIn {
 		const char *message;
@@ -108,6 +132,9 @@ private:
 	void ParseMessage(ParseIn &parseIn);
 	void ParseAction(ParseIn &parseIn);
 	void ParseQuery(ParseIn &parseIn);
+	bool ParseGameControlPlan(idLexer &lexer);
+	void FinishBenchmark(bool completed);
+	void WriteBenchmarkReport(bool completed);
 	void WriteResponse(int seqno, const char *response);
 	void WriteGameControlResponse(const char *message);
 };
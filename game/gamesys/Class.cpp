@@ -626,6 +626,10 @@ idClass::CancelEvents
 ================
 */
 void idClass::CancelEvents( const idEventDef *ev ) {
+	if ( ParallelThinkBatch *batch = ParallelThinkBatch::Current() ) {
+		batch->CancelEvents( this, ev );
+		return;
+	}
 	idEvent::CancelEvents( this, ev );
 }
 
@@ -652,6 +656,12 @@ bool idClass::PostEventArgs( const idEventDef *ev, int time, int numargs, ... )
 	}
 
 	va_start( args, numargs );
+	if ( ParallelThinkBatch *batch = ParallelThinkBatch::Current() ) {
+		// keep the event queue untouched until the think jobs are done
+		batch->PostEvent( ev, numargs, args, this, c, time );
+		va_end( args );
+		return true;
+	}
 	event = idEvent::Alloc( ev, numargs, args );
 	va_end( args );
 
@@ -72,7 +72,199 @@ The InitializeCache must be called before any ordinary data is read from the fil
 It uses fseek to get offset to cache image, then reads it, probably decompresses it.
 Afterwards it fseeks to the file position on the moment of call.
 Then all the Read* happens which reads ordinary data from cache and special data from file.
+
+The cache is compressed in blocks of SAVEGAME_BLOCK_SIZE bytes, every block is an independent
+zlib stream, so the blocks are compressed and decompressed in parallel jobs. The cache image is:
+	1. Negative number of blocks (older savegames have the size of their single zlib stream here)
+	2. Uncompressed cache size
+	3. Compressed size of every block
+	4. Compressed blocks
+With tdm_savegame_async, FinalizeCache only hands the cache over to the jobs and returns.
+The session has closed the file by the time the last job appends the cache image to it,
+idSaveGame::FinishWrite must be called before the file is opened again.
+*/
+
+// the cache is compressed in blocks of this size
+#define SAVEGAME_BLOCK_SIZE		( 1 << 20 )
+#define MAX_SAVEGAME_JOBS		32
+
+typedef struct saveGameBlocks_s {
+	CRawVector				cache;			// uncompressed, SAVEGAME_BLOCK_SIZE bytes for every block but the last one
+	CRawVector				zipped;
+	int						numBlocks;
+	idList<int>				zipOffsets;		// of every block in zipped
+	idList<int>				zipSizes;
+	idList<int>				errors;			// zlib result of every block
+	idStr					fileName;		// the blocks are appended to this file by a job, empty if FinalizeCache writes them
+	bool					written;
+} saveGameBlocks_t;
+
+typedef struct saveGameJob_s {
+	saveGameBlocks_t *		blocks;
+	int						first;
+	int						last;
+} saveGameJob_t;
+
+static saveGameBlocks_t		saveGameBlocks;		// of the savegame being written
+static saveGameJob_t		saveGameJobs[MAX_SAVEGAME_JOBS];
+static idParallelJobList *	saveGameJobList = NULL;
+
+/*
+================
+SaveGame_InitBlocks
+================
+*/
+static void SaveGame_InitBlocks( saveGameBlocks_t &blocks ) {
+	blocks.numBlocks = Max( 1, ( blocks.cache.size() + SAVEGAME_BLOCK_SIZE - 1 ) / SAVEGAME_BLOCK_SIZE );
+	blocks.zipOffsets.SetNum( blocks.numBlocks );
+	blocks.zipSizes.SetNum( blocks.numBlocks );
+	blocks.errors.SetNum( blocks.numBlocks );
+	blocks.written = false;
+}
+
+/*
+================
+SaveGame_FreeBlocks
+================
+*/
+static void SaveGame_FreeBlocks( saveGameBlocks_t &blocks ) {
+	// CRawVector never shrinks
+	CRawVector cache, zipped;
+	std::swap( blocks.cache, cache );
+	std::swap( blocks.zipped, zipped );
+	blocks.numBlocks = 0;
+	blocks.zipOffsets.Clear();
+	blocks.zipSizes.Clear();
+	blocks.errors.Clear();
+	blocks.fileName.Clear();
+}
+
+/*
+================
+SaveGame_BlockSize
+================
+*/
+static int SaveGame_BlockSize( const saveGameBlocks_t &blocks, int i ) {
+	return Min( SAVEGAME_BLOCK_SIZE, blocks.cache.size() - i * SAVEGAME_BLOCK_SIZE );
+}
+
+/*
+================
+SaveGame_WriteBlocks
+
+Writes the cache image followed by the offset from the end of the file to its start.
+Returns false if a block could not be compressed.
+================
+*/
+static bool SaveGame_WriteBlocks( idFile *file, const saveGameBlocks_t &blocks ) {
+	int i;
+
+	for ( i = 0; i < blocks.numBlocks; i++ ) {
+		if ( blocks.errors[i] != Z_OK ) {
+			return false;
+		}
+	}
+
+	int offset = sizeof(int);
+
+	//write number of blocks and uncompressed size
+	file->WriteInt(-blocks.numBlocks);			offset += sizeof(int);
+	file->WriteInt(blocks.cache.size());		offset += sizeof(int);
+	//write compressed size of every block
+	for ( i = 0; i < blocks.numBlocks; i++ ) {
+		file->WriteInt(blocks.zipSizes[i]);		offset += sizeof(int);
+	}
+	//write compressed data
+	for ( i = 0; i < blocks.numBlocks; i++ ) {
+		file->Write(&blocks.zipped[blocks.zipOffsets[i]], blocks.zipSizes[i]);
+		offset += blocks.zipSizes[i];
+	}
+	//write offset from EOF to cache start
+	file->WriteInt(-offset);
+
+	return true;
+}
+
+/*
+================
+SaveGameCompressJob
+================
+*/
+void SaveGameCompressJob( saveGameJob_t *job ) {
+	saveGameBlocks_t *blocks = job->blocks;
+	for ( int i = job->first; i < job->last; i++ ) {
+		uLongf zipSize = blocks->zipSizes[i];
+		blocks->errors[i] = ExtLibs::compress(
+			(Bytef *)&blocks->zipped[blocks->zipOffsets[i]], &zipSize,
+			(const Bytef *)&blocks->cache[i * SAVEGAME_BLOCK_SIZE], (uLongf)SaveGame_BlockSize( *blocks, i )
+		);
+		blocks->zipSizes[i] = zipSize;
+	}
+}
+
+REGISTER_PARALLEL_JOB( SaveGameCompressJob, "SaveGameCompressJob" );
+
+/*
+================
+SaveGameAppendJob
+
+Runs after all blocks are compressed.
+================
+*/
+void SaveGameAppendJob( saveGameBlocks_t *blocks ) {
+	idFile *file = fileSystem->OpenFileAppend( blocks->fileName );
+	if ( file ) {
+		blocks->written = SaveGame_WriteBlocks( file, *blocks );
+		fileSystem->CloseFile( file );
+	}
+}
+
+REGISTER_PARALLEL_JOB( SaveGameAppendJob, "SaveGameAppendJob" );
+
+/*
+================
+SaveGameDecompressJob
+================
+*/
+void SaveGameDecompressJob( saveGameJob_t *job ) {
+	saveGameBlocks_t *blocks = job->blocks;
+	for ( int i = job->first; i < job->last; i++ ) {
+		const int blockSize = SaveGame_BlockSize( *blocks, i );
+		uLongf size = blockSize;
+		blocks->errors[i] = ExtLibs::uncompress(
+			(Bytef *)&blocks->cache[i * SAVEGAME_BLOCK_SIZE], &size,
+			(const Bytef *)&blocks->zipped[blocks->zipOffsets[i]], (uLongf)blocks->zipSizes[i]
+		);
+		if ( blocks->errors[i] == Z_OK && size != blockSize ) {
+			blocks->errors[i] = Z_DATA_ERROR;
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB( SaveGameDecompressJob, "SaveGameDecompressJob" );
+
+/*
+================
+SaveGame_AddJobs
+
+Splits the blocks between the jobs, returns the number of jobs added to the job list.
+================
 */
+static int SaveGame_AddJobs( saveGameBlocks_t &blocks, jobRun_t function, int jobHandles[MAX_SAVEGAME_JOBS] ) {
+	if ( !saveGameJobList ) {
+		// one more for the append job
+		saveGameJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_SAVEGAME_JOBS + 1, 0, NULL );
+	}
+
+	const int numJobs = Min( blocks.numBlocks, MAX_SAVEGAME_JOBS );
+	for ( int i = 0; i < numJobs; i++ ) {
+		saveGameJobs[i].blocks = &blocks;
+		saveGameJobs[i].first = blocks.numBlocks * i / numJobs;
+		saveGameJobs[i].last = blocks.numBlocks * ( i + 1 ) / numJobs;
+		jobHandles[i] = saveGameJobList->AddJob( function, &saveGameJobs[i] );
+	}
+	return numJobs;
+}
 
 idSaveGame::idSaveGame( idFile *savefile ) {
 
@@ -112,32 +304,79 @@ void idSaveGame::Close( void ) {
 
 void idSaveGame::FinalizeCache( void ) {
 	if (!isCompressed) return;
-		
-	int offset = sizeof(int);
+
+	// the previous savegame may still be in the jobs
+	FinishWrite();
+
+	saveGameBlocks_t &blocks = saveGameBlocks;
+	std::swap(blocks.cache, cache);
+	SaveGame_InitBlocks(blocks);
 
 	//resize destination buffer
-	CRawVector zipped;
-	uLongf zipsize = ExtLibs::compressBound((uLongf)cache.size());
-	zipped.resize(zipsize);
+	const int zipBound = ExtLibs::compressBound(SAVEGAME_BLOCK_SIZE);
+	blocks.zipped.resize(blocks.numBlocks * zipBound);
+	for (int i = 0; i < blocks.numBlocks; i++) {
+		blocks.zipOffsets[i] = i * zipBound;
+		blocks.zipSizes[i] = zipBound;
+	}
 
 	//compress the cache
-	int err = ExtLibs::compress(
-		(Bytef *)&zipped[0], &zipsize,
-		(const Bytef *)&cache[0], (uLongf)cache.size()
-	);
-	if (err != Z_OK)
-		gameLocal.Error("idSaveGame::FinalizeCache: compress failed with code %d", err);
-	zipped.resize(zipsize);
-
-	//write compressed size and uncompressed size
-	file->WriteInt(zipped.size());				offset += sizeof(int);
-	file->WriteInt(cache.size());				offset += sizeof(int);
-	//write compressed data
-	file->Write(&zipped[0], zipped.size());		offset += zipped.size();
-	//write offset from EOF to cache start
-	file->WriteInt(-offset);
+	int jobHandles[MAX_SAVEGAME_JOBS];
+	const int numJobs = SaveGame_AddJobs(blocks, (jobRun_t)SaveGameCompressJob, jobHandles);
+
+	if (cv_savegame_async.GetBool()) {
+		// the blocks are appended by another file handle, nothing written so far may stay in the buffer of this one
+		file->Flush();
+		blocks.fileName = file->GetName();
+
+		const int appendJob = saveGameJobList->AddJob((jobRun_t)SaveGameAppendJob, &blocks);
+		for (int i = 0; i < numJobs; i++) {
+			saveGameJobList->AddDependency(appendJob, jobHandles[i]);
+		}
+		saveGameJobList->Submit();
+		return;
+	}
+
+	saveGameJobList->Submit();
+	saveGameJobList->Wait();
+
+	for (int i = 0; i < blocks.numBlocks; i++) {
+		if (blocks.errors[i] != Z_OK)
+			gameLocal.Error("idSaveGame::FinalizeCache: compress failed with code %d", blocks.errors[i]);
+	}
+	SaveGame_WriteBlocks(file, blocks);
+
+	SaveGame_FreeBlocks(blocks);
+}
+
+/*
+================
+idSaveGame::FinishWrite
 
-	cache.clear();
+Waits for the jobs compressing and appending the cache of the last savegame.
+================
+*/
+void idSaveGame::FinishWrite( void ) {
+	if ( saveGameJobList && saveGameJobList->IsSubmitted() ) {
+		saveGameJobList->Wait();
+	}
+
+	if ( saveGameBlocks.fileName.Length() && !saveGameBlocks.written ) {
+		gameLocal.Warning( "Failed to write savegame %s", saveGameBlocks.fileName.c_str() );
+	}
+	SaveGame_FreeBlocks( saveGameBlocks );
+}
+
+/*
+================
+idSaveGame::Shutdown
+================
+*/
+void idSaveGame::Shutdown( void ) {
+	FinishWrite();
+
+	parallelJobManager->FreeJobList( saveGameJobList );
+	saveGameJobList = NULL;
 }
 
 void idSaveGame::WriteObjectList( void ) {
@@ -597,7 +836,7 @@ void idRestoreGame::InitializeCache() {
 	//read compressed cache size
 	int zipSize = -1;
 	file->ReadInt(zipSize);
-	if (zipSize <= 0)
+	if (zipSize == 0)
 		Error("idRestoreGame::InitializeCache: bad compressed cache size (%d)", zipSize);
 
 	//read decompressed cache size
@@ -606,23 +845,29 @@ void idRestoreGame::InitializeCache() {
 	if (cacheSize <= 0)
 		Error("idRestoreGame::InitializeCache: bad uncompressed cache size (%d)", cacheSize);
 
-	//read compressed data
-	CRawVector zipped;
-	zipped.resize(zipSize);
-	cache.resize(cacheSize);
-	file->Read(&zipped[0], zipped.size());
-
-	//decompress data
-	uLongf cacheSizeL = cacheSize;
-	int err = ExtLibs::uncompress(
-		(Bytef *)&cache[0], &cacheSizeL,
-		(const Bytef *)&zipped[0], (uLongf)zipped.size()
-	);
-	cacheSize = cacheSizeL;
-	if (err != Z_OK)
-		Error("idRestoreGame::InitializeCache: uncompress failed with code %d", err);
-	if (cacheSize != cache.size())
-		Error("idRestoreGame::InitializeCache: uncompressed size is %d instead of %d", cacheSize, cache.size());
+	if (zipSize < 0) {
+		//read and decompress the blocks
+		ReadCacheBlocks(-zipSize, cacheSize);
+	}
+	else {
+		//read compressed data
+		CRawVector zipped;
+		zipped.resize(zipSize);
+		cache.resize(cacheSize);
+		file->Read(&zipped[0], zipped.size());
+
+		//decompress data
+		uLongf cacheSizeL = cacheSize;
+		int err = ExtLibs::uncompress(
+			(Bytef *)&cache[0], &cacheSizeL,
+			(const Bytef *)&zipped[0], (uLongf)zipped.size()
+		);
+		cacheSize = cacheSizeL;
+		if (err != Z_OK)
+			Error("idRestoreGame::InitializeCache: uncompress failed with code %d", err);
+		if (cacheSize != cache.size())
+			Error("idRestoreGame::InitializeCache: uncompressed size is %d instead of %d", cacheSize, cache.size());
+	}
 
 	//set cache pointer
 	cachePointer = 0;
@@ -630,6 +875,54 @@ void idRestoreGame::InitializeCache() {
 	file->Seek(position, FS_SEEK_SET);
 }
 
+/*
+================
+idRestoreGame::ReadCacheBlocks
+
+Reads the blocks of the cache and decompresses them in parallel.
+================
+*/
+void idRestoreGame::ReadCacheBlocks( int numBlocks, int cacheSize ) {
+	saveGameBlocks_t blocks;
+
+	// the job list may still append the last savegame
+	idSaveGame::FinishWrite();
+
+	blocks.cache.resize(cacheSize);
+	SaveGame_InitBlocks(blocks);
+	if (numBlocks != blocks.numBlocks)
+		Error("idRestoreGame::InitializeCache: bad number of blocks (%d) for cache size %d", numBlocks, cacheSize);
+
+	//read compressed size of every block
+	const int zipBound = ExtLibs::compressBound(SAVEGAME_BLOCK_SIZE);
+	int zipSize = 0;
+	for (int i = 0; i < numBlocks; i++) {
+		file->ReadInt(blocks.zipSizes[i]);
+		if (blocks.zipSizes[i] <= 0 || blocks.zipSizes[i] > zipBound)
+			Error("idRestoreGame::InitializeCache: bad compressed size (%d) of block %d", blocks.zipSizes[i], i);
+		blocks.zipOffsets[i] = zipSize;
+		zipSize += blocks.zipSizes[i];
+	}
+
+	//read compressed data
+	blocks.zipped.resize(zipSize);
+	if (file->Read(&blocks.zipped[0], zipSize) != zipSize)
+		Error("idRestoreGame::InitializeCache: compressed cache is truncated");
+
+	//decompress data
+	int jobHandles[MAX_SAVEGAME_JOBS];
+	SaveGame_AddJobs(blocks, (jobRun_t)SaveGameDecompressJob, jobHandles);
+	saveGameJobList->Submit();
+	saveGameJobList->Wait();
+
+	for (int i = 0; i < numBlocks; i++) {
+		if (blocks.errors[i] != Z_OK)
+			Error("idRestoreGame::InitializeCache: uncompress of block %d failed with code %d", i, blocks.errors[i]);
+	}
+
+	std::swap(cache, blocks.cache);
+}
+
 void idRestoreGame::CreateObjects( void ) {
 	int i, num;
 	idStr classname;
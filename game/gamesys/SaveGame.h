@@ -110,6 +110,10 @@ public:
 	// Dump the contents of cache buffer to file
 	void					FinalizeCache();
 
+	// Wait until the cache of the last savegame is completely written to its file
+	static void				FinishWrite( void );
+	static void				Shutdown( void );
+
 private:
 	idFile *				file;
 
@@ -203,6 +207,7 @@ private:
 	int						cachePointer;
 
 	void					CallRestore_r( const idTypeInfo *cls, idClass *obj );
+	void					ReadCacheBlocks( int numBlocks, int cacheSize );
 };
 
 #endif /* !__SAVEGAME_H__*/
@@ -1960,6 +1960,67 @@ static void Cmd_TestDeath_f( const idCmdArgs &args ) {
 
 }
 
+/*
+==================
+Cmd_TestClipBatch_f
+
+  Traces random rays from the eye of the player one by one and as batches, and compares the results.
+==================
+*/
+static void Cmd_TestClipBatch_f( const idCmdArgs &args ) {
+	idPlayer *player;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	int num = 4096;
+	if ( args.Argc() >= 2 ) {
+		num = Max( 1, atoi( args.Argv( 1 ) ) );
+	}
+
+	idRandom random( 0 );
+	const idVec3 eye = player->GetEyePosition();
+	idList<clipTrace_t> traces;
+	traces.SetNum( num );
+	for ( int i = 0; i < num; i++ ) {
+		idVec3 dir( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() );
+		if ( dir.Normalize() == 0.0f ) {
+			dir.Set( 1.0f, 0.0f, 0.0f );
+		}
+		traces[i].start = eye;
+		traces[i].end = eye + dir * 1024.0f;
+		traces[i].mdl = NULL;
+		traces[i].trmAxis = mat3_identity;
+		traces[i].contentMask = MASK_OPAQUE;
+		traces[i].passEntity = player;
+	}
+
+	idList<trace_t> single;
+	single.SetNum( num );
+	int64 time = Sys_GetTimeMicroseconds();
+	for ( int i = 0; i < num; i++ ) {
+		gameLocal.clip.TracePoint( single[i], traces[i].start, traces[i].end, traces[i].contentMask, traces[i].passEntity );
+	}
+	const int64 singleTime = Sys_GetTimeMicroseconds() - time;
+
+	for ( int pass = 0; pass < 2; pass++ ) {
+		time = Sys_GetTimeMicroseconds();
+		gameLocal.clip.TranslationBatch( traces.Ptr(), num, pass != 0 );
+		const int64 batchTime = Sys_GetTimeMicroseconds() - time;
+
+		int mismatches = 0;
+		for ( int i = 0; i < num; i++ ) {
+			if ( traces[i].results.fraction != single[i].fraction || traces[i].results.c.entityNum != single[i].c.entityNum ) {
+				mismatches++;
+			}
+		}
+		gameLocal.Printf( "%s batch: %d traces in %.3f ms, single traces in %.3f ms, %d mismatches\n",
+			pass ? "parallel" : "serial", num, batchTime * 0.001f, singleTime * 0.001f, mismatches );
+	}
+}
+
 /*
 ==================
 Cmd_WeaponSplat_f
@@ -3608,6 +3669,7 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "testPointLight",		Cmd_TestPointLight_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"tests a point light" );
 	cmdSystem->AddCommand( "popLight",				Cmd_PopLight_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"removes the last created light" );
 	cmdSystem->AddCommand( "testDeath",				Cmd_TestDeath_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests death" );
+	cmdSystem->AddCommand( "testClipBatch",			Cmd_TestClipBatch_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"compares batched traces with single traces" );
 	cmdSystem->AddCommand( "testSave",				Cmd_TestSave_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"writes out a test savegame" );
 	cmdSystem->AddCommand( "testModel",				idTestModel::TestModel_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a model", idTestModel::ArgCompletion_TestModel );
 	cmdSystem->AddCommand( "testSkin",				idTestModel::TestSkin_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a skin on an existing testModel", idCmdSystem::ArgCompletion_Decl<DECL_SKIN> );
@@ -3703,6 +3765,7 @@ void idGameLocal::InitConsoleCommands( void ) {
 
 	cmdSystem->AddCommand( "getGameTime",			Cmd_GetGameTime_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"prints current game time (gameLocal.time) in milliseconds" );
 	cmdSystem->AddCommand( "setGameTime",			Cmd_SetGameTime_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"assigns specified value in milliseconds to game time (gameLocal.time)\nnote: this is unsafe!" );
+	cmdSystem->AddCommand( "benchmark",				Auto_Benchmark_f,			CMD_FL_GAME,				"loads a map, replays a gameplay plan with fixed timestep and writes frame timings report (usage: benchmark <map> <plan file> [report file] [quit])", idCmdSystem::ArgCompletion_MapName );
 }
 
 /*
@@ -166,12 +166,14 @@ idCVar cv_tdm_difficulty(			"tdm_difficulty",	"-1",					CVAR_GAME | CVAR_INTEGER
 
 idCVar cv_sr_disable (				"tdm_sr_disable",           "0",           CVAR_GAME | CVAR_BOOL, "Set to 1 to disable all stim/response processing." );
 idCVar cv_sr_show(					"tdm_show_stimresponse",    "0",           CVAR_GAME | CVAR_INTEGER, "Set to 1 to show all successful stims, set to 2 to show all including failed ones." );
+idCVar cv_sr_broadphase(			"tdm_sr_broadphase",        "0",           CVAR_GAME | CVAR_INTEGER, "How stims find the entities with responses they reach:\n 0 - query the clip octree for every stim\n 1 - collect the stims of a frame and query an octree of the responders only\n 2 - same as 1, with the queries running in parallel jobs\nWith 1 and 2 stims see the responders where they were at the start of the frame and may reach them in a different order.", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 
 idCVar cv_debug_mainmenu(			"tdm_debug_mainmenu",      "0",            CVAR_BOOL, "Set to 1 to enable main menu GUI debugging in the console." );
 idCVar cv_mainmenu_confirmquit(		"tdm_mainmenu_confirmquit",      "1", CVAR_ARCHIVE | CVAR_BOOL, "Set to 0 to disable the 'Quit Game' confirmation dialog when exiting the game." );
 
 idCVar cv_force_savegame_load(		"tdm_force_savegame_load", "0",   CVAR_BOOL|CVAR_ARCHIVE, "Set to 1 to enable force loading of save games in case of version mismatch." );
 idCVar cv_savegame_compress(		"tdm_savegame_compress", "1",   CVAR_BOOL|CVAR_ARCHIVE, "Set to 0 to disable savegame file compression." );
+idCVar cv_savegame_async(			"tdm_savegame_async", "1",   CVAR_BOOL|CVAR_ARCHIVE, "Set to 0 to compress and write the savegame before the game goes on. Only used with tdm_savegame_compress." );
 
 /**
 * Dark Mod player movement
@@ -644,6 +646,10 @@ idCVar g_frametime(					"g_frametime",				"0",			CVAR_GAME | CVAR_BOOL, "display
 
 // TDM: greebo: Use this to stretch the hardcoded 16 msec each frame takes. This can be used to let the game run ultra-slow.
 idCVar g_timeModifier(				"g_timeModifier",			"1",			CVAR_GAME | CVAR_FLOAT, "Use this to stretch the hardcoded 16 msec each frame takes. This can be used to let the game run ultra-slow." );
+idCVar g_parallelThink(				"g_parallelThink",			"0",			CVAR_GAME | CVAR_BOOL, "let entities that declare themselves parallel-safe think in jobs, with their side effects applied afterward" );
+idCVar g_clipBatchCheck(			"g_clipBatchCheck",			"0",			CVAR_GAME | CVAR_BOOL, "repeat every trace of idClip::TranslationBatch and ContentsBatch one by one and warn if the results differ" );
+idCVar g_parallelAnim(				"g_parallelAnim",			"1",			CVAR_GAME | CVAR_BOOL, "create the poses of the animated entities in jobs at the end of the game frame instead of when the renderer asks for them" );
+idCVar g_animFrameCache(			"g_animFrameCache",			"32",			CVAR_GAME | CVAR_INTEGER, "MB of memory for anim frames decoded once and shared by all animators, 0 disables" );
 idCVar g_timeentities(				"g_timeEntities",			"0",			CVAR_GAME | CVAR_FLOAT, "when non-zero, shows entities whose think functions exceeded the # of milliseconds specified" );
 
 
@@ -697,6 +703,7 @@ idCVar af_useLinearTime(			"af_useLinearTime",			"1",			CVAR_GAME | CVAR_BOOL, "
 idCVar af_useImpulseFriction(		"af_useImpulseFriction",	"0",			CVAR_GAME | CVAR_BOOL, "use impulse based contact friction" );
 idCVar af_useJointImpulseFriction(	"af_useJointImpulseFriction","0",			CVAR_GAME | CVAR_BOOL, "use impulse based joint friction" );
 idCVar af_useSymmetry(				"af_useSymmetry",			"1",			CVAR_GAME | CVAR_BOOL, "use constraint matrix symmetry" );
+idCVar af_batchSolver(				"af_batchSolver",			"1",			CVAR_GAME | CVAR_BOOL, "build the auxiliary constraint matrix with SIMD, calculate the responses of independent trees and the rows of large matrices in parallel jobs" );
 #ifdef MOD_WATERPHYSICS
 
 idCVar af_useBodyDensityBuoyancy(   "af_useBodyDensityBuoyancy","0",            CVAR_GAME | CVAR_BOOL, "uses density of each body to calculate buoyancy"); // MOD_WATERPHYSICS
@@ -738,6 +745,7 @@ idCVar rb_showMass(					"rb_showMass",				"0",			CVAR_GAME | CVAR_BOOL, "show th
 idCVar rb_showInertia(				"rb_showInertia",			"0",			CVAR_GAME | CVAR_BOOL, "show the inertia tensor of each rigid body" );
 idCVar rb_showVelocity(				"rb_showVelocity",			"0",			CVAR_GAME | CVAR_BOOL, "show the velocity of each rigid body" );
 idCVar rb_showActive(				"rb_showActive",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid bodies that are not at rest" );
+idCVar rb_islands(					"rb_islands",				"1",			CVAR_GAME | CVAR_BOOL, "group the moving rigid bodies into islands and predict their collision traces in parallel jobs before the entities think" );
 #ifdef MOD_WATERPHYSICS
 
 idCVar rb_showBuoyancy(             "rb_showBuoyancy",          "0",            CVAR_GAME | CVAR_BOOL, "show rigid body buoyancy information" ); // MOD_WATERPHYSICS
@@ -831,6 +839,8 @@ idCVar aas_pullPlayer(				"aas_pullPlayer",			"0",			CVAR_GAME | CVAR_INTEGER, "
 idCVar aas_randomPullPlayer(		"aas_randomPullPlayer",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar aas_goalArea(				"aas_goalArea",				"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showPushIntoArea(		"aas_showPushIntoArea",		"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar aas_precomputeRouting(		"aas_precomputeRouting",	"0",			CVAR_GAME | CVAR_BOOL | CVAR_ARCHIVE, "precompute the routing cache of all clusters for walking AI at map load" );
+idCVar aas_precomputeRoutingMemory(	"aas_precomputeRoutingMemory",	"64",		CVAR_GAME | CVAR_INTEGER | CVAR_ARCHIVE, "memory limit of the precomputed routing cache per AAS in MB" );
 
 idCVar g_password(					"g_password",				"",				CVAR_GAME | CVAR_ARCHIVE, "game password" );
 idCVar clientPassword(					"password",					"",				CVAR_GAME | CVAR_NOCHEAT, "client password used when connecting" );
@@ -117,6 +117,7 @@ extern idCVar cv_tdm_difficulty;
 
 extern idCVar cv_sr_disable;
 extern idCVar cv_sr_show;
+extern idCVar cv_sr_broadphase;
 
 extern idCVar cv_sndprop_disable;
 extern idCVar cv_spr_debug;
@@ -208,6 +209,7 @@ extern idCVar cv_ai_search_type; // grayman #4220 - control type of search
 
 extern idCVar cv_force_savegame_load;
 extern idCVar cv_savegame_compress;
+extern idCVar cv_savegame_async;
 
 // angua: TDM toggle crouch
 extern idCVar cv_tdm_crouch_toggle;
@@ -495,6 +497,10 @@ extern idCVar	g_showActiveEntities;
 extern idCVar	g_showEnemies;
 
 extern idCVar	g_frametime;
+extern idCVar	g_parallelThink;
+extern idCVar	g_clipBatchCheck;
+extern idCVar	g_parallelAnim;
+extern idCVar	g_animFrameCache;
 extern idCVar	g_timeentities;
 
 extern idCVar	g_timeModifier;
@@ -543,6 +549,7 @@ extern idCVar	af_useLinearTime;
 extern idCVar	af_useImpulseFriction;
 extern idCVar	af_useJointImpulseFriction;
 extern idCVar	af_useSymmetry;
+extern idCVar	af_batchSolver;
 extern idCVar	af_skipSelfCollision;
 extern idCVar	af_skipLimits;
 extern idCVar	af_skipFriction;
@@ -571,6 +578,7 @@ extern idCVar	af_showActive;
 extern idCVar	af_testSolid;
 
 extern idCVar	rb_showTimings;
+extern idCVar	rb_islands;
 extern idCVar	rb_showBodies;
 extern idCVar	rb_showMass;
 extern idCVar	rb_showInertia;
@@ -656,6 +664,8 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_precomputeRouting;
+extern idCVar	aas_precomputeRoutingMemory;
 
 extern idCVar	net_clientPredictGUI;
 
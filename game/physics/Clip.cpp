@@ -21,6 +21,8 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "math/Line.h"
 #include "../Game_local.h"
 
+#include <algorithm>
+
 //stgatilov: record some information into trace events for idClip calls
 //unfortunately, it adds considerable overhead time, so is disabled by default
 #define TRACE_CLIP_INFO 0
@@ -35,6 +37,10 @@ typedef struct trmCache_s {
 
 idVec3 vec3_boxEpsilon( CM_BOX_EPSILON, CM_BOX_EPSILON, CM_BOX_EPSILON );
 
+// clip models the traces of this thread see elsewhere, see idClip::SetTraceMoves
+static thread_local const clipModelMove_t *	traceMoves = NULL;
+static thread_local int						numTraceMoves = 0;
+
 
 
 /*
@@ -47,6 +53,8 @@ idVec3 vec3_boxEpsilon( CM_BOX_EPSILON, CM_BOX_EPSILON, CM_BOX_EPSILON );
 
 static idList<trmCache_s*>		traceModelCache;
 static idHashIndex				traceModelHash;
+
+std::atomic<int>				idClipModel::changeCounter( 0 );
 	
 /*
 ===============
@@ -211,6 +219,7 @@ bool idClipModel::LoadModel( const char *name, const idDeclSkin* skin )
 		FreeTraceModel( traceModelIndex );
 		traceModelIndex = -1;
 	}
+	Changed();
 	collisionModelHandle = collisionModelManager->LoadModel( name, false, skin );
 	if ( collisionModelHandle >= 0 ) {
 		collisionModelManager->GetModelBounds( collisionModelHandle, bounds );
@@ -235,6 +244,7 @@ void idClipModel::LoadModel( const idTraceModel &trm ) {
 	}
 	traceModelIndex = AllocTraceModel( trm );
 	bounds = trm.bounds;
+	Changed();
 }
 
 /*
@@ -255,6 +265,7 @@ void idClipModel::LoadModel( const int renderModelHandle ) {
 		FreeTraceModel( traceModelIndex );
 		traceModelIndex = -1;
 	}
+	Changed();
 }
 
 /*
@@ -277,6 +288,7 @@ void idClipModel::Init( void ) {
 	renderModelHandle = -1;
 	traceModelIndex = -1;
 	touchCount = -1;
+	Changed();
 }
 
 /*
@@ -353,6 +365,7 @@ idClipModel::idClipModel( const idClipModel *model ) {
 	}
 	renderModelHandle = model->renderModelHandle;
 	touchCount = -1;
+	Changed();
 }
 
 /*
@@ -495,12 +508,18 @@ idClipModel::Unlink
 ===============
 */
 void idClipModel::Unlink() {
+	if ( ParallelThinkBatch *batch = ParallelThinkBatch::Current() ) {
+		batch->UnlinkClipModel( this );
+		return;
+	}
+
 	// stgatilov: this is a bit hacky,
 	// but we only ever use one instance of idClip,
 	// and storing additional pointer would be unnecessary waste of memory
 	idClip &clp = gameLocal.clip;
 
 	clp.octree.Remove( this );
+	Changed();
 
 	assert( !octreeHandle.IsLinked() );
 }
@@ -517,6 +536,12 @@ void idClipModel::Link( idClip &clp ) {
 		return;
 	}
 
+	// the octree is shared by all entities, other jobs may be tracing against it
+	if ( ParallelThinkBatch *batch = ParallelThinkBatch::Current() ) {
+		batch->LinkClipModel( this, &clp );
+		return;
+	}
+
 
 	if ( bounds.IsCleared() ) {
 		Unlink();	// unlink from old position
@@ -539,6 +564,7 @@ void idClipModel::Link( idClip &clp ) {
 	absBounds[1] += vec3_boxEpsilon;
 
 	clp.octree.Update( this, absBounds );
+	Changed();
 }
 
 /*
@@ -588,6 +614,9 @@ idClip::idClip
 */
 idClip::idClip( void ) {
 	worldBounds.Zero();
+	touchCount = -1;
+	parallelTraces = false;
+	batchJobList = NULL;
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
 
@@ -662,6 +691,34 @@ void idClip::Shutdown( void ) {
 		idClipModel::FreeTraceModel( defaultClipModel.traceModelIndex );
 		defaultClipModel.traceModelIndex = -1;
 	}
+
+	if ( batchJobList ) {
+		parallelJobManager->FreeJobList( batchJobList );
+		batchJobList = NULL;
+	}
+}
+
+/*
+================
+idClip::IsNewTouch
+
+  The touch counts of the clip models are shared by all threads, parallel queries search the list instead.
+================
+*/
+ID_INLINE bool idClip::IsNewTouch( idClipModel *check, const idClip_ClipModelList &clipModelList ) const {
+	if ( parallelTraces ) {
+		for ( int i = 0; i < clipModelList.Num(); i++ ) {
+			if ( clipModelList[i] == check ) {
+				return false;
+			}
+		}
+		return true;
+	}
+	if ( check->touchCount == touchCount ) {
+		return false;
+	}
+	check->touchCount = touchCount;
+	return true;
 }
 
 /*
@@ -683,7 +740,9 @@ int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, i
 	octree.QueryInBox(queryBox, res);
 
 	clipModelList.Clear();
-	touchCount++;
+	if ( !parallelTraces ) {
+		touchCount++;
+	}
 
 	for ( int i = 0; i < res.Num(); i++ ) {
 		auto chunk = res[i];
@@ -709,11 +768,9 @@ int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, i
 			}
 
 			// avoid duplicates in the list
-			if ( check->touchCount == touchCount ) {
+			if ( !IsNewTouch( check, clipModelList ) ) {
 				continue;
 			}
-
-			check->touchCount = touchCount;
 			clipModelList.AddGrow(check);
 		}
 	}
@@ -749,7 +806,9 @@ int idClip::ClipModelsTouchingMovingBounds(
 
 	clipModelList.Clear();
 	fractionLowers.Clear();
-	touchCount++;
+	if ( !parallelTraces ) {
+		touchCount++;
+	}
 
 	for ( int i = 0; i < res.Num(); i++ ) {
 		auto chunk = res[i];
@@ -781,11 +840,9 @@ int idClip::ClipModelsTouchingMovingBounds(
 			}
 
 			// avoid duplicates in the list
-			if ( check->touchCount == touchCount ) {
+			if ( !IsNewTouch( check, clipModelList ) ) {
 				continue;
 			}
-
-			check->touchCount = touchCount;
 			clipModelList.AddGrow(check);
 			fractionLowers.AddGrow(range[0]);
 		}
@@ -845,6 +902,9 @@ idClip::GetTraceClipModels
 */
 int idClip::GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClip_ClipModelList &clipModelList ) const {
 	ClipModelsTouchingBounds( bounds, contentMask, clipModelList );
+	if ( numTraceMoves ) {
+		ApplyTraceMoves( bounds, contentMask, clipModelList, NULL );
+	}
 	FilterClipModels(passEntity, clipModelList);
 	return clipModelList.Num();
 }
@@ -852,38 +912,117 @@ int idClip::GetTraceClipModels( const idBounds &absBounds, const idBounds &still
 	int contentMask, const idEntity *passEntity, idClip_ClipModelList &clipModelList, idClip_FloatList &fractionLowers ) const 
 {
 	ClipModelsTouchingMovingBounds( absBounds, stillBounds, start, end, contentMask, clipModelList, fractionLowers );
+	if ( numTraceMoves ) {
+		ApplyTraceMoves( absBounds, contentMask, clipModelList, &fractionLowers );
+	}
 	FilterClipModels(passEntity, clipModelList);
 	return clipModelList.Num();
 }
+
+/*
+====================
+idClip::SetTraceMoves
+====================
+*/
+void idClip::SetTraceMoves( const clipModelMove_t *moves, int numMoves ) {
+	traceMoves = moves;
+	numTraceMoves = moves ? numMoves : 0;
+}
+
+/*
+====================
+idClip::ApplyTraceMoves
+
+  Replaces the moved clip models in the list by their copies. The copies which are touched
+  are put in front, their lower bound on the intersection time is zero to keep the list sorted.
+====================
+*/
+void idClip::ApplyTraceMoves( const idBounds &bounds, int contentMask, idClip_ClipModelList &clipModelList, idClip_FloatList *fractionLowers ) const {
+	for ( int i = 0; i < clipModelList.Num(); i++ ) {
+		for ( int j = 0; j < numTraceMoves; j++ ) {
+			if ( clipModelList[i] == traceMoves[j].clipModel ) {
+				clipModelList[i] = NULL;
+				break;
+			}
+		}
+	}
+
+	idBounds queryBox = bounds;
+	queryBox.ExpandSelf( vec3_boxEpsilon );
+
+	for ( int j = 0; j < numTraceMoves; j++ ) {
+		idClipModel *check = traceMoves[j].moved;
+		if ( !check->enabled || !( check->contents & contentMask ) ) {
+			continue;
+		}
+
+		// same abs box as Link
+		idBounds absBounds;
+		if ( check->axis.IsRotated() ) {
+			absBounds.FromTransformedBounds( check->bounds, check->origin, check->axis );
+		} else {
+			absBounds[0] = check->bounds[0] + check->origin;
+			absBounds[1] = check->bounds[1] + check->origin;
+		}
+		absBounds[0] -= vec3_boxEpsilon;
+		absBounds[1] += vec3_boxEpsilon;
+		if ( !absBounds.IntersectsBounds( queryBox ) ) {
+			continue;
+		}
+
+		const int num = clipModelList.Num();
+		clipModelList.SetNum( num + 1 );
+		for ( int i = num; i > 0; i-- ) {
+			clipModelList[i] = clipModelList[i - 1];
+		}
+		clipModelList[0] = check;
+		if ( fractionLowers ) {
+			fractionLowers->SetNum( num + 1 );
+			for ( int i = num; i > 0; i-- ) {
+				( *fractionLowers )[i] = ( *fractionLowers )[i - 1];
+			}
+			( *fractionLowers )[0] = 0.0f;
+		}
+	}
+}
 //stgatilov: filtering part of GetTraceClipModels refactored into this internal method
 void idClip::FilterClipModels(const idEntity *passEntity, idClip_ClipModelList &clipModelList ) const {
 	if ( !passEntity ) {
 		return;
 	}
 
-	idEntity *passOwner;
-	if ( passEntity->GetPhysics()->GetNumClipModels() > 0 ) {
-		passOwner = passEntity->GetPhysics()->GetClipModel()->GetOwner();
-	} else {
-		passOwner = NULL;
-	}
+	const idEntity *passOwner = PassOwner( passEntity );
 
 	for ( int i = 0; i < clipModelList.Num(); i++ ) {
-		idClipModel	*cm = clipModelList[i];
-
-		// check if we should ignore this entity
-		if ( cm->entity == passEntity ) {
-			clipModelList[i] = NULL;			// don't clip against the pass entity
-		} else if ( cm->entity == passOwner ) {
-			clipModelList[i] = NULL;			// missiles don't clip with their owner
-		} else if ( cm->owner ) {
-			if ( cm->owner == passEntity ) {
-				clipModelList[i] = NULL;		// don't clip against own missiles
-			} else if ( cm->owner == passOwner ) {
-				clipModelList[i] = NULL;		// don't clip against other missiles from same owner
-			}
+		if ( IgnoreClipModel( clipModelList[i], passEntity, passOwner ) ) {
+			clipModelList[i] = NULL;
+		}
+	}
+}
+
+ID_INLINE const idEntity *idClip::PassOwner( const idEntity *passEntity ) {
+	if ( passEntity && passEntity->GetPhysics()->GetNumClipModels() > 0 ) {
+		return passEntity->GetPhysics()->GetClipModel()->GetOwner();
+	}
+	return NULL;
+}
+
+ID_INLINE bool idClip::IgnoreClipModel( const idClipModel *cm, const idEntity *passEntity, const idEntity *passOwner ) {
+	if ( !passEntity ) {
+		return false;
+	}
+	if ( cm->entity == passEntity ) {
+		return true;			// don't clip against the pass entity
+	} else if ( cm->entity == passOwner ) {
+		return true;			// missiles don't clip with their owner
+	} else if ( cm->owner ) {
+		if ( cm->owner == passEntity ) {
+			return true;		// don't clip against own missiles
+		} else if ( cm->owner == passOwner ) {
+			return true;		// don't clip against other missiles from same owner
 		}
 	}
+	return false;
 }
 
 /*
@@ -892,6 +1031,8 @@ idClip::TraceRenderModel
 ============
 */
 void idClip::TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const {
+	assert( !parallelTraces );
+
 	trace.fraction = 1.0f;
 
 	// if the trace is passing through the bounds
@@ -984,10 +1125,8 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 						const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity,
 						bool ignoreWorld ) {
 	int i, num;
-	idClipModel *touch;
 	idBounds traceBounds;
 	float radius;
-	trace_t trace;
 	const idTraceModel *trm;
 
 	if ( TestHugeTranslation( results, mdl, start, end, trmAxis ) ) {
@@ -1056,16 +1195,42 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 		num = GetTraceClipModels( traceBounds, contentMask, passEntity, clipModelList );
 	}
 
-	for ( i = 0; i < num; i++ ) {
-		touch = clipModelList[i];
+	TranslationClipModels( results, start, end, trm, trmAxis, contentMask, radius, clipModelList, movingClipCheck ? fractionLowers.Ptr() : NULL );
+
+#if TRACE_CLIP_INFO
+	TRACE_ATTACH_FORMAT("%s#cand: %d\nFrac: %0.3f\nHitEnt: %s\nCont:0x%d",
+		movingClipCheck ? "Moving check\n" : "",
+		num,
+		results.fraction,
+		(results.c.entityNum == ENTITYNUM_NONE || !gameLocal.entities[results.c.entityNum] ? "[none]" : gameLocal.entities[results.c.entityNum]->name.c_str()),
+		results.c.contents
+	)
+#endif
+	return ( results.fraction < 1.0f );
+}
+
+/*
+============
+idClip::TranslationClipModels
+
+  Translates the trace model versus each clip model of the list, results must hold the trace versus the world.
+  If fractionLowers is set the clip models are sorted on it and the loop stops at the first one which cannot be hit earlier.
+============
+*/
+void idClip::TranslationClipModels( trace_t &results, const idVec3 &start, const idVec3 &end, const idTraceModel *trm, const idMat3 &trmAxis,
+								int contentMask, float radius, const idClip_ClipModelList &clipModelList, const float *fractionLowers ) {
+	trace_t trace;
+
+	for ( int i = 0; i < clipModelList.Num(); i++ ) {
+		idClipModel *touch = clipModelList[i];
 
 		if ( !touch ) {
 			continue;
 		}
 
-		if (movingClipCheck && fractionLowers[i] > results.fraction) {
+		if (fractionLowers && fractionLowers[i] > results.fraction) {
 			//stgatilov: judging from bounds, we can only obtain higher fractions for other models
-			for (int t = i; t < num; t++)
+			for (int t = i; t < clipModelList.Num(); t++)
 				assert(fractionLowers[t] > results.fraction);	//were sorted in ClipModelsTouchingMovingBounds
 			break;
 		}
@@ -1088,17 +1253,6 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 			}
 		}
 	}
-
-#if TRACE_CLIP_INFO
-	TRACE_ATTACH_FORMAT("%s#cand: %d\nFrac: %0.3f\nHitEnt: %s\nCont:0x%d",
-		movingClipCheck ? "Moving check\n" : "",
-		num,
-		results.fraction,
-		(results.c.entityNum == ENTITYNUM_NONE || !gameLocal.entities[results.c.entityNum] ? "[none]" : gameLocal.entities[results.c.entityNum]->name.c_str()),
-		results.c.contents
-	)
-#endif
-	return ( results.fraction < 1.0f );
 }
 
 /*
@@ -1431,8 +1585,7 @@ idClip::Contents
 ============
 */
 int idClip::Contents( const idVec3 &start, const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity ) {
-	int i, num, contents;
-	idClipModel *touch;
+	int num, contents;
 	idBounds traceBounds;
 	const idTraceModel *trm;
 
@@ -1470,8 +1623,28 @@ int idClip::Contents( const idVec3 &start, const idClipModel *mdl, const idMat3
 	idClip_ClipModelList clipModelList;
 	num = GetTraceClipModels( traceBounds, -1, passEntity, clipModelList );
 
-	for ( i = 0; i < num; i++ ) {
-		touch = clipModelList[i];
+	contents = ContentsClipModels( contents, start, trm, trmAxis, contentMask, clipModelList );
+
+#if TRACE_CLIP_INFO
+	TRACE_ATTACH_FORMAT("#cand: %d\n#contents: 0x%x\n",
+		num,
+		contents
+	)
+#endif
+	return contents;
+}
+
+/*
+============
+idClip::ContentsClipModels
+
+  Adds the contents of the clip models of the list to the contents of the world.
+============
+*/
+int idClip::ContentsClipModels( int contents, const idVec3 &start, const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+								const idClip_ClipModelList &clipModelList ) {
+	for ( int i = 0; i < clipModelList.Num(); i++ ) {
+		idClipModel *touch = clipModelList[i];
 
 		if ( !touch ) {
 			continue;
@@ -1497,13 +1670,6 @@ int idClip::Contents( const idVec3 &start, const idClipModel *mdl, const idMat3
 			contents |= ( touch->contents & contentMask );
 		}
 	}
-
-#if TRACE_CLIP_INFO
-	TRACE_ATTACH_FORMAT("#cand: %d\n#contents: 0x%x\n",
-		num,
-		contents
-	)
-#endif
 	return contents;
 }
 
@@ -1621,6 +1787,394 @@ bool idClip::GetModelContactFeature( const contactInfo_t &contact, const idClipM
 	return true;
 }
 
+/*
+============
+idClip::BeginParallelTraces
+============
+*/
+void idClip::BeginParallelTraces( void ) {
+	assert( !parallelTraces );
+	collisionModelManager->BeginParallelTraces();
+	parallelTraces = true;
+}
+
+/*
+============
+idClip::EndParallelTraces
+============
+*/
+void idClip::EndParallelTraces( void ) {
+	assert( parallelTraces );
+	parallelTraces = false;
+	collisionModelManager->EndParallelTraces();
+}
+
+/*
+===============================================================
+
+	Trace batches
+
+===============================================================
+*/
+
+#define CLIP_BATCH_GROUP_SIZE		16			// maximum number of traces sharing one clip model query
+#define CLIP_BATCH_GROUP_EXTENT		256.0f		// the shared query may be this much larger than twice its largest trace
+#define MAX_CLIP_BATCH_JOBS			32
+
+typedef struct clipTraceBatch_s {
+	clipTrace_t *			traces;
+	int						numTraces;
+	bool					contents;			// contents instead of translations
+	idList<idBounds>		bounds;				// of every trace
+	idList<int>				order;				// traces sorted by position
+	idList<int>				groups;				// first entry of order of every group and the end of the last one
+	idList<bool>			deferred;			// traces versus render models, done on the main thread afterward
+} clipTraceBatch_t;
+
+typedef struct clipTraceJob_s {
+	idClip *				clip;
+	clipTraceBatch_t *		batch;
+	int						firstGroup;
+	int						lastGroup;
+	bool					skipped;			// no trace slot for the job thread, done on the main thread afterward
+} clipTraceJob_t;
+
+/*
+============
+ClipBatchMortonCode
+
+  Interleaves the bits of the position quantized to 10 bits per axis.
+============
+*/
+static unsigned int ClipBatchMortonCode( const idVec3 &point, const idBounds &worldBounds ) {
+	const idVec3 size = worldBounds.GetSize();
+	unsigned int code = 0;
+	for ( int i = 0; i < 3; i++ ) {
+		float f = size[i] > 0.0f ? ( point[i] - worldBounds[0][i] ) / size[i] : 0.0f;
+		unsigned int x = (unsigned int) idMath::ClampInt( 0, 1023, (int) ( f * 1023.0f ) );
+		x = ( x | ( x << 16 ) ) & 0x030000ff;
+		x = ( x | ( x << 8 ) ) & 0x0300f00f;
+		x = ( x | ( x << 4 ) ) & 0x030c30c3;
+		x = ( x | ( x << 2 ) ) & 0x09249249;
+		code |= x << i;
+	}
+	return code;
+}
+
+/*
+============
+ClipTraceBatchJob
+============
+*/
+void ClipTraceBatchJob( clipTraceJob_t *job ) {
+	// too many threads tracing, leave the groups to the main thread
+	job->skipped = !collisionModelManager->CanTraceInParallel();
+	if ( job->skipped ) {
+		return;
+	}
+	for ( int i = job->firstGroup; i < job->lastGroup; i++ ) {
+		job->clip->TraceBatchGroup( *job->batch, i );
+	}
+}
+
+REGISTER_PARALLEL_JOB( ClipTraceBatchJob, "ClipTraceBatchJob" );
+
+/*
+============
+idClip::TranslationBatch
+============
+*/
+void idClip::TranslationBatch( clipTrace_t *traces, int numTraces, bool parallel ) {
+	clipTraceBatch_t batch;
+
+	batch.traces = traces;
+	batch.numTraces = numTraces;
+	batch.contents = false;
+	batch.bounds.SetNum( numTraces );
+	for ( int i = 0; i < numTraces; i++ ) {
+		const clipTrace_t &trace = traces[i];
+		const idTraceModel *trm = TraceModelForClipModel( trace.mdl );
+		idBounds localBounds;
+		if ( !trm ) {
+			localBounds.Zero();
+		} else if ( trace.trmAxis.IsRotated() ) {
+			localBounds.FromTransformedBounds( trm->bounds, vec3_origin, trace.trmAxis );
+		} else {
+			localBounds = trm->bounds;
+		}
+		batch.bounds[i].FromBoundsTranslation( localBounds, trace.start, trace.end - trace.start );
+	}
+
+	RunTraceBatch( batch, parallel );
+}
+
+/*
+============
+idClip::ContentsBatch
+============
+*/
+void idClip::ContentsBatch( clipTrace_t *traces, int numTraces, bool parallel ) {
+	clipTraceBatch_t batch;
+
+	batch.traces = traces;
+	batch.numTraces = numTraces;
+	batch.contents = true;
+	batch.bounds.SetNum( numTraces );
+	for ( int i = 0; i < numTraces; i++ ) {
+		const clipTrace_t &trace = traces[i];
+		const idTraceModel *trm = TraceModelForClipModel( trace.mdl );
+		if ( !trm ) {
+			batch.bounds[i][0] = trace.start;
+			batch.bounds[i][1] = trace.start;
+		} else if ( trace.trmAxis.IsRotated() ) {
+			batch.bounds[i].FromTransformedBounds( trm->bounds, trace.start, trace.trmAxis );
+		} else {
+			batch.bounds[i][0] = trm->bounds[0] + trace.start;
+			batch.bounds[i][1] = trm->bounds[1] + trace.start;
+		}
+	}
+
+	RunTraceBatch( batch, parallel );
+}
+
+/*
+============
+idClip::RunTraceBatch
+============
+*/
+void idClip::RunTraceBatch( clipTraceBatch_t &batch, bool parallel ) {
+	const int numTraces = batch.numTraces;
+
+	assert( !parallelTraces );
+
+	if ( numTraces <= 0 ) {
+		return;
+	}
+
+	TRACE_CPU_SCOPE( "Clip:TraceBatch" );
+
+	// sort the traces along a Z-order curve through the world
+	idList<unsigned int> keys;
+	keys.SetNum( numTraces );
+	batch.order.SetNum( numTraces );
+	for ( int i = 0; i < numTraces; i++ ) {
+		keys[i] = ClipBatchMortonCode( batch.bounds[i].GetCenter(), worldBounds );
+		batch.order[i] = i;
+	}
+	std::sort( batch.order.Ptr(), batch.order.Ptr() + numTraces, [&keys]( int a, int b ) {
+		return keys[a] < keys[b] || ( keys[a] == keys[b] && a < b );
+	} );
+
+	// neighbouring traces share a group as long as its bounds stay small
+	batch.groups.SetNum( 0, false );
+	idBounds groupBounds;
+	idVec3 largest;
+	for ( int i = 0; i < numTraces; i++ ) {
+		const idBounds &bounds = batch.bounds[batch.order[i]];
+		const idVec3 size = bounds.GetSize();
+		bool fits = false;
+		if ( batch.groups.Num() && i - batch.groups[batch.groups.Num() - 1] < CLIP_BATCH_GROUP_SIZE ) {
+			idBounds merged = groupBounds;
+			merged.AddBounds( bounds );
+			const idVec3 mergedSize = merged.GetSize();
+			fits = true;
+			for ( int j = 0; j < 3; j++ ) {
+				if ( mergedSize[j] > 2.0f * Max( largest[j], size[j] ) + CLIP_BATCH_GROUP_EXTENT ) {
+					fits = false;
+				}
+			}
+		}
+		if ( fits ) {
+			groupBounds.AddBounds( bounds );
+			for ( int j = 0; j < 3; j++ ) {
+				largest[j] = Max( largest[j], size[j] );
+			}
+		} else {
+			batch.groups.Append( i );
+			groupBounds = bounds;
+			largest = size;
+		}
+	}
+	const int numGroups = batch.groups.Num();
+	batch.groups.Append( numTraces );
+
+	batch.deferred.SetNum( numTraces );
+	memset( batch.deferred.Ptr(), 0, numTraces * sizeof( bool ) );
+
+	// the jobs would wait for other jobs
+	if ( parallel && numGroups > 1 && !ParallelThinkBatch::Current() ) {
+		if ( !batchJobList ) {
+			batchJobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_CLIP_BATCH_JOBS, 0, NULL );
+		}
+		clipTraceJob_t jobs[MAX_CLIP_BATCH_JOBS];
+		const int numJobs = Min( numGroups, MAX_CLIP_BATCH_JOBS );
+		for ( int i = 0; i < numJobs; i++ ) {
+			jobs[i].clip = this;
+			jobs[i].batch = &batch;
+			jobs[i].firstGroup = numGroups * i / numJobs;
+			jobs[i].lastGroup = numGroups * ( i + 1 ) / numJobs;
+			batchJobList->AddJob( ( jobRun_t )ClipTraceBatchJob, &jobs[i] );
+		}
+		BeginParallelTraces();
+		batchJobList->Submit();
+		batchJobList->Wait();
+		EndParallelTraces();
+
+		for ( int i = 0; i < numJobs; i++ ) {
+			if ( jobs[i].skipped ) {
+				for ( int j = jobs[i].firstGroup; j < jobs[i].lastGroup; j++ ) {
+					TraceBatchGroup( batch, j );
+				}
+			}
+		}
+		for ( int i = 0; i < numTraces; i++ ) {
+			if ( batch.deferred[i] ) {
+				clipTrace_t &trace = batch.traces[i];
+				Translation( trace.results, trace.start, trace.end, trace.mdl, trace.trmAxis, trace.contentMask, trace.passEntity );
+			}
+		}
+	} else {
+		for ( int i = 0; i < numGroups; i++ ) {
+			TraceBatchGroup( batch, i );
+		}
+	}
+
+	if ( g_clipBatchCheck.GetBool() ) {
+		CheckTraceBatch( batch );
+	}
+}
+
+/*
+============
+idClip::CheckTraceBatch
+
+  Compares the results of a batch with Translation or Contents, see g_clipBatchCheck.
+============
+*/
+void idClip::CheckTraceBatch( const clipTraceBatch_t &batch ) {
+	for ( int i = 0; i < batch.numTraces; i++ ) {
+		const clipTrace_t &trace = batch.traces[i];
+		if ( batch.contents ) {
+			const int contents = Contents( trace.start, trace.mdl, trace.trmAxis, trace.contentMask, trace.passEntity );
+			if ( contents != trace.contents ) {
+				gameLocal.Warning( "idClip::ContentsBatch: trace %d at (%s) gives %x instead of %x",
+					i, trace.start.ToString(), trace.contents, contents );
+			}
+		} else {
+			trace_t results;
+			Translation( results, trace.start, trace.end, trace.mdl, trace.trmAxis, trace.contentMask, trace.passEntity );
+			if ( results.fraction != trace.results.fraction || results.endpos != trace.results.endpos || results.c.entityNum != trace.results.c.entityNum ) {
+				gameLocal.Warning( "idClip::TranslationBatch: trace %d from (%s) to (%s) gives fraction %f entity %d instead of %f entity %d",
+					i, trace.start.ToString(), trace.end.ToString(), trace.results.fraction, trace.results.c.entityNum, results.fraction, results.c.entityNum );
+			}
+		}
+	}
+}
+
+/*
+============
+idClip::TraceBatchGroup
+
+  Same as Translation or Contents for every trace of the group, versus the clip models of one query.
+============
+*/
+void idClip::TraceBatchGroup( clipTraceBatch_t &batch, int group ) {
+	const int first = batch.groups[group];
+	const int last = batch.groups[group + 1];
+
+	idBounds groupBounds;
+	int groupMask = 0;
+	groupBounds.Clear();
+	for ( int i = first; i < last; i++ ) {
+		const int t = batch.order[i];
+		groupBounds.AddBounds( batch.bounds[t] );
+		groupMask |= batch.contents ? -1 : batch.traces[t].contentMask;
+	}
+
+	idClip_ClipModelList touching;
+	ClipModelsTouchingBounds( groupBounds, groupMask, touching );
+
+	idClip_ClipModelList clipModelList;
+	for ( int i = first; i < last; i++ ) {
+		const int t = batch.order[i];
+		clipTrace_t &trace = batch.traces[t];
+		const idTraceModel *trm = TraceModelForClipModel( trace.mdl );
+		const bool testWorld = !trace.passEntity || trace.passEntity->entityNumber != ENTITYNUM_WORLD;
+
+		idBounds traceBounds;
+		float radius = 0.0f;
+		int contents = 0;
+
+		if ( batch.contents ) {
+			if ( testWorld ) {
+				idClip::numContents++;
+				contents = collisionModelManager->Contents( trace.start, trm, trace.trmAxis, trace.contentMask, 0, vec3_origin, mat3_default );
+			}
+			traceBounds = batch.bounds[t];
+		} else {
+			trace_t &results = trace.results;
+			if ( TestHugeTranslation( results, trace.mdl, trace.start, trace.end, trace.trmAxis ) ) {
+				continue;
+			}
+			if ( testWorld ) {
+				idClip::numTranslations++;
+				collisionModelManager->Translation( &results, trace.start, trace.end, trm, trace.trmAxis, trace.contentMask, 0, vec3_origin, mat3_default );
+				results.c.entityNum = results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+				if ( results.fraction == 0.0f ) {
+					continue;		// blocked immediately by the world
+				}
+			} else {
+				memset( &results, 0, sizeof( results ) );
+				results.fraction = 1.0f;
+				results.endpos = trace.end;
+				results.endAxis = trace.trmAxis;
+			}
+
+			// the clip models up to where the world was hit
+			idBounds localBounds;
+			if ( trm ) {
+				if ( trace.trmAxis.IsRotated() ) {
+					localBounds.FromTransformedBounds( trm->bounds, vec3_origin, trace.trmAxis );
+				} else {
+					localBounds = trm->bounds;
+				}
+				radius = trm->bounds.GetRadius();
+			} else {
+				localBounds.Zero();
+			}
+			traceBounds.FromBoundsTranslation( localBounds, trace.start, results.endpos - trace.start );
+		}
+
+		// same selection as ClipModelsTouchingBounds and FilterClipModels
+		traceBounds.ExpandSelf( vec3_boxEpsilon );
+		const int contentMask = batch.contents ? -1 : trace.contentMask;
+		const idEntity *passOwner = PassOwner( trace.passEntity );
+		bool renderModels = false;
+		clipModelList.Clear();
+		for ( int j = 0; j < touching.Num(); j++ ) {
+			idClipModel *check = touching[j];
+			if ( !( check->contents & contentMask ) || !check->absBounds.IntersectsBounds( traceBounds ) ) {
+				continue;
+			}
+			if ( IgnoreClipModel( check, trace.passEntity, passOwner ) ) {
+				continue;
+			}
+			if ( check->renderModelHandle != -1 ) {
+				renderModels = true;
+			}
+			clipModelList.AddGrow( check );
+		}
+
+		if ( batch.contents ) {
+			trace.contents = ContentsClipModels( contents, trace.start, trm, trace.trmAxis, trace.contentMask, clipModelList );
+		} else if ( renderModels && parallelTraces ) {
+			batch.deferred[t] = true;
+		} else {
+			TranslationClipModels( trace.results, trace.start, trace.end, trm, trace.trmAxis, trace.contentMask, radius, clipModelList, NULL );
+		}
+	}
+}
+
 /*
 ============
 idClip::PrintStatistics
@@ -1628,7 +2182,7 @@ idClip::PrintStatistics
 */
 void idClip::PrintStatistics( void ) {
 	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d\n",
-					numTranslations, numRotations, numMotions, numRenderModelTraces, numContents, numContacts );
+					numTranslations.load(), numRotations.load(), numMotions.load(), numRenderModelTraces.load(), numContents.load(), numContacts.load() );
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
 
@@ -109,6 +109,7 @@ public:
 	cmHandle_t				Handle( void ) const;				// returns handle used to collide vs this model
 	idBoxOctreeHandle&		GetOctreeHandle( void ) { return octreeHandle; }
 	const idTraceModel *	GetTraceModel( void ) const;
+	int						GetChangeStamp( void ) const { return changeStamp; }
 	void					GetMassProperties( const float density, float &mass, idVec3 &centerOfMass, idMat3 &inertiaTensor ) const;
 
 	static cmHandle_t		CheckModel( const char *name, const idDeclSkin* skin = NULL ); // skin added #4232 SteveL
@@ -118,6 +119,9 @@ public:
 	static void				SaveTraceModels( idSaveGame *savefile );
 	static void				RestoreTraceModels( idRestoreGame *savefile );
 
+							// the stamp of the last change made to any clip model
+	static int				GetChangeCounter( void ) { return changeCounter; }
+
 private:
 	bool					enabled;				// true if this clip model is used for clipping
 	idEntity *				entity;					// entity using this clip model
@@ -135,8 +139,12 @@ private:
 
 	idBoxOctreeHandle		octreeHandle;			// links back to the octree containing the model
 	int						touchCount;				// mutable counter to avoid double-reporting clipmodel
+	int						changeStamp;			// changeCounter when the model was last linked, unlinked or modified
+
+	static std::atomic<int>	changeCounter;
 
 	void					Init( void );			// initialize
+	void					Changed( void ) { changeStamp = ++changeCounter; }
 
 	static int				AllocTraceModel( const idTraceModel &trm );
 	static void				FreeTraceModel( const int traceModelIndex );
@@ -170,14 +178,17 @@ ID_INLINE void idClipModel::Scale( const idVec3 &scale ) {
 
 ID_INLINE void idClipModel::Enable( void ) {
 	enabled = true;
+	Changed();
 }
 
 ID_INLINE void idClipModel::Disable( void ) {
 	enabled = false;
+	Changed();
 }
 
 ID_INLINE void idClipModel::SetMaterial( const idMaterial *m ) {
 	material = m;
+	Changed();
 }
 
 ID_INLINE const idMaterial * idClipModel::GetMaterial( void ) const {
@@ -186,6 +197,7 @@ ID_INLINE const idMaterial * idClipModel::GetMaterial( void ) const {
 
 ID_INLINE void idClipModel::SetContents( int newContents ) {
 	contents = newContents;
+	Changed();
 }
 
 ID_INLINE int idClipModel::GetContents( void ) const {
@@ -194,6 +206,7 @@ ID_INLINE int idClipModel::GetContents( void ) const {
 
 ID_INLINE void idClipModel::SetEntity( idEntity *newEntity ) {
 	entity = newEntity;
+	Changed();
 }
 
 ID_INLINE idEntity *idClipModel::GetEntity( void ) const {
@@ -202,6 +215,7 @@ ID_INLINE idEntity *idClipModel::GetEntity( void ) const {
 
 ID_INLINE void idClipModel::SetId( int newId ) {
 	id = newId;
+	Changed();
 }
 
 ID_INLINE int idClipModel::GetId( void ) const {
@@ -210,6 +224,7 @@ ID_INLINE int idClipModel::GetId( void ) const {
 
 ID_INLINE void idClipModel::SetOwner( idEntity *newOwner ) {
 	owner = newOwner;
+	Changed();
 }
 
 ID_INLINE idEntity *idClipModel::GetOwner( void ) const {
@@ -266,6 +281,27 @@ ID_INLINE const idTraceModel *idClipModel::GetTraceModel( void ) const {
 //
 //===============================================================
 
+// a trace of a batch, see idClip::TranslationBatch and idClip::ContentsBatch
+typedef struct clipTrace_s {
+	idVec3					start;
+	idVec3					end;					// not used for contents
+	const idClipModel *		mdl;					// NULL for points and rays
+	idMat3					trmAxis;
+	int						contentMask;
+	const idEntity *		passEntity;
+	trace_t					results;				// set by TranslationBatch
+	int						contents;				// set by ContentsBatch
+} clipTrace_t;
+
+// a clip model seen by the traces of one thread at the position of an unlinked copy, see idClip::SetTraceMoves
+typedef struct clipModelMove_s {
+	const idClipModel *		clipModel;
+	idClipModel *			moved;
+} clipModelMove_t;
+
+struct clipTraceBatch_s;
+struct clipTraceJob_s;
+
 class idClip {
 
 	friend class idClipModel;
@@ -293,6 +329,12 @@ public:
 	int						Contents( const idVec3 &start,
 								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
 
+	// Same as Translation or Contents for every trace of the array. The traces are sorted by position and
+	// neighbouring traces share one query for the clip models they may touch. If parallel is set, groups of
+	// them run in jobs. Hits at exactly the same fraction may name another entity than Translation would.
+	void					TranslationBatch( clipTrace_t *traces, int numTraces, bool parallel );
+	void					ContentsBatch( clipTrace_t *traces, int numTraces, bool parallel );
+
 	// special case translations versus the rest of the world
 	bool					TracePoint( trace_t &results, const idVec3 &start, const idVec3 &end,
 								int contentMask, const idEntity *passEntity );
@@ -320,6 +362,15 @@ public:
 	// get a contact feature
 	bool					GetModelContactFeature( const contactInfo_t &contact, const idClipModel *clipModel, idFixedWinding &winding ) const;
 
+	// Until EndParallelTraces, Translation, Rotation, Motion, Contents and the touching queries
+	// may be called from several threads at once. Render models may not be traced in between.
+	void					BeginParallelTraces( void );
+	void					EndParallelTraces( void );
+
+	// The traces of the calling thread see the clip models of the moves where their copies are.
+	// The moves are used until they are set to NULL, the array has to stay valid until then.
+	void					SetTraceMoves( const clipModelMove_t *moves, int numMoves );
+
 	// get entities/clip models within or touching the given bounds
 	int						EntitiesTouchingBounds( const idBounds &bounds, int contentMask, idClip_EntityList &entityList ) const;
 	int						ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, idClip_ClipModelList &clipModelList ) const;
@@ -339,21 +390,36 @@ private:
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
 	mutable int				touchCount;
+	bool					parallelTraces;
+	idParallelJobList *		batchJobList;
 							// statistics
-	int						numTranslations;
-	int						numRotations;
-	int						numMotions;
-	int						numRenderModelTraces;
-	int						numContents;
-	int						numContacts;
+	std::atomic<int>		numTranslations;
+	std::atomic<int>		numRotations;
+	std::atomic<int>		numMotions;
+	std::atomic<int>		numRenderModelTraces;
+	std::atomic<int>		numContents;
+	std::atomic<int>		numContacts;
 
 private:
 	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
+	bool					IsNewTouch( idClipModel *check, const idClip_ClipModelList &clipModelList ) const;
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClip_ClipModelList &clipModelList ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
 
 	void					FilterClipModels(const idEntity *passEntity, idClip_ClipModelList &clipModelList ) const;
+	void					ApplyTraceMoves( const idBounds &bounds, int contentMask, idClip_ClipModelList &clipModelList, idClip_FloatList *fractionLowers ) const;
+	static const idEntity *	PassOwner( const idEntity *passEntity );
+	static bool				IgnoreClipModel( const idClipModel *cm, const idEntity *passEntity, const idEntity *passOwner );
+	void					TranslationClipModels( trace_t &results, const idVec3 &start, const idVec3 &end, const idTraceModel *trm, const idMat3 &trmAxis,
+								int contentMask, float radius, const idClip_ClipModelList &clipModelList, const float *fractionLowers );
+	int						ContentsClipModels( int contents, const idVec3 &start, const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+								const idClip_ClipModelList &clipModelList );
+
+	void					RunTraceBatch( struct clipTraceBatch_s &batch, bool parallel );
+	void					TraceBatchGroup( struct clipTraceBatch_s &batch, int group );
+	void					CheckTraceBatch( const struct clipTraceBatch_s &batch );
+	friend void				ClipTraceBatchJob( struct clipTraceJob_s *job );
 	void					FilterEntities( idClip_EntityList &entityList, idClip_ClipModelList &clipModelList ) const;
 
 	void					ClipModelsTouchingMovingBounds_r( const clipSector_s *node, idBounds &nodeBounds, listParmsMoving &parms ) const;
@@ -58,6 +58,10 @@ const idVec6 vec6_lcp_epsilon				= idVec6( LCP_EPSILON, LCP_EPSILON, LCP_EPSILON
 static const float MAX_GRABBER_EXT_VELOCITY		= 120.0f;
 static const float MAX_GRABBER_EXT_ANGVEL		= 5.0f;
 
+// the batched solver only uses jobs for figures with at least this many auxiliary constraint rows
+static const int AF_MIN_PARALLEL_AUX_ROWS		= 48;
+static const int AF_MIN_AUX_ROWS_PER_JOB		= 16;
+
 #define AF_TIMINGS
 
 #ifdef AF_TIMINGS
@@ -4652,6 +4656,21 @@ void idAFTree::Factor( void ) const {
 	}
 }
 
+/*
+================
+AF_MultiplySelf
+
+  vec = mat * vec without using the temporary memory of idVecX which is shared by all threads
+================
+*/
+static void AF_MultiplySelf( const idMatX &mat, idVecX &vec ) {
+	idVecX tmp;
+
+	tmp.SetData( mat.GetNumRows(), VECX_ALLOCA( mat.GetNumRows() ) );
+	mat.Multiply( tmp, vec );
+	vec = tmp;
+}
+
 /*
 ================
 idAFTree::Solve
@@ -4697,7 +4716,7 @@ void idAFTree::Solve( int auxiliaryIndex ) const {
 			}
 
 			if ( !primaryConstraint->fl.isZero ) {
-				primaryConstraint->s = primaryConstraint->invI * primaryConstraint->s;
+				AF_MultiplySelf( primaryConstraint->invI, primaryConstraint->s );
 			}
 			primaryConstraint->J.MultiplySub( primaryConstraint->s, primaryConstraint->body2->s );
 
@@ -4709,12 +4728,12 @@ void idAFTree::Solve( int auxiliaryIndex ) const {
 
 			if ( body->children.Num() ) {
 				if ( !body->fl.isZero ) {
-					body->s = body->invI * body->s;
+					AF_MultiplySelf( body->invI, body->s );
 				}
 				body->J.MultiplySub( body->s, primaryConstraint->s );
 			}
 		} else if ( body->children.Num() ) {
-			body->s = body->invI * body->s;
+			AF_MultiplySelf( body->invI, body->s );
 		}
 	}
 }
@@ -5184,6 +5203,186 @@ void idPhysics_AF::PrimaryForces( float timeStep ) {
 	}
 }
 
+/*
+================
+AF_TreeResponsesJob
+================
+*/
+void AF_TreeResponsesJob( idPhysics_AF::auxSolverJob_t *job ) {
+	job->physics->TreeResponses( *job );
+}
+
+REGISTER_PARALLEL_JOB( AF_TreeResponsesJob, "AF_TreeResponsesJob" );
+
+/*
+================
+AF_AuxiliaryMatrixJob
+================
+*/
+void AF_AuxiliaryMatrixJob( idPhysics_AF::auxSolverJob_t *job ) {
+	job->physics->AuxiliaryMatrixRows( *job );
+}
+
+REGISTER_PARALLEL_JOB( AF_AuxiliaryMatrixJob, "AF_AuxiliaryMatrixJob" );
+
+/*
+================
+idPhysics_AF::TreeResponses
+
+  calculate the responses of every job.step-th tree to all auxiliary constraint rows
+  a tree only changes its own bodies and primary constraints so trees can run in parallel
+================
+*/
+void idPhysics_AF::TreeResponses( const auxSolverJob_t &job ) const {
+	int i, k;
+	const idAFTree *tree;
+	const idAFConstraint *constraint;
+
+	for ( i = job.first; i < job.last; i += job.step ) {
+		tree = trees[i];
+
+		// responses are added in the order of the auxiliary constraint rows like AuxiliaryForces does
+		for ( k = 0; k < job.numRows; k++ ) {
+			constraint = job.rowConstraints[k];
+			if ( constraint->body1->tree == tree || ( constraint->body2 && constraint->body2->tree == tree ) ) {
+				tree->Response( constraint, job.rowIndices[k], k );
+			}
+		}
+	}
+}
+
+/*
+================
+idPhysics_AF::AuxiliaryMatrixRows
+
+  create the rows [job.first, job.last) of the constraint matrix for auxiliary constraints
+================
+*/
+void idPhysics_AF::AuxiliaryMatrixRows( const auxSolverJob_t &job ) const {
+	int i, k, n, s, row;
+	float *dots, *dstPtr;
+	const idAFBody *body;
+	const idAFConstraint *constraint;
+	idVecX tmp;
+
+	tmp.SetData( 6, VECX_ALLOCA( 6 ) );
+	dots = (float *) _alloca16( job.numRows * sizeof( float ) );
+
+	bool useSymmetry = af_useSymmetry.GetBool();
+
+	for ( k = job.first; k < job.last; k++ ) {
+		constraint = job.rowConstraints[k];
+		row = job.rowIndices[k];
+		dstPtr = (*job.jmk)[k];
+		s = useSymmetry ? k + 1 : job.numRows;
+
+		memset( dstPtr, 0, s * sizeof( float ) );
+
+		// the response indices are sorted, only the responses before column s are needed
+		body = constraint->body1;
+		for ( n = 0; n < body->numResponses && body->responseIndex[n] < s; n++ ) {
+		}
+		body->InverseWorldSpatialInertiaMultiply( tmp, constraint->J1[row] );
+		SIMDProcessor->Dot6Padded8( dots, tmp.ToFloatPtr(), body->response, n );
+		for ( i = 0; i < n; i++ ) {
+			dstPtr[body->responseIndex[i]] = dots[i];
+		}
+
+		body = constraint->body2;
+		if ( body ) {
+			for ( n = 0; n < body->numResponses && body->responseIndex[n] < s; n++ ) {
+			}
+			body->InverseWorldSpatialInertiaMultiply( tmp, constraint->J2[row] );
+			SIMDProcessor->Dot6Padded8( dots, tmp.ToFloatPtr(), body->response, n );
+			for ( i = 0; i < n; i++ ) {
+				dstPtr[body->responseIndex[i]] += dots[i];
+			}
+		}
+	}
+}
+
+/*
+================
+idPhysics_AF::RunAuxiliarySolverJobs
+================
+*/
+void idPhysics_AF::RunAuxiliarySolverJobs( jobRun_t function, auxSolverJob_t *jobs, int numJobs ) const {
+	idParallelJobList *jobList = gameLocal.afSolverJobList;
+
+	// never wait for other jobs from inside a job
+	if ( numJobs <= 1 || jobList == NULL || ParallelThinkBatch::Current() != NULL ) {
+		for ( int i = 0; i < numJobs; i++ ) {
+			function( &jobs[i] );
+		}
+		return;
+	}
+
+	for ( int i = 0; i < numJobs; i++ ) {
+		jobList->AddJob( function, &jobs[i] );
+	}
+	jobList->Submit();
+	jobList->Wait();
+}
+
+/*
+================
+idPhysics_AF::AuxiliaryMatrixBatched
+
+  same as the response and constraint matrix calculation in AuxiliaryForces but
+  the dot products with the body responses use SIMD and large figures are split into jobs
+================
+*/
+void idPhysics_AF::AuxiliaryMatrixBatched( idMatX &jmk, int numRows ) const {
+	int i, j, k, numJobs;
+	const idAFConstraint **rowConstraints;
+	int *rowIndices;
+	auxSolverJob_t jobs[MAX_AF_SOLVER_JOBS];
+
+	rowConstraints = (const idAFConstraint **) _alloca16( numRows * sizeof( rowConstraints[0] ) );
+	rowIndices = (int *) _alloca16( numRows * sizeof( rowIndices[0] ) );
+
+	for ( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+		for ( j = 0; j < auxiliaryConstraints[i]->J1.GetNumRows(); j++, k++ ) {
+			rowConstraints[k] = auxiliaryConstraints[i];
+			rowIndices[k] = j;
+		}
+	}
+
+	for ( i = 0; i < MAX_AF_SOLVER_JOBS; i++ ) {
+		jobs[i].physics = this;
+		jobs[i].rowConstraints = rowConstraints;
+		jobs[i].rowIndices = rowIndices;
+		jobs[i].numRows = numRows;
+		jobs[i].jmk = &jmk;
+	}
+
+	bool parallel = ( numRows >= AF_MIN_PARALLEL_AUX_ROWS );
+
+	// calculate forces of primary constraints in response to the auxiliary constraint forces
+	numJobs = parallel ? idMath::Imin( trees.Num(), MAX_AF_SOLVER_JOBS ) : 1;
+	for ( i = 0; i < numJobs; i++ ) {
+		jobs[i].first = i;
+		jobs[i].last = trees.Num();
+		jobs[i].step = numJobs;
+	}
+	RunAuxiliarySolverJobs( (jobRun_t)AF_TreeResponsesJob, jobs, numJobs );
+
+	// create constraint matrix for auxiliary constraints using a mass matrix adjusted for the primary constraints
+	numJobs = parallel ? idMath::Imin( numRows / AF_MIN_AUX_ROWS_PER_JOB, MAX_AF_SOLVER_JOBS ) : 1;
+	for ( i = 0; i < numJobs; i++ ) {
+		jobs[i].first = ( i == 0 ) ? 0 : jobs[i-1].last;
+		if ( af_useSymmetry.GetBool() ) {
+			// only the lower triangle is calculated, give all jobs about the same area
+			jobs[i].last = (int)( numRows * idMath::Sqrt( (float)( i + 1 ) / numJobs ) );
+		} else {
+			jobs[i].last = numRows * ( i + 1 ) / numJobs;
+		}
+		jobs[i].step = 1;
+	}
+	jobs[numJobs-1].last = numRows;
+	RunAuxiliarySolverJobs( (jobRun_t)AF_AuxiliaryMatrixJob, jobs, numJobs );
+}
+
 /*
 ================
 idPhysics_AF::AuxiliaryForces
@@ -5239,60 +5438,65 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 		}
 	}
 
-	// calculate forces of primary constraints in response to the auxiliary constraint forces
-	for ( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ ) {
-		constraint = auxiliaryConstraints[i];
-
-		for ( j = 0; j < constraint->J1.GetNumRows(); j++, k++ ) {
-
-			// calculate body forces in the tree in response to the constraint force
-			constraint->body1->tree->Response( constraint, j, k );
-			// if there is a second body which is part of a different tree
-			if ( constraint->body2 && constraint->body2->tree != constraint->body1->tree ) {
-				// calculate body forces in the second tree in response to the constraint force
-				constraint->body2->tree->Response( constraint, j, k );
-			}
-		}
-	}
-
 	// NOTE: the rows are 16 byte padded
 	jmk.SetData( numAuxConstraints, ((numAuxConstraints+3)&~3), MATX_ALLOCA( numAuxConstraints * ((numAuxConstraints+3)&~3) ) );
 	tmp.SetData( 6, VECX_ALLOCA( 6 ) );
 
-	// create constraint matrix for auxiliary constraints using a mass matrix adjusted for the primary constraints
-	for ( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ ) {
-		constraint = auxiliaryConstraints[i];
+	if ( af_batchSolver.GetBool() ) {
+		AuxiliaryMatrixBatched( jmk, numAuxConstraints );
+	}
+	else {
+		// calculate forces of primary constraints in response to the auxiliary constraint forces
+		for ( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+			constraint = auxiliaryConstraints[i];
 
-		for ( j = 0; j < constraint->J1.GetNumRows(); j++, k++ ) {
-			constraint->body1->InverseWorldSpatialInertiaMultiply( tmp, constraint->J1[j] );
-			j1 = tmp.ToFloatPtr();
-			ptr = constraint->body1->response;
-			index = constraint->body1->responseIndex;
-			dstPtr = jmk[k];
-			s = af_useSymmetry.GetBool() ? k + 1 : numAuxConstraints;
-			for ( l = n = 0, m = index[n]; n < constraint->body1->numResponses && m < s; n++, m = index[n] ) {
-				while( l < m ) {
-					dstPtr[l++] = 0.0f;
+			for ( j = 0; j < constraint->J1.GetNumRows(); j++, k++ ) {
+
+				// calculate body forces in the tree in response to the constraint force
+				constraint->body1->tree->Response( constraint, j, k );
+				// if there is a second body which is part of a different tree
+				if ( constraint->body2 && constraint->body2->tree != constraint->body1->tree ) {
+					// calculate body forces in the second tree in response to the constraint force
+					constraint->body2->tree->Response( constraint, j, k );
 				}
-				dstPtr[l++] = j1[0] * ptr[0] + j1[1] * ptr[1] + j1[2] * ptr[2] +
-								j1[3] * ptr[3] + j1[4] * ptr[4] + j1[5] * ptr[5];
-				ptr += 8;
 			}
+		}
 
-			while( l < s ) {
-				dstPtr[l++] = 0.0f;
-			}
+		// create constraint matrix for auxiliary constraints using a mass matrix adjusted for the primary constraints
+		for ( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+			constraint = auxiliaryConstraints[i];
 
-			if ( constraint->body2 ) {
-				constraint->body2->InverseWorldSpatialInertiaMultiply( tmp, constraint->J2[j] );
-				j2 = tmp.ToFloatPtr();
-				ptr = constraint->body2->response;
-				index = constraint->body2->responseIndex;
-				for ( n = 0, m = index[n]; n < constraint->body2->numResponses && m < s; n++, m = index[n] ) {
-					dstPtr[m] += j2[0] * ptr[0] + j2[1] * ptr[1] + j2[2] * ptr[2] +
-										j2[3] * ptr[3] + j2[4] * ptr[4] + j2[5] * ptr[5];
+			for ( j = 0; j < constraint->J1.GetNumRows(); j++, k++ ) {
+				constraint->body1->InverseWorldSpatialInertiaMultiply( tmp, constraint->J1[j] );
+				j1 = tmp.ToFloatPtr();
+				ptr = constraint->body1->response;
+				index = constraint->body1->responseIndex;
+				dstPtr = jmk[k];
+				s = af_useSymmetry.GetBool() ? k + 1 : numAuxConstraints;
+				for ( l = n = 0, m = index[n]; n < constraint->body1->numResponses && m < s; n++, m = index[n] ) {
+					while( l < m ) {
+						dstPtr[l++] = 0.0f;
+					}
+					dstPtr[l++] = j1[0] * ptr[0] + j1[1] * ptr[1] + j1[2] * ptr[2] +
+									j1[3] * ptr[3] + j1[4] * ptr[4] + j1[5] * ptr[5];
 					ptr += 8;
 				}
+
+				while( l < s ) {
+					dstPtr[l++] = 0.0f;
+				}
+
+				if ( constraint->body2 ) {
+					constraint->body2->InverseWorldSpatialInertiaMultiply( tmp, constraint->J2[j] );
+					j2 = tmp.ToFloatPtr();
+					ptr = constraint->body2->response;
+					index = constraint->body2->responseIndex;
+					for ( n = 0, m = index[n]; n < constraint->body2->numResponses && m < s; n++, m = index[n] ) {
+						dstPtr[m] += j2[0] * ptr[0] + j2[1] * ptr[1] + j2[2] * ptr[2] +
+											j2[3] * ptr[3] + j2[4] * ptr[4] + j2[5] * ptr[5];
+						ptr += 8;
+					}
+				}
 			}
 		}
 	}
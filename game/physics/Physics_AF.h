@@ -825,6 +825,9 @@ typedef struct AFCollision_s {
 } AFCollision_t;
 
 
+// maximum number of jobs the auxiliary constraints of one articulated figure are solved with
+#define MAX_AF_SOLVER_JOBS		16
+
 class idPhysics_AF : public idPhysics_Base {
 
 public:
@@ -1085,6 +1088,21 @@ private:
 	idAFBody *				masterBody;						// master body
 	idLCP *					lcp;							// linear complementarity problem solver
 
+							// work of the batched auxiliary constraint solver (af_batchSolver)
+	struct auxSolverJob_t {
+		const idPhysics_AF *	physics;
+		const idAFConstraint **	rowConstraints;				// constraint of each auxiliary constraint row
+		const int *				rowIndices;					// row within that constraint
+		int						numRows;
+		idMatX *				jmk;						// constraint matrix built by the job
+		int						first;						// first tree or matrix row of the job
+		int						last;						// one past the last tree or matrix row
+		int						step;						// step between the trees of the job
+	};
+
+	friend void				AF_TreeResponsesJob( auxSolverJob_t *job );
+	friend void				AF_AuxiliaryMatrixJob( auxSolverJob_t *job );
+
 private:
 	bool					IsClosedLoop( const idAFBody *body1, const idAFBody *body2 ) const;
 	void					PrimaryFactor( void );
@@ -1095,6 +1113,10 @@ private:
 	void					ApplyFriction( float timeStep, float endTimeMSec );
 	void					PrimaryForces( float timeStep  );
 	void					AuxiliaryForces( float timeStep );
+	void					AuxiliaryMatrixBatched( idMatX &jmk, int numRows ) const;
+	void					TreeResponses( const auxSolverJob_t &job ) const;
+	void					AuxiliaryMatrixRows( const auxSolverJob_t &job ) const;
+	void					RunAuxiliarySolverJobs( jobRun_t function, auxSolverJob_t *jobs, int numJobs ) const;
 	void					VerifyContactConstraints( void );
 	void					SetupContactConstraints( void );
 	void					ApplyContactForces( void );
@@ -563,9 +563,10 @@ idPhysics_RigidBody::CheckForCollisions
 
   Check for collisions between the current and next state.
   If there is a collision the next state is set to the state at the moment of impact.
+  The traces are taken from the prediction if it was made for the same step.
 ================
 */
-bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPState_t &next, trace_t &collision ) {
+bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPState_t &next, trace_t &collision, const rigidBodyPrediction_t *prediction ) {
 //#define TEST_COLLISION_DETECTION
 	idMat3 axis;
 	idRotation rotation;
@@ -582,6 +583,11 @@ bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPS
 	}
 #endif
 
+	if ( prediction && ( prediction->start != current.i.position || prediction->startAxis != current.i.orientation ||
+			prediction->end != next.i.position || prediction->endAxis != next.i.orientation ) ) {
+		prediction = NULL;
+	}
+
 	TransposeMultiply( current.i.orientation, next.i.orientation, axis );
 	rotation = axis.ToRotation();
 	rotation.SetOrigin( current.i.position );
@@ -591,7 +597,15 @@ bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPS
 	pos = next.i.position;
 #endif
 
-	if ( gameLocal.clip.Motion( collision, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self ) ) {
+	bool hit;
+	if ( prediction ) {
+		collision = prediction->collision;
+		hit = prediction->collided;
+	} else {
+		hit = gameLocal.clip.Motion( collision, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self );
+	}
+
+	if ( hit ) {
 
 		// set the next state to the state at the moment of impact
 		next.i.position = collision.endpos;
@@ -605,7 +619,14 @@ bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPS
 	// Check for water collision
 	// ideally we could do this check in one step but if a body moves quickly in shallow water
 	// they will occasionally clip through a solid entity (ie. fall through the floor)
-	if ( gameLocal.clip.Motion( waterCollision, current.i.position, pos, rotation, clipModel, current.i.orientation, MASK_WATER, self ) )
+	if ( prediction ) {
+		waterCollision = prediction->waterCollision;
+		hit = prediction->collidedWater;
+	} else {
+		hit = gameLocal.clip.Motion( waterCollision, current.i.position, pos, rotation, clipModel, current.i.orientation, MASK_WATER, self );
+	}
+
+	if ( hit )
 	{
 		idEntity *ent = gameLocal.entities[waterCollision.c.entityNum];
 
@@ -1175,6 +1196,9 @@ idPhysics_RigidBody::idPhysics_RigidBody( void ) {
 	isBlocked = false;
 	propagateImpulseLock = false;
 
+	predictionFrame = -1;
+	predictionIndex = 0;
+
 	memset(&collisionTrace, 0, sizeof(collisionTrace));
 
 	// tels
@@ -1718,6 +1742,9 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 //	current.i.linearMomentum -= current.pushVelocity.SubVec3( 0 ) * mass;
 //	current.i.angularMomentum -= current.pushVelocity.SubVec3( 1 ) * inertiaTensor;
 
+	// the collision traces may have been predicted, they are checked while the clip model is still linked
+	const rigidBodyPrediction_t *prediction = gameLocal.rigidBodyIslands.Take( this );
+
 	clipModel->Unlink();
 
 	next = current;
@@ -1730,7 +1757,7 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 #endif
 
 	// check for collisions from the current to the next state
-	collided = CheckForCollisions( timeStep, next, collision );
+	collided = CheckForCollisions( timeStep, next, collision, prediction );
 
 #ifdef RB_TIMINGS
 	timer_collision.Stop();
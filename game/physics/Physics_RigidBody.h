@@ -206,6 +206,10 @@ private:
 
 	bool					propagateImpulseLock;
 
+	// collision traces of the next step, see idRigidBodyIslands
+	int						predictionFrame;
+	int						predictionIndex;
+
 #ifdef MOD_WATERPHYSICS
 	// buoyancy
 	int					noMoveTime;	// MOD_WATERPHYSICS suspend simulation if hardly any movement for this many seconds
@@ -213,8 +217,9 @@ private:
 
 private:
 	friend void				RigidBodyDerivatives( const float t, const void *clientData, const float *state, float *derivatives );
+	friend class			idRigidBodyIslands;
 	void					Integrate( const float deltaTime, rigidBodyPState_t &next );
-	bool					CheckForCollisions( const float deltaTime, rigidBodyPState_t &next, trace_t &collision );
+	bool					CheckForCollisions( const float deltaTime, rigidBodyPState_t &next, trace_t &collision, const rigidBodyPrediction_t *prediction = NULL );
 public:
 	bool					CollisionImpulse( const trace_t &collision, idVec3 &impulse );
 private:
@@ -0,0 +1,510 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include <algorithm>
+
+#include "../Game_local.h"
+
+// islands are only traced in jobs when there are at least this many of them
+static const int MIN_PARALLEL_ISLANDS = 4;
+
+/*
+================
+idRigidBodyIslands::idRigidBodyIslands
+================
+*/
+idRigidBodyIslands::idRigidBodyIslands( void ) {
+	frameNum = -1;
+	numIslands = 0;
+	numPredicted = 0;
+	jobList = NULL;
+}
+
+/*
+================
+idRigidBodyIslands::Init
+================
+*/
+void idRigidBodyIslands::Init( void ) {
+	jobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_RIGID_BODY_ISLAND_JOBS, 0, NULL );
+}
+
+/*
+================
+idRigidBodyIslands::Shutdown
+================
+*/
+void idRigidBodyIslands::Shutdown( void ) {
+	Clear();
+	parallelJobManager->FreeJobList( jobList );
+	jobList = NULL;
+	predictions.Clear();
+	members.Clear();
+	moves.Clear();
+	firstMember.Clear();
+	sorted.Clear();
+}
+
+/*
+================
+idRigidBodyIslands::Clear
+================
+*/
+void idRigidBodyIslands::Clear( void ) {
+	for ( int i = 0; i < moves.Num(); i++ ) {
+		delete moves[i].moved;
+	}
+	moves.SetNum( 0, false );
+	predictions.SetNum( 0, false );
+	members.SetNum( 0, false );
+	firstMember.SetNum( 0, false );
+	frameNum = -1;
+	numIslands = 0;
+	numPredicted = 0;
+}
+
+/*
+================
+RigidBodyIslandsJob
+================
+*/
+void RigidBodyIslandsJob( idRigidBodyIslands::predictionJob_t *job ) {
+	idRigidBodyIslands *islands = job->islands;
+	// too many threads tracing, the bodies trace serially when they move
+	if ( !collisionModelManager->CanTraceInParallel() ) {
+		return;
+	}
+	for ( int i = job->first; i < job->last; i++ ) {
+		islands->TraceIsland( i );
+	}
+}
+
+REGISTER_PARALLEL_JOB( RigidBodyIslandsJob, "RigidBodyIslandsJob" );
+
+/*
+================
+idRigidBodyIslands::Predict
+================
+*/
+void idRigidBodyIslands::Predict( void ) {
+	Clear();
+	frameNum = gameLocal.framenum;
+
+	if ( !rb_islands.GetBool() ) {
+		return;
+	}
+
+	// same step as idEntity::RunPhysics takes for entities which are not AI
+	const int timeStepMSec = gameLocal.time - gameLocal.previousTime;
+	if ( timeStepMSec <= 0 ) {
+		return;
+	}
+	const float timeStep = MS2SEC( timeStepMSec );
+
+	TRACE_CPU_SCOPE( "RigidBodyIslands" );
+
+	for ( auto iter = gameLocal.activeEntities.Begin(); iter; gameLocal.activeEntities.Next( iter ) ) {
+		idEntity *ent = iter.entity;
+
+		// team members are disabled for clipping while the team moves
+		if ( !( ent->thinkFlags & TH_PHYSICS ) || ent->GetTeamMaster() || ent->IsType( idAI::Type ) ) {
+			continue;
+		}
+		if ( !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) ) {
+			continue;
+		}
+		idPhysics_RigidBody *body = static_cast<idPhysics_RigidBody *>( ent->GetPhysics() );
+
+		// only bodies which will integrate and check for collisions in Evaluate
+		if ( body->hasMaster || body->current.atRest >= 0 || body->dropToFloor ) {
+			continue;
+		}
+		idClipModel *clipModel = body->clipModel;
+		if ( !clipModel || !clipModel->IsTraceModel() || !clipModel->IsLinked() ) {
+			continue;
+		}
+		// the other bodies of the island see the clip model where the body is
+		if ( clipModel->GetOrigin() != body->current.i.position || clipModel->GetAxis() != body->current.i.orientation ) {
+			continue;
+		}
+		// render models can only be traced from the main thread
+		if ( body->clipMask & CONTENTS_RENDERMODEL ) {
+			continue;
+		}
+#ifdef MOD_WATERPHYSICS
+		if ( body->water ) {
+			continue;
+		}
+		// Integrate would set the water
+		idClip_EntityList waterEntities;
+		if ( gameLocal.clip.EntitiesTouchingBounds( body->GetBounds() + body->GetOrigin(), MASK_WATER, waterEntities ) > 0 ) {
+			continue;
+		}
+		const float murkiness = body->m_fWaterMurkiness;
+#endif
+
+		rigidBodyPState_t next = body->current;
+		body->Integrate( timeStep, next );
+
+#ifdef MOD_WATERPHYSICS
+		body->m_fWaterMurkiness = murkiness;
+#endif
+
+		rigidBodyPrediction_t &prediction = predictions.Alloc();
+		prediction.body = body;
+		prediction.entityNum = ent->entityNumber;
+		prediction.spawnId = gameLocal.spawnIds[ent->entityNumber];
+		prediction.clipModel = clipModel;
+		prediction.trm = clipModel->GetTraceModel();
+		prediction.material = clipModel->GetMaterial();
+		prediction.owner = clipModel->GetOwner();
+		prediction.contents = clipModel->GetContents();
+		prediction.enabled = clipModel->IsEnabled();
+		prediction.clipMask = body->clipMask;
+		prediction.start = body->current.i.position;
+		prediction.startAxis = body->current.i.orientation;
+		prediction.end = next.i.position;
+		prediction.endAxis = next.i.orientation;
+
+		// any orientation of the trace model stays within its radius around the origin
+		prediction.bounds.Clear();
+		prediction.bounds.AddPoint( prediction.start );
+		prediction.bounds.AddPoint( prediction.end );
+		prediction.bounds.ExpandSelf( prediction.trm->bounds.GetRadius() + CM_BOX_EPSILON );
+
+		prediction.numTouching = 0;
+		prediction.island = predictions.Num() - 1;
+		prediction.traced = false;
+		prediction.taken = false;
+		prediction.collided = false;
+
+		body->predictionFrame = frameNum;
+		body->predictionIndex = predictions.Num() - 1;
+	}
+
+	if ( predictions.Num() == 0 ) {
+		return;
+	}
+
+	BuildIslands();
+
+	// the members of every island in think order
+	const int num = predictions.Num();
+	firstMember.SetNum( num + 1, false );
+	memset( firstMember.Ptr(), 0, firstMember.Num() * sizeof( int ) );
+	for ( int i = 0; i < num; i++ ) {
+		if ( predictions[i].island == i ) {
+			predictions[i].island = numIslands++;
+		} else {
+			predictions[i].island = predictions[predictions[i].island].island;
+		}
+		firstMember[predictions[i].island + 1]++;
+	}
+	firstMember.SetNum( numIslands + 1, false );
+	sorted.SetNum( numIslands, false );
+	for ( int i = 0; i < numIslands; i++ ) {
+		firstMember[i + 1] += firstMember[i];
+		sorted[i] = firstMember[i];
+	}
+	members.SetNum( num, false );
+	moves.SetNum( num, false );
+	for ( int i = 0; i < num; i++ ) {
+		const int island = predictions[i].island;
+		const int m = sorted[island]++;
+		members[m] = i;
+		moves[m].clipModel = predictions[i].clipModel;
+		// the copy is moved along while the island is traced, it is never linked
+		moves[m].moved = ( firstMember[island + 1] - firstMember[island] > 1 ) ? new idClipModel( predictions[i].clipModel ) : NULL;
+	}
+
+	// creating the copies counts as a change
+	const int changeCounter = idClipModel::GetChangeCounter();
+	for ( int i = 0; i < num; i++ ) {
+		predictions[i].changeCounter = changeCounter;
+	}
+
+	if ( numIslands < MIN_PARALLEL_ISLANDS ) {
+		for ( int i = 0; i < numIslands; i++ ) {
+			TraceIsland( i );
+		}
+	} else {
+		const int numJobs = Min( numIslands, MAX_RIGID_BODY_ISLAND_JOBS );
+		for ( int i = 0; i < numJobs; i++ ) {
+			jobs[i].islands = this;
+			jobs[i].first = numIslands * i / numJobs;
+			jobs[i].last = numIslands * ( i + 1 ) / numJobs;
+			jobList->AddJob( ( jobRun_t )RigidBodyIslandsJob, &jobs[i] );
+		}
+		gameLocal.clip.BeginParallelTraces();
+		jobList->Submit();
+		jobList->Wait();
+		gameLocal.clip.EndParallelTraces();
+	}
+
+	for ( int i = 0; i < num; i++ ) {
+		if ( predictions[i].traced ) {
+			numPredicted++;
+		}
+	}
+}
+
+/*
+================
+idRigidBodyIslands::FindIsland
+================
+*/
+int idRigidBodyIslands::FindIsland( int i ) {
+	while ( predictions[i].island != i ) {
+		predictions[i].island = predictions[predictions[i].island].island;
+		i = predictions[i].island;
+	}
+	return i;
+}
+
+/*
+================
+idRigidBodyIslands::BuildIslands
+
+  Joins the bodies whose bounds overlap, every island is named after its body which thinks first.
+================
+*/
+void idRigidBodyIslands::BuildIslands( void ) {
+	const int num = predictions.Num();
+
+	sorted.SetNum( num, false );
+	for ( int i = 0; i < num; i++ ) {
+		sorted[i] = i;
+	}
+	std::sort( sorted.Ptr(), sorted.Ptr() + num, [this]( int a, int b ) {
+		const float ax = predictions[a].bounds[0].x;
+		const float bx = predictions[b].bounds[0].x;
+		return ax < bx || ( ax == bx && a < b );
+	} );
+
+	// sweep along x
+	for ( int i = 0; i < num; i++ ) {
+		const idBounds &bounds = predictions[sorted[i]].bounds;
+		for ( int j = i + 1; j < num; j++ ) {
+			const idBounds &other = predictions[sorted[j]].bounds;
+			if ( other[0].x > bounds[1].x ) {
+				break;
+			}
+			if ( !bounds.IntersectsBounds( other ) ) {
+				continue;
+			}
+			const int a = FindIsland( sorted[i] );
+			const int b = FindIsland( sorted[j] );
+			if ( a < b ) {
+				predictions[b].island = a;
+			} else if ( b < a ) {
+				predictions[a].island = b;
+			}
+		}
+	}
+
+	for ( int i = 0; i < num; i++ ) {
+		predictions[i].island = FindIsland( i );
+	}
+}
+
+/*
+================
+idRigidBodyIslands::FindPrediction
+
+  Returns the prediction made this frame for the body of the clip model, -1 if there is none.
+================
+*/
+int idRigidBodyIslands::FindPrediction( const idClipModel *clipModel ) const {
+	const idEntity *ent = clipModel->GetEntity();
+	if ( !ent || !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) ) {
+		return -1;
+	}
+	const idPhysics_RigidBody *body = static_cast<const idPhysics_RigidBody *>( ent->GetPhysics() );
+	if ( body->predictionFrame != frameNum || predictions[body->predictionIndex].clipModel != clipModel ) {
+		return -1;
+	}
+	return body->predictionIndex;
+}
+
+/*
+================
+idRigidBodyIslands::ClipModelChanged
+
+  Returns true if the body is gone or its clip model is not the one the prediction was made for.
+================
+*/
+bool idRigidBodyIslands::ClipModelChanged( const rigidBodyPrediction_t &prediction ) const {
+	const idEntity *ent = gameLocal.entities[prediction.entityNum];
+	if ( !ent || gameLocal.spawnIds[prediction.entityNum] != prediction.spawnId || ent->GetPhysics() != prediction.body ) {
+		return true;
+	}
+	const idClipModel *clipModel = prediction.body->clipModel;
+	return ( clipModel != prediction.clipModel || !clipModel->IsLinked() || clipModel->IsEnabled() != prediction.enabled ||
+				clipModel->GetContents() != prediction.contents || clipModel->GetTraceModel() != prediction.trm ||
+					clipModel->GetMaterial() != prediction.material || clipModel->GetOwner() != prediction.owner );
+}
+
+/*
+================
+idRigidBodyIslands::CountTouching
+
+  Returns the number of clip models which are inside the bounds of the prediction, other than the bodies of its island.
+  Returns -1 if one of them is a render model, or if checkChanges is set and one of them has changed since the prediction.
+================
+*/
+int idRigidBodyIslands::CountTouching( const rigidBodyPrediction_t &prediction, bool checkChanges ) const {
+	idClip_ClipModelList clipModels;
+	gameLocal.clip.ClipModelsTouchingBounds( prediction.bounds, prediction.clipMask | MASK_WATER, clipModels );
+
+	int num = 0;
+	for ( int i = 0; i < clipModels.Num(); i++ ) {
+		const idClipModel *check = clipModels[i];
+		if ( check == prediction.clipModel ) {
+			continue;
+		}
+		// Take checks the bodies of the island one by one
+		const int other = FindPrediction( check );
+		if ( other >= 0 && predictions[other].island == prediction.island ) {
+			continue;
+		}
+		if ( check->IsRenderModel() ) {
+			return -1;
+		}
+		if ( checkChanges && check->GetChangeStamp() > prediction.changeCounter ) {
+			return -1;
+		}
+		num++;
+	}
+	return num;
+}
+
+/*
+================
+idRigidBodyIslands::TraceIsland
+
+  Traces the bodies of the island in think order, the copy of every body is moved to the end of its step
+  before the next one is traced. A body which is not traced leaves the rest of the island to Evaluate.
+================
+*/
+void idRigidBodyIslands::TraceIsland( int island ) {
+	const int first = firstMember[island];
+	const int last = firstMember[island + 1];
+
+	if ( last - first > 1 ) {
+		gameLocal.clip.SetTraceMoves( moves.Ptr() + first, last - first );
+	}
+	for ( int m = first; m < last; m++ ) {
+		rigidBodyPrediction_t &prediction = predictions[members[m]];
+		Trace( prediction );
+		if ( !prediction.traced ) {
+			break;
+		}
+		if ( moves[m].moved ) {
+			moves[m].moved->SetPosition( prediction.reached, prediction.reachedAxis );
+		}
+	}
+	gameLocal.clip.SetTraceMoves( NULL, 0 );
+}
+
+/*
+================
+idRigidBodyIslands::Trace
+
+  Same traces as idPhysics_RigidBody::CheckForCollisions.
+================
+*/
+void idRigidBodyIslands::Trace( rigidBodyPrediction_t &prediction ) const {
+	idMat3 axis;
+	idRotation rotation;
+
+	prediction.numTouching = CountTouching( prediction, false );
+	if ( prediction.numTouching < 0 ) {
+		return;
+	}
+
+	TransposeMultiply( prediction.startAxis, prediction.endAxis, axis );
+	rotation = axis.ToRotation();
+	rotation.SetOrigin( prediction.start );
+
+	idEntity *self = prediction.body->self;
+	prediction.collided = gameLocal.clip.Motion( prediction.collision, prediction.start, prediction.end, rotation,
+									prediction.clipModel, prediction.startAxis, prediction.clipMask, self );
+#ifdef MOD_WATERPHYSICS
+	prediction.collidedWater = gameLocal.clip.Motion( prediction.waterCollision, prediction.start, prediction.end, rotation,
+									prediction.clipModel, prediction.startAxis, MASK_WATER, self );
+#endif
+
+	// where Evaluate links the clip model
+	if ( prediction.collided ) {
+		prediction.reached = prediction.collision.endpos;
+		prediction.reachedAxis = prediction.collision.endAxis;
+	} else {
+		prediction.reached = prediction.end;
+		prediction.reachedAxis = prediction.endAxis;
+	}
+	prediction.traced = true;
+}
+
+/*
+================
+idRigidBodyIslands::Take
+
+  Called from idPhysics_RigidBody::Evaluate before the clip model of the body is unlinked.
+  The bodies of the island which think earlier must be where their predicted step ended,
+  the later ones must not have moved yet.
+  The caller still has to compare the step it integrated with the predicted one.
+================
+*/
+const rigidBodyPrediction_t *idRigidBodyIslands::Take( idPhysics_RigidBody *body ) {
+	if ( body->predictionFrame != frameNum || frameNum != gameLocal.framenum ) {
+		return NULL;
+	}
+
+	rigidBodyPrediction_t &prediction = predictions[body->predictionIndex];
+	assert( prediction.body == body );
+	if ( !prediction.traced || prediction.taken ) {
+		return NULL;
+	}
+	prediction.taken = true;
+
+	if ( body->clipMask != prediction.clipMask || ClipModelChanged( prediction ) ) {
+		return NULL;
+	}
+
+	const int self = body->predictionIndex;
+	for ( int m = firstMember[prediction.island]; m < firstMember[prediction.island + 1]; m++ ) {
+		const int i = members[m];
+		if ( i == self ) {
+			continue;
+		}
+		const rigidBodyPrediction_t &other = predictions[i];
+		if ( ClipModelChanged( other ) ) {
+			return NULL;
+		}
+		const idVec3 &origin = ( i < self ) ? other.reached : other.start;
+		const idMat3 &axis = ( i < self ) ? other.reachedAxis : other.startAxis;
+		if ( other.clipModel->GetOrigin() != origin || other.clipModel->GetAxis() != axis ) {
+			return NULL;
+		}
+	}
+
+	if ( CountTouching( prediction, true ) != prediction.numTouching ) {
+		return NULL;
+	}
+	return &prediction;
+}
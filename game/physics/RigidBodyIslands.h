@@ -0,0 +1,128 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef __RIGIDBODYISLANDS_H__
+#define __RIGIDBODYISLANDS_H__
+
+class idParallelJobList;
+class idPhysics_RigidBody;
+
+#define MAX_RIGID_BODY_ISLAND_JOBS		32
+
+/*
+===============================================================================
+
+	Rigid body islands
+
+	The moving rigid bodies are grouped into islands of bodies which may touch
+	each other during the next step. Before the entities think, the collision
+	traces of all bodies are run in jobs, every island in one job. The islands
+	do not share anything they trace against, within an island the bodies are
+	traced in think order. The traces of a body see the bodies of its island
+	which think earlier where their predicted step ends, copies of their clip
+	models are moved there.
+
+	idPhysics_RigidBody::Evaluate takes the traces of its body instead of tracing
+	itself if the step of the body and all clip models the traces may have touched
+	are still the same as when they were predicted, including the clip models of
+	its island being where the prediction left them. Everything else is evaluated
+	in think order as before, so the results only depend on what the bodies thinking
+	earlier in the frame did.
+
+===============================================================================
+*/
+
+typedef struct rigidBodyPrediction_s {
+	idPhysics_RigidBody *	body;
+	int						entityNum;				// the body is only looked at while its entity is still spawned
+	int						spawnId;
+	const idClipModel *		clipModel;
+	const idTraceModel *	trm;
+	const idMaterial *		material;
+	idEntity *				owner;
+	int						contents;
+	bool					enabled;
+	int						clipMask;
+	idVec3					start;					// position and orientation before the step
+	idMat3					startAxis;
+	idVec3					end;					// position and orientation after the step without collisions
+	idMat3					endAxis;
+	idVec3					reached;				// position and orientation after the traced step
+	idMat3					reachedAxis;
+	idBounds				bounds;					// contains everything the traces may touch
+	int						numTouching;			// clip models inside bounds, not counting the bodies of the island
+	int						changeCounter;			// idClipModel::GetChangeCounter() when predicted
+	int						island;
+	bool					traced;
+	bool					taken;
+	bool					collided;
+	trace_t					collision;
+#ifdef MOD_WATERPHYSICS
+	bool					collidedWater;
+	trace_t					waterCollision;
+#endif
+} rigidBodyPrediction_t;
+
+class idRigidBodyIslands {
+public:
+							idRigidBodyIslands( void );
+
+	// allocates the job list, called once on game init
+	void					Init( void );
+	void					Shutdown( void );
+
+	// frees the predictions, called on map shutdown before the clip models go away
+	void					Clear( void );
+
+	// predicts the collisions of the moving rigid bodies, call before the entities think
+	void					Predict( void );
+
+	// the traces predicted for the body this frame, NULL if anything they depend on has changed
+	const rigidBodyPrediction_t *Take( idPhysics_RigidBody *body );
+
+	int						GetNumIslands( void ) const { return numIslands; }
+	int						GetNumPredicted( void ) const { return numPredicted; }
+
+private:
+	typedef struct {
+		idRigidBodyIslands *islands;
+		int					first;
+		int					last;
+	} predictionJob_t;
+
+	int						FindIsland( int i );
+	void					BuildIslands( void );
+	int						FindPrediction( const idClipModel *clipModel ) const;
+	bool					ClipModelChanged( const rigidBodyPrediction_t &prediction ) const;
+	void					TraceIsland( int island );
+	void					Trace( rigidBodyPrediction_t &prediction ) const;
+	int						CountTouching( const rigidBodyPrediction_t &prediction, bool checkChanges ) const;
+
+	idList<rigidBodyPrediction_t> predictions;
+	idList<int>				members;				// predictions sorted by island and think order
+	idList<clipModelMove_t>	moves;					// copies of the clip models of the members, only for islands with several bodies
+	idList<int>				firstMember;			// first member of every island, one more for the end
+	idList<int>				sorted;
+	int						frameNum;
+	int						numIslands;
+	int						numPredicted;
+
+	idParallelJobList *		jobList;
+	predictionJob_t			jobs[MAX_RIGID_BODY_ISLAND_JOBS];
+
+	friend void				RigidBodyIslandsJob( predictionJob_t *job );
+};
+
+#endif /* !__RIGIDBODYISLANDS_H__ */
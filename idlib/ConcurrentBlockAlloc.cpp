@@ -0,0 +1,140 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+#include "precompiled.h"
+#pragma hdrstop
+
+#include <thread>
+#include "ConcurrentBlockAlloc.h"
+
+static std::atomic<uint64> concurrentAllocUsedSlots( 0 );
+static_assert( CONCURRENT_ALLOC_MAX_THREADS <= 64, "used slots must fit into 64-bit mask" );
+
+// gives the slot back when the thread exits, job threads are restarted whenever jobs_numThreads changes
+// the magazines of the slot stay in the caches and are taken over by the next thread getting the slot
+struct concurrentAllocThreadSlot_t {
+	int slot = -2;
+	~concurrentAllocThreadSlot_t() {
+		if ( slot >= 0 ) {
+			concurrentAllocUsedSlots.fetch_and( ~( (uint64)1 << slot ), std::memory_order_release );
+		}
+		// allocators used by later thread_local destructors go to the shared cache
+		slot = -1;
+	}
+};
+
+static thread_local concurrentAllocThreadSlot_t concurrentAllocSlot;
+
+int idConcurrentBlockAlloc_ThreadSlot( void ) {
+	int slot = concurrentAllocSlot.slot;
+	if ( slot == -2 ) {
+		uint64 used = concurrentAllocUsedSlots.load( std::memory_order_relaxed );
+		do {
+			for ( slot = 0; slot < CONCURRENT_ALLOC_MAX_THREADS; slot++ ) {
+				if ( !( used & ( (uint64)1 << slot ) ) ) {
+					break;
+				}
+			}
+			if ( slot >= CONCURRENT_ALLOC_MAX_THREADS ) {
+				slot = -1;
+				break;
+			}
+		} while ( !concurrentAllocUsedSlots.compare_exchange_weak( used, used | ( (uint64)1 << slot ), std::memory_order_acquire, std::memory_order_relaxed ) );
+		concurrentAllocSlot.slot = slot;
+	}
+	return slot;
+}
+
+
+#include "../tests/testing.h"
+
+TEST_CASE("idConcurrentBlockAlloc: alloc and free from several threads") {
+	struct element_t {
+		int owner;
+		int value;
+	};
+	static idConcurrentBlockAlloc<element_t, 64, 8> allocator;
+	static const int NUM_THREADS = 4;
+	static const int NUM_ITERATIONS = 20000;
+	static std::atomic<int> numErrors;
+	numErrors = 0;
+
+	auto worker = [](int thread) {
+		idList<element_t *> live;
+		for ( int i = 0; i < NUM_ITERATIONS; i++ ) {
+			if ( live.Num() < 100 && ( i % 3 ) != 2 ) {
+				element_t *e = allocator.Alloc();
+				e->owner = thread;
+				e->value = i;
+				live.Append( e );
+			} else if ( live.Num() > 0 ) {
+				element_t *e = live[live.Num() - 1];
+				live.RemoveIndex( live.Num() - 1 );
+				// nobody else may have got the same element meanwhile
+				if ( e->owner != thread ) {
+					numErrors++;
+				}
+				allocator.Free( e );
+			}
+		}
+		for ( int i = 0; i < live.Num(); i++ ) {
+			if ( live[i]->owner != thread ) {
+				numErrors++;
+			}
+			allocator.Free( live[i] );
+		}
+	};
+
+	std::thread threads[NUM_THREADS];
+	for ( int t = 0; t < NUM_THREADS; t++ ) {
+		threads[t] = std::thread( worker, t );
+	}
+	for ( int t = 0; t < NUM_THREADS; t++ ) {
+		threads[t].join();
+	}
+
+	CHECK( numErrors == 0 );
+	CHECK( allocator.GetAllocCount() == 0 );
+
+	concurrentAllocStats_t stats;
+	allocator.GetStats( stats );
+	CHECK( stats.allocCount == 0 );
+	CHECK( stats.totalCount == stats.numBlocks * 64 );
+
+	allocator.Shutdown();
+	CHECK( allocator.GetTotalCount() == 0 );
+}
+
+TEST_CASE("idConcurrentBlockAlloc: slots of finished threads are reused") {
+	static idConcurrentBlockAlloc<int, 16, 4> allocator;
+	static std::atomic<int> numShared;
+	numShared = 0;
+
+	// many more threads than slots, but only a few live at once
+	for ( int round = 0; round < 4 * CONCURRENT_ALLOC_MAX_THREADS; round++ ) {
+		std::thread thread( [] {
+			if ( idConcurrentBlockAlloc_ThreadSlot() < 0 ) {
+				numShared++;
+			}
+			int *e = allocator.Alloc();
+			allocator.Free( e );
+		} );
+		thread.join();
+	}
+
+	CHECK( numShared == 0 );
+	CHECK( allocator.GetAllocCount() == 0 );
+
+	allocator.Shutdown();
+}
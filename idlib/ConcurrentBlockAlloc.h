@@ -0,0 +1,354 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef __CONCURRENT_BLOCK_ALLOC_H__
+#define __CONCURRENT_BLOCK_ALLOC_H__
+
+#include <atomic>
+
+// number of threads which get their own magazines in every idConcurrentBlockAlloc
+// further threads share one set of magazines under a mutex
+#define CONCURRENT_ALLOC_MAX_THREADS	32
+
+// returns index in [0..CONCURRENT_ALLOC_MAX_THREADS) assigned to the calling thread on first call,
+// or -1 if all indices are taken; the index is given back when the thread exits
+int idConcurrentBlockAlloc_ThreadSlot( void );
+
+typedef struct {
+	int						totalCount;			// number of elements in all blocks
+	int						allocCount;			// number of elements in use
+	int						numBlocks;
+	int						numMagazines;
+	int						numDepotGets;		// magazines taken from the depot
+	int						numDepotPuts;		// magazines given back to the depot
+	int						numSharedAllocs;	// allocations by threads without own magazines
+} concurrentAllocStats_t;
+
+/*
+===============================================================================
+
+	Block based allocator for fixed size objects, which can be used from any thread.
+
+	Same as idBlockAlloc: all objects of the 'type' are properly constructed,
+	but the constructor is not called for re-used objects.
+
+	Every thread keeps a loaded and a previous magazine of free elements, so most
+	Alloc/Free calls touch only data of the calling thread. When both are exhausted
+	(or filled up), magazines are exchanged with a global depot, which is a pair of
+	lock-free stacks (full and empty magazines). Only allocating a new block takes a lock.
+
+	An element may be freed by any thread, not only the one which allocated it.
+	Shutdown must not run concurrently with any other call.
+
+===============================================================================
+*/
+
+template<class type, int blockSize, int magazineSize = 32>
+class idConcurrentBlockAlloc {
+public:
+							idConcurrentBlockAlloc( void );
+							~idConcurrentBlockAlloc( void );
+
+	void					Shutdown( void );
+
+	type *					Alloc( void );
+	void					Free( type *element );
+
+	int						GetTotalCount( void ) const { return total.load( std::memory_order_relaxed ); }
+	int						GetAllocCount( void ) const;
+	int						GetFreeCount( void ) const { return GetTotalCount() - GetAllocCount(); }
+	void					GetStats( concurrentAllocStats_t &stats ) const;
+
+private:
+	typedef struct {
+		int					num;
+		int					index;				// position in magazineChunks
+		std::atomic<int>	next;				// depot link: magazine index + 1, 0 = none
+		type *				elements[magazineSize];
+	} magazine_t;
+
+	typedef struct block_s {
+		type				elements[blockSize];
+		struct block_s *	next;
+	} block_t;
+
+	// padded to cache line size to avoid false sharing between threads
+	typedef struct {
+		magazine_t *		loaded;
+		magazine_t *		previous;
+		// only written by the owning thread, may be read by any
+		std::atomic<int>	numAllocs;
+		std::atomic<int>	numFrees;
+		char				padding[64 - 2 * sizeof( void * ) - 2 * sizeof( int )];
+	} threadCache_t;
+
+	static const int		MAGAZINES_PER_CHUNK = 256;
+	static const int		MAX_MAGAZINE_CHUNKS = 1024;
+
+	threadCache_t			caches[CONCURRENT_ALLOC_MAX_THREADS + 1];	// last one is shared
+	idSysMutex				sharedCacheMutex;
+
+	// depot stacks: lower 32 bits = magazine index + 1, upper 32 bits = ABA tag
+	std::atomic<uint64_t>	fullMagazines;
+	std::atomic<uint64_t>	emptyMagazines;
+	std::atomic<int>		numDepotGets;
+	std::atomic<int>		numDepotPuts;
+	std::atomic<int>		numSharedAllocs;
+
+	// magazines are never freed until Shutdown, so depot can access them without locks
+	magazine_t *			magazineChunks[MAX_MAGAZINE_CHUNKS];
+	std::atomic<int>		numMagazines;
+
+	idSysMutex				growMutex;			// protects blocks and creation of magazines
+	block_t *				blocks;
+	std::atomic<int>		total;
+	std::atomic<int>		numBlocks;
+
+	magazine_t *			GetMagazine( int index ) const { return &magazineChunks[index / MAGAZINES_PER_CHUNK][index % MAGAZINES_PER_CHUNK]; }
+	magazine_t *			NewMagazine( void );
+	magazine_t *			Pop( std::atomic<uint64_t> &stack );
+	void					Push( std::atomic<uint64_t> &stack, magazine_t *magazine );
+	magazine_t *			GetEmptyMagazine( void );
+	void					Grow( threadCache_t &cache );
+
+	type *					AllocFromCache( threadCache_t &cache );
+	void					FreeToCache( threadCache_t &cache, type *element );
+};
+
+template<class type, int blockSize, int magazineSize>
+idConcurrentBlockAlloc<type,blockSize,magazineSize>::idConcurrentBlockAlloc( void ) {
+	for ( int i = 0; i <= CONCURRENT_ALLOC_MAX_THREADS; i++ ) {
+		caches[i].loaded = NULL;
+		caches[i].previous = NULL;
+		caches[i].numAllocs = 0;
+		caches[i].numFrees = 0;
+	}
+	fullMagazines = 0;
+	emptyMagazines = 0;
+	numDepotGets = 0;
+	numDepotPuts = 0;
+	numSharedAllocs = 0;
+	memset( magazineChunks, 0, sizeof( magazineChunks ) );
+	numMagazines = 0;
+	blocks = NULL;
+	total = 0;
+	numBlocks = 0;
+}
+
+template<class type, int blockSize, int magazineSize>
+idConcurrentBlockAlloc<type,blockSize,magazineSize>::~idConcurrentBlockAlloc( void ) {
+	Shutdown();
+}
+
+template<class type, int blockSize, int magazineSize>
+void idConcurrentBlockAlloc<type,blockSize,magazineSize>::Shutdown( void ) {
+	while ( blocks ) {
+		block_t *block = blocks;
+		blocks = blocks->next;
+		delete block;
+	}
+	for ( int i = 0; i < MAX_MAGAZINE_CHUNKS && magazineChunks[i]; i++ ) {
+		delete [] magazineChunks[i];
+		magazineChunks[i] = NULL;
+	}
+	for ( int i = 0; i <= CONCURRENT_ALLOC_MAX_THREADS; i++ ) {
+		caches[i].loaded = NULL;
+		caches[i].previous = NULL;
+		caches[i].numAllocs = 0;
+		caches[i].numFrees = 0;
+	}
+	fullMagazines = 0;
+	emptyMagazines = 0;
+	numMagazines = 0;
+	total = 0;
+	numBlocks = 0;
+}
+
+template<class type, int blockSize, int magazineSize>
+int idConcurrentBlockAlloc<type,blockSize,magazineSize>::GetAllocCount( void ) const {
+	int count = 0;
+	for ( int i = 0; i <= CONCURRENT_ALLOC_MAX_THREADS; i++ ) {
+		count += caches[i].numAllocs.load( std::memory_order_relaxed ) - caches[i].numFrees.load( std::memory_order_relaxed );
+	}
+	return count;
+}
+
+template<class type, int blockSize, int magazineSize>
+void idConcurrentBlockAlloc<type,blockSize,magazineSize>::GetStats( concurrentAllocStats_t &stats ) const {
+	stats.totalCount = GetTotalCount();
+	stats.allocCount = GetAllocCount();
+	stats.numBlocks = numBlocks.load( std::memory_order_relaxed );
+	stats.numMagazines = numMagazines.load( std::memory_order_relaxed );
+	stats.numDepotGets = numDepotGets.load( std::memory_order_relaxed );
+	stats.numDepotPuts = numDepotPuts.load( std::memory_order_relaxed );
+	stats.numSharedAllocs = numSharedAllocs.load( std::memory_order_relaxed );
+}
+
+template<class type, int blockSize, int magazineSize>
+typename idConcurrentBlockAlloc<type,blockSize,magazineSize>::magazine_t *idConcurrentBlockAlloc<type,blockSize,magazineSize>::NewMagazine( void ) {
+	idScopedCriticalSection lock( growMutex );
+
+	int index = numMagazines.load( std::memory_order_relaxed );
+	int chunk = index / MAGAZINES_PER_CHUNK;
+	if ( chunk >= MAX_MAGAZINE_CHUNKS ) {
+		idLib::common->FatalError( "idConcurrentBlockAlloc: too many magazines" );
+	}
+	if ( !magazineChunks[chunk] ) {
+		magazineChunks[chunk] = new magazine_t[MAGAZINES_PER_CHUNK];
+	}
+	magazine_t *magazine = GetMagazine( index );
+	magazine->num = 0;
+	magazine->index = index;
+	magazine->next.store( 0, std::memory_order_relaxed );
+	// publishes the chunk pointer before the magazine can get into the depot
+	numMagazines.store( index + 1, std::memory_order_release );
+	return magazine;
+}
+
+template<class type, int blockSize, int magazineSize>
+typename idConcurrentBlockAlloc<type,blockSize,magazineSize>::magazine_t *idConcurrentBlockAlloc<type,blockSize,magazineSize>::Pop( std::atomic<uint64_t> &stack ) {
+	uint64_t head = stack.load( std::memory_order_acquire );
+	while ( true ) {
+		int link = int( head & 0xFFFFFFFFu );
+		if ( link == 0 ) {
+			return NULL;
+		}
+		magazine_t *magazine = GetMagazine( link - 1 );
+		// the magazine may be popped by another thread meanwhile, then the tag has changed and CAS fails
+		uint64_t next = ( ( head >> 32 ) + 1 ) << 32 | unsigned( magazine->next.load( std::memory_order_relaxed ) );
+		if ( stack.compare_exchange_weak( head, next, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+			numDepotGets.fetch_add( 1, std::memory_order_relaxed );
+			return magazine;
+		}
+	}
+}
+
+template<class type, int blockSize, int magazineSize>
+void idConcurrentBlockAlloc<type,blockSize,magazineSize>::Push( std::atomic<uint64_t> &stack, magazine_t *magazine ) {
+	uint64_t link = unsigned( magazine->index + 1 );
+	uint64_t head = stack.load( std::memory_order_relaxed );
+	while ( true ) {
+		magazine->next.store( int( head & 0xFFFFFFFFu ), std::memory_order_relaxed );
+		uint64_t newHead = ( ( head >> 32 ) + 1 ) << 32 | link;
+		if ( stack.compare_exchange_weak( head, newHead, std::memory_order_release, std::memory_order_relaxed ) ) {
+			numDepotPuts.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+	}
+}
+
+template<class type, int blockSize, int magazineSize>
+typename idConcurrentBlockAlloc<type,blockSize,magazineSize>::magazine_t *idConcurrentBlockAlloc<type,blockSize,magazineSize>::GetEmptyMagazine( void ) {
+	magazine_t *magazine = Pop( emptyMagazines );
+	if ( !magazine ) {
+		magazine = NewMagazine();
+	}
+	assert( magazine->num == 0 );
+	return magazine;
+}
+
+template<class type, int blockSize, int magazineSize>
+void idConcurrentBlockAlloc<type,blockSize,magazineSize>::Grow( threadCache_t &cache ) {
+	block_t *block = new block_t;
+	{
+		idScopedCriticalSection lock( growMutex );
+		block->next = blocks;
+		blocks = block;
+	}
+	total.fetch_add( blockSize, std::memory_order_relaxed );
+	numBlocks.fetch_add( 1, std::memory_order_relaxed );
+
+	// the loaded magazine is empty: fill it first, the rest goes to the depot
+	magazine_t *magazine = cache.loaded;
+	for ( int i = 0; i < blockSize; i++ ) {
+		if ( magazine->num == magazineSize ) {
+			if ( magazine != cache.loaded ) {
+				Push( fullMagazines, magazine );
+			}
+			magazine = GetEmptyMagazine();
+		}
+		magazine->elements[magazine->num++] = &block->elements[i];
+	}
+	if ( magazine != cache.loaded ) {
+		Push( fullMagazines, magazine );
+	}
+}
+
+template<class type, int blockSize, int magazineSize>
+type *idConcurrentBlockAlloc<type,blockSize,magazineSize>::AllocFromCache( threadCache_t &cache ) {
+	if ( !cache.loaded ) {
+		cache.loaded = GetEmptyMagazine();
+		cache.previous = GetEmptyMagazine();
+	}
+	if ( cache.loaded->num == 0 ) {
+		if ( cache.previous->num > 0 ) {
+			idSwap( cache.loaded, cache.previous );
+		} else {
+			magazine_t *full = Pop( fullMagazines );
+			if ( full ) {
+				Push( emptyMagazines, cache.previous );
+				cache.previous = cache.loaded;
+				cache.loaded = full;
+			} else {
+				Grow( cache );
+			}
+		}
+	}
+	cache.numAllocs.store( cache.numAllocs.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+	return cache.loaded->elements[--cache.loaded->num];
+}
+
+template<class type, int blockSize, int magazineSize>
+void idConcurrentBlockAlloc<type,blockSize,magazineSize>::FreeToCache( threadCache_t &cache, type *element ) {
+	if ( !cache.loaded ) {
+		cache.loaded = GetEmptyMagazine();
+		cache.previous = GetEmptyMagazine();
+	}
+	if ( cache.loaded->num == magazineSize ) {
+		if ( cache.previous->num == 0 ) {
+			idSwap( cache.loaded, cache.previous );
+		} else {
+			Push( fullMagazines, cache.previous );
+			cache.previous = cache.loaded;
+			cache.loaded = GetEmptyMagazine();
+		}
+	}
+	cache.numFrees.store( cache.numFrees.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+	cache.loaded->elements[cache.loaded->num++] = element;
+}
+
+template<class type, int blockSize, int magazineSize>
+type *idConcurrentBlockAlloc<type,blockSize,magazineSize>::Alloc( void ) {
+	int slot = idConcurrentBlockAlloc_ThreadSlot();
+	if ( slot >= 0 ) {
+		return AllocFromCache( caches[slot] );
+	}
+	idScopedCriticalSection lock( sharedCacheMutex );
+	numSharedAllocs.fetch_add( 1, std::memory_order_relaxed );
+	return AllocFromCache( caches[CONCURRENT_ALLOC_MAX_THREADS] );
+}
+
+template<class type, int blockSize, int magazineSize>
+void idConcurrentBlockAlloc<type,blockSize,magazineSize>::Free( type *element ) {
+	int slot = idConcurrentBlockAlloc_ThreadSlot();
+	if ( slot >= 0 ) {
+		FreeToCache( caches[slot], element );
+		return;
+	}
+	idScopedCriticalSection lock( sharedCacheMutex );
+	FreeToCache( caches[CONCURRENT_ALLOC_MAX_THREADS], element );
+}
+
+#endif /* !__CONCURRENT_BLOCK_ALLOC_H__ */
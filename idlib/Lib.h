@@ -268,6 +268,7 @@ template<class T> struct idRaw {
 #include "MapFile.h"
 #include "Timer.h"
 #include "Thread.h"
+#include "ConcurrentBlockAlloc.h"
 #include "RevisionTracker.h"
 #include "ParallelJobList.h"
 
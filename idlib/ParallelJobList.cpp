@@ -26,6 +26,7 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 const char * jobNames[] = {
 	ASSERT_ENUM_STRING( JOBLIST_RENDERER_FRONTEND,	0 ),
 	ASSERT_ENUM_STRING( JOBLIST_RENDERER_BACKEND,	1 ),
+	ASSERT_ENUM_STRING( JOBLIST_GAME,				2 ),
 	ASSERT_ENUM_STRING( JOBLIST_UTILITY,			9 ),
 };
 
@@ -114,6 +115,7 @@ idParallelJobList_Threads
 */
 
 static idCVar jobs_longJobMicroSec( "jobs_longJobMicroSec", "100000", CVAR_INTEGER, "print a warning for jobs that take more than this number of microseconds" );
+static idCVar jobs_workStealing( "jobs_workStealing", "0", CVAR_BOOL | CVAR_NOCHEAT, "run job lists on the work-stealing scheduler (per-thread job deques) instead of fetching jobs in list order" );
 
 
 const static int		MAX_THREADS	= 32;
@@ -124,18 +126,21 @@ struct threadJobListState_t {
 									version( 0xFFFFFFFF ),
 									signalIndex( 0 ),
 									lastJobIndex( 0 ),
-									nextJobIndex( -1 ) {}
+									nextJobIndex( -1 ),
+									stalledSignalIndex( -1 ) {}
 								threadJobListState_t( int _version ) :
 									jobList( NULL ),
 									version( _version ),
 									signalIndex( 0 ),
 									lastJobIndex( 0 ),
-									nextJobIndex( -1 ) {}
+									nextJobIndex( -1 ),
+									stalledSignalIndex( -1 ) {}
 	idParallelJobList_Threads *	jobList;
 	int							version;
 	int							signalIndex;
 	int							lastJobIndex;
 	int							nextJobIndex;
+	int							stalledSignalIndex;		// only the first stall on a sync point goes to the timeline
 };
 
 struct threadStats_t {
@@ -149,6 +154,20 @@ struct threadStats_t {
 	uint64			threadTotalTime[MAX_THREADS];
 };
 
+class idParallelJobList_Threads;
+
+struct stealJob_t {
+	jobRun_t					function;
+	void *						data;
+	idParallelJobList_Threads *	jobList;
+	int							jobIndex;		// -1 for jobs spawned from inside other jobs
+};
+
+// hand over to the manager
+void SubmitStealingJobs( const stealJob_t * jobs, int numJobs, int parallelism );
+void PushStealingJobs( const stealJob_t * jobs, int numJobs );
+bool RunAnyStealingJob();
+
 class idParallelJobList_Threads {
 public:
 							idParallelJobList_Threads( jobListId_t id, jobListPriority_t priority, unsigned int maxJobs, unsigned int maxSyncs );
@@ -157,8 +176,9 @@ public:
 	//------------------------
 	// These are called from the one thread that manages this list.
 	//------------------------
-	ID_INLINE void			AddJob( jobRun_t function, void * data );
+	ID_INLINE int			AddJob( jobRun_t function, void * data );
 	ID_INLINE void			InsertSyncPoint( jobSyncType_t syncType );
+	void					AddDependency( int job, int prerequisite );
 	void					Submit( idParallelJobList_Threads * waitForJobList_, int parallelism );
 	void					Wait();
 	bool					TryWait();
@@ -193,6 +213,11 @@ public:
 
 	int						RunJobs( unsigned int threadNum, threadJobListState_t & state, bool singleJob );
 
+	// work-stealing scheduler: run a single job and release the jobs depending on it
+	void					RunStealingJob( const stealJob_t & job, unsigned int threadNum );
+	// work-stealing scheduler: account for a job spawned by a job of this list
+	void					AddSpawnedJob() { pendingJobs.Increment(); numSpawnedJobs.Increment(); }
+
 private:
 	static const int		NUM_DONE_GUARDS = 4;	// cycle through 4 guards so we can cyclicly chain job lists
 
@@ -223,7 +248,21 @@ private:
 	threadStats_t						deferredThreadStats;
 	threadStats_t						threadStats;
 
+	// work-stealing scheduler state
+	struct jobDependency_t {
+		int			job;
+		int			prerequisite;
+	};
+	bool								useWorkStealing;
+	idList< jobDependency_t >			dependencies;
+	idList< int >						firstDependent;			// per job index into dependents, one extra at the end
+	idList< int >						dependents;
+	idList< idSysInterlockedInteger >	numPrerequisites;		// per job number of unfinished prerequisites
+	idSysInterlockedInteger				pendingJobs;			// jobs not finished yet, including spawned ones
+	idSysInterlockedInteger				numSpawnedJobs;
+
 	int						RunJobsInternal( unsigned int threadNum, threadJobListState_t & state, bool singleJob );
+	void					BuildDependencyGraph( idList< stealJob_t > & readyJobs );
 
 	static void				Nop( void * data ) {}
 
@@ -251,7 +290,8 @@ idParallelJobList_Threads::idParallelJobList_Threads( jobListId_t id, jobListPri
 	lastSignalJob( 0 ),
 	waitForGuard( NULL ),
 	currentDoneGuard( 0 ),
-	jobList() {
+	jobList(),
+	useWorkStealing( false ) {
 
 	assert( listPriority != JOBLIST_PRIORITY_NONE );
 
@@ -282,14 +322,14 @@ static idCVarBool jobs_debugCheck( "jobs_debugCheck", "0", CVAR_TOOL, "check job
 idParallelJobList_Threads::AddJob
 ========================
 */
-ID_INLINE void idParallelJobList_Threads::AddJob( jobRun_t function, void * data ) {
+ID_INLINE int idParallelJobList_Threads::AddJob( jobRun_t function, void * data ) {
 	assert( done );
 	if ( int(maxJobs) == jobList.Num() ) {
 		static int runOnce = []() {
 			common->Warning( "idParallelJobList_Threads overflow\n" );
 			return 0;
 		} ( );
-		return;
+		return -1;
 	}
 	// make sure there isn't already a job with the same function and data in the list
 	if ( jobs_debugCheck ) {	
@@ -307,6 +347,7 @@ ID_INLINE void idParallelJobList_Threads::AddJob( jobRun_t function, void * data
 		job.function = function;
 		job.data = data;
 		job.executed = 0;
+		return jobList.Num() - 1;
 //	} else {
 #else
 		// debug output to show us what is overflowing
@@ -368,6 +409,126 @@ ID_INLINE void idParallelJobList_Threads::InsertSyncPoint( jobSyncType_t syncTyp
 	}
 }
 
+/*
+========================
+idParallelJobList_Threads::AddDependency
+========================
+*/
+void idParallelJobList_Threads::AddDependency( int job, int prerequisite ) {
+	assert( done );
+	if ( job < 0 || prerequisite < 0 ) {
+		// one of the jobs did not fit into the list
+		return;
+	}
+	assert( job < jobList.Num() && prerequisite < jobList.Num() );
+	if ( job == prerequisite ) {
+		return;
+	}
+	jobDependency_t & dependency = dependencies.Alloc();
+	dependency.job = job;
+	dependency.prerequisite = prerequisite;
+}
+
+/*
+========================
+idParallelJobList_Threads::BuildDependencyGraph
+
+Turns the explicit dependencies and the sync points into per job
+prerequisite counts and lists of dependent jobs, and collects the
+jobs that can start right away.
+========================
+*/
+void idParallelJobList_Threads::BuildDependencyGraph( idList< stealJob_t > & readyJobs ) {
+	const int numJobs = jobList.Num();
+	auto addEdge = [this]( int job, int prerequisite ) {
+		jobDependency_t & dependency = dependencies.Alloc();
+		dependency.job = job;
+		dependency.prerequisite = prerequisite;
+	};
+
+	// sync points become edges: a signal waits for all jobs since the previous signal,
+	// and every job after a synchronize waits for the last signal
+	int segmentStart = 0;
+	int lastSignal = -1;
+	int activeSignal = -1;
+	for ( int i = 0; i < numJobs; i++ ) {
+		const void * data = jobList[i].data;
+		if ( data == & JOB_SIGNAL ) {
+			for ( int j = segmentStart; j < i; j++ ) {
+				if ( jobList[j].data != & JOB_SYNCHRONIZE ) {
+					addEdge( i, j );
+				}
+			}
+			segmentStart = i + 1;
+			lastSignal = i;
+		} else if ( data == & JOB_SYNCHRONIZE ) {
+			activeSignal = lastSignal;
+		} else if ( activeSignal >= 0 ) {
+			addEdge( i, activeSignal );
+		}
+	}
+
+	firstDependent.SetNum( numJobs + 1 );
+	numPrerequisites.SetNum( numJobs );
+	for ( int i = 0; i <= numJobs; i++ ) {
+		firstDependent[i] = 0;
+	}
+	for ( int i = 0; i < numJobs; i++ ) {
+		numPrerequisites[i].SetValue( 0 );
+	}
+	for ( int i = 0; i < dependencies.Num(); i++ ) {
+		firstDependent[dependencies[i].prerequisite + 1]++;
+		numPrerequisites[dependencies[i].job].Increment();
+	}
+	for ( int i = 0; i < numJobs; i++ ) {
+		firstDependent[i + 1] += firstDependent[i];
+	}
+	dependents.SetNum( dependencies.Num() );
+	idList< int > fill;
+	fill.SetNum( numJobs );
+	for ( int i = 0; i < numJobs; i++ ) {
+		fill[i] = firstDependent[i];
+	}
+	for ( int i = 0; i < dependencies.Num(); i++ ) {
+		dependents[fill[dependencies[i].prerequisite]++] = dependencies[i].job;
+	}
+
+	readyJobs.SetNum( 0 );
+	for ( int i = 0; i < numJobs; i++ ) {
+		if ( numPrerequisites[i].GetValue() == 0 ) {
+			stealJob_t & job = readyJobs.Alloc();
+			job.function = jobList[i].function;
+			job.data = jobList[i].data;
+			job.jobList = this;
+			job.jobIndex = i;
+		}
+	}
+
+	if ( jobs_debugCheck ) {
+		// a cycle would leave the list unfinished forever
+		idList< int > counts, queue;
+		counts.SetNum( numJobs );
+		for ( int i = 0; i < numJobs; i++ ) {
+			counts[i] = numPrerequisites[i].GetValue();
+			if ( counts[i] == 0 ) {
+				queue.Append( i );
+			}
+		}
+		for ( int q = 0; q < queue.Num(); q++ ) {
+			for ( int i = firstDependent[queue[q]]; i < firstDependent[queue[q] + 1]; i++ ) {
+				if ( --counts[dependents[i]] == 0 ) {
+					queue.Append( dependents[i] );
+				}
+			}
+		}
+		if ( queue.Num() != numJobs ) {
+			common->Warning( "jobs_debugCheck failed: cyclic job dependencies in job list %s\n", GetJobListName( listId ) );
+		}
+	}
+	pendingJobs.SetValue( numJobs );
+	numSpawnedJobs.SetValue( 0 );
+}
+
 /*
 ========================
 idParallelJobList_Threads::Submit
@@ -381,6 +542,7 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads * waitForJobLi
 
 	done = false;
 	currentJob.SetValue( 0 );
+	pendingJobs.SetValue( 0 );
 
 	memset( &deferredThreadStats, 0, sizeof( deferredThreadStats ) );
 	deferredThreadStats.numExecutedJobs = jobList.Num() - numSyncs * 2;
@@ -410,6 +572,24 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads * waitForJobLi
 	job.function = Nop;
 	job.data = & JOB_LIST_DONE;
 
+	// waiting for another job list is only supported by the list order scheduler,
+	// unless the jobs have dependencies which that scheduler can't handle
+	useWorkStealing = dependencies.Num() > 0 || ( jobs_workStealing.GetBool() && waitForJobList == NULL );
+	if ( useWorkStealing ) {
+		if ( waitForGuard != NULL ) {
+			while ( waitForGuard->GetValue() > 0 ) {
+				if ( !RunAnyStealingJob() ) {
+					Sys_Yield();
+				}
+			}
+			waitForGuard = NULL;
+		}
+		idList< stealJob_t > readyJobs;
+		BuildDependencyGraph( readyJobs );
+		SubmitStealingJobs( readyJobs.Ptr(), readyJobs.Num(), threaded ? parallelism : 0 );
+		return;
+	}
+
 	if ( threaded ) {
 		// hand over to the manager
 		void SubmitJobList( idParallelJobList_Threads * jobList, int parallelism );
@@ -427,7 +607,8 @@ idParallelJobList_Threads::Wait
 ========================
 */
 void idParallelJobList_Threads::Wait() {
-	if ( jobList.Num() > 0 ) {
+	const bool executed = jobList.Num() > 0;
+	if ( executed ) {
 		// don't lock up but return if the job list was never properly submitted
 		if ( !verify( !done && signalJobCount.Num() > 0 ) ) {
 			return;
@@ -436,9 +617,19 @@ void idParallelJobList_Threads::Wait() {
 		bool waited = false;
 		uint64 waitStart = Sys_Microseconds();
 
-		while ( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 ) {
-			Sys_Yield();
-			waited = true;
+		if ( useWorkStealing ) {
+			// help out with any stolen jobs instead of just spinning
+			while ( pendingJobs.GetValue() > 0 ) {
+				if ( !RunAnyStealingJob() ) {
+					Sys_Yield();
+				}
+				waited = true;
+			}
+		} else {
+			while ( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 ) {
+				Sys_Yield();
+				waited = true;
+			}
 		}
 		version.Increment();
 		while ( numThreadsExecuting.GetValue() > 0 ) {
@@ -446,8 +637,12 @@ void idParallelJobList_Threads::Wait() {
 			waited = true;
 		}
 
+		deferredThreadStats.numExecutedJobs += numSpawnedJobs.GetValue();
+		numSpawnedJobs.SetValue( 0 );
+
 		jobList.Clear();
 		signalJobCount.Clear();
+		dependencies.Clear();
 		numSyncs = 0;
 		lastSignalJob = 0;
 
@@ -455,6 +650,12 @@ void idParallelJobList_Threads::Wait() {
 		deferredThreadStats.waitTime = waited ? ( waitEnd - waitStart ) : 0;
 	}
 	memcpy( & threadStats, & deferredThreadStats, sizeof( threadStats ) );
+
+	if ( g_timelineEnabled && executed && threadStats.startTime != 0 ) {
+		TimelineAddJobList( listId, threadStats.submitTime, threadStats.startTime, threadStats.endTime,
+			threadStats.numExecutedJobs, threadStats.numExecutedSyncs,
+			GetTotalProcessingTimeMicroSec(), GetTotalWastedTimeMicroSec(), threadStats.waitTime );
+	}
 	done = true;
 }
 
@@ -464,7 +665,11 @@ idParallelJobList_Threads::TryWait
 ========================
 */
 bool idParallelJobList_Threads::TryWait() {
-	if ( jobList.Num() == 0 || signalJobCount[signalJobCount.Num() - 1].GetValue() <= 0 ) {
+	if ( jobList.Num() == 0 ) {
+		Wait();
+		return true;
+	}
+	if ( useWorkStealing ? pendingJobs.GetValue() <= 0 : signalJobCount[signalJobCount.Num() - 1].GetValue() <= 0 ) {
 		Wait();
 		return true;
 	}
@@ -536,6 +741,40 @@ volatile jobRun_t longJobFunc;
 volatile void * longJobData;
 #endif
 
+/*
+========================
+CheckLongJob
+========================
+*/
+static void CheckLongJob( jobListId_t listId, jobRun_t function, void * data, uint64 jobStart, uint64 jobEnd, unsigned int threadNum ) {
+#ifndef _DEBUG
+	if ( jobs_longJobMicroSec.GetInteger() > 0 ) {
+		if ( jobEnd - jobStart > jobs_longJobMicroSec.GetInteger()
+			&& listId != JOBLIST_UTILITY ) {
+			longJobTime = ( jobEnd - jobStart ) * ( 1.0f / 1000.0f );
+			longJobFunc = function;
+			longJobData = data;
+			const char * jobName = GetJobName( function );
+			const char * jobListName = GetJobListName( listId );
+			idLib::Printf( "%1.1f milliseconds for a single '%s' job from job list %s on thread %d\n", longJobTime, jobName, jobListName, threadNum );
+		}
+	}
+#endif
+}
+
+/*
+========================
+TimelineSyncStall
+========================
+*/
+static void TimelineSyncStall( jobListId_t listId, threadJobListState_t & state ) {
+	if ( g_timelineEnabled && state.stalledSignalIndex != state.signalIndex ) {
+		state.stalledSignalIndex = state.signalIndex;
+		uint64 now = Sys_Microseconds();
+		TimelineAddEvent( TIMELINE_SYNC_STALL, "SyncStall", now, now, listId, state.signalIndex );
+	}
+}
+
 /*
 ========================
 idParallelJobList_Threads::RunJobsInternal
@@ -567,6 +806,7 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 				assert( state.signalIndex > 0 );
 				if ( signalJobCount[state.signalIndex - 1].GetValue() > 0 ) {
 					// stalled on a synchronization point
+					TimelineSyncStall( listId, state );
 					return ( result | RUN_STALLED );
 				}
 			} else if ( jobList[state.lastJobIndex].data == & JOB_LIST_DONE ) {
@@ -596,6 +836,7 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 						// release the fetch lock
 						fetchLock.Decrement();
 						// stalled on a synchronization point
+						TimelineSyncStall( listId, state );
 						return ( result | RUN_STALLED );
 					}
 				} else if ( jobList[state.lastJobIndex].data == & JOB_LIST_DONE ) {
@@ -635,19 +876,10 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 			uint64 jobEnd = Sys_Microseconds();
 			deferredThreadStats.threadExecTime[threadNum] += jobEnd - jobStart;
 
-#ifndef _DEBUG
-			if ( jobs_longJobMicroSec.GetInteger() > 0 ) {
-				if ( jobEnd - jobStart > jobs_longJobMicroSec.GetInteger()
-					&& GetId() != JOBLIST_UTILITY ) {
-					longJobTime = ( jobEnd - jobStart ) * ( 1.0f / 1000.0f );
-					longJobFunc = jobList[state.nextJobIndex].function;
-					longJobData = jobList[state.nextJobIndex].data;
-					const char * jobName = GetJobName( jobList[state.nextJobIndex].function );
-					const char * jobListName = GetJobListName( GetId() );
-					idLib::Printf( "%1.1f milliseconds for a single '%s' job from job list %s on thread %d\n", longJobTime, jobName, jobListName, threadNum );
-				}
+			CheckLongJob( GetId(), jobList[state.nextJobIndex].function, jobList[state.nextJobIndex].data, jobStart, jobEnd, threadNum );
+			if ( g_timelineEnabled ) {
+				TimelineAddEvent( TIMELINE_JOB, GetJobName( jobList[state.nextJobIndex].function ), jobStart, jobEnd, listId );
 			}
-#endif
 		}
 
 		result |= RUN_PROGRESS;
@@ -659,6 +891,10 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 				deferredThreadStats.endTime = Sys_Microseconds();
 				return ( result | RUN_DONE );
 			}
+			if ( g_timelineEnabled ) {
+				uint64 now = Sys_Microseconds();
+				TimelineAddEvent( TIMELINE_SYNC_SIGNAL, "SyncSignal", now, now, listId, state.signalIndex );
+			}
 		}
 
 	} while( ! singleJob );
@@ -685,6 +921,73 @@ int idParallelJobList_Threads::RunJobs( unsigned int threadNum, threadJobListSta
 	return result;
 }
 
+/*
+========================
+idParallelJobList_Threads::RunStealingJob
+========================
+*/
+static thread_local idParallelJobList_Threads *	currentStealingJobList = NULL;
+
+void idParallelJobList_Threads::RunStealingJob( const stealJob_t & job, unsigned int threadNum ) {
+	assert( threadNum < MAX_THREADS );
+
+	numThreadsExecuting.Increment();
+
+	uint64 jobStart = Sys_Microseconds();
+	if ( deferredThreadStats.startTime == 0 ) {
+		deferredThreadStats.startTime = jobStart;	// first time any thread is running jobs from this list
+	}
+
+	// jobs may be run while waiting inside another job, so restore the outer job list afterwards
+	idParallelJobList_Threads * outerJobList = currentStealingJobList;
+	currentStealingJobList = this;
+	job.function( job.data );
+	currentStealingJobList = outerJobList;
+
+	uint64 jobEnd = Sys_Microseconds();
+	deferredThreadStats.threadExecTime[threadNum] += jobEnd - jobStart;
+	deferredThreadStats.threadTotalTime[threadNum] += jobEnd - jobStart;
+
+	CheckLongJob( GetId(), job.function, job.data, jobStart, jobEnd, threadNum );
+	if ( g_timelineEnabled ) {
+		TimelineAddEvent( TIMELINE_JOB, GetJobName( job.function ), jobStart, jobEnd, listId );
+	}
+
+	if ( job.jobIndex >= 0 ) {
+		jobList[job.jobIndex].executed = 1;
+
+		// release the dependent jobs that have no other unfinished prerequisites
+		const int first = firstDependent[job.jobIndex];
+		const int last = firstDependent[job.jobIndex + 1];
+		stealJob_t readyJobs[16];
+		int numReadyJobs = 0;
+		for ( int i = first; i < last; i++ ) {
+			const int dependent = dependents[i];
+			if ( numPrerequisites[dependent].Decrement() == 0 ) {
+				stealJob_t & readyJob = readyJobs[numReadyJobs++];
+				readyJob.function = jobList[dependent].function;
+				readyJob.data = jobList[dependent].data;
+				readyJob.jobList = this;
+				readyJob.jobIndex = dependent;
+				if ( numReadyJobs == sizeof( readyJobs ) / sizeof( readyJobs[0] ) ) {
+					PushStealingJobs( readyJobs, numReadyJobs );
+					numReadyJobs = 0;
+				}
+			}
+		}
+		if ( numReadyJobs > 0 ) {
+			PushStealingJobs( readyJobs, numReadyJobs );
+		}
+	}
+
+	if ( pendingJobs.Decrement() == 0 ) {
+		deferredThreadStats.endTime = Sys_Microseconds();
+		doneGuards[currentDoneGuard].Decrement();
+	}
+
+	numThreadsExecuting.Decrement();
+}
+
 /*
 ========================
 idParallelJobList_Threads::WaitForOtherJobList
@@ -732,9 +1035,9 @@ idParallelJobList::~idParallelJobList() {
 idParallelJobList::AddJob
 ========================
 */
-void idParallelJobList::AddJob( jobRun_t function, void * data ) {
+int idParallelJobList::AddJob( jobRun_t function, void * data ) {
 	assert( IsRegisteredJob( function ) );
-	jobListThreads->AddJob( function, data );
+	return jobListThreads->AddJob( function, data );
 }
 
 /*
@@ -755,6 +1058,15 @@ void idParallelJobList::InsertSyncPoint( jobSyncType_t syncType ) {
 	jobListThreads->InsertSyncPoint( syncType );
 }
 
+/*
+========================
+idParallelJobList::AddDependency
+========================
+*/
+void idParallelJobList::AddDependency( int job, int prerequisite ) {
+	jobListThreads->AddDependency( job, prerequisite );
+}
+
 /*
 ========================
 idParallelJobList::Wait
@@ -915,6 +1227,87 @@ struct threadJobList_t {
 
 static idCVar jobs_prioritize( "jobs_prioritize", "1", CVAR_BOOL | CVAR_NOCHEAT, "prioritize job lists" );
 
+/*
+================================================
+idJobDeque
+
+Ready jobs of the work-stealing scheduler. The owning thread
+pushes and pops at the back (most recently released jobs first,
+which are most likely to still be in cache), other threads
+steal from the front. Each deque has its own lock, so threads
+only contend when they touch the same deque.
+================================================
+*/
+class idJobDeque {
+public:
+							idJobDeque() : first( 0 ) { jobs.SetGranularity( 256 ); }
+
+	void					Push( const stealJob_t * newJobs, int numNewJobs );
+	bool					Pop( stealJob_t & job );
+	bool					Steal( stealJob_t & job );
+	// may be out of date by the time it returns, only used to skip empty deques without locking
+	bool					IsEmpty() const { return numJobs == 0; }
+
+private:
+	idSysMutex				mutex;
+	idList< stealJob_t >	jobs;
+	int						first;
+	volatile int			numJobs;
+};
+
+/*
+========================
+idJobDeque::Push
+========================
+*/
+void idJobDeque::Push( const stealJob_t * newJobs, int numNewJobs ) {
+	idScopedCriticalSection lock( mutex );
+	for ( int i = 0; i < numNewJobs; i++ ) {
+		jobs.Append( newJobs[i] );
+	}
+	numJobs = jobs.Num() - first;
+}
+
+/*
+========================
+idJobDeque::Pop
+========================
+*/
+bool idJobDeque::Pop( stealJob_t & job ) {
+	idScopedCriticalSection lock( mutex );
+	if ( first >= jobs.Num() ) {
+		return false;
+	}
+	job = jobs.Pop();
+	if ( first >= jobs.Num() ) {
+		jobs.SetNum( 0, false );
+		first = 0;
+	}
+	numJobs = jobs.Num() - first;
+	return true;
+}
+
+/*
+========================
+idJobDeque::Steal
+========================
+*/
+bool idJobDeque::Steal( stealJob_t & job ) {
+	idScopedCriticalSection lock( mutex );
+	if ( first >= jobs.Num() ) {
+		return false;
+	}
+	job = jobs[first++];
+	if ( first >= jobs.Num() ) {
+		jobs.SetNum( 0, false );
+		first = 0;
+	}
+	numJobs = jobs.Num() - first;
+	return true;
+}
+
+static thread_local int currentJobThread = -1;
+
 class idJobThread : public idSysThread {
 public:
 								idJobThread();
@@ -935,6 +1328,8 @@ private:
 	virtual int					Run();
 };
 
+
+
 /*
 ========================
 idJobThread::idJobThread
@@ -993,6 +1388,8 @@ int idJobThread::Run() {
 	int numJobLists = 0;
 	int lastStalledJobList = -1;
 
+	currentJobThread = threadNum;
+
 	while ( !IsTerminating() ) {
 
 		// fetch any new job lists and add them to the local list
@@ -1005,6 +1402,13 @@ int idJobThread::Run() {
 			numJobLists++;
 			firstJobList++;
 		}
+
+		// jobs of the work-stealing scheduler are only ever queued when they are ready to run,
+		// so they never stall and go before the job lists that are run in list order
+		if ( RunAnyStealingJob() ) {
+			continue;
+		}
+
 		if ( numJobLists == 0 ) {
 			break;
 		}
@@ -1122,10 +1526,18 @@ public:
 
 	virtual void				WaitForAllJobLists();
 
+	virtual void				SpawnJob( jobRun_t function, void * data );
+
 	void						Submit( idParallelJobList_Threads * jobList, int parallelism );
 
+	void						SubmitStealingJobs( const stealJob_t * jobs, int numJobs, int parallelism );
+	void						PushStealingJobs( const stealJob_t * jobs, int numJobs );
+	bool						RunStealingJob();
+
 private:
 	idJobThread						threads[MAX_JOB_THREADS];
+	idJobDeque						jobDeques[MAX_JOB_THREADS + 1];	// one per job thread and a shared one for all other threads
+	unsigned int					nextRootDeque;
 	int								currentActiveThreads;
 	int								maxThreads;
 	int								numPhysicalCpuCores;
@@ -1148,6 +1560,33 @@ void SubmitJobList( idParallelJobList_Threads * jobList, int parallelism ) {
 	parallelJobManagerLocal.Submit( jobList, parallelism );
 }
 
+/*
+========================
+SubmitStealingJobs
+========================
+*/
+void SubmitStealingJobs( const stealJob_t * jobs, int numJobs, int parallelism ) {
+	parallelJobManagerLocal.SubmitStealingJobs( jobs, numJobs, parallelism );
+}
+
+/*
+========================
+PushStealingJobs
+========================
+*/
+void PushStealingJobs( const stealJob_t * jobs, int numJobs ) {
+	parallelJobManagerLocal.PushStealingJobs( jobs, numJobs );
+}
+
+/*
+========================
+RunAnyStealingJob
+========================
+*/
+bool RunAnyStealingJob() {
+	return parallelJobManagerLocal.RunStealingJob();
+}
+
 void idParallelJobManagerLocal::RescaleThreadList() {
 	// on consoles this will have specific cores for the threads, but on PC they will all be CORE_ANY
 	core_t cores[] = JOB_THREAD_CORES;
@@ -1169,6 +1608,7 @@ idParallelJobManagerLocal::Init
 */
 void idParallelJobManagerLocal::Init() {
 	currentActiveThreads = 0;
+	nextRootDeque = 0;
 	RescaleThreadList();
 	Sys_CPUCount( numPhysicalCpuCores, numLogicalCpuCores, numCpuPackages );
 	assert(numLogicalCpuCores >= 0);
@@ -1304,4 +1744,188 @@ void idParallelJobManagerLocal::Submit( idParallelJobList_Threads * jobList, int
 		threads[i].AddJobList( jobList );
 		threads[i].SignalWork();
 	}
-}
\ No newline at end of file
+}
+
+/*
+========================
+idParallelJobManagerLocal::SubmitStealingJobs
+========================
+*/
+void idParallelJobManagerLocal::SubmitStealingJobs( const stealJob_t * jobs, int numJobs, int parallelism ) {
+	if ( jobs_numThreads.IsModified() ) {
+		RescaleThreadList();
+		jobs_numThreads.ClearModified();
+	}
+
+	int numThreads;
+	if ( parallelism == JOBLIST_PARALLELISM_DEFAULT ) {
+		numThreads = jobs_numThreads.GetInteger();
+	} else if ( parallelism == JOBLIST_PARALLELISM_MAX_CORES ) {
+		numThreads = numLogicalCpuCores;
+	} else if ( parallelism == JOBLIST_PARALLELISM_MAX_THREADS ) {
+		numThreads = MAX_THREADS;
+	} else {
+		numThreads = parallelism;
+	}
+	numThreads = idMath::Imin( numThreads, maxThreads );
+
+	if ( numThreads <= 0 ) {
+		// no job threads, so run the whole list right here
+		idParallelJobList_Threads * jobList = jobs[0].jobList;
+		jobDeques[MAX_JOB_THREADS].Push( jobs, numJobs );
+		jobList->Wait();
+		return;
+	}
+
+	// spread the initial jobs over the threads, anything uneven gets stolen later on
+	for ( int i = 0; i < numThreads; i++ ) {
+		const int deque = ( nextRootDeque + i ) % numThreads;
+		const int begin = numJobs * i / numThreads;
+		const int end = numJobs * ( i + 1 ) / numThreads;
+		if ( end > begin ) {
+			jobDeques[deque].Push( jobs + begin, end - begin );
+		}
+	}
+	nextRootDeque++;
+
+	for ( int i = 0; i < numThreads; i++ ) {
+		threads[i].SignalWork();
+	}
+}
+
+/*
+========================
+idParallelJobManagerLocal::PushStealingJobs
+
+Called from inside a running job to queue newly released or spawned jobs.
+========================
+*/
+void idParallelJobManagerLocal::PushStealingJobs( const stealJob_t * jobs, int numJobs ) {
+	const int self = currentJobThread;
+	jobDeques[self >= 0 ? self : MAX_JOB_THREADS].Push( jobs, numJobs );
+
+	// wake up the other threads so they can steal
+	for ( int i = 0; i < currentActiveThreads; i++ ) {
+		if ( i != self ) {
+			threads[i].SignalWork();
+		}
+	}
+}
+
+/*
+========================
+idParallelJobManagerLocal::RunStealingJob
+
+Runs a single job from the own deque or steals one from another thread.
+Returns false if there was nothing to do.
+========================
+*/
+bool idParallelJobManagerLocal::RunStealingJob() {
+	static thread_local unsigned int nextVictim = 0;
+
+	const int self = currentJobThread;
+	const int ownDeque = self >= 0 ? self : MAX_JOB_THREADS;
+	// threads outside the job system share the last unit for their statistics
+	const unsigned int unit = self >= 0 ? self : MAX_THREADS - 1;
+
+	stealJob_t job;
+	if ( !jobDeques[ownDeque].Pop( job ) ) {
+		// look at every deque, threads may have been stopped with jobs still queued
+		const int numDeques = MAX_JOB_THREADS + 1;
+		bool found = false;
+		for ( int i = 0; i < numDeques && !found; i++ ) {
+			const int victim = ( nextVictim + i ) % numDeques;
+			if ( victim == ownDeque || jobDeques[victim].IsEmpty() ) {
+				continue;
+			}
+			found = jobDeques[victim].Steal( job );
+		}
+		nextVictim++;
+		if ( !found ) {
+			return false;
+		}
+	}
+
+	job.jobList->RunStealingJob( job, unit );
+	return true;
+}
+
+/*
+========================
+idParallelJobManagerLocal::SpawnJob
+========================
+*/
+void idParallelJobManagerLocal::SpawnJob( jobRun_t function, void * data ) {
+	idParallelJobList_Threads * jobList = currentStealingJobList;
+	if ( jobList == NULL ) {
+		function( data );
+		return;
+	}
+	jobList->AddSpawnedJob();
+
+	stealJob_t job;
+	job.function = function;
+	job.data = data;
+	job.jobList = jobList;
+	job.jobIndex = -1;
+	PushStealingJobs( &job, 1 );
+}
+
+
+#include "../tests/testing.h"
+
+struct testStealingJob_t {
+	idSysInterlockedInteger *	counter;
+	int							order;			// value of the counter when the job ran
+	int							numChildren;	// jobs to spawn from inside this job
+	testStealingJob_t *			children;
+};
+
+static void TestStealingJob( testStealingJob_t * job ) {
+	job->order = job->counter->Increment();
+	for ( int i = 0; i < job->numChildren; i++ ) {
+		parallelJobManager->SpawnJob( (jobRun_t)TestStealingJob, &job->children[i] );
+	}
+}
+REGISTER_PARALLEL_JOB( TestStealingJob, "TestStealingJob" );
+
+TEST_CASE("ParallelJobList: work stealing dependencies") {
+	const int NUM_JOBS = 200;
+	idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, NUM_JOBS, 0, NULL );
+	idSysInterlockedInteger counter;
+	idList<testStealingJob_t> jobs;
+	jobs.SetNum( NUM_JOBS );
+	idList<testStealingJob_t> children;
+	children.SetNum( NUM_JOBS );
+
+	for ( int round = 0; round < 10; round++ ) {
+		counter.SetValue( 0 );
+		idList<int> handles;
+		for ( int i = 0; i < NUM_JOBS; i++ ) {
+			jobs[i] = { &counter, 0, 1, &children[i] };
+			children[i] = { &counter, 0, 0, NULL };
+			handles.Append( jobList->AddJob( (jobRun_t)TestStealingJob, &jobs[i] ) );
+		}
+		// a chain over the first ten jobs and a fan-in on the last one
+		for ( int i = 1; i < 10; i++ ) {
+			jobList->AddDependency( handles[i], handles[i - 1] );
+		}
+		for ( int i = 0; i < NUM_JOBS - 1; i++ ) {
+			jobList->AddDependency( handles[NUM_JOBS - 1], handles[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+
+		CHECK( counter.GetValue() == NUM_JOBS * 2 );
+		CHECK( jobList->GetNumExecutedJobs() == NUM_JOBS * 2 );
+		for ( int i = 1; i < 10; i++ ) {
+			CHECK( jobs[i].order > jobs[i - 1].order );
+		}
+		for ( int i = 0; i < NUM_JOBS - 1; i++ ) {
+			CHECK( jobs[NUM_JOBS - 1].order > jobs[i].order );
+			CHECK( children[i].order > jobs[i].order );
+		}
+	}
+
+	parallelJobManager->FreeJobList( jobList );
+}
@@ -30,6 +30,7 @@ enum jobSyncType_t {
 enum jobListId_t {
 	JOBLIST_RENDERER_FRONTEND	= 0,
 	JOBLIST_RENDERER_BACKEND	= 1,
+	JOBLIST_GAME				= 2,
 	JOBLIST_UTILITY				= 9,			// won't print over-time warnings
 
 	MAX_JOBLISTS				= 32			// the editor may cause quite a few to be allocated
@@ -62,15 +63,25 @@ order to outweigh any job switching overhead. On the other
 hand a job should consume no more than a couple of
 100,000 clock cycles to maintain a good load balance over
 multiple processing units.
+
+A job list is either executed in list order by all threads
+fetching from a shared job index, or by the work-stealing
+scheduler (jobs_workStealing), where every job thread owns
+a deque of ready jobs and steals from the others when idle.
+Job lists with dependencies between individual jobs always
+use the work-stealing scheduler.
 ================================================
 */
 class idParallelJobList {
 	friend class idParallelJobManagerLocal;
 public:
 
-	void					AddJob( jobRun_t function, void * data );
+	// Returns a handle which can be passed to AddDependency, or -1 if the list is full.
+	int						AddJob( jobRun_t function, void * data );
 	CellSpursJob128 *		AddJobSPURS();
 	void					InsertSyncPoint( jobSyncType_t syncType );
+	// Don't start the job before the prerequisite job has finished.
+	void					AddDependency( int job, int prerequisite );
 
 	// Submit the jobs in this list.
 	void					Submit( idParallelJobList * waitForJobList = NULL, int parallelism = JOBLIST_PARALLELISM_DEFAULT );
@@ -140,6 +151,11 @@ public:
 	virtual int					GetNumProcessingUnits() = 0;
 
 	virtual void				WaitForAllJobLists() = 0;
+
+	// Adds a job from inside a job that is run by the work-stealing scheduler.
+	// The new job belongs to the same job list, so waiting for that list also waits for it.
+	// When called from anywhere else, the job is executed immediately.
+	virtual void				SpawnJob( jobRun_t function, void * data ) = 0;
 };
 
 extern idParallelJobManager *	parallelJobManager;
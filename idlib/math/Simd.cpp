@@ -869,6 +869,34 @@ void TestDot( void ) {
 		result = idMath::Fabs( dot1 - dot2 ) < 1e-4f ? "ok" : S_COLOR_RED"X";
 		PrintClocks( va( "   simd->Dot( float[%2d] * float[%2d] ) %s", j, j, result ), 1, bestClocksSIMD, bestClocksGeneric );
 	}
+
+	idLib::common->Printf( "====================================\n" );
+
+	// fsrc0 as COUNT/8 spatial vectors padded to 8 floats
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->Dot6Padded8( fdst0, fsrc1, fsrc0, COUNT / 8 );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->Dot6Padded8( float[6] * float[8][] )", COUNT / 8, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->Dot6Padded8( fdst1, fsrc1, fsrc0, COUNT / 8 );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT / 8; i++ ) {
+		if ( idMath::Fabs( fdst0[i] - fdst1[i] ) > 1e-4f ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT / 8 ) ? "ok" : S_COLOR_RED"X";
+	PrintClocks( va( "   simd->Dot6Padded8( float[6] * float[8][] ) %s", result ), COUNT / 8, bestClocksSIMD, bestClocksGeneric );
 }
 
 /*
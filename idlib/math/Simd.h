@@ -109,6 +109,8 @@ public:
 	virtual void Dot( float *dst,			const idPlane &constant,const idDrawVert *src,	const int count ) = 0;
 	virtual	void Dot( float *dst,			const idVec3 *src0,		const idVec3 *src1,		const int count ) = 0;
 	virtual void Dot( float &dot,			const float *src1,		const float *src2,		const int count ) = 0;
+	// dot products of a 6D spatial vector with count 6D vectors, each padded to 8 floats (padding may be garbage)
+	virtual void Dot6Padded8( float *dst,	const float *constant,	const float *src,		const int count ) = 0;
 
 	virtual	void CmpGT( byte *dst,			const float *src0,		const float constant,	const int count ) = 0;
 	virtual	void CmpGT( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count ) = 0;
@@ -104,4 +104,32 @@ void idSIMD_AVX::CullByFrustum2( idDrawVert *verts, const int numVerts, const id
 	_mm256_zeroupper();
 }
 
+/*
+============
+idSIMD_AVX::Dot6Padded8
+============
+*/
+void idSIMD_AVX::Dot6Padded8( float *dst, const float *constant, const float *src, const int count ) {
+	// the two padding floats are never loaded
+	const __m256i mask6 = _mm256_setr_epi32( -1, -1, -1, -1, -1, -1, 0, 0 );
+	const __m256 c = _mm256_maskload_ps( constant, mask6 );
+
+	int i = 0;
+	for ( ; i + 4 <= count; i += 4, src += 32 ) {
+		__m256 p0 = _mm256_mul_ps( c, _mm256_maskload_ps( src +  0, mask6 ) );
+		__m256 p1 = _mm256_mul_ps( c, _mm256_maskload_ps( src +  8, mask6 ) );
+		__m256 p2 = _mm256_mul_ps( c, _mm256_maskload_ps( src + 16, mask6 ) );
+		__m256 p3 = _mm256_mul_ps( c, _mm256_maskload_ps( src + 24, mask6 ) );
+		// each 128-bit lane holds partial sums of the four vectors
+		__m256 h = _mm256_hadd_ps( _mm256_hadd_ps( p0, p1 ), _mm256_hadd_ps( p2, p3 ) );
+		__m128 sum = _mm_add_ps( _mm256_castps256_ps128( h ), _mm256_extractf128_ps( h, 1 ) );
+		_mm_storeu_ps( dst + i, sum );
+	}
+	for ( ; i < count; i++, src += 8 ) {
+		dst[i] = constant[0] * src[0] + constant[1] * src[1] + constant[2] * src[2] +
+					constant[3] * src[3] + constant[4] * src[4] + constant[5] * src[5];
+	}
+	_mm256_zeroupper();
+}
+
 #endif
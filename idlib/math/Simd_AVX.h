@@ -39,5 +39,6 @@ public:
 #ifdef ENABLE_SSE_PROCESSORS
 	virtual void CullByFrustum( idDrawVert *verts, const int numVerts, const idPlane frustum[6], byte *pointCull, float epsilon ) ALLOW_AVX;
 	virtual void CullByFrustum2( idDrawVert *verts, const int numVerts, const idPlane frustum[6], unsigned short *pointCull, float epsilon ) ALLOW_AVX;
+	virtual void Dot6Padded8( float *dst, const float *constant, const float *src, const int count ) ALLOW_AVX;
 #endif
 };
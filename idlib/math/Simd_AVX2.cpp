@@ -92,6 +92,42 @@ void idSIMD_AVX2::CullByFrustum2( idDrawVert *verts, const int numVerts, const i
 	_mm256_zeroupper();
 }
 
+/*
+============
+idSIMD_AVX2::TransformVerts
+
+The products of the joint rows and the weights are summed up with FMA,
+they are only added horizontally once per vertex.
+============
+*/
+void idSIMD_AVX2::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (const byte *)joints;
+
+	__m256 sumXY = _mm256_setzero_ps();
+	__m128 sumZ = _mm_setzero_ps();
+	idDrawVert *vert = verts;
+
+	for (int j = 0; j < numWeights; j++) {
+		const float *matrix = ((const idJointMat *)(jointsPtr + index[j*2]))->ToFloatPtr();
+		__m256 wgt = _mm256_broadcast_ps((const __m128 *)weights[j].ToFloatPtr());
+
+		sumXY = _mm256_fmadd_ps(_mm256_loadu_ps(matrix + 0), wgt, sumXY);		//x0as y1bt
+		sumZ = _mm_fmadd_ps(_mm_loadu_ps(matrix + 8), _mm256_castps256_ps128(wgt), sumZ);	//z2cr
+
+		if (index[j*2+1]) {
+			__m128 xy = _mm_hadd_ps(_mm256_castps256_ps128(sumXY), _mm256_extractf128_ps(sumXY, 1));
+			__m128 zz = _mm_hadd_ps(sumZ, sumZ);
+			__m128 xyz = _mm_hadd_ps(xy, zz);
+			_mm_store_sd((double*)&vert->xyz.x, _mm_castps_pd(xyz));
+			_mm_store_ss(&vert->xyz.z, _mm_movehl_ps(xyz, xyz));
+			vert++;
+			sumXY = _mm256_setzero_ps();
+			sumZ = _mm_setzero_ps();
+		}
+	}
+	_mm256_zeroupper();
+}
+
 #define SHUF(i0, i1, i2, i3) _MM_SHUFFLE(i3, i2, i1, i0)
 
 #define DECL3_P8(Res) __m256 Res##_x, Res##_y, Res##_z;
@@ -494,4 +530,254 @@ void idSIMD_AVX2::NormalizeTangents( idDrawVert *verts, const int numVerts ) {
 	}
 }
 
+/*
+============
+idSIMD_AVX2::GenerateMipMap2x2
+============
+*/
+void idSIMD_AVX2::GenerateMipMap2x2( const byte *srcPtr, int srcStride, int halfWidth, int halfHeight, byte *dstPtr, int dstStride ) {
+	int avxWidth = halfWidth & ~7;
+
+	for (int i = 0; i < halfHeight; i++) {
+		const byte *inRow0 = &srcPtr[(2*i+0) * srcStride];
+		const byte *inRow1 = &srcPtr[(2*i+1) * srcStride];
+		byte *outRow = &dstPtr[i * dstStride];
+
+		for (int j = 0; j < avxWidth; j += 8) {
+			__m256i A0 = _mm256_loadu_si256((__m256i*)(inRow0 + 8*j + 0));
+			__m256i A1 = _mm256_loadu_si256((__m256i*)(inRow0 + 8*j + 32));
+			__m256i B0 = _mm256_loadu_si256((__m256i*)(inRow1 + 8*j + 0));
+			__m256i B1 = _mm256_loadu_si256((__m256i*)(inRow1 + 8*j + 32));
+
+			// same as SSE2 version in each 128-bit lane
+			__m256i A0shuf = _mm256_shuffle_epi32(A0, SHUF(0, 2, 1, 3));
+			__m256i A1shuf = _mm256_shuffle_epi32(A1, SHUF(0, 2, 1, 3));
+			__m256i B0shuf = _mm256_shuffle_epi32(B0, SHUF(0, 2, 1, 3));
+			__m256i B1shuf = _mm256_shuffle_epi32(B1, SHUF(0, 2, 1, 3));
+			__m256i A0l = _mm256_unpacklo_epi8(A0shuf, _mm256_setzero_si256());
+			__m256i A0r = _mm256_unpackhi_epi8(A0shuf, _mm256_setzero_si256());
+			__m256i A1l = _mm256_unpacklo_epi8(A1shuf, _mm256_setzero_si256());
+			__m256i A1r = _mm256_unpackhi_epi8(A1shuf, _mm256_setzero_si256());
+			__m256i B0l = _mm256_unpacklo_epi8(B0shuf, _mm256_setzero_si256());
+			__m256i B0r = _mm256_unpackhi_epi8(B0shuf, _mm256_setzero_si256());
+			__m256i B1l = _mm256_unpacklo_epi8(B1shuf, _mm256_setzero_si256());
+			__m256i B1r = _mm256_unpackhi_epi8(B1shuf, _mm256_setzero_si256());
+
+			__m256i sum0 = _mm256_add_epi16(_mm256_add_epi16(A0l, A0r), _mm256_add_epi16(B0l, B0r));
+			__m256i sum1 = _mm256_add_epi16(_mm256_add_epi16(A1l, A1r), _mm256_add_epi16(B1l, B1r));
+			__m256i avg0 = _mm256_srli_epi16(_mm256_add_epi16(sum0, _mm256_set1_epi16(2)), 2);
+			__m256i avg1 = _mm256_srli_epi16(_mm256_add_epi16(sum1, _mm256_set1_epi16(2)), 2);
+
+			// pixel pairs come out as 0 2 1 3 after packing the lanes
+			__m256i res = _mm256_packus_epi16(avg0, avg1);
+			res = _mm256_permute4x64_epi64(res, SHUF(0, 2, 1, 3));
+			_mm256_storeu_si256((__m256i*)(outRow + 4*j), res);
+		}
+	}
+	_mm256_zeroupper();
+
+	if (avxWidth < halfWidth) {
+		idSIMD_SSE2::GenerateMipMap2x2(srcPtr + 8 * avxWidth, srcStride, halfWidth - avxWidth, halfHeight, dstPtr + 4 * avxWidth, dstStride);
+	}
+}
+
+/*
+Decompression of DXT / RGTC blocks:
+the key values of each block are computed by the generic code, then all 16 texels
+are looked up with byte shuffles, two rows of the block per 256-bit register.
+*/
+
+ALLOW_AVX2 static ID_FORCE_INLINE __m256i DxtIndices( uint bits, __m256i shifts, int mask ) {
+	return _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(bits), shifts), _mm256_set1_epi32(mask));
+}
+
+// converts 2-bit color indices into shuffle masks selecting the whole RGBA key
+ALLOW_AVX2 static ID_FORCE_INLINE __m256i DxtColorShuffle( __m256i indices ) {
+	__m256i first = _mm256_slli_epi32(indices, 2);
+	__m256i broadcast = _mm256_shuffle_epi8(first, _mm256_setr_epi8(
+		0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12,
+		0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12
+	));
+	return _mm256_add_epi8(broadcast, _mm256_set1_epi32(0x03020100));
+}
+
+ALLOW_AVX2 static ID_FORCE_INLINE void DxtStoreBlock( __m256i rows01, __m256i rows23, byte *dstPtr, int stride, int numRows, int numCols ) {
+	if (numRows == 4 && numCols == 4) {
+		_mm_storeu_si128((__m128i*)(dstPtr + 0 * stride), _mm256_castsi256_si128(rows01));
+		_mm_storeu_si128((__m128i*)(dstPtr + 1 * stride), _mm256_extracti128_si256(rows01, 1));
+		_mm_storeu_si128((__m128i*)(dstPtr + 2 * stride), _mm256_castsi256_si128(rows23));
+		_mm_storeu_si128((__m128i*)(dstPtr + 3 * stride), _mm256_extracti128_si256(rows23, 1));
+		return;
+	}
+	// block on the right or bottom border of the image
+	ALIGNTYPE16 byte block[4][16];
+	_mm256_storeu_si256((__m256i*)block[0], rows01);
+	_mm256_storeu_si256((__m256i*)block[2], rows23);
+	for (int r = 0; r < numRows; r++)
+		memcpy(dstPtr + r * stride, block[r], 4 * numCols);
+}
+
+/*
+============
+idSIMD_AVX2::DecompressRGBA8FromDXT1
+============
+*/
+void idSIMD_AVX2::DecompressRGBA8FromDXT1( const byte *srcPtr, int width, int height, byte *dstPtr, int stride, bool allowTransparency ) {
+	int bw = (width + 3) / 4;
+	int bh = (height + 3) / 4;
+	const uint64 *srcBlocks = (uint64*)srcPtr;
+	const __m256i shifts01 = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+	const __m256i shifts23 = _mm256_setr_epi32(16, 18, 20, 22, 24, 26, 28, 30);
+
+	for (int brow = 0; brow < bh; brow++) {
+		int numRows = idMath::Imin(height - 4 * brow, 4);
+		for (int bcol = 0; bcol < bw; bcol++) {
+			uint64 blockData = *srcBlocks++;
+
+			ALIGNTYPE16 byte keyRgba[4][4];
+			DecodeDXTColorKeys(blockData, true, allowTransparency, keyRgba);
+			__m256i keys = _mm256_broadcastsi128_si256(_mm_load_si128((__m128i*)keyRgba));
+			uint colorBits = uint(blockData >> 32);
+
+			__m256i rows01 = _mm256_shuffle_epi8(keys, DxtColorShuffle(DxtIndices(colorBits, shifts01, 3)));
+			__m256i rows23 = _mm256_shuffle_epi8(keys, DxtColorShuffle(DxtIndices(colorBits, shifts23, 3)));
+
+			DxtStoreBlock(rows01, rows23, &dstPtr[4 * brow * stride + 16 * bcol], stride, numRows, idMath::Imin(width - 4 * bcol, 4));
+		}
+	}
+	_mm256_zeroupper();
+}
+
+/*
+============
+idSIMD_AVX2::DecompressRGBA8FromDXT3
+============
+*/
+void idSIMD_AVX2::DecompressRGBA8FromDXT3( const byte *srcPtr, int width, int height, byte *dstPtr, int stride ) {
+	int bw = (width + 3) / 4;
+	int bh = (height + 3) / 4;
+	const uint64 *srcBlocks = (uint64*)srcPtr;
+	const __m256i colorShifts01 = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+	const __m256i colorShifts23 = _mm256_setr_epi32(16, 18, 20, 22, 24, 26, 28, 30);
+	const __m256i alphaShifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+	const __m256i rgbMask = _mm256_set1_epi32(0x00FFFFFF);
+
+	for (int brow = 0; brow < bh; brow++) {
+		int numRows = idMath::Imin(height - 4 * brow, 4);
+		for (int bcol = 0; bcol < bw; bcol++) {
+			uint64 alphaData = *srcBlocks++;
+			uint64 rgbData = *srcBlocks++;
+
+			ALIGNTYPE16 byte keyRgba[4][4];
+			DecodeDXTColorKeys(rgbData, false, false, keyRgba);
+			__m256i keys = _mm256_broadcastsi128_si256(_mm_load_si128((__m128i*)keyRgba));
+			uint colorBits = uint(rgbData >> 32);
+
+			__m256i rows01 = _mm256_shuffle_epi8(keys, DxtColorShuffle(DxtIndices(colorBits, colorShifts01, 3)));
+			__m256i rows23 = _mm256_shuffle_epi8(keys, DxtColorShuffle(DxtIndices(colorBits, colorShifts23, 3)));
+
+			// 4-bit alpha times 17 is the nibble repeated in the alpha byte
+			__m256i alpha01 = DxtIndices(uint(alphaData), alphaShifts, 0xF);
+			__m256i alpha23 = DxtIndices(uint(alphaData >> 32), alphaShifts, 0xF);
+			alpha01 = _mm256_or_si256(_mm256_slli_epi32(alpha01, 24), _mm256_slli_epi32(alpha01, 28));
+			alpha23 = _mm256_or_si256(_mm256_slli_epi32(alpha23, 24), _mm256_slli_epi32(alpha23, 28));
+			rows01 = _mm256_or_si256(_mm256_and_si256(rows01, rgbMask), alpha01);
+			rows23 = _mm256_or_si256(_mm256_and_si256(rows23, rgbMask), alpha23);
+
+			DxtStoreBlock(rows01, rows23, &dstPtr[4 * brow * stride + 16 * bcol], stride, numRows, idMath::Imin(width - 4 * bcol, 4));
+		}
+	}
+	_mm256_zeroupper();
+}
+
+/*
+============
+idSIMD_AVX2::DecompressRGBA8FromDXT5
+============
+*/
+void idSIMD_AVX2::DecompressRGBA8FromDXT5( const byte *srcPtr, int width, int height, byte *dstPtr, int stride ) {
+	int bw = (width + 3) / 4;
+	int bh = (height + 3) / 4;
+	const uint64 *srcBlocks = (uint64*)srcPtr;
+	const __m256i colorShifts01 = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+	const __m256i colorShifts23 = _mm256_setr_epi32(16, 18, 20, 22, 24, 26, 28, 30);
+	const __m256i alphaShifts = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+	const __m256i rgbMask = _mm256_set1_epi32(0x00FFFFFF);
+	// alpha index goes into the top byte of the shuffle mask, the other bytes are zeroed
+	const __m256i alphaShuffle = _mm256_set1_epi32(0x00808080);
+
+	for (int brow = 0; brow < bh; brow++) {
+		int numRows = idMath::Imin(height - 4 * brow, 4);
+		for (int bcol = 0; bcol < bw; bcol++) {
+			uint64 alphaData = *srcBlocks++;
+			uint64 rgbData = *srcBlocks++;
+
+			ALIGNTYPE16 byte keyRgba[4][4];
+			DecodeDXTColorKeys(rgbData, false, false, keyRgba);
+			__m256i keys = _mm256_broadcastsi128_si256(_mm_load_si128((__m128i*)keyRgba));
+			uint colorBits = uint(rgbData >> 32);
+
+			uint64 keyAlpha;
+			DecodeDXTAlphaKeys(alphaData, (byte*)&keyAlpha);
+			__m256i alphaKeys = _mm256_set1_epi64x(keyAlpha);
+			uint64 alphaBits = alphaData >> 16;
+
+			__m256i rows01 = _mm256_shuffle_epi8(keys, DxtColorShuffle(DxtIndices(colorBits, colorShifts01, 3)));
+			__m256i rows23 = _mm256_shuffle_epi8(keys, DxtColorShuffle(DxtIndices(colorBits, colorShifts23, 3)));
+
+			__m256i alpha01 = DxtIndices(uint(alphaBits & 0xFFFFFF), alphaShifts, 7);
+			__m256i alpha23 = DxtIndices(uint(alphaBits >> 24), alphaShifts, 7);
+			alpha01 = _mm256_shuffle_epi8(alphaKeys, _mm256_or_si256(_mm256_slli_epi32(alpha01, 24), alphaShuffle));
+			alpha23 = _mm256_shuffle_epi8(alphaKeys, _mm256_or_si256(_mm256_slli_epi32(alpha23, 24), alphaShuffle));
+			rows01 = _mm256_or_si256(_mm256_and_si256(rows01, rgbMask), alpha01);
+			rows23 = _mm256_or_si256(_mm256_and_si256(rows23, rgbMask), alpha23);
+
+			DxtStoreBlock(rows01, rows23, &dstPtr[4 * brow * stride + 16 * bcol], stride, numRows, idMath::Imin(width - 4 * bcol, 4));
+		}
+	}
+	_mm256_zeroupper();
+}
+
+/*
+============
+idSIMD_AVX2::DecompressRGBA8FromRGTC
+============
+*/
+void idSIMD_AVX2::DecompressRGBA8FromRGTC( const byte *srcPtr, int width, int height, byte *dstPtr, int stride ) {
+	int bw = (width + 3) / 4;
+	int bh = (height + 3) / 4;
+	const uint64 *srcBlocks = (uint64*)srcPtr;
+	const __m256i shifts = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+	// red key in byte 0, green key (stored after the red ones) in byte 1, zero blue
+	const __m256i greenOffset = _mm256_set1_epi32(0x80800800);
+	const __m256i alpha = _mm256_set1_epi32(0xFF000000);
+
+	for (int brow = 0; brow < bh; brow++) {
+		int numRows = idMath::Imin(height - 4 * brow, 4);
+		for (int bcol = 0; bcol < bw; bcol++) {
+			uint64 redData = *srcBlocks++;
+			uint64 greenData = *srcBlocks++;
+
+			ALIGNTYPE16 byte keyRedGreen[16];
+			DecodeDXTAlphaKeys(redData, keyRedGreen + 0);
+			DecodeDXTAlphaKeys(greenData, keyRedGreen + 8);
+			__m256i keys = _mm256_broadcastsi128_si256(_mm_load_si128((__m128i*)keyRedGreen));
+			uint64 redBits = redData >> 16;
+			uint64 greenBits = greenData >> 16;
+
+			__m256i red01 = DxtIndices(uint(redBits & 0xFFFFFF), shifts, 7);
+			__m256i red23 = DxtIndices(uint(redBits >> 24), shifts, 7);
+			__m256i green01 = DxtIndices(uint(greenBits & 0xFFFFFF), shifts, 7);
+			__m256i green23 = DxtIndices(uint(greenBits >> 24), shifts, 7);
+			__m256i mask01 = _mm256_add_epi32(_mm256_or_si256(red01, _mm256_slli_epi32(green01, 8)), greenOffset);
+			__m256i mask23 = _mm256_add_epi32(_mm256_or_si256(red23, _mm256_slli_epi32(green23, 8)), greenOffset);
+			__m256i rows01 = _mm256_or_si256(_mm256_shuffle_epi8(keys, mask01), alpha);
+			__m256i rows23 = _mm256_or_si256(_mm256_shuffle_epi8(keys, mask23), alpha);
+
+			DxtStoreBlock(rows01, rows23, &dstPtr[4 * brow * stride + 16 * bcol], stride, numRows, idMath::Imin(width - 4 * bcol, 4));
+		}
+	}
+	_mm256_zeroupper();
+}
+
 #endif
@@ -372,6 +372,20 @@ void idSIMD_Generic::Dot( float &dot, const float *src1, const float *src2, cons
 #endif
 }
 
+/*
+============
+idSIMD_Generic::Dot6Padded8
+
+  dst[i] = constant * src[i*8+0..5]
+============
+*/
+void idSIMD_Generic::Dot6Padded8( float *dst, const float *constant, const float *src, const int count ) {
+	for ( int i = 0; i < count; i++, src += 8 ) {
+		dst[i] = constant[0] * src[0] + constant[1] * src[1] + constant[2] * src[2] +
+					constant[3] * src[3] + constant[4] * src[4] + constant[5] * src[5];
+	}
+}
+
 /*
 ============
 idSIMD_Generic::CmpGT
@@ -3202,6 +3216,48 @@ ID_FORCE_INLINE static void Dxt5Keys5(byte keys[8]) {
 	keys[7] = 0xFF;
 }
 
+/*
+============
+idSIMD_Generic::DecodeDXTColorKeys
+============
+*/
+void idSIMD_Generic::DecodeDXTColorKeys( uint64 colorData, bool dxt1, bool allowTransparency, byte keyRgba[4][4] ) {
+	word keyColor[2];
+	float keyFloat[2][3];
+	for (int k = 0; k < 2; k++) {
+		keyColor[k] = colorData & 0xFFFF;
+		colorData >>= 16;
+		Color565to888f(keyColor[k], keyFloat[k]);
+	}
+
+	for (int k = 0; k < 4; k++)
+		keyRgba[k][3] = 0xFF;
+
+	if (!dxt1 || keyColor[0] > keyColor[1])
+		Dxt1Keys3(keyFloat, keyRgba);
+	else {
+		Dxt1Keys2(keyFloat, keyRgba);
+		if (allowTransparency)
+			keyRgba[3][3] = 0;
+	}
+}
+
+/*
+============
+idSIMD_Generic::DecodeDXTAlphaKeys
+============
+*/
+void idSIMD_Generic::DecodeDXTAlphaKeys( uint64 alphaData, byte keys[8] ) {
+	keys[0] = (alphaData & 0xFF);
+	alphaData >>= 8;
+	keys[1] = (alphaData & 0xFF);
+
+	if (keys[0] > keys[1])
+		Dxt5Keys7(keys);
+	else
+		Dxt5Keys5(keys);
+}
+
 /*
 ============
 idSIMD_Generic::DecompressRGBA8FromDXT1
@@ -3216,25 +3272,9 @@ void idSIMD_Generic::DecompressRGBA8FromDXT1( const byte *srcPtr, int width, int
 		for (int bcol = 0; bcol < bw; bcol++) {
 			uint64 blockData = *srcBlocks++;
 
-			word keyColor[2];
-			float keyFloat[2][3];
-			for (int k = 0; k < 2; k++) {
-				keyColor[k] = blockData & 0xFFFF;
-				blockData >>= 16;
-				Color565to888f(keyColor[k], keyFloat[k]);
-			}
-
 			byte keyRgba[4][4];
-			for (int k = 0; k < 4; k++)
-				keyRgba[k][3] = 0xFF;
-
-			if (keyColor[0] > keyColor[1])
-				Dxt1Keys3(keyFloat, keyRgba);
-			else {
-				Dxt1Keys2(keyFloat, keyRgba);
-				if (allowTransparency)
-					keyRgba[3][3] = 0;
-			}
+			DecodeDXTColorKeys(blockData, true, allowTransparency, keyRgba);
+			blockData >>= 32;
 
 			for (int r = 0; r < 4; r++)
 				for (int c = 0; c < 4; c++) {
@@ -3271,15 +3311,9 @@ void idSIMD_Generic::DecompressRGBA8FromDXT3( const byte *srcPtr, int width, int
 			uint64 alphaData = *srcBlocks++;
 			uint64 rgbData = *srcBlocks++;
 
-			float keyFloat[2][3];
-			for (int k = 0; k < 2; k++) {
-				word rgb565 = rgbData & 0xFFFF;
-				rgbData >>= 16;
-				Color565to888f(rgb565, keyFloat[k]);
-			}
-
 			byte keyRgba[4][4];
-			Dxt1Keys3(keyFloat, keyRgba);
+			DecodeDXTColorKeys(rgbData, false, false, keyRgba);
+			rgbData >>= 32;
 
 			for (int r = 0; r < 4; r++)
 				for (int c = 0; c < 4; c++) {
@@ -3318,26 +3352,13 @@ void idSIMD_Generic::DecompressRGBA8FromDXT5( const byte *srcPtr, int width, int
 			uint64 alphaData = *srcBlocks++;
 			uint64 rgbData = *srcBlocks++;
 
-			float keyFloat[2][3];
-			for (int k = 0; k < 2; k++) {
-				word rgb565 = rgbData & 0xFFFF;
-				rgbData >>= 16;
-				Color565to888f(rgb565, keyFloat[k]);
-			}
-
-			byte keyAlpha[8];
-			keyAlpha[0] = (alphaData & 0xFF);
-			alphaData >>= 8;
-			keyAlpha[1] = (alphaData & 0xFF);
-			alphaData >>= 8;
-
 			byte keyRgba[4][4];
-			Dxt1Keys3(keyFloat, keyRgba);
+			DecodeDXTColorKeys(rgbData, false, false, keyRgba);
+			rgbData >>= 32;
 
-			if (keyAlpha[0] > keyAlpha[1])
-				Dxt5Keys7(keyAlpha);
-			else
-				Dxt5Keys5(keyAlpha);
+			byte keyAlpha[8];
+			DecodeDXTAlphaKeys(alphaData, keyAlpha);
+			alphaData >>= 16;
 
 			for (int r = 0; r < 4; r++)
 				for (int c = 0; c < 4; c++) {
@@ -3377,25 +3398,10 @@ void idSIMD_Generic::DecompressRGBA8FromRGTC( const byte *srcPtr, int width, int
 			uint64 greenData = *srcBlocks++;
 
 			byte keyRed[8], keyGreen[8];
-			keyRed[0] = (redData & 0xFF);
-			redData >>= 8;
-			keyRed[1] = (redData & 0xFF);
-			redData >>= 8;
-
-			keyGreen[0] = (greenData & 0xFF);
-			greenData >>= 8;
-			keyGreen[1] = (greenData & 0xFF);
-			greenData >>= 8;
-
-			if (keyRed[0] > keyRed[1])
-				Dxt5Keys7(keyRed);
-			else
-				Dxt5Keys5(keyRed);
-
-			if (keyGreen[0] > keyGreen[1])
-				Dxt5Keys7(keyGreen);
-			else
-				Dxt5Keys5(keyGreen);
+			DecodeDXTAlphaKeys(redData, keyRed);
+			redData >>= 16;
+			DecodeDXTAlphaKeys(greenData, keyGreen);
+			greenData >>= 16;
 
 			for (int r = 0; r < 4; r++)
 				for (int c = 0; c < 4; c++) {
@@ -52,6 +52,7 @@ public:
 	virtual void Dot( float *dst,			const idPlane &constant,const idDrawVert *src,	const int count );
 	virtual void Dot( float *dst,			const idVec3 *src0,		const idVec3 *src1,		const int count );
 	virtual void Dot( float &dot,			const float *src1,		const float *src2,		const int count );
+	virtual void Dot6Padded8( float *dst,	const float *constant,	const float *src,		const int count );
 
 	virtual void CmpGT( byte *dst,			const float *src0,		const float constant,	const int count );
 	virtual void CmpGT( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
@@ -131,6 +132,12 @@ public:
 	virtual void MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] );
 	virtual void MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] );
 	virtual void MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples );
+
+protected:
+	// key colors of a DXT color block, DXT1 blocks may use three colors and transparent black
+	static void DecodeDXTColorKeys( uint64 colorData, bool dxt1, bool allowTransparency, byte keyRgba[4][4] );
+	// key values of a DXT5 alpha block or RGTC channel block
+	static void DecodeDXTAlphaKeys( uint64 alphaData, byte keys[8] );
 };
 
 #endif /* !__MATH_SIMD_GENERIC_H__ */
@@ -290,7 +290,8 @@ private:
 	bool				isBindlessHandleResident;
 public:
 	bool				isImmutable;
-	int					lastNeededInFrame;
+	int					lastNeededInFrame;		// last frame the image was bound, for streaming and bindless residency
+	int					streamPriority;			// screen area of the biggest surface waiting for a background load
 	void				MakeResident();
 	void				MakeNonResident();
 	GLuint64			BindlessHandle();
@@ -353,6 +354,14 @@ public:
 
 	void				PrintMemInfo( MemInfo_t *mi );
 
+	// image streaming, used when images are not preloaded
+	// schedules a background load, or raises the priority of a scheduled one
+	void				RequestBackgroundLoad( idImage *image, int priority );
+	// called by the backend once per frame, evicts images above the budgets and starts loader jobs
+	void				UpdateStreaming();
+	// drops all requests and data not uploaded yet, waits for running loads
+	void				CancelStreaming();
+
 	// cvars
 	static idCVar		image_colorMipLevels;		// development aid to see texture mip usage
 	static idCVar		image_downSize;				// controls texture downsampling
@@ -375,6 +384,9 @@ public:
 	static idCVar		image_ignoreHighQuality;	// ignore high quality on materials
 	static idCVar		image_downSizeLimit;		// downsize diffuse limit
 	static idCVar		image_blockChecksum;		// duplicate check
+	static idCVar		image_streamJobs;			// number of loader jobs for streamed images
+	static idCVar		image_streamCpuBudget;		// MB of streamed data waiting for upload
+	static idCVar		image_streamGpuBudget;		// MB of textures of file images
 
 	// built-in images
 	idImage *			defaultImage;
@@ -432,6 +444,16 @@ public:
 	idImage *			imageHashTable[FILE_HASH_SIZE];
 
 	void				MakeUnusedImagesNonResident();
+
+	static const int	MAX_STREAM_JOBS = 8;
+	static const int	MAX_STREAM_IMAGES_PER_JOB = 4;	// loader jobs end after this many and are submitted again with the newest requests
+	idSysMutex			streamMutex;				// protects the lists below and backgroundLoadState of their images
+	idList<idImage*>	streamQueue;				// scheduled images not taken by a loader job yet
+	idList<idImage*>	streamLoaded;				// loaded in background, waiting for upload
+	int64				streamLoadedBytes;
+	int					streamLoads;				// loads and their time in ms since the last UpdateStreaming,
+	int					streamLoadTime;				// added to backEnd.pc by the backend thread
+	idParallelJobList *	streamJobList;
 };
 
 extern idImageManager	*globalImages;		// pointer to global list for the rest of the system
@@ -450,6 +472,8 @@ byte *R_Dropsample( const byte *in, int inwidth, int inheight,
 byte *R_ResampleTexture( const byte *in, int inwidth, int inheight,
                          int outwidth, int outheight );
 byte *R_MipMap( const byte *in, int width, int height );
+// all levels below the given one, numLevels includes the given level
+void R_GenerateMipMaps( const byte *in, int width, int height, byte **levels, int numLevels );
 
 // these operate in-place on the provided pixels
 void R_SetBorderTexels( byte *inBase, int width, int height, const byte border[4] );
@@ -242,6 +242,7 @@ idImage::idImage() {
 	isBindlessHandleResident = false;
 	textureHandle = 0;
 	lastNeededInFrame = -1;
+	streamPriority = 0;
 	isImmutable = false;
 	loadStack = nullptr;
 }
@@ -1399,6 +1400,7 @@ PurgeAllImages
 */
 void idImageManager::PurgeAllImages() {
 	idImage	*image;
+	CancelStreaming();
 	for ( int i = 0; i < images.Num() ; i++ ) {
 		image = images[i];
 		image->PurgeImage();
@@ -1601,6 +1603,11 @@ Shutdown
 ===============
 */
 void idImageManager::Shutdown() {
+	CancelStreaming();
+	if ( streamJobList ) {
+		parallelJobManager->FreeJobList( streamJobList );
+		streamJobList = nullptr;
+	}
 	images.DeleteContents( true );
 }
 
@@ -1618,6 +1625,9 @@ void idImageManager::BeginLevelLoad() {
 	insideLevelLoad = true;
 	idImage	*image;
 
+	// the images may be purged below
+	CancelStreaming();
+
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		image = images[ i ];
 		// generator function images are always kept around
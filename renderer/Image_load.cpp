@@ -18,12 +18,9 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 #include "tr_local.h"
 #include "FrameBuffer.h"
-#include <thread>
-#include <mutex>          // std::mutex, std::unique_lock, std::defer_lock
-#include <stack>
-#include <condition_variable>
 #include "LoadStack.h"
 #include "../tests/testing.h"
+#include "../idlib/math/Simd_Generic.h"
 
 /*
 PROBLEM: compressed textures may break the zero clamp rule!
@@ -534,19 +531,15 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 	if ( image_mipmapMode.GetInteger() == 0 && useTexStorage ) {
 		TRACE_CPU_SCOPE ("GenerateMipmap" );
 		qglTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipLevels - 1 );
-		byte *currentMip = scaledBuffer;
+		byte *mips[32];
+		R_GenerateMipMaps( scaledBuffer, scaled_width, scaled_height, mips, mipLevels );
 		int w = scaled_width, h = scaled_height;
 		for ( int lvl = 1; lvl < mipLevels; lvl++ ) {
-			byte *nextMip = R_MipMap( currentMip, w, h );
 			w = idMath::Imax( w >> 1, 1 );
 			h = idMath::Imax( h >> 1, 1 );
-			qglTexSubImage2D( GL_TEXTURE_2D, lvl, 0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nextMip );
-			if ( currentMip != scaledBuffer )
-				R_StaticFree( currentMip );
-			currentMip = nextMip;
+			qglTexSubImage2D( GL_TEXTURE_2D, lvl, 0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, mips[lvl - 1] );
+			R_StaticFree( mips[lvl - 1] );
 		}
-		if ( currentMip != scaledBuffer )
-			R_StaticFree( currentMip );
 	}
 	else {
 		TRACE_CPU_SCOPE( "GenerateMipmap" );
@@ -1359,30 +1352,220 @@ void R_UploadImageData( idImage& image ) {
 	}
 }
 
-std::stack<idImage*> backgroundLoads;
-std::mutex signalMutex;
-std::condition_variable imageThreadSignal;
+/*
+================================================================================================
+
+Image streaming
+
+With image_preload 0, images are loaded on the first Bind by a few loader jobs.
+Requests of the images needed most recently and covering most of the screen are
+served first. Loaded data waits on the CPU until the image is bound again and
+uploaded, which is limited by image_streamCpuBudget. Textures of file images are
+limited by image_streamGpuBudget, the least recently used ones are purged and
+streamed in again when needed.
 
-void BackgroundLoading() {
-	while ( 1 ) {
-		idImage* img = nullptr;
+================================================================================================
+*/
+
+idCVar idImageManager::image_streamJobs( "image_streamJobs", "2", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "number of parallel jobs loading images in background when image_preload is 0", 1, idImageManager::MAX_STREAM_JOBS );
+idCVar idImageManager::image_streamCpuBudget( "image_streamCpuBudget", "256", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "megabytes of image data loaded in background and waiting for upload, 0 = unlimited", 0, 65536 );
+idCVar idImageManager::image_streamGpuBudget( "image_streamGpuBudget", "0", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "megabytes of textures loaded from files, least recently used ones are purged above it, 0 = unlimited", 0, 65536 );
+
+static int R_StreamedCpuBytes( const idImage &image ) {
+	int bytes = 0;
+	if ( image.cpuData.IsValid() )
+		bytes += image.cpuData.GetTotalSizeInBytes();
+	if ( image.compressedData )
+		bytes += image.compressedData->GetTotalSize();
+	return bytes;
+}
+
+// recently needed images first, then the ones covering more of the screen
+static bool R_StreamBefore( const idImage *a, const idImage *b ) {
+	if ( a->lastNeededInFrame != b->lastNeededInFrame )
+		return a->lastNeededInFrame > b->lastNeededInFrame;
+	return a->streamPriority > b->streamPriority;
+}
+
+/*
+===============
+R_StreamImages
+
+Loader job, takes the best request from the queue up to MAX_STREAM_IMAGES_PER_JOB times,
+until it is empty or the CPU budget is reached. UpdateStreaming submits the jobs again.
+===============
+*/
+static void R_StreamImages( idImageManager *manager ) {
+	const int64 cpuBudget = (int64)idImageManager::image_streamCpuBudget.GetInteger() << 20;
+
+	for ( int n = 0; n < idImageManager::MAX_STREAM_IMAGES_PER_JOB; n++ ) {
+		idImage *image = nullptr;
 		{
-			std::unique_lock<std::mutex> lock( signalMutex );
-			imageThreadSignal.wait( lock, []() { return backgroundLoads.size() > 0; } );
-			img = backgroundLoads.top();
-			backgroundLoads.pop();
+			idScopedCriticalSection lock( manager->streamMutex );
+			if ( cpuBudget > 0 && manager->streamLoadedBytes >= cpuBudget )
+				break;
+			int best = -1;
+			for ( int i = 0; i < manager->streamQueue.Num(); i++ ) {
+				if ( best < 0 || R_StreamBefore( manager->streamQueue[i], manager->streamQueue[best] ) )
+					best = i;
+			}
+			if ( best < 0 )
+				break;
+			image = manager->streamQueue[best];
+			manager->streamQueue.RemoveIndex( best, false );
 		}
-		/*if ( loading && !uploading ) // debug state check
-			GetTickCount();*/
+
 		auto start = Sys_Milliseconds();
-		R_LoadImageData( *img );
-		backEnd.pc.textureLoadTime += ( Sys_Milliseconds() - start );
-		backEnd.pc.textureBackgroundLoads++;
-		img->backgroundLoadState = IS_LOADED;
+		R_LoadImageData( *image );
+		int loadTime = Sys_Milliseconds() - start;
+
+		{
+			// backEnd.pc is only written by the backend thread, see UpdateStreaming
+			idScopedCriticalSection lock( manager->streamMutex );
+			image->backgroundLoadState = IS_LOADED;
+			manager->streamLoaded.AddUnique( image );
+			manager->streamLoadedBytes += R_StreamedCpuBytes( *image );
+			manager->streamLoads++;
+			manager->streamLoadTime += loadTime;
+		}
 	}
 }
+REGISTER_PARALLEL_JOB( R_StreamImages, "R_StreamImages" );
 
-uintptr_t backgroundImageLoader = Sys_CreateThread((xthread_t)BackgroundLoading, NULL, THREAD_NORMAL, "Image Loader" );
+/*
+===============
+idImageManager::RequestBackgroundLoad
+===============
+*/
+void idImageManager::RequestBackgroundLoad( idImage *image, int priority ) {
+	idScopedCriticalSection lock( streamMutex );
+	if ( image->backgroundLoadState == IS_NONE ) {
+		image->backgroundLoadState = IS_SCHEDULED;
+		image->streamPriority = priority;
+		streamQueue.Append( image );
+	} else if ( image->backgroundLoadState == IS_SCHEDULED ) {
+		image->streamPriority = idMath::Imax( image->streamPriority, priority );
+	}
+}
+
+/*
+===============
+idImageManager::UpdateStreaming
+
+Called by the backend at the end of each frame.
+===============
+*/
+void idImageManager::UpdateStreaming() {
+	TRACE_CPU_SCOPE( "Image:Streaming" )
+
+	// loader jobs are only submitted again once all of them have finished
+	const bool loading = streamJobList && streamJobList->IsSubmitted() && !streamJobList->TryWait();
+
+	// forget loads which have been uploaded meanwhile, drop the least recently needed ones above the CPU budget
+	const int64 cpuBudget = (int64)image_streamCpuBudget.GetInteger() << 20;
+	{
+		idScopedCriticalSection lock( streamMutex );
+		backEnd.pc.textureBackgroundLoads += streamLoads;
+		backEnd.pc.textureLoadTime += streamLoadTime;
+		streamLoads = streamLoadTime = 0;
+		streamLoadedBytes = 0;
+		for ( int i = 0; i < streamLoaded.Num(); i++ ) {
+			if ( streamLoaded[i]->backgroundLoadState != IS_LOADED ) {
+				streamLoaded.RemoveIndex( i--, false );
+			} else {
+				streamLoadedBytes += R_StreamedCpuBytes( *streamLoaded[i] );
+			}
+		}
+		if ( cpuBudget > 0 && streamLoadedBytes > cpuBudget ) {
+			std::sort( streamLoaded.begin(), streamLoaded.end(), R_StreamBefore );
+			while ( streamLoadedBytes > cpuBudget && streamLoaded.Num() > 0 ) {
+				idImage *image = streamLoaded[streamLoaded.Num() - 1];
+				if ( image->lastNeededInFrame >= backEnd.frameCount )
+					break;
+				streamLoadedBytes -= R_StreamedCpuBytes( *image );
+				image->cpuData.Purge();
+				if ( image->compressedData ) {
+					R_StaticFree( image->compressedData );
+					image->compressedData = nullptr;
+				}
+				image->backgroundLoadState = IS_NONE;
+				streamLoaded.RemoveIndex( streamLoaded.Num() - 1 );
+			}
+		}
+	}
+
+	// purge the least recently used textures above the GPU budget,
+	// only the ones not bound in the last two frames
+	const int64 gpuBudget = (int64)image_streamGpuBudget.GetInteger() << 20;
+	if ( gpuBudget > 0 ) {
+		idList<idImage*> candidates;
+		int64 gpuBytes = 0;
+		for ( idImage *image : images ) {
+			if ( image->generatorFunction || image->texnum == idImage::TEXTURE_NOT_LOADED )
+				continue;
+			gpuBytes += image->StorageSize();
+			if ( image->backgroundLoadState == IS_NONE && image->lastNeededInFrame < backEnd.frameCount - 1 )
+				candidates.AddGrow( image );
+		}
+		if ( gpuBytes > gpuBudget ) {
+			std::sort( candidates.begin(), candidates.end(), []( const idImage *a, const idImage *b ) {
+				return a->lastNeededInFrame < b->lastNeededInFrame;
+			} );
+			for ( int i = 0; i < candidates.Num() && gpuBytes > gpuBudget; i++ ) {
+				gpuBytes -= candidates[i]->StorageSize();
+				candidates[i]->PurgeImage( false );
+			}
+		}
+	}
+
+	if ( loading )
+		return;
+
+	{
+		idScopedCriticalSection lock( streamMutex );
+		if ( streamQueue.Num() == 0 || ( cpuBudget > 0 && streamLoadedBytes >= cpuBudget ) )
+			return;
+	}
+
+	if ( !streamJobList )
+		streamJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_STREAM_JOBS, 0, nullptr );
+	int numJobs = idMath::ClampInt( 1, MAX_STREAM_JOBS, image_streamJobs.GetInteger() );
+	for ( int i = 0; i < numJobs; i++ )
+		streamJobList->AddJob( (jobRun_t)R_StreamImages, this );
+	streamJobList->Submit( nullptr, numJobs );
+}
+
+/*
+===============
+idImageManager::CancelStreaming
+
+Drops all requests, waits for the loader jobs and frees the data not uploaded yet.
+===============
+*/
+void idImageManager::CancelStreaming() {
+	{
+		idScopedCriticalSection lock( streamMutex );
+		for ( idImage *image : streamQueue )
+			image->backgroundLoadState = IS_NONE;
+		streamQueue.Clear();
+	}
+
+	if ( streamJobList && streamJobList->IsSubmitted() )
+		streamJobList->Wait();
+
+	for ( idImage *image : streamLoaded ) {
+		if ( image->backgroundLoadState != IS_LOADED )
+			continue;
+		image->cpuData.Purge();
+		if ( image->compressedData ) {
+			R_StaticFree( image->compressedData );
+			image->compressedData = nullptr;
+		}
+		image->backgroundLoadState = IS_NONE;
+	}
+	streamLoaded.Clear();
+	streamLoadedBytes = 0;
+}
 
 /*
 ===============
@@ -1413,14 +1596,9 @@ void idImage::ActuallyLoadImage( bool allowBackground ) {
 	// load the image from disk
 	//
 	if ( allowBackground ) {
-		if ( backgroundLoadState == IS_NONE ) {
-			backgroundLoadState = IS_SCHEDULED;
-			std::unique_lock<std::mutex> lock( signalMutex );
-			backgroundLoads.push( this );
-			imageThreadSignal.notify_all();
-			return;
-		}
-		if ( backgroundLoadState == IS_SCHEDULED ) {
+		if ( backgroundLoadState != IS_LOADED ) {
+			// screen area of the surface being drawn
+			globalImages->RequestBackgroundLoad( this, backEnd.currentScissor.GetArea() );
 			return;
 		}
 		if ( backgroundLoadState == IS_LOADED ) {
@@ -1485,6 +1663,8 @@ void idImage::Bind() {
 	}
 #endif
 
+	lastNeededInFrame = backEnd.frameCount;
+
 	// load the image if necessary
 	if ( texnum == TEXTURE_NOT_LOADED ) {
 		auto start = Sys_Milliseconds();
@@ -2002,12 +2182,107 @@ static void TestDecompressDxt(bool checkPerfo) {
 	}
 }
 
+//runs the image kernels of SIMDProcessor and of the generic processor on the same input,
+//the output must be exactly the same
+static void TestSimdImageKernels(bool checkPerfo) {
+	idSIMD_Generic generic;
+	idSIMDProcessor *processors[2] = {&generic, SIMDProcessor};
+	idRandom rnd;
+
+	static const int SIZES[][2] = { {1024, 1024}, {512, 512}, {231, 177}, {22, 18}, {16, 16}, {6, 2}, {4, 4}, {3, 5}, {1, 1} };
+	static const char *KERNELS[] = { "DXT1", "DXT1 alpha", "DXT3", "DXT5", "RGTC", "MipMap2x2" };
+	const int numSizes = checkPerfo ? 1 : sizeof(SIZES) / sizeof(SIZES[0]);
+	const int TRIES = checkPerfo ? 5 : 1;
+
+	for (int s = 0; s < numSizes; s++) {
+		int W = SIZES[s][0], H = SIZES[s][1];
+		for (int k = 0; k < sizeof(KERNELS) / sizeof(KERNELS[0]); k++) {
+			bool mipmap = (k == 5);
+			if (mipmap && (W < 2 || H < 2))
+				continue;
+			int blockBytes = (k == 0 || k == 1 ? 8 : 16);
+			//any random bytes are valid compressed blocks too
+			idList<byte> input;
+			input.SetNum(mipmap ? W * H * 4 : ((W + 3) / 4) * ((H + 3) / 4) * blockBytes);
+			for (int i = 0; i < input.Num(); i++)
+				input[i] = rnd.RandomInt(256);
+
+			idList<byte> output[2];
+			double time[2] = {0.0, 0.0};
+			for (int p = 0; p < 2; p++) {
+				idSIMDProcessor *proc = processors[p];
+				output[p].SetNum(W * H * 4);
+				memset(output[p].Ptr(), 0xCD, output[p].Num());
+				for (int ntry = 0; ntry < TRIES; ntry++) {
+					double startClock = Sys_GetClockTicks();
+					if (k == 0)
+						proc->DecompressRGBA8FromDXT1(input.Ptr(), W, H, output[p].Ptr(), 4 * W, false);
+					else if (k == 1)
+						proc->DecompressRGBA8FromDXT1(input.Ptr(), W, H, output[p].Ptr(), 4 * W, true);
+					else if (k == 2)
+						proc->DecompressRGBA8FromDXT3(input.Ptr(), W, H, output[p].Ptr(), 4 * W);
+					else if (k == 3)
+						proc->DecompressRGBA8FromDXT5(input.Ptr(), W, H, output[p].Ptr(), 4 * W);
+					else if (k == 4)
+						proc->DecompressRGBA8FromRGTC(input.Ptr(), W, H, output[p].Ptr(), 4 * W);
+					else
+						proc->GenerateMipMap2x2(input.Ptr(), 4 * W, W / 2, H / 2, output[p].Ptr(), 4 * (W / 2));
+					double endClock = Sys_GetClockTicks();
+					time[p] = 1e+3 * (endClock - startClock) / Sys_ClockTicksPerSecond();
+				}
+			}
+			if (checkPerfo) {
+				MESSAGE(va("%s (%d x %d): %s %0.3lf ms, %s %0.3lf ms", KERNELS[k], W, H,
+					processors[0]->GetName(), time[0], processors[1]->GetName(), time[1]
+				));
+			}
+			CHECK_MESSAGE(memcmp(output[0].Ptr(), output[1].Ptr(), output[0].Num()) == 0,
+				va("%s (%d x %d) of %s differs from %s", KERNELS[k], W, H, processors[1]->GetName(), processors[0]->GetName())
+			);
+		}
+	}
+}
+
 TEST_CASE("DecompressDxt:Correctness") {
 	TestDecompressDxt(false);
 }
 
+TEST_CASE("DecompressDxt:SimdMatchesGeneric") {
+	TestSimdImageKernels(false);
+}
+
 TEST_CASE("DecompressDxt:Performance"
 	* doctest::skip()
 ) {
 	TestDecompressDxt(true);
+	TestSimdImageKernels(true);
+}
+
+TEST_CASE("GenerateMipMaps") {
+	idRandom rnd;
+	static const int SIZES[][2] = { {1024, 1024}, {1000, 600}, {333, 1025}, {1, 300} };
+	for (int s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+		int W = SIZES[s][0], H = SIZES[s][1];
+		idList<byte> image = GenImageRandom(W, H, rnd);
+		int numLevels = 1 + idMath::ILog2(Max(W, H));
+
+		byte *mips[32];
+		R_GenerateMipMaps(image.Ptr(), W, H, mips, numLevels);
+
+		// must be exactly the same as serial quartering
+		const byte *current = image.Ptr();
+		int w = W, h = H;
+		for (int lvl = 1; lvl < numLevels; lvl++) {
+			byte *expected = R_MipMap(current, w, h);
+			if (current != image.Ptr())
+				R_StaticFree((void*)current);
+			w = idMath::Imax(w >> 1, 1);
+			h = idMath::Imax(h >> 1, 1);
+			CHECK(memcmp(expected, mips[lvl - 1], w * h * 4) == 0);
+			R_StaticFree(mips[lvl - 1]);
+			current = expected;
+		}
+		if (current != image.Ptr())
+			R_StaticFree((void*)current);
+	}
 }
@@ -160,6 +160,38 @@ void R_SetBorderTexels( byte *inBase, int width, int height, const byte border[4
 	}
 }
 
+idCVar image_mipmapParallel( "image_mipmapParallel", "1", CVAR_BOOL | CVAR_RENDERER, "Split generation of large mipmap levels into parallel jobs" );
+
+// levels with fewer output rows are not worth splitting into jobs
+static const int MIPMAP_MIN_ROWS_PER_JOB = 64;
+static const int MIPMAP_MAX_JOBS = 16;
+
+/*
+================
+R_MipMapRows
+
+Writes rows [firstRow, lastRow) of the level below the given one into out.
+================
+*/
+static void R_MipMapRows( const byte *in, int width, int height, byte *out, int firstRow, int lastRow ) {
+	int newWidth = idMath::Imax(width >> 1, 1);
+
+	if (width == 1 || height == 1) {
+		int n = idMath::Imax(width, height);
+		int bn = n >> 1;
+		for (int i = 0; i < bn; i++) {
+			for (int c = 0; c < 4; c++)
+				out[4*i+c] = ((unsigned)in[8*i+c] + in[8*i+4+c] + 1) >> 1;
+		}
+	}
+	else {
+		SIMDProcessor->GenerateMipMap2x2(
+			in + 2 * firstRow * width * 4, width * 4, newWidth, lastRow - firstRow,
+			out + firstRow * newWidth * 4, newWidth * 4
+		);
+	}
+}
+
 /*
 ================
 R_MipMap
@@ -177,19 +209,83 @@ byte *R_MipMap( const byte *in, int width, int height ) {
 	int newHeight = idMath::Imax(height >> 1, 1);
 	byte *out = (byte *)R_StaticAlloc( newWidth * newHeight * 4 );
 
-	if (width == 1 || height == 1) {
-		int n = idMath::Imax(width, height);
-		int bn = n >> 1;
-		for (int i = 0; i < bn; i++) {
-			for (int c = 0; c < 4; c++)
-				out[4*i+c] = ((unsigned)in[8*i+c] + in[8*i+4+c] + 1) >> 1;
-		}
+	R_MipMapRows( in, width, height, out, 0, newHeight );
+
+	return out;
+}
+
+struct mipMapJob_t {
+	const byte *	in;
+	int				width;
+	int				height;
+	byte *			out;
+	int				firstRow;
+	int				lastRow;
+};
+
+static void R_MipMapJob( mipMapJob_t *job ) {
+	R_MipMapRows( job->in, job->width, job->height, job->out, job->firstRow, job->lastRow );
+}
+
+REGISTER_PARALLEL_JOB( R_MipMapJob, "R_MipMapJob" );
+
+/*
+================
+R_GenerateMipMaps
+
+Fills levels[0 .. numLevels-2] with all mip levels below the given image,
+each one allocated with R_StaticAlloc and owned by the caller.
+Large levels are split into bands of rows which are filtered in parallel,
+the levels themselves depend on each other and are processed in order.
+================
+*/
+void R_GenerateMipMaps( const byte *in, int width, int height, byte **levels, int numLevels ) {
+	int maxJobs = 1;
+	if ( image_mipmapParallel.GetBool() ) {
+		maxJobs = idMath::ClampInt( 1, MIPMAP_MAX_JOBS, ( height >> 1 ) / MIPMAP_MIN_ROWS_PER_JOB );
 	}
-	else {
-		SIMDProcessor->GenerateMipMap2x2(in, width * 4, newWidth, newHeight, out, newWidth * 4);
+	idParallelJobList *jobList = NULL;
+	if ( maxJobs > 1 ) {
+		jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, maxJobs, 0, NULL );
 	}
+	mipMapJob_t jobs[MIPMAP_MAX_JOBS];
 
-	return out;
+	const byte *current = in;
+	for ( int lvl = 1; lvl < numLevels; lvl++ ) {
+		int newWidth = idMath::Imax( width >> 1, 1 );
+		int newHeight = idMath::Imax( height >> 1, 1 );
+		byte *out = (byte *)R_StaticAlloc( newWidth * newHeight * 4 );
+
+		int numJobs = 1;
+		if ( jobList && width > 1 ) {
+			numJobs = idMath::ClampInt( 1, maxJobs, newHeight / MIPMAP_MIN_ROWS_PER_JOB );
+		}
+		if ( numJobs > 1 ) {
+			for ( int i = 0; i < numJobs; i++ ) {
+				mipMapJob_t &job = jobs[i];
+				job.in = current;
+				job.width = width;
+				job.height = height;
+				job.out = out;
+				job.firstRow = newHeight * i / numJobs;
+				job.lastRow = newHeight * ( i + 1 ) / numJobs;
+				jobList->AddJob( (jobRun_t)R_MipMapJob, &job );
+			}
+			jobList->Submit();
+			jobList->Wait();
+		} else {
+			R_MipMapRows( current, width, height, out, 0, newHeight );
+		}
+
+		levels[lvl - 1] = out;
+		current = out;
+		width = newWidth;
+		height = newHeight;
+	}
+
+	if ( jobList ) {
+		parallelJobManager->FreeJobList( jobList );
+	}
 }
 
 /*
@@ -480,6 +480,7 @@ idInteraction::idInteraction( void ) {
 	entityPrev				= NULL;
 	dynamicModelFrameCount	= 0;
 	frustumState			= FRUSTUM_UNINITIALIZED;
+	activeModel				= NULL;
 }
 
 /*
@@ -497,6 +498,7 @@ idInteraction *idInteraction::AllocAndLink( idRenderEntityLocal *edef, idRenderL
 
 	// link and initialize
 	interaction->dynamicModelFrameCount = 0;
+	interaction->activeModel = NULL;
 
 	interaction->lightDef = ldef;
 	interaction->entityDef = edef;
@@ -1210,21 +1212,29 @@ instantiate the dynamic model to find out
 void idInteraction::AddActiveInteraction( void ) {
 	TRACE_CPU_SCOPE_TEXT("AddActiveInteraction", GetTraceLabel(lightDef->parms));
 
-	viewLight_t *	vLight;
-	viewEntity_t *	vEntity;
-	idScreenRect	lightScissor;
-	idVec3			localLightOrigin;
+	if ( BeginActiveInteraction() ) {
+		CreateActiveInteraction();
+	}
+	FinishActiveInteraction();
+}
 
-	vLight = lightDef->viewLight;
-	vEntity = entityDef->viewEntity;
+/*
+==================
+idInteraction::BeginActiveInteraction
 
+Culls the interaction and instantiates the dynamic model.
+Must not run concurrently with other interactions of the same entity.
+==================
+*/
+bool idInteraction::BeginActiveInteraction( void ) {
 	flagMakeEmpty = false;
+	activeModel = NULL;
 
 	// Try to cull the whole interaction away in a multitide of ways
 	// Also, reduce scissor rect of the interaction if possible
-	idScreenRect shadowScissor = vLight->scissorRect;
-	if ( !IsPotentiallyVisible( shadowScissor ) )
-		return;
+	activeShadowScissor = lightDef->viewLight->scissorRect;
+	if ( !IsPotentiallyVisible( activeShadowScissor ) )
+		return false;
 
 	// We will need the dynamic surface created to make interactions, even if the
 	// model itself wasn't visible.  This just returns a cached value after it
@@ -1232,7 +1242,7 @@ void idInteraction::AddActiveInteraction( void ) {
 	idRenderModel *model = R_EntityDefDynamicModel( entityDef );
 
 	if ( model == NULL || model->NumSurfaces() <= 0 ) {
-		return;
+		return false;
 	}
 
 	// the dynamic model may have changed since we built the surface list
@@ -1240,11 +1250,45 @@ void idInteraction::AddActiveInteraction( void ) {
 		FreeSurfaces();
 	}
 	dynamicModelFrameCount = entityDef->dynamicModelFrameCount;
+	activeModel = model;
+
+	return IsDeferred();
+}
+
+/*
+==================
+idInteraction::CreateActiveInteraction
+==================
+*/
+void idInteraction::CreateActiveInteraction( void ) {
+	TRACE_CPU_SCOPE_TEXT("CreateActiveInteraction", GetTraceLabel(lightDef->parms));
+
+	// actually create the interaction, building light and shadow surfaces as needed
+	CreateInteraction( activeModel );
+}
+
+/*
+==================
+idInteraction::FinishActiveInteraction
+
+Adds the light and shadow surfaces of the interaction to the view.
+==================
+*/
+void idInteraction::FinishActiveInteraction( void ) {
+	viewLight_t *	vLight;
+	viewEntity_t *	vEntity;
+	idScreenRect	lightScissor;
+	idVec3			localLightOrigin;
 
-	// actually create the interaction if needed, building light and shadow surfaces as needed
-	if ( IsDeferred() ) {
-		CreateInteraction( model );
+	if ( activeModel == NULL ) {
+		return;
 	}
+	activeModel = NULL;
+
+	vLight = lightDef->viewLight;
+	vEntity = entityDef->viewEntity;
+	const idScreenRect &shadowScissor = activeShadowScissor;
+
 	R_GlobalPointToLocal( vEntity->modelMatrix, lightDef->globalLightOrigin, localLightOrigin );
 
 	// calculate the scissor as the intersection of the light and model rects
@@ -127,6 +127,14 @@ public:
 	// makes sure all necessary light surfaces and shadow surfaces are created, and
 	// calls R_PrepareLightSurf() for each one
 	void					AddActiveInteraction( void );
+
+	// AddActiveInteraction split into steps, so that the light and shadow surfaces
+	// of all interactions in the view can be created in parallel:
+	// returns true if CreateActiveInteraction must be called before FinishActiveInteraction
+	bool					BeginActiveInteraction( void );
+	// builds the light tris and shadow volumes, may run concurrently with other interactions of the same entity
+	void					CreateActiveInteraction( void );
+	void					FinishActiveInteraction( void );
 	// returns false if the whole interaction can be omitted from rendering (culled away)
 	// also writes screen scissor bounding the visible part of interaction
 	bool					IsPotentiallyVisible( idScreenRect &shadowScissor );
@@ -143,6 +151,10 @@ private:
 
 	int						dynamicModelFrameCount;	// so we can tell if a callback model animated
 
+	// state between BeginActiveInteraction and FinishActiveInteraction, activeModel is NULL if culled
+	const idRenderModel *	activeModel;
+	idScreenRect			activeShadowScissor;
+
 	// actually create the interaction
 	void					CreateInteraction( const idRenderModel *model );
 
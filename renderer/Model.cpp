@@ -48,6 +48,8 @@ idRenderModelStatic::idRenderModelStatic() {
 	reloadable = true;
 	levelLoadReferenced = false;
 	timeStamp = 0;
+	cookedSourceLength = -1;
+	cookedSourceChecksum = 0;
 }
 
 /*
@@ -271,6 +273,13 @@ void idRenderModelStatic::InitFromFile( const char *fileName ) {
 	// FIXME: load new .proc map format
 	name.ExtractFileExtension( extension );
 
+	// the cooked surfaces skip both parsing and cleaning up
+	if ( ( extension.Icmp( "ase" ) == 0 || extension.Icmp( "lwo" ) == 0 ) && LoadCookedModel( name ) ) {
+		reloadable = true;
+		FinishCleanSurfaces();
+		return;
+	}
+
 	if ( extension.Icmp( "ase" ) == 0 ) {
 		loaded		= LoadASE( name );
 		// Tels: #3111 try to load LWO as a fallback
@@ -319,6 +328,10 @@ void idRenderModelStatic::InitFromFile( const char *fileName ) {
 
 	// create the bounds for culling and dynamic surface creation
 	FinishSurfaces();
+
+	if ( fallback.IsEmpty() ) {
+		WriteCookedModel( name );
+	}
 }
 
 /*
@@ -666,6 +679,21 @@ void idRenderModelStatic::FinishSurfaces() {
 		}
 	}
 
+	FinishCleanSurfaces();
+}
+
+/*
+================
+idRenderModelStatic::FinishCleanSurfaces
+
+The rest of FinishSurfaces once the surfaces are cleaned up, also used for cooked surfaces.
+================
+*/
+void idRenderModelStatic::FinishCleanSurfaces() {
+	int			i;
+
+	purged = false;
+
 	// add up the total surface area for development information
 	for ( i = 0 ; i < surfaces.Num() ; i++ ) {
 		const modelSurface_t	*surf = &surfaces[i];
@@ -0,0 +1,803 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+
+
+#include "tr_local.h"
+#include "Model_local.h"
+
+/*
+===============================================================================
+
+	Cooked models
+
+	After an ASE, LWO or MD5 model is loaded from its source file, the processed
+	surfaces are written to a .bmesh file next to it: the cleaned up triangles of
+	static models with their silhouette and tangent data, and the joints, weights
+	and deform info of MD5 meshes. Later loads of the same source file read the
+	.bmesh instead, which skips both parsing and the triangle cleanup.
+
+	The .bmesh is only used while the length and checksum of the source file, the
+	material properties the processing depends on and the sizes of the stored
+	structures are still the same.
+
+===============================================================================
+*/
+
+#define COOKED_MODEL_EXT		"bmesh"
+#define COOKED_MODEL_ID			( ( 'H' << 24 ) | ( 'S' << 16 ) | ( 'M' << 8 ) | 'B' )
+#define COOKED_MODEL_VERSION	1
+
+typedef struct cookedModelHeader_s {
+	int				id;
+	int				version;
+	int				sourceLength;		// length of the source file
+	unsigned int	sourceChecksum;		// MD5_BlockChecksum of the source file
+	int				drawVertSize;		// sizeof( idDrawVert )
+	int				indexSize;			// sizeof( glIndex_t )
+	int				silEdgeSize;		// sizeof( silEdge_t )
+	int				dominantTriSize;	// sizeof( dominantTri_t )
+} cookedModelHeader_t;
+
+// material properties which change how the surfaces are processed
+enum {
+	COOKED_MATERIAL_DISCRETE			= BIT( 0 ),
+	COOKED_MATERIAL_RENDERBUMP			= BIT( 1 ),
+	COOKED_MATERIAL_BACKSIDES			= BIT( 2 ),
+	COOKED_MATERIAL_UNSMOOTHED_TANGENTS	= BIT( 3 )
+};
+
+// which parts of a triangle surface are stored
+enum {
+	COOKED_TRI_GENERATE_NORMALS			= BIT( 0 ),
+	COOKED_TRI_TANGENTS_CALCULATED		= BIT( 1 ),
+	COOKED_TRI_FACE_PLANES_CALCULATED	= BIT( 2 ),
+	COOKED_TRI_PERFECT_HULL				= BIT( 3 ),
+	COOKED_TRI_SIL_INDEXES				= BIT( 4 ),
+	COOKED_TRI_FACE_PLANES				= BIT( 5 ),
+	COOKED_TRI_DOMINANT_TRIS			= BIT( 6 )
+};
+
+typedef struct cookedTriSurf_s {
+	int				flags;
+	int				numVerts;			// also numOutputVerts of deform info
+	int				numSourceVerts;		// deform info only
+	int				numIndexes;
+	int				numMirroredVerts;
+	int				numDupVerts;
+	int				numSilEdges;
+} cookedTriSurf_t;
+
+/*
+================
+R_CookedModelName
+================
+*/
+static idStr R_CookedModelName( const char *sourceName ) {
+	idStr name = sourceName;
+	name += "." COOKED_MODEL_EXT;
+	return name;
+}
+
+/*
+================
+R_CookedWrite
+
+Writes the data padded to four bytes, so the arrays following it stay aligned.
+================
+*/
+static void R_CookedWrite( idFile *f, const void *data, int size ) {
+	static const byte pad[4] = { 0, 0, 0, 0 };
+	f->Write( data, size );
+	if ( size & 3 ) {
+		f->Write( pad, 4 - ( size & 3 ) );
+	}
+}
+
+static void R_CookedWriteInt( idFile *f, int value ) {
+	R_CookedWrite( f, &value, sizeof( value ) );
+}
+
+static void R_CookedWriteString( idFile *f, const char *string ) {
+	const int length = idStr::Length( string ) + 1;
+	R_CookedWriteInt( f, length );
+	R_CookedWrite( f, string, length );
+}
+
+/*
+================
+R_CookedRead
+
+Returns a pointer to the next size bytes of the file, or NULL past its end.
+================
+*/
+static const void *R_CookedRead( cookedReader_t &src, int size ) {
+	if ( src.error || size < 0 || size > src.length - src.offset ) {
+		src.error = true;
+		return NULL;
+	}
+	const void *data = src.data + src.offset;
+	src.offset += ( size + 3 ) & ~3;
+	if ( src.offset > src.length ) {
+		src.offset = src.length;
+	}
+	return data;
+}
+
+static int R_CookedReadInt( cookedReader_t &src ) {
+	const int *value = (const int *)R_CookedRead( src, sizeof( int ) );
+	return value ? *value : 0;
+}
+
+static const char *R_CookedReadString( cookedReader_t &src ) {
+	const int length = R_CookedReadInt( src );
+	const char *string = (const char *)R_CookedRead( src, length );
+	if ( !string || length < 1 || string[length - 1] != '\0' ) {
+		src.error = true;
+		return "";
+	}
+	return string;
+}
+
+/*
+================
+R_CookedMaterialFlags
+================
+*/
+static int R_CookedMaterialFlags( const idMaterial *material ) {
+	int flags = 0;
+
+	if ( material->IsDiscrete() ) {
+		flags |= COOKED_MATERIAL_DISCRETE;
+	}
+	const char *rb = material->GetRenderBump();
+	if ( rb && rb[0] ) {
+		flags |= COOKED_MATERIAL_RENDERBUMP;
+	}
+	if ( material->ShouldCreateBackSides() ) {
+		flags |= COOKED_MATERIAL_BACKSIDES;
+	}
+	if ( material->UseUnsmoothedTangents() ) {
+		flags |= COOKED_MATERIAL_UNSMOOTHED_TANGENTS;
+	}
+	return flags;
+}
+
+/*
+================
+R_CookedCheckIndexes
+================
+*/
+static bool R_CookedCheckIndexes( const glIndex_t *indexes, int numIndexes, int numVerts ) {
+	for ( int i = 0; i < numIndexes; i++ ) {
+		if ( indexes[i] < 0 || indexes[i] >= numVerts ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+R_CookedCheckVerts
+================
+*/
+static bool R_CookedCheckVerts( const int *verts, int num, int numVerts ) {
+	for ( int i = 0; i < num; i++ ) {
+		if ( verts[i] < 0 || verts[i] >= numVerts ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+R_CookedCheckSilEdges
+================
+*/
+static bool R_CookedCheckSilEdges( const silEdge_t *silEdges, int numSilEdges, int numIndexes, int numVerts ) {
+	for ( int i = 0; i < numSilEdges; i++ ) {
+		// p2 is the number of planes for dangling edges
+		if ( silEdges[i].p1 < 0 || silEdges[i].p1 > numIndexes / 3 || silEdges[i].p2 < 0 || silEdges[i].p2 > numIndexes / 3 ||
+				silEdges[i].v1 < 0 || silEdges[i].v1 >= numVerts || silEdges[i].v2 < 0 || silEdges[i].v2 >= numVerts ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+R_WriteCookedTriSurf
+================
+*/
+static void R_WriteCookedTriSurf( idFile *f, const srfTriangles_t *tri ) {
+	cookedTriSurf_t header;
+
+	header.flags = 0;
+	if ( tri->generateNormals ) {
+		header.flags |= COOKED_TRI_GENERATE_NORMALS;
+	}
+	if ( tri->tangentsCalculated ) {
+		header.flags |= COOKED_TRI_TANGENTS_CALCULATED;
+	}
+	if ( tri->facePlanesCalculated ) {
+		header.flags |= COOKED_TRI_FACE_PLANES_CALCULATED;
+	}
+	if ( tri->perfectHull ) {
+		header.flags |= COOKED_TRI_PERFECT_HULL;
+	}
+	if ( tri->silIndexes ) {
+		header.flags |= COOKED_TRI_SIL_INDEXES;
+	}
+	if ( tri->facePlanes ) {
+		header.flags |= COOKED_TRI_FACE_PLANES;
+	}
+	if ( tri->dominantTris ) {
+		header.flags |= COOKED_TRI_DOMINANT_TRIS;
+	}
+	header.numVerts = tri->numVerts;
+	header.numSourceVerts = tri->numVerts;
+	header.numIndexes = tri->numIndexes;
+	header.numMirroredVerts = tri->mirroredVerts ? tri->numMirroredVerts : 0;
+	header.numDupVerts = tri->dupVerts ? tri->numDupVerts : 0;
+	header.numSilEdges = tri->silEdges ? tri->numSilEdges : 0;
+	R_CookedWrite( f, &header, sizeof( header ) );
+
+	R_CookedWrite( f, tri->verts, header.numVerts * sizeof( tri->verts[0] ) );
+	R_CookedWrite( f, tri->indexes, header.numIndexes * sizeof( tri->indexes[0] ) );
+	if ( header.flags & COOKED_TRI_SIL_INDEXES ) {
+		R_CookedWrite( f, tri->silIndexes, header.numIndexes * sizeof( tri->silIndexes[0] ) );
+	}
+	R_CookedWrite( f, tri->mirroredVerts, header.numMirroredVerts * sizeof( tri->mirroredVerts[0] ) );
+	R_CookedWrite( f, tri->dupVerts, header.numDupVerts * 2 * sizeof( tri->dupVerts[0] ) );
+	R_CookedWrite( f, tri->silEdges, header.numSilEdges * sizeof( tri->silEdges[0] ) );
+	if ( header.flags & COOKED_TRI_FACE_PLANES ) {
+		R_CookedWrite( f, tri->facePlanes, header.numIndexes / 3 * sizeof( tri->facePlanes[0] ) );
+	}
+	if ( header.flags & COOKED_TRI_DOMINANT_TRIS ) {
+		R_CookedWrite( f, tri->dominantTris, header.numVerts * sizeof( tri->dominantTris[0] ) );
+	}
+}
+
+/*
+================
+R_ReadCookedTriSurf
+
+Returns NULL and sets the error of the reader if the surface is damaged.
+================
+*/
+static srfTriangles_t *R_ReadCookedTriSurf( cookedReader_t &src ) {
+	const cookedTriSurf_t *header = (const cookedTriSurf_t *)R_CookedRead( src, sizeof( cookedTriSurf_t ) );
+	if ( !header ) {
+		return NULL;
+	}
+
+	const idDrawVert *verts = (const idDrawVert *)R_CookedRead( src, header->numVerts * sizeof( verts[0] ) );
+	const glIndex_t *indexes = (const glIndex_t *)R_CookedRead( src, header->numIndexes * sizeof( indexes[0] ) );
+	const glIndex_t *silIndexes = NULL;
+	if ( header->flags & COOKED_TRI_SIL_INDEXES ) {
+		silIndexes = (const glIndex_t *)R_CookedRead( src, header->numIndexes * sizeof( silIndexes[0] ) );
+	}
+	const int *mirroredVerts = (const int *)R_CookedRead( src, header->numMirroredVerts * sizeof( mirroredVerts[0] ) );
+	const int *dupVerts = (const int *)R_CookedRead( src, header->numDupVerts * 2 * sizeof( dupVerts[0] ) );
+	const silEdge_t *silEdges = (const silEdge_t *)R_CookedRead( src, header->numSilEdges * sizeof( silEdges[0] ) );
+	const idPlane *facePlanes = NULL;
+	if ( header->flags & COOKED_TRI_FACE_PLANES ) {
+		facePlanes = (const idPlane *)R_CookedRead( src, header->numIndexes / 3 * sizeof( facePlanes[0] ) );
+	}
+	const dominantTri_t *dominantTris = NULL;
+	if ( header->flags & COOKED_TRI_DOMINANT_TRIS ) {
+		dominantTris = (const dominantTri_t *)R_CookedRead( src, header->numVerts * sizeof( dominantTris[0] ) );
+	}
+	if ( src.error ) {
+		return NULL;
+	}
+
+	if ( !R_CookedCheckIndexes( indexes, header->numIndexes, header->numVerts ) ||
+			( silIndexes && !R_CookedCheckIndexes( silIndexes, header->numIndexes, header->numVerts ) ) ||
+				!R_CookedCheckVerts( mirroredVerts, header->numMirroredVerts, header->numVerts ) ||
+					!R_CookedCheckVerts( dupVerts, header->numDupVerts * 2, header->numVerts ) ||
+						!R_CookedCheckSilEdges( silEdges, header->numSilEdges, header->numIndexes, header->numVerts ) ) {
+		src.error = true;
+		return NULL;
+	}
+
+	srfTriangles_t *tri = R_AllocStaticTriSurf();
+
+	tri->generateNormals = ( header->flags & COOKED_TRI_GENERATE_NORMALS ) != 0;
+	tri->tangentsCalculated = ( header->flags & COOKED_TRI_TANGENTS_CALCULATED ) != 0;
+	tri->facePlanesCalculated = ( header->flags & COOKED_TRI_FACE_PLANES_CALCULATED ) != 0;
+	tri->perfectHull = ( header->flags & COOKED_TRI_PERFECT_HULL ) != 0;
+
+	tri->numVerts = header->numVerts;
+	R_AllocStaticTriSurfVerts( tri, tri->numVerts );
+	SIMDProcessor->Memcpy( tri->verts, verts, tri->numVerts * sizeof( tri->verts[0] ) );
+
+	tri->numIndexes = header->numIndexes;
+	R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+	SIMDProcessor->Memcpy( tri->indexes, indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+
+	if ( silIndexes ) {
+		R_AllocStaticTriSurfSilIndexes( tri, tri->numIndexes );
+		SIMDProcessor->Memcpy( tri->silIndexes, silIndexes, tri->numIndexes * sizeof( tri->silIndexes[0] ) );
+	}
+	if ( header->numMirroredVerts > 0 ) {
+		tri->numMirroredVerts = header->numMirroredVerts;
+		R_AllocStaticTriSurfMirroredVerts( tri, tri->numMirroredVerts );
+		memcpy( tri->mirroredVerts, mirroredVerts, tri->numMirroredVerts * sizeof( tri->mirroredVerts[0] ) );
+	}
+	if ( header->numDupVerts > 0 ) {
+		tri->numDupVerts = header->numDupVerts;
+		R_AllocStaticTriSurfDupVerts( tri, tri->numDupVerts );
+		memcpy( tri->dupVerts, dupVerts, tri->numDupVerts * 2 * sizeof( tri->dupVerts[0] ) );
+	}
+	if ( header->numSilEdges > 0 ) {
+		tri->numSilEdges = header->numSilEdges;
+		R_AllocStaticTriSurfSilEdges( tri, tri->numSilEdges );
+		memcpy( tri->silEdges, silEdges, tri->numSilEdges * sizeof( tri->silEdges[0] ) );
+	}
+	if ( facePlanes ) {
+		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
+		memcpy( tri->facePlanes, facePlanes, tri->numIndexes / 3 * sizeof( tri->facePlanes[0] ) );
+	}
+	if ( dominantTris ) {
+		R_AllocStaticTriSurfDominantTris( tri, tri->numVerts );
+		memcpy( tri->dominantTris, dominantTris, tri->numVerts * sizeof( tri->dominantTris[0] ) );
+	}
+
+	// the stored bounds may already be expanded for deforms by FinishSurfaces
+	R_BoundTriSurf( tri );
+
+	return tri;
+}
+
+/*
+================
+R_WriteCookedDeformInfo
+
+Same layout as a triangle surface without vertexes.
+================
+*/
+static void R_WriteCookedDeformInfo( idFile *f, const deformInfo_t *deform ) {
+	cookedTriSurf_t header;
+
+	header.flags = 0;
+	if ( deform->silIndexes ) {
+		header.flags |= COOKED_TRI_SIL_INDEXES;
+	}
+	if ( deform->dominantTris ) {
+		header.flags |= COOKED_TRI_DOMINANT_TRIS;
+	}
+	header.numVerts = deform->numOutputVerts;
+	header.numSourceVerts = deform->numSourceVerts;
+	header.numIndexes = deform->numIndexes;
+	header.numMirroredVerts = deform->mirroredVerts ? deform->numMirroredVerts : 0;
+	header.numDupVerts = deform->dupVerts ? deform->numDupVerts : 0;
+	header.numSilEdges = deform->silEdges ? deform->numSilEdges : 0;
+	R_CookedWrite( f, &header, sizeof( header ) );
+
+	R_CookedWrite( f, deform->indexes, header.numIndexes * sizeof( deform->indexes[0] ) );
+	if ( header.flags & COOKED_TRI_SIL_INDEXES ) {
+		R_CookedWrite( f, deform->silIndexes, header.numIndexes * sizeof( deform->silIndexes[0] ) );
+	}
+	R_CookedWrite( f, deform->mirroredVerts, header.numMirroredVerts * sizeof( deform->mirroredVerts[0] ) );
+	R_CookedWrite( f, deform->dupVerts, header.numDupVerts * 2 * sizeof( deform->dupVerts[0] ) );
+	R_CookedWrite( f, deform->silEdges, header.numSilEdges * sizeof( deform->silEdges[0] ) );
+	if ( header.flags & COOKED_TRI_DOMINANT_TRIS ) {
+		R_CookedWrite( f, deform->dominantTris, header.numVerts * sizeof( deform->dominantTris[0] ) );
+	}
+}
+
+/*
+================
+R_ReadCookedDeformInfo
+
+Returns NULL and sets the error of the reader if the deform info is damaged.
+================
+*/
+static deformInfo_t *R_ReadCookedDeformInfo( cookedReader_t &src ) {
+	const cookedTriSurf_t *header = (const cookedTriSurf_t *)R_CookedRead( src, sizeof( cookedTriSurf_t ) );
+	if ( !header ) {
+		return NULL;
+	}
+
+	const glIndex_t *indexes = (const glIndex_t *)R_CookedRead( src, header->numIndexes * sizeof( indexes[0] ) );
+	const glIndex_t *silIndexes = NULL;
+	if ( header->flags & COOKED_TRI_SIL_INDEXES ) {
+		silIndexes = (const glIndex_t *)R_CookedRead( src, header->numIndexes * sizeof( silIndexes[0] ) );
+	}
+	const int *mirroredVerts = (const int *)R_CookedRead( src, header->numMirroredVerts * sizeof( mirroredVerts[0] ) );
+	const int *dupVerts = (const int *)R_CookedRead( src, header->numDupVerts * 2 * sizeof( dupVerts[0] ) );
+	const silEdge_t *silEdges = (const silEdge_t *)R_CookedRead( src, header->numSilEdges * sizeof( silEdges[0] ) );
+	const dominantTri_t *dominantTris = NULL;
+	if ( header->flags & COOKED_TRI_DOMINANT_TRIS ) {
+		dominantTris = (const dominantTri_t *)R_CookedRead( src, header->numVerts * sizeof( dominantTris[0] ) );
+	}
+	if ( src.error || header->numSourceVerts < 0 || header->numVerts < 0 ) {
+		src.error = true;
+		return NULL;
+	}
+
+	// mirrored vertexes refer to the source vertexes
+	if ( !R_CookedCheckIndexes( indexes, header->numIndexes, header->numVerts ) ||
+			( silIndexes && !R_CookedCheckIndexes( silIndexes, header->numIndexes, header->numVerts ) ) ||
+				!R_CookedCheckVerts( mirroredVerts, header->numMirroredVerts, header->numVerts ) ||
+					!R_CookedCheckVerts( dupVerts, header->numDupVerts * 2, header->numVerts ) ||
+						!R_CookedCheckSilEdges( silEdges, header->numSilEdges, header->numIndexes, header->numVerts ) ) {
+		src.error = true;
+		return NULL;
+	}
+
+	// allocate the arrays the same way R_BuildDeformInfo does
+	srfTriangles_t tri;
+	memset( &tri, 0, sizeof( tri ) );
+
+	R_AllocStaticTriSurfIndexes( &tri, header->numIndexes );
+	SIMDProcessor->Memcpy( tri.indexes, indexes, header->numIndexes * sizeof( tri.indexes[0] ) );
+	if ( silIndexes ) {
+		R_AllocStaticTriSurfSilIndexes( &tri, header->numIndexes );
+		SIMDProcessor->Memcpy( tri.silIndexes, silIndexes, header->numIndexes * sizeof( tri.silIndexes[0] ) );
+	}
+	if ( header->numMirroredVerts > 0 ) {
+		R_AllocStaticTriSurfMirroredVerts( &tri, header->numMirroredVerts );
+		memcpy( tri.mirroredVerts, mirroredVerts, header->numMirroredVerts * sizeof( tri.mirroredVerts[0] ) );
+	}
+	if ( header->numDupVerts > 0 ) {
+		R_AllocStaticTriSurfDupVerts( &tri, header->numDupVerts );
+		memcpy( tri.dupVerts, dupVerts, header->numDupVerts * 2 * sizeof( tri.dupVerts[0] ) );
+	}
+	if ( header->numSilEdges > 0 ) {
+		R_AllocStaticTriSurfSilEdges( &tri, header->numSilEdges );
+		memcpy( tri.silEdges, silEdges, header->numSilEdges * sizeof( tri.silEdges[0] ) );
+	}
+	if ( dominantTris ) {
+		R_AllocStaticTriSurfDominantTris( &tri, header->numVerts );
+		memcpy( tri.dominantTris, dominantTris, header->numVerts * sizeof( tri.dominantTris[0] ) );
+	}
+
+	deformInfo_t *deform = (deformInfo_t *)R_ClearedStaticAlloc( sizeof( *deform ) );
+
+	deform->numSourceVerts = header->numSourceVerts;
+	deform->numOutputVerts = header->numVerts;
+
+	deform->numIndexes = header->numIndexes;
+	deform->indexes = tri.indexes;
+
+	deform->silIndexes = tri.silIndexes;
+
+	deform->numSilEdges = header->numSilEdges;
+	deform->silEdges = tri.silEdges;
+
+	deform->dominantTris = tri.dominantTris;
+
+	deform->numMirroredVerts = header->numMirroredVerts;
+	deform->mirroredVerts = tri.mirroredVerts;
+
+	deform->numDupVerts = header->numDupVerts;
+	deform->dupVerts = tri.dupVerts;
+
+	return deform;
+}
+
+/*
+================
+idRenderModelStatic::LoadCookedModel
+
+Loads the surfaces from the .bmesh written from the source file.
+Returns false if it is missing or outdated, the source file has to be loaded then.
+================
+*/
+bool idRenderModelStatic::LoadCookedModel( const char *sourceName ) {
+	void *buffer;
+
+	cookedSourceLength = -1;
+	if ( fastLoad || !r_cookedModels.GetBool() ) {
+		return false;
+	}
+
+	// the cooked surfaces are only used if they were written from exactly this file
+	const int sourceLength = fileSystem->ReadFile( sourceName, &buffer, &timeStamp );
+	if ( !buffer ) {
+		return false;
+	}
+	cookedSourceLength = sourceLength;
+	cookedSourceChecksum = MD5_BlockChecksum( buffer, sourceLength );
+	fileSystem->FreeFile( buffer );
+
+	const idStr cookedName = R_CookedModelName( sourceName );
+	const int length = fileSystem->ReadFile( cookedName, &buffer );
+	if ( !buffer ) {
+		return false;
+	}
+	TRACE_CPU_SCOPE_TEXT( "Load:CookedModel", sourceName )
+
+	cookedReader_t src;
+	src.data = (const byte *)buffer;
+	src.length = length;
+	src.offset = 0;
+	src.error = false;
+
+	const cookedModelHeader_t *header = (const cookedModelHeader_t *)R_CookedRead( src, sizeof( cookedModelHeader_t ) );
+	if ( !header || header->id != COOKED_MODEL_ID || header->version != COOKED_MODEL_VERSION ||
+			header->sourceLength != cookedSourceLength || header->sourceChecksum != cookedSourceChecksum ||
+				header->drawVertSize != sizeof( idDrawVert ) || header->indexSize != sizeof( glIndex_t ) ||
+					header->silEdgeSize != sizeof( silEdge_t ) || header->dominantTriSize != sizeof( dominantTri_t ) ) {
+		common->DPrintf( "%s is out of date\n", cookedName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	const bool loaded = ReadCookedSurfaces( src );
+
+	fileSystem->FreeFile( buffer );
+
+	if ( !loaded ) {
+		if ( src.error ) {
+			common->Warning( "%s is damaged, loading %s instead", cookedName.c_str(), sourceName );
+		} else {
+			common->DPrintf( "%s is out of date\n", cookedName.c_str() );
+		}
+		PurgeModel();
+		purged = false;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+================
+idRenderModelStatic::WriteCookedModel
+
+Writes the surfaces loaded from the source file read by LoadCookedModel.
+================
+*/
+void idRenderModelStatic::WriteCookedModel( const char *sourceName ) {
+	cookedModelHeader_t header;
+
+	if ( cookedSourceLength < 0 || defaulted || fastLoad || !r_cookedModels.GetBool() ) {
+		return;
+	}
+
+	const idStr cookedName = R_CookedModelName( sourceName );
+	idFile *f = fileSystem->OpenFileWrite( cookedName );
+	if ( !f ) {
+		common->Warning( "idRenderModelStatic::WriteCookedModel: couldn't open %s", cookedName.c_str() );
+		return;
+	}
+
+	header.id = COOKED_MODEL_ID;
+	header.version = COOKED_MODEL_VERSION;
+	header.sourceLength = cookedSourceLength;
+	header.sourceChecksum = cookedSourceChecksum;
+	header.drawVertSize = sizeof( idDrawVert );
+	header.indexSize = sizeof( glIndex_t );
+	header.silEdgeSize = sizeof( silEdge_t );
+	header.dominantTriSize = sizeof( dominantTri_t );
+	R_CookedWrite( f, &header, sizeof( header ) );
+
+	WriteCookedSurfaces( f );
+
+	fileSystem->CloseFile( f );
+}
+
+/*
+================
+idRenderModelStatic::WriteCookedSurfaces
+
+The surfaces after FinishSurfaces, including the back sides it creates.
+================
+*/
+void idRenderModelStatic::WriteCookedSurfaces( idFile *f ) const {
+	// converting the source file depends on these
+	const float slop[3] = { r_slopVertex.GetFloat(), r_slopTexCoord.GetFloat(), r_slopNormal.GetFloat() };
+	R_CookedWriteInt( f, r_mergeModelSurfaces.GetBool() );
+	R_CookedWrite( f, slop, sizeof( slop ) );
+
+	R_CookedWriteInt( f, surfaces.Num() );
+	for ( int i = 0 ; i < surfaces.Num() ; i++ ) {
+		const modelSurface_t *surf = &surfaces[i];
+
+		R_CookedWriteInt( f, surf->id );
+		R_CookedWriteString( f, surf->material->GetName() );
+		R_CookedWriteInt( f, R_CookedMaterialFlags( surf->material ) );
+		R_WriteCookedTriSurf( f, surf->geometry );
+	}
+}
+
+/*
+================
+idRenderModelStatic::ReadCookedSurfaces
+
+Returns false if the surfaces are damaged or depend on settings which have changed since.
+================
+*/
+bool idRenderModelStatic::ReadCookedSurfaces( cookedReader_t &src ) {
+	const int mergeSurfaces = R_CookedReadInt( src );
+	const float *slop = (const float *)R_CookedRead( src, 3 * sizeof( float ) );
+	if ( src.error ) {
+		return false;
+	}
+	if ( mergeSurfaces != (int)r_mergeModelSurfaces.GetBool() || slop[0] != r_slopVertex.GetFloat() ||
+			slop[1] != r_slopTexCoord.GetFloat() || slop[2] != r_slopNormal.GetFloat() ) {
+		return false;
+	}
+
+	const int numSurfaces = R_CookedReadInt( src );
+	for ( int i = 0 ; i < numSurfaces && !src.error ; i++ ) {
+		modelSurface_t	surf;
+
+		surf.id = R_CookedReadInt( src );
+		const char *materialName = R_CookedReadString( src );
+		const int materialFlags = R_CookedReadInt( src );
+		if ( src.error ) {
+			return false;
+		}
+
+		surf.material = declManager->FindMaterial( materialName );
+		if ( R_CookedMaterialFlags( surf.material ) != materialFlags ) {
+			return false;
+		}
+
+		surf.geometry = R_ReadCookedTriSurf( src );
+		if ( !surf.geometry ) {
+			return false;
+		}
+
+		AddSurface( surf );
+	}
+
+	return !src.error;
+}
+
+/*
+================
+idRenderModelMD5::WriteCookedSurfaces
+
+The joints and default pose followed by the weights and deform info of the meshes.
+================
+*/
+void idRenderModelMD5::WriteCookedSurfaces( idFile *f ) const {
+	int i;
+
+	R_CookedWriteInt( f, joints.Num() );
+	for ( i = 0; i < joints.Num(); i++ ) {
+		R_CookedWriteString( f, joints[i].name );
+		R_CookedWriteInt( f, joints[i].parent ? joints[i].parent - joints.Ptr() : -1 );
+		R_CookedWrite( f, defaultPose[i].q.ToFloatPtr(), 4 * sizeof( float ) );
+		R_CookedWrite( f, defaultPose[i].t.ToFloatPtr(), 3 * sizeof( float ) );
+	}
+	R_CookedWrite( f, &bounds, sizeof( bounds ) );
+
+	R_CookedWriteInt( f, meshes.Num() );
+	for ( i = 0; i < meshes.Num(); i++ ) {
+		const idMD5Mesh &mesh = meshes[i];
+
+		R_CookedWriteString( f, mesh.shader->GetName() );
+		R_CookedWriteInt( f, R_CookedMaterialFlags( mesh.shader ) );
+		R_CookedWriteInt( f, mesh.texCoords.Num() );
+		R_CookedWriteInt( f, mesh.numWeights );
+		R_CookedWriteInt( f, mesh.numTris );
+		R_CookedWrite( f, mesh.texCoords.Ptr(), mesh.texCoords.Num() * sizeof( idVec2 ) );
+		R_CookedWrite( f, mesh.scaledWeights, mesh.numWeights * sizeof( mesh.scaledWeights[0] ) );
+		R_CookedWrite( f, mesh.weightIndex, mesh.numWeights * 2 * sizeof( mesh.weightIndex[0] ) );
+		R_WriteCookedDeformInfo( f, mesh.deformInfo );
+	}
+}
+
+/*
+================
+idRenderModelMD5::ReadCookedSurfaces
+================
+*/
+bool idRenderModelMD5::ReadCookedSurfaces( cookedReader_t &src ) {
+	int i, j;
+
+	const int numJoints = R_CookedReadInt( src );
+	if ( src.error || numJoints < 0 ) {
+		src.error = true;
+		return false;
+	}
+	joints.SetGranularity( 1 );
+	joints.SetNum( numJoints );
+	defaultPose.SetGranularity( 1 );
+	defaultPose.SetNum( numJoints );
+	for ( i = 0; i < numJoints; i++ ) {
+		const char *jointName = R_CookedReadString( src );
+		const int parentNum = R_CookedReadInt( src );
+		const float *q = (const float *)R_CookedRead( src, 4 * sizeof( float ) );
+		const float *t = (const float *)R_CookedRead( src, 3 * sizeof( float ) );
+		if ( src.error || parentNum < -1 || parentNum >= numJoints ) {
+			src.error = true;
+			return false;
+		}
+		joints[i].name = jointName;
+		joints[i].parent = parentNum >= 0 ? &joints[parentNum] : NULL;
+		defaultPose[i].q.Set( q[0], q[1], q[2], q[3] );
+		defaultPose[i].t.Set( t[0], t[1], t[2] );
+	}
+	const idBounds *meshBounds = (const idBounds *)R_CookedRead( src, sizeof( idBounds ) );
+
+	const int numMeshes = R_CookedReadInt( src );
+	if ( src.error || numMeshes < 0 ) {
+		src.error = true;
+		return false;
+	}
+	meshes.SetGranularity( 1 );
+	meshes.SetNum( numMeshes );
+	for ( i = 0; i < numMeshes; i++ ) {
+		idMD5Mesh &mesh = meshes[i];
+
+		const char *shaderName = R_CookedReadString( src );
+		const int materialFlags = R_CookedReadInt( src );
+		const int numVerts = R_CookedReadInt( src );
+		const int numWeights = R_CookedReadInt( src );
+		const int numTris = R_CookedReadInt( src );
+		const idVec2 *texCoords = (const idVec2 *)R_CookedRead( src, numVerts * sizeof( idVec2 ) );
+		const idVec4 *scaledWeights = (const idVec4 *)R_CookedRead( src, numWeights * sizeof( idVec4 ) );
+		const int *weightIndex = (const int *)R_CookedRead( src, numWeights * 2 * sizeof( int ) );
+		if ( src.error ) {
+			return false;
+		}
+
+		// every vertex ends with a weight flagged as the last one, and all joints exist
+		int numLastWeights = 0;
+		for ( j = 0; j < numWeights; j++ ) {
+			if ( weightIndex[j * 2 + 0] < 0 || weightIndex[j * 2 + 0] >= numJoints * (int)sizeof( idJointMat ) ||
+					weightIndex[j * 2 + 0] % sizeof( idJointMat ) != 0 || ( weightIndex[j * 2 + 1] & ~1 ) != 0 ) {
+				src.error = true;
+				return false;
+			}
+			numLastWeights += weightIndex[j * 2 + 1];
+		}
+		if ( numLastWeights != numVerts || ( numWeights > 0 && weightIndex[numWeights * 2 - 1] != 1 ) ) {
+			src.error = true;
+			return false;
+		}
+
+		mesh.shader = declManager->FindMaterial( shaderName );
+		if ( R_CookedMaterialFlags( mesh.shader ) != materialFlags ) {
+			return false;
+		}
+
+		mesh.texCoords.SetNum( numVerts );
+		memcpy( mesh.texCoords.Ptr(), texCoords, numVerts * sizeof( idVec2 ) );
+
+		mesh.numWeights = numWeights;
+		mesh.scaledWeights = (idVec4 *) Mem_Alloc16( numWeights * sizeof( mesh.scaledWeights[0] ) );
+		memcpy( mesh.scaledWeights, scaledWeights, numWeights * sizeof( mesh.scaledWeights[0] ) );
+		mesh.weightIndex = (int *) Mem_Alloc16( numWeights * 2 * sizeof( mesh.weightIndex[0] ) );
+		memcpy( mesh.weightIndex, weightIndex, numWeights * 2 * sizeof( mesh.weightIndex[0] ) );
+
+		mesh.numTris = numTris;
+		mesh.deformInfo = R_ReadCookedDeformInfo( src );
+		if ( !mesh.deformInfo ) {
+			return false;
+		}
+		if ( mesh.deformInfo->numSourceVerts != numVerts ) {
+			src.error = true;
+			return false;
+		}
+	}
+
+	bounds = *meshBounds;
+
+	return true;
+}
@@ -24,6 +24,14 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 ===============================================================================
 */
 
+// processed model geometry read from a .bmesh file, see Model_cooked.cpp
+typedef struct cookedReader_s {
+	const byte *				data;
+	int							length;
+	int							offset;
+	bool						error;				// set when reading past the end or invalid data
+} cookedReader_t;
+
 class idRenderModelStatic : public idRenderModel {
 public:
 	// the inherited public interface
@@ -91,6 +99,11 @@ public:
 	void						DeleteSurfacesWithNegativeId( void );
 	bool						FindSurfaceWithId( int id, int &surfaceNum );
 
+	// the processed surfaces are cooked into a .bmesh file on the first load of the source file, see Model_cooked.cpp
+	bool						LoadCookedModel( const char *sourceName );
+	void						WriteCookedModel( const char *sourceName );
+	void						FinishCleanSurfaces();
+
 public:
 	idList<modelSurface_t>		surfaces;
 	idBounds					bounds;
@@ -110,6 +123,11 @@ protected:
 	bool						levelLoadReferenced;	// for determining if it needs to be freed
 	ID_TIME_T					timeStamp;
 	idStr						proxySourceName;		// stgatilov #4970: name of the source model (only for proxy models)
+	int							cookedSourceLength;		// length of the source file read by LoadCookedModel, -1 if it can't be cooked
+	unsigned int				cookedSourceChecksum;	// MD5_BlockChecksum of the source file
+
+	virtual bool				ReadCookedSurfaces( cookedReader_t &src );
+	virtual void				WriteCookedSurfaces( idFile *f ) const;
 
 	static idCVar				r_mergeModelSurfaces;	// combine model surfaces with the same material
 	static idCVar				r_slopVertex;			// merge xyz coordinates this far apart
@@ -134,6 +152,8 @@ public:
 
  	void						ParseMesh( idLexer &parser, int numJoints, const idJointMat *joints );
 	void						UpdateSurface( const struct renderEntity_s *ent, const idJointMat *joints, modelSurface_t *surf );
+	void						PrepareSurface( const struct renderEntity_s *ent, modelSurface_t *surf );
+	void						SkinSurface( const struct renderEntity_s *ent, const idJointMat *joints, srfTriangles_t *tri ) const;
 	idBounds					CalcBounds( const idJointMat *joints );
 	int							NearestJoint( int a, int b, int c ) const;
 	int							NumVerts( void ) const;
@@ -150,10 +170,19 @@ private:
 	struct deformInfo_s *		deformInfo;			// used to create srfTriangles_t from base frames and new vertexes
 	int							surfaceNum;			// number of the static surface created for this mesh
 
-	void						TransformVerts( idDrawVert *verts, const idJointMat *joints );
-	void						TransformScaledVerts( idDrawVert *verts, const idJointMat *joints, float scale );
+	void						TransformVerts( idDrawVert *verts, const idJointMat *joints ) const;
+	void						TransformScaledVerts( idDrawVert *verts, const idJointMat *joints, float scale ) const;
 };
 
+// a prepared md5 surface that still has to be skinned, see idRenderModelMD5::InstantiateSurfaces
+typedef struct {
+	const idMD5Mesh *			mesh;
+	const struct renderEntity_s *ent;
+	srfTriangles_t *			tri;
+	const idMaterial *			material;			// after skin remapping
+	const struct viewEntity_s *	space;				// if set, the skinned vertexes are uploaded for drawing in this view
+} md5Skinning_t;
+
 class idRenderModelMD5 : public idRenderModelStatic {
 public:
 	virtual void				InitFromFile( const char *fileName );
@@ -173,6 +202,10 @@ public:
 	virtual const idJointQuat *	GetDefaultPose( void ) const;
 	virtual int					NearestJoint( int surfaceNum, int a, int b, int c ) const;
 
+	// same as InstantiateDynamicModel, but only sets up the surfaces and appends them to skinning,
+	// the caller has to SkinSurface them and add the surface bounds to the returned model
+	idRenderModelStatic *		InstantiateSurfaces( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel, idList<md5Skinning_t> *skinning );
+
 private:
 	idList<idMD5Joint>			joints;
 	idList<idJointQuat>			defaultPose;
@@ -182,6 +215,9 @@ private:
 	void						GetFrameBounds( const renderEntity_t *ent, idBounds &bounds ) const;
 	void						DrawJoints( const renderEntity_t *ent, const struct viewDef_s *view ) const;
 	void						ParseJoint( idLexer &parser, idMD5Joint *joint, idJointQuat *defaultPose );
+
+	virtual bool				ReadCookedSurfaces( cookedReader_t &src );
+	virtual void				WriteCookedSurfaces( idFile *f ) const;
 };
 
 /*
@@ -239,7 +239,7 @@ void idMD5Mesh::ParseMesh( idLexer &parser, int numJoints, const idJointMat *joi
 idMD5Mesh::TransformVerts
 ====================
 */
-void idMD5Mesh::TransformVerts( idDrawVert *verts, const idJointMat *entJoints ) {
+void idMD5Mesh::TransformVerts( idDrawVert *verts, const idJointMat *entJoints ) const {
 	SIMDProcessor->TransformVerts( verts, texCoords.Num(), entJoints, scaledWeights, weightIndex, numWeights );
 }
 
@@ -250,7 +250,7 @@ idMD5Mesh::TransformScaledVerts
 Special transform to make the mesh seem fat or skinny.  May be used for zombie deaths
 ====================
 */
-void idMD5Mesh::TransformScaledVerts( idDrawVert *verts, const idJointMat *entJoints, float scale ) {
+void idMD5Mesh::TransformScaledVerts( idDrawVert *verts, const idJointMat *entJoints, float scale ) const {
 	idVec4 *scaledWeights = (idVec4 *) _alloca16( numWeights * sizeof( scaledWeights[0] ) );
 	SIMDProcessor->Mul( scaledWeights[0].ToFloatPtr(), scale, scaledWeights[0].ToFloatPtr(), numWeights * 4 );
 	SIMDProcessor->TransformVerts( verts, texCoords.Num(), entJoints, scaledWeights, weightIndex, numWeights );
@@ -262,7 +262,19 @@ idMD5Mesh::UpdateSurface
 ====================
 */
 void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, modelSurface_t *surf ) {
-	int i, base;
+	PrepareSurface( ent, surf );
+	SkinSurface( ent, entJoints, surf->geometry );
+}
+
+/*
+====================
+idMD5Mesh::PrepareSurface
+
+Sets up the triangle surface for this frame without deforming the vertexes yet
+====================
+*/
+void idMD5Mesh::PrepareSurface( const struct renderEntity_s *ent, modelSurface_t *surf ) {
+	int i;
 	srfTriangles_t *tri;
 
 	if ( r_showDynamic.GetBool() ) {
@@ -312,6 +324,18 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 			tri->verts[i].st = texCoords[i];
 		}
 	}
+}
+
+/*
+====================
+idMD5Mesh::SkinSurface
+
+Deforms the vertexes of a surface set up by PrepareSurface.
+Only writes to the given surface, so different surfaces can be skinned in parallel.
+====================
+*/
+void idMD5Mesh::SkinSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, srfTriangles_t *tri ) const {
+	int i, base;
 
 	if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
 		TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
@@ -495,6 +519,11 @@ void idRenderModelMD5::LoadModel() {
 	}
 	purged = false;
 
+	// the cooked meshes skip both parsing and building the deform info
+	if ( LoadCookedModel( name ) ) {
+		return;
+	}
+
 	if ( !parser.LoadFile( name ) ) {
 		MakeDefaultModel();
 		return;
@@ -562,6 +591,8 @@ void idRenderModelMD5::LoadModel() {
 
 	// set the timestamp for reloadmodels
 	fileSystem->ReadFile( name, NULL, &timeStamp );
+
+	WriteCookedModel( name );
 }
 
 /*
@@ -711,6 +742,18 @@ idRenderModelMD5::InstantiateDynamicModel
 ====================
 */
 idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel ) {
+	return InstantiateSurfaces( ent, view, cachedModel, NULL );
+}
+
+/*
+====================
+idRenderModelMD5::InstantiateSurfaces
+
+If skinning is NULL the surfaces are deformed right away, otherwise they are
+appended to skinning so the caller can deform them all together.
+====================
+*/
+idRenderModelStatic *idRenderModelMD5::InstantiateSurfaces( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel, idList<md5Skinning_t> *skinning ) {
 	int					i, surfaceNum;
 	idMD5Mesh			*mesh;
 	idRenderModelStatic	*staticModel;
@@ -792,6 +835,18 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 			surf->id = i;
 		}
 
+		if ( skinning ) {
+			mesh->PrepareSurface( ent, surf );
+
+			md5Skinning_t &skin = skinning->Alloc();
+			skin.mesh = mesh;
+			skin.ent = ent;
+			skin.tri = surf->geometry;
+			skin.material = shader;
+			skin.space = NULL;
+			continue;
+		}
+
 		mesh->UpdateSurface( ent, ent->joints, surf );
 
 		staticModel->bounds.AddPoint( surf->geometry->bounds[0] );
@@ -104,7 +104,8 @@ static void R_PerformanceCounters( void ) {
 	if ( r_showMemory.GetBool() ) {
 		int m0 = frameData ? frameData->frameMemoryAllocated.load() : 0;
 		int	m1 = frameData ? frameData->memoryHighwater : 0;
-		common->Printf( "frameData: %i (%i)\n", m0, m1 );
+		int m2 = frameData ? frameData->overflowMemoryAllocated : 0;
+		common->Printf( "frameData: %i (%i) overflow: %i\n", m0, m1, m2 );
 	}
 	if ( r_showSmp.GetBool() )
 	{ common->Printf( "%c", backEnd.pc.waitedFor ); }
@@ -254,6 +255,7 @@ void R_LockSurfaceScene( viewDef_t &parms ) {
 	cmd->commandId = RC_DRAW_VIEW;
 	cmd->viewDef = &lockSurfView;
 	frameData->frameMemoryAllocated = lockFrameReserve;
+	frameData->allocGeneration++;
 
 	// set the matrix for world space to eye space
 	R_SetViewMatrix( parms );
@@ -65,6 +65,11 @@ void R_ListRenderLightDefs_f( const idCmdArgs &args ) {
 	}
 
 	common->Printf( "%i lightDefs, %i interactions, %i areaRefs\n", active, totalIntr, totalRef );
+
+	concurrentAllocStats_t stats;
+	tr.primaryWorld->interactionAllocator.GetStats( stats );
+	common->Printf( "interaction allocator: %i / %i used, %i blocks, %i magazines, %i depot gets, %i depot puts, %i shared allocs\n",
+		stats.allocCount, stats.totalCount, stats.numBlocks, stats.numMagazines, stats.numDepotGets, stats.numDepotPuts, stats.numSharedAllocs );
 }
 
 /*
@@ -75,12 +75,101 @@ void idRenderWorldLocal::TouchWorldModels( void ) {
 	}
 }
 
+/*
+================
+R_BinaryProcWrite
+
+Writes the data padded to four bytes, so the arrays following it stay aligned.
+================
+*/
+static void R_BinaryProcWrite( idFile *f, const void *data, int size ) {
+	static const byte pad[4] = { 0, 0, 0, 0 };
+	f->Write( data, size );
+	if ( size & 3 ) {
+		f->Write( pad, 4 - ( size & 3 ) );
+	}
+}
+
+static void R_BinaryProcWriteInt( idFile *f, int value ) {
+	R_BinaryProcWrite( f, &value, sizeof( value ) );
+}
+
+static void R_BinaryProcWriteString( idFile *f, const char *string ) {
+	const int length = idStr::Length( string ) + 1;
+	R_BinaryProcWriteInt( f, length );
+	R_BinaryProcWrite( f, string, length );
+}
+
+/*
+================
+R_BinaryProcRead
+
+Returns a pointer to the next size bytes of the file, or NULL past its end.
+================
+*/
+static const void *R_BinaryProcRead( bprocReader_t &src, int size ) {
+	if ( src.error || size < 0 || size > src.length - src.offset ) {
+		src.error = true;
+		return NULL;
+	}
+	const void *data = src.data + src.offset;
+	src.offset += ( size + 3 ) & ~3;
+	if ( src.offset > src.length ) {
+		src.offset = src.length;
+	}
+	return data;
+}
+
+static int R_BinaryProcReadInt( bprocReader_t &src ) {
+	const int *value = ( const int * )R_BinaryProcRead( src, sizeof( int ) );
+	return value ? *value : 0;
+}
+
+static const char *R_BinaryProcReadString( bprocReader_t &src ) {
+	const int length = R_BinaryProcReadInt( src );
+	const char *string = ( const char * )R_BinaryProcRead( src, length );
+	if ( !string || length < 1 || string[length - 1] != '\0' ) {
+		src.error = true;
+		return "";
+	}
+	return string;
+}
+
+/*
+================
+R_ProcSurfaceMaterial
+================
+*/
+static const idMaterial *R_ProcSurfaceMaterial( const idRenderModel *model, int surfaceNum, const char *name ) {
+	const idMaterial *material = declManager->FindMaterial( name );
+
+	((idMaterial*)material)->AddReference();
+
+	if (!(com_editors & EDITOR_RUNPARTICLE)) {
+		//stgatilov #4957: preload all collisionStatic images
+		if (material->Deform() == DFRM_PARTICLE || material->Deform() == DFRM_PARTICLE2) {
+			const idDeclParticle *particleDecl = (idDeclParticle *)material->GetDeformDecl();
+			const auto &prtStages = particleDecl->stages;
+			for (int g = 0; g < prtStages.Num(); g++)
+				if (prtStages[g]->collisionStatic) {
+					idPartSysEmitterSignature sign;
+					sign.mainName = model->Name();
+					sign.surfaceIndex = surfaceNum;
+					sign.particleStageIndex = g;
+					idParticleStage::LoadCutoffTimeMap(idParticleStage::GetCollisionStaticImagePath(sign));
+				}
+		}
+	}
+
+	return material;
+}
+
 /*
 ================
 idRenderWorldLocal::ParseModel
 ================
 */
-idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
+idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src, idFile *bproc ) {
 	idRenderModel	*model;
 	idToken			token;
 	int				i, j;
@@ -102,30 +191,18 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
 		src->Error( "R_ParseModel: bad numSurfaces" );
 	}
 
+	if ( bproc ) {
+		R_BinaryProcWriteInt( bproc, BPROC_MODEL );
+		R_BinaryProcWriteString( bproc, model->Name() );
+		R_BinaryProcWriteInt( bproc, numSurfaces );
+	}
+
 	for ( i = 0 ; i < numSurfaces ; i++ ) {
 		src->ExpectTokenString( "{" );
 
 		src->ExpectAnyToken( &token );
 
-		surf.material = declManager->FindMaterial( token );
-
-		((idMaterial*)surf.material)->AddReference();
-
-		if (!(com_editors & EDITOR_RUNPARTICLE)) {
-			//stgatilov #4957: preload all collisionStatic images
-			if (surf.material->Deform() == DFRM_PARTICLE || surf.material->Deform() == DFRM_PARTICLE2) {
-				const idDeclParticle *particleDecl = (idDeclParticle *)surf.material->GetDeformDecl();
-				const auto &prtStages = particleDecl->stages;
-				for (int g = 0; g < prtStages.Num(); g++)
-					if (prtStages[g]->collisionStatic) {
-						idPartSysEmitterSignature sign;
-						sign.mainName = model->Name();
-						sign.surfaceIndex = i;
-						sign.particleStageIndex = g;
-						idParticleStage::LoadCutoffTimeMap(idParticleStage::GetCollisionStaticImagePath(sign));
-					}
-			}
-		}
+		surf.material = R_ProcSurfaceMaterial( model, i, token );
 
 		tri = R_AllocStaticTriSurf();
 		surf.geometry = tri;
@@ -155,6 +232,23 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
 		}
 		src->ExpectTokenString( "}" );
 
+		if ( bproc ) {
+			// the parsed values only, FinishSurfaces derives the rest after loading either file
+			idDrawVert *verts = (idDrawVert *)Mem_Alloc( Max( tri->numVerts, 1 ) * sizeof( verts[0] ) );
+			for ( j = 0 ; j < tri->numVerts ; j++ ) {
+				verts[j].Clear();
+				verts[j].xyz = tri->verts[j].xyz;
+				verts[j].st = tri->verts[j].st;
+				verts[j].normal = tri->verts[j].normal;
+			}
+			R_BinaryProcWriteString( bproc, token );
+			R_BinaryProcWriteInt( bproc, tri->numVerts );
+			R_BinaryProcWriteInt( bproc, tri->numIndexes );
+			R_BinaryProcWrite( bproc, verts, tri->numVerts * sizeof( verts[0] ) );
+			R_BinaryProcWrite( bproc, tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+			Mem_Free( verts );
+		}
+
 		// add the completed surface to the model
 		model->AddSurface( surf );
 	}
@@ -167,12 +261,61 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
 	return model;
 }
 
+/*
+================
+idRenderWorldLocal::ReadBinaryModel
+
+Same as ParseModel for the record written by it.
+================
+*/
+idRenderModel *idRenderWorldLocal::ReadBinaryModel( bprocReader_t &src ) {
+	idRenderModel	*model;
+	modelSurface_t	surf;
+
+	model = renderModelManager->AllocModel();
+	model->InitEmpty( R_BinaryProcReadString( src ) );
+	TRACE_CPU_SCOPE_TEXT("Load:Model", model->Name())
+	declManager->BeginModelLoad(model);
+
+	const int numSurfaces = R_BinaryProcReadInt( src );
+	for ( int i = 0 ; i < numSurfaces && !src.error ; i++ ) {
+		const char *materialName = R_BinaryProcReadString( src );
+		const int numVerts = R_BinaryProcReadInt( src );
+		const int numIndexes = R_BinaryProcReadInt( src );
+		const idDrawVert *verts = (const idDrawVert *)R_BinaryProcRead( src, numVerts * sizeof( verts[0] ) );
+		const glIndex_t *indexes = (const glIndex_t *)R_BinaryProcRead( src, numIndexes * sizeof( indexes[0] ) );
+		if ( src.error ) {
+			break;
+		}
+
+		surf.material = R_ProcSurfaceMaterial( model, i, materialName );
+
+		srfTriangles_t *tri = R_AllocStaticTriSurf();
+		surf.geometry = tri;
+
+		tri->numVerts = numVerts;
+		tri->numIndexes = numIndexes;
+		R_AllocStaticTriSurfVerts( tri, tri->numVerts );
+		SIMDProcessor->Memcpy( tri->verts, verts, tri->numVerts * sizeof( tri->verts[0] ) );
+		R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+		SIMDProcessor->Memcpy( tri->indexes, indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+
+		// add the completed surface to the model
+		model->AddSurface( surf );
+	}
+
+	model->FinishSurfaces();
+	declManager->EndModelLoad(model);
+
+	return model;
+}
+
 /*
 ================
 idRenderWorldLocal::ParseShadowModel
 ================
 */
-idRenderModel *idRenderWorldLocal::ParseShadowModel( idLexer *src ) {
+idRenderModel *idRenderWorldLocal::ParseShadowModel( idLexer *src, idFile *bproc ) {
 	idRenderModel	*model;
 	idToken			token;
 	int				j;
@@ -219,6 +362,18 @@ idRenderModel *idRenderWorldLocal::ParseShadowModel( idLexer *src ) {
 		tri->indexes[j] = src->ParseInt();
 	}
 
+	if ( bproc ) {
+		R_BinaryProcWriteInt( bproc, BPROC_SHADOW_MODEL );
+		R_BinaryProcWriteString( bproc, model->Name() );
+		R_BinaryProcWriteInt( bproc, tri->numVerts );
+		R_BinaryProcWriteInt( bproc, tri->numShadowIndexesNoCaps );
+		R_BinaryProcWriteInt( bproc, tri->numShadowIndexesNoFrontCaps );
+		R_BinaryProcWriteInt( bproc, tri->numIndexes );
+		R_BinaryProcWriteInt( bproc, tri->shadowCapPlaneBits );
+		R_BinaryProcWrite( bproc, tri->shadowVertexes, tri->numVerts * sizeof( tri->shadowVertexes[0] ) );
+		R_BinaryProcWrite( bproc, tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+	}
+
 	// add the completed surface to the model
 	model->AddSurface( surf );
 
@@ -231,6 +386,57 @@ idRenderModel *idRenderWorldLocal::ParseShadowModel( idLexer *src ) {
 	return model;
 }
 
+/*
+================
+idRenderWorldLocal::ReadBinaryShadowModel
+================
+*/
+idRenderModel *idRenderWorldLocal::ReadBinaryShadowModel( bprocReader_t &src ) {
+	idRenderModel	*model;
+	srfTriangles_t	*tri;
+	modelSurface_t	surf;
+
+	model = renderModelManager->AllocModel();
+	model->InitEmpty( R_BinaryProcReadString( src ) );
+	TRACE_CPU_SCOPE_TEXT("Load:Model", model->Name())
+	declManager->BeginModelLoad(model);
+
+	surf.material = tr.defaultMaterial;
+
+	tri = R_AllocStaticTriSurf();
+	surf.geometry = tri;
+
+	const int numVerts = R_BinaryProcReadInt( src );
+	tri->numShadowIndexesNoCaps = R_BinaryProcReadInt( src );
+	tri->numShadowIndexesNoFrontCaps = R_BinaryProcReadInt( src );
+	const int numIndexes = R_BinaryProcReadInt( src );
+	tri->shadowCapPlaneBits = R_BinaryProcReadInt( src );
+	const shadowCache_t *verts = (const shadowCache_t *)R_BinaryProcRead( src, numVerts * sizeof( verts[0] ) );
+	const glIndex_t *indexes = (const glIndex_t *)R_BinaryProcRead( src, numIndexes * sizeof( indexes[0] ) );
+
+	if ( !src.error ) {
+		tri->numVerts = numVerts;
+		tri->numIndexes = numIndexes;
+
+		R_AllocStaticTriSurfShadowVerts( tri, tri->numVerts );
+		SIMDProcessor->Memcpy( tri->shadowVertexes, verts, tri->numVerts * sizeof( tri->shadowVertexes[0] ) );
+		tri->bounds.Clear();
+		for ( int j = 0 ; j < tri->numVerts ; j++ ) {
+			tri->bounds.AddPoint( tri->shadowVertexes[j].xyz.ToVec3() );
+		}
+
+		R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+		SIMDProcessor->Memcpy( tri->indexes, indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+	}
+
+	// add the completed surface to the model
+	model->AddSurface( surf );
+
+	declManager->EndModelLoad(model);
+
+	return model;
+}
+
 /*
 ================
 idRenderWorldLocal::SetupAreaRefs
@@ -251,12 +457,41 @@ void idRenderWorldLocal::SetupAreaRefs() {
 	}
 }
 
+/*
+================
+idRenderWorldLocal::LinkInterAreaPortal
+
+Links the portal to both areas once its winding is set.
+================
+*/
+void idRenderWorldLocal::LinkInterAreaPortal( int portalNum, int a1, int a2 ) {
+	portal_t	*p = &doublePortals[portalNum].portals[0];
+	idWinding	*w = &p->w;
+
+	// add the portal to a1
+	p->intoArea = a2;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w.GetPlane( p->plane );
+
+	portalAreas[a1].areaPortals.Append(p);
+
+	// reverse it for a2
+	p++;
+	p->intoArea = a1;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = *w;
+	p->w.ReverseSelf();
+	p->w.GetPlane( p->plane );
+
+	portalAreas[a2].areaPortals.Append(p);
+}
+
 /*
 ================
 idRenderWorldLocal::ParseInterAreaPortals
 ================
 */
-void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
+void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src, idFile *bproc ) {
 	int i, j;
 
 	src->ExpectTokenString( "{" );
@@ -279,10 +514,15 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 
 	doublePortals.SetNum( numInterAreaPortals );
 
+	if ( bproc ) {
+		R_BinaryProcWriteInt( bproc, BPROC_INTER_AREA_PORTALS );
+		R_BinaryProcWriteInt( bproc, numPortalAreas );
+		R_BinaryProcWriteInt( bproc, numInterAreaPortals );
+	}
+
 	for ( i = 0 ; i < numInterAreaPortals ; i++ ) {
 		int		numPoints, a1, a2;
-		portal_t	*p = &doublePortals[i].portals[0];
-		idWinding	*w = &p->w;
+		idWinding	*w = &doublePortals[i].portals[0].w;
 
 		numPoints = src->ParseInt();
 		a1 = src->ParseInt();
@@ -297,25 +537,63 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 			(*w)[j][4] = 0;
 		}
 
-		// add the portal to a1
-		p->intoArea = a2;
-		p->doublePortal = &doublePortals[i];
-		p->w.GetPlane( p->plane );
+		if ( bproc ) {
+			R_BinaryProcWriteInt( bproc, numPoints );
+			R_BinaryProcWriteInt( bproc, a1 );
+			R_BinaryProcWriteInt( bproc, a2 );
+			for ( j = 0 ; j < numPoints ; j++ ) {
+				R_BinaryProcWrite( bproc, (*w)[j].ToFloatPtr(), 3 * sizeof( float ) );
+			}
+		}
 
-		portalAreas[a1].areaPortals.Append(p);
+		LinkInterAreaPortal( i, a1, a2 );
+	}
 
-		// reverse it for a2
-		p++;
-		p->intoArea = a1;
-		p->doublePortal = &doublePortals[i];
-		p->w = *w;
-		p->w.ReverseSelf();
-		p->w.GetPlane( p->plane );
+	src->ExpectTokenString( "}" );
+}
 
-		portalAreas[a2].areaPortals.Append(p);
+/*
+================
+idRenderWorldLocal::ReadBinaryInterAreaPortals
+================
+*/
+bool idRenderWorldLocal::ReadBinaryInterAreaPortals( bprocReader_t &src ) {
+	const int numPortalAreas = R_BinaryProcReadInt( src );
+	const int numInterAreaPortals = R_BinaryProcReadInt( src );
+	if ( src.error || numPortalAreas < 0 || numInterAreaPortals < 0 ) {
+		return false;
 	}
 
-	src->ExpectTokenString( "}" );
+	portalAreas.SetNum( numPortalAreas );
+
+	// set the doubly linked lists
+	SetupAreaRefs();
+
+	doublePortals.SetNum( numInterAreaPortals );
+
+	for ( int i = 0 ; i < numInterAreaPortals ; i++ ) {
+		idWinding	*w = &doublePortals[i].portals[0].w;
+
+		const int numPoints = R_BinaryProcReadInt( src );
+		const int a1 = R_BinaryProcReadInt( src );
+		const int a2 = R_BinaryProcReadInt( src );
+		const idVec3 *points = (const idVec3 *)R_BinaryProcRead( src, numPoints * sizeof( points[0] ) );
+		if ( src.error || a1 < 0 || a1 >= numPortalAreas || a2 < 0 || a2 >= numPortalAreas ) {
+			return false;
+		}
+
+		w->SetNumPoints( numPoints );
+		for ( int j = 0 ; j < numPoints ; j++ ) {
+			(*w)[j].ToVec3() = points[j];
+			// no texture coordinates
+			(*w)[j][3] = 0;
+			(*w)[j][4] = 0;
+		}
+
+		LinkInterAreaPortal( i, a1, a2 );
+	}
+
+	return true;
 }
 
 /*
@@ -323,7 +601,7 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 idRenderWorldLocal::ParseNodes
 ================
 */
-void idRenderWorldLocal::ParseNodes( idLexer *src ) {
+void idRenderWorldLocal::ParseNodes( idLexer *src, idFile *bproc ) {
 	int			i;
 
 	src->ExpectTokenString( "{" );
@@ -345,6 +623,31 @@ void idRenderWorldLocal::ParseNodes( idLexer *src ) {
 	}
 
 	src->ExpectTokenString( "}" );
+
+	if ( bproc ) {
+		R_BinaryProcWriteInt( bproc, BPROC_NODES );
+		R_BinaryProcWriteInt( bproc, numAreaNodes );
+		R_BinaryProcWrite( bproc, areaNodes, numAreaNodes * sizeof( areaNodes[0] ) );
+	}
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryNodes
+================
+*/
+bool idRenderWorldLocal::ReadBinaryNodes( bprocReader_t &src ) {
+	const int numNodes = R_BinaryProcReadInt( src );
+	const areaNode_t *nodes = (const areaNode_t *)R_BinaryProcRead( src, numNodes * sizeof( nodes[0] ) );
+	if ( src.error ) {
+		return false;
+	}
+
+	numAreaNodes = numNodes;
+	areaNodes = (areaNode_t *)R_ClearedStaticAlloc( numAreaNodes * sizeof( areaNodes[0] ) );
+	memcpy( areaNodes, nodes, numAreaNodes * sizeof( areaNodes[0] ) );
+
+	return true;
 }
 
 /*
@@ -443,6 +746,86 @@ void idRenderWorldLocal::FreeDefs() {
 	}
 }
 
+/*
+=================
+idRenderWorldLocal::LoadBinaryProc
+
+Loads the world from the binary copy of the .proc file.
+Returns false if it is missing or was not written from the given .proc file.
+=================
+*/
+bool idRenderWorldLocal::LoadBinaryProc( const char *filename, int procLength, unsigned int procChecksum ) {
+	void *			buffer;
+	idRenderModel *	lastModel;
+
+	const int length = fileSystem->ReadFile( filename, &buffer );
+	if ( !buffer ) {
+		return false;
+	}
+	TRACE_CPU_SCOPE_TEXT( "Load:BinaryProc", filename )
+
+	bprocReader_t src;
+	src.data = (const byte *)buffer;
+	src.length = length;
+	src.offset = 0;
+	src.error = false;
+
+	const bprocHeader_t *header = (const bprocHeader_t *)R_BinaryProcRead( src, sizeof( *header ) );
+	if ( !header || header->id != BPROC_FILE_ID || header->version != BPROC_FILE_VERSION ||
+			header->procLength != procLength || header->procChecksum != procChecksum ||
+				header->drawVertSize != sizeof( idDrawVert ) || header->shadowVertSize != sizeof( shadowCache_t ) ||
+					header->indexSize != sizeof( glIndex_t ) ) {
+		common->Printf( "idRenderWorldLocal::InitFromMap: %s is outdated\n", filename );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	bool done = false;
+	while ( !done && !src.error ) {
+		switch ( R_BinaryProcReadInt( src ) ) {
+			case BPROC_END:
+				done = true;
+				break;
+			case BPROC_MODEL:
+				lastModel = ReadBinaryModel( src );
+
+				// add it to the model manager list
+				renderModelManager->AddModel( lastModel );
+
+				// save it in the list to free when clearing this map
+				localModels.Append( lastModel );
+				break;
+			case BPROC_SHADOW_MODEL:
+				lastModel = ReadBinaryShadowModel( src );
+				renderModelManager->AddModel( lastModel );
+				localModels.Append( lastModel );
+				break;
+			case BPROC_INTER_AREA_PORTALS:
+				if ( !ReadBinaryInterAreaPortals( src ) ) {
+					src.error = true;
+				}
+				break;
+			case BPROC_NODES:
+				if ( !ReadBinaryNodes( src ) ) {
+					src.error = true;
+				}
+				break;
+			default:
+				src.error = true;
+				break;
+		}
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	if ( src.error ) {
+		common->Warning( "idRenderWorldLocal::InitFromMap: %s is damaged, parsing the .proc file instead", filename );
+		FreeWorld();
+		return false;
+	}
+	return true;
+}
+
 /*
 =================
 idRenderWorldLocal::InitFromMap
@@ -455,6 +838,8 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 	idLexer *		src;
 	idToken			token;
 	idStr			filename;
+	idStr			bprocName;
+	idFile *		bproc;
 	idRenderModel *	lastModel;
 
 	// if this is an empty world, initialize manually
@@ -489,13 +874,19 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 
 	FreeWorld();
 
-	src = new idLexer( filename, LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
-	if ( !src->IsLoaded() ) {
+	// the binary copy is only used if it was written from exactly this file
+	char *procBuffer;
+	const int procLength = fileSystem->ReadFile( filename, (void **)&procBuffer );
+	if ( !procBuffer ) {
 		common->Printf( "idRenderWorldLocal::InitFromMap: %s not found\n", filename.c_str() );
 		ClearWorld();
 		return false;
 	}
+	const unsigned int procChecksum = MD5_BlockChecksum( procBuffer, procLength );
 
+	bprocName = filename;
+	bprocName.SetFileExtension( BPROC_FILE_EXT );
+	const bool binaryLoaded = r_binaryProc.GetBool() && LoadBinaryProc( bprocName, procLength, procChecksum );
 
 	mapName = name;
 	mapTimeStamp = currentTimeStamp;
@@ -505,12 +896,38 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		WriteLoadMap();
 	}
 
+	if ( binaryLoaded ) {
+		fileSystem->FreeFile( procBuffer );
+		return FinishWorld();
+	}
+
+	src = new idLexer( LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
+	src->LoadMemory( procBuffer, procLength, filename );
+
 	if ( !src->ReadToken( &token ) || token.Icmp( PROC_FILE_ID ) ) {
 		common->Printf( "idRenderWorldLocal::InitFromMap: bad id '%s' instead of '%s'\n", token.c_str(), PROC_FILE_ID );
 		delete src;
+		fileSystem->FreeFile( procBuffer );
 		return false;
 	}
 
+	// the records are copied into the binary file while they are parsed
+	bproc = NULL;
+	if ( r_binaryProc.GetBool() ) {
+		bproc = fileSystem->OpenFileWrite( bprocName );
+	}
+	if ( bproc ) {
+		bprocHeader_t header;
+		header.id = BPROC_FILE_ID;
+		header.version = BPROC_FILE_VERSION;
+		header.procLength = procLength;
+		header.procChecksum = procChecksum;
+		header.drawVertSize = sizeof( idDrawVert );
+		header.shadowVertSize = sizeof( shadowCache_t );
+		header.indexSize = sizeof( glIndex_t );
+		R_BinaryProcWrite( bproc, &header, sizeof( header ) );
+	}
+
 	// parse the file
 	while ( 1 ) {
 		if ( !src->ReadToken( &token ) ) {
@@ -518,7 +935,7 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		}
 
 		if ( token == "model" ) {
-			lastModel = ParseModel( src );
+			lastModel = ParseModel( src, bproc );
 
 			// add it to the model manager list
 			renderModelManager->AddModel( lastModel );
@@ -529,7 +946,7 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		}
 
 		if ( token == "shadowModel" ) {
-			lastModel = ParseShadowModel( src );
+			lastModel = ParseShadowModel( src, bproc );
 
 			// add it to the model manager list
 			renderModelManager->AddModel( lastModel );
@@ -540,12 +957,12 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		}
 
 		if ( token == "interAreaPortals" ) {
-			ParseInterAreaPortals( src );
+			ParseInterAreaPortals( src, bproc );
 			continue;
 		}
 
 		if ( token == "nodes" ) {
-			ParseNodes( src );
+			ParseNodes( src, bproc );
 			continue;
 		}
 
@@ -553,7 +970,23 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 	}
 
 	delete src;
+	fileSystem->FreeFile( procBuffer );
+
+	// only a complete file ends with this record
+	if ( bproc ) {
+		R_BinaryProcWriteInt( bproc, BPROC_END );
+		fileSystem->CloseFile( bproc );
+	}
 
+	return FinishWorld();
+}
+
+/*
+=================
+idRenderWorldLocal::FinishWorld
+=================
+*/
+bool idRenderWorldLocal::FinishWorld() {
 	// if it was a trivial map without any areas, create a single area
 	if ( !portalAreas.Num() ) {
 		ClearWorld();
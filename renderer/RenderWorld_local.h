@@ -85,6 +85,40 @@ typedef struct {
 										// this is the area number, else CHILDREN_HAVE_MULTIPLE_AREAS
 } areaNode_t;
 
+/*
+ * The binary .bproc holds the same records as the .proc it was written from, see r_binaryProc.
+ * The vertexes and indexes are stored as they are in memory so they are copied straight into
+ * the allocated geometry, the header rejects files of other builds and outdated .proc files.
+ */
+#define BPROC_FILE_EXT				"bproc"
+#define BPROC_FILE_ID				( ( 'C' << 24 ) | ( 'R' << 16 ) | ( 'P' << 8 ) | 'B' )
+#define BPROC_FILE_VERSION			1
+
+typedef struct {
+	int				id;
+	int				version;
+	int				procLength;			// length of the .proc file
+	unsigned int	procChecksum;		// MD5_BlockChecksum of the .proc file
+	int				drawVertSize;
+	int				shadowVertSize;
+	int				indexSize;
+} bprocHeader_t;
+
+typedef enum {
+	BPROC_END,
+	BPROC_MODEL,
+	BPROC_SHADOW_MODEL,
+	BPROC_INTER_AREA_PORTALS,
+	BPROC_NODES
+} bprocRecord_t;
+
+typedef struct {
+	const byte *	data;
+	int				length;
+	int				offset;
+	bool			error;				// read past the end
+} bprocReader_t;
+
 
 //used when r_useInteractionTable = 2
 struct InterTableHashFunction {
@@ -117,6 +151,17 @@ private:
 	idInteraction** SM_matrix;
 	//r_useInteractionTable = 2: Single Hash Table
 	idHashMap<int, idInteraction*> SHT_table;
+	//r_useInteractionTable = 3: Sorted Lists per light
+	//Add and Remove shift the rest of the row, so they are linear in the number of interactions of the light
+	//only Find uses the rows: there is no per-entity index, iteration still goes over the linked lists
+	struct SortedRow {
+		idList<int> keys;					//index of entity, ascending
+		idList<idInteraction*> inters;		//interaction for the corresponding key
+	};
+	idList<SortedRow> SL_lights;
+	int SL_count = 0;
+	bool SL_Insert(int lightIdx, int key, idInteraction *inter);
+	bool SL_Remove(int lightIdx, int key);
 };
 
 class idRenderWorldLocal : public idRenderWorld {
@@ -203,8 +248,8 @@ public:
 	idList<idRenderEntityLocal*>	entityDefs;
 	idList<idRenderLightLocal*>		lightDefs;
 
-	idBlockAlloc<areaReference_t, 1024> areaReferenceAllocator;
-	idBlockAlloc<idInteraction, 256>	interactionAllocator;
+	idConcurrentBlockAlloc<areaReference_t, 1024> areaReferenceAllocator;
+	idConcurrentBlockAlloc<idInteraction, 256>	interactionAllocator;
 
 	// all light / entity interactions are referenced here for fast lookup without
 	// having to crawl the doubly linked lists.  EnntityDefs are sequential for better
@@ -219,11 +264,18 @@ public:
 	//-----------------------
 	// RenderWorld_load.cpp
 
-	idRenderModel *			ParseModel( idLexer *src );
-	idRenderModel *			ParseShadowModel( idLexer *src );
+	idRenderModel *			ParseModel( idLexer *src, idFile *bproc );
+	idRenderModel *			ParseShadowModel( idLexer *src, idFile *bproc );
 	void					SetupAreaRefs();
-	void					ParseInterAreaPortals( idLexer *src );
-	void					ParseNodes( idLexer *src );
+	void					ParseInterAreaPortals( idLexer *src, idFile *bproc );
+	void					ParseNodes( idLexer *src, idFile *bproc );
+	void					LinkInterAreaPortal( int portalNum, int a1, int a2 );
+	idRenderModel *			ReadBinaryModel( bprocReader_t &src );
+	idRenderModel *			ReadBinaryShadowModel( bprocReader_t &src );
+	bool					ReadBinaryInterAreaPortals( bprocReader_t &src );
+	bool					ReadBinaryNodes( bprocReader_t &src );
+	bool					LoadBinaryProc( const char *filename, int procLength, unsigned int procChecksum );
+	bool					FinishWorld();
 	int						CommonChildrenArea_r( areaNode_t *node );
 	void					FreeWorld();
 	void					ClearWorld();
@@ -936,6 +936,8 @@ void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
 		backEnd.c_copyDepthBuffer = 0;
 	}
 
+	globalImages->UpdateStreaming();
+
 	if ( image_showBackgroundLoads && backEnd.pc.textureLoads ) {
 		common->Printf( "%i/%i loads in %i/%i ms\n", backEnd.pc.textureLoads, backEnd.pc.textureBackgroundLoads, backEnd.pc.textureLoadTime, backEnd.pc.textureUploadTime );
 	}
@@ -23,6 +23,8 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 idCVar r_maxShadowMapLight( "r_maxShadowMapLight", "1000", CVAR_ARCHIVE | CVAR_RENDERER, "lights bigger than this will be force-sent to stencil" );
 idCVar r_useParallelAddModels( "r_useParallelAddModels", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "parallelize R_AddModelSurfaces in frontend using jobs" );
+idCVar r_useParallelInteractions( "r_useParallelInteractions", "1", CVAR_RENDERER | CVAR_BOOL, "with r_useParallelAddModels, create interactions and shadow volumes in separate jobs rather than per entity" );
+idCVar r_useParallelSkinning( "r_useParallelSkinning", "1", CVAR_RENDERER | CVAR_BOOL, "deform all visible md5 meshes of a view together in parallel jobs" );
 idCVarBool r_useClipPlaneCulling( "r_useClipPlaneCulling", "1", CVAR_RENDERER, "cull surfaces behind mirrors" );
 
 /*
@@ -499,6 +501,42 @@ void idRenderWorldLocal::CreateLightDefInteractions( idRenderLightLocal *ldef )
 
 static const int INTERACTION_TABLE_MAX_LIGHTS = 4096;
 static const int INTERACTION_TABLE_MAX_ENTITYS = 8192/*MAX_GENTITIES*/;	//stgatilov: cannot allocate 2GB table =(
+
+//returns the first position in sorted keys[0..num) which has key >= given key
+//branchless binary search: the loop compiles to cmov, so there are no mispredictions on random keys
+static ID_FORCE_INLINE int InterTableLowerBound(const int *keys, int num, int key) {
+	if (num == 0)
+		return 0;
+	const int *base = keys;
+	while (num > 1) {
+		int half = num >> 1;
+		base = (base[half] < key ? base + half : base);
+		num -= half;
+	}
+	return int(base - keys) + (*base < key);
+}
+bool idInteractionTable::SL_Insert(int lightIdx, int key, idInteraction *inter) {
+	if (lightIdx >= SL_lights.Num())
+		SL_lights.SetNum(lightIdx + 1);
+	SortedRow &r = SL_lights[lightIdx];
+	int pos = InterTableLowerBound(r.keys.Ptr(), r.keys.Num(), key);
+	if (pos < r.keys.Num() && r.keys[pos] == key)
+		return false;
+	r.keys.Insert(key, pos);
+	r.inters.Insert(inter, pos);
+	return true;
+}
+bool idInteractionTable::SL_Remove(int lightIdx, int key) {
+	if (lightIdx >= SL_lights.Num())
+		return false;
+	SortedRow &r = SL_lights[lightIdx];
+	int pos = InterTableLowerBound(r.keys.Ptr(), r.keys.Num(), key);
+	if (pos >= r.keys.Num() || r.keys[pos] != key)
+		return false;
+	r.keys.RemoveIndex(pos);
+	r.inters.RemoveIndex(pos);
+	return true;
+}
 idInteractionTable::idInteractionTable() {
 	SM_matrix = nullptr;
 }
@@ -517,6 +555,9 @@ void idInteractionTable::Init() {
 	if (useInteractionTable == 2) {
 		SHT_table.Reserve(256, true);
 	}
+	if (useInteractionTable == 3) {
+		SL_count = 0;
+	}
 }
 void idInteractionTable::Shutdown() {
 	if (useInteractionTable == 1) {
@@ -526,6 +567,10 @@ void idInteractionTable::Shutdown() {
 	if (useInteractionTable == 2) {
 		SHT_table.ClearFree();
 	}
+	if (useInteractionTable == 3) {
+		SL_lights.Clear();
+		SL_count = 0;
+	}
 	useInteractionTable = -1;
 }
 DEBUG_OPTIMIZE_ON
@@ -540,6 +585,16 @@ idInteraction *idInteractionTable::Find(idRenderLightLocal *ldef, idRenderEntity
 		int key = (ldef->index << 16) + edef->index;
 		return SHT_table.Get(key, nullptr);
 	}
+	if (useInteractionTable == 3) {
+		//CreateLightDefInteractions looks up many entities for the same light: its row stays in cache
+		if (ldef->index >= SL_lights.Num())
+			return nullptr;
+		const SortedRow &row = SL_lights[ldef->index];
+		int pos = InterTableLowerBound(row.keys.Ptr(), row.keys.Num(), edef->index);
+		if (pos < row.keys.Num() && row.keys[pos] == edef->index)
+			return row.inters[pos];
+		return nullptr;
+	}
 	for ( idInteraction *inter = edef->lastInteraction; inter; inter = inter->entityPrev ) {
 		if ( inter->lightDef == ldef ) {
 			return inter;
@@ -566,6 +621,13 @@ bool idInteractionTable::Add(idInteraction *interaction) {
 		int key = (interaction->lightDef->index << 16 ) + interaction->entityDef->index;
 		return SHT_table.AddIfNew(key, interaction);
 	}
+	if (useInteractionTable == 3) {
+		int lightIdx = interaction->lightDef->index, entityIdx = interaction->entityDef->index;
+		if (!SL_Insert(lightIdx, entityIdx, interaction))
+			return false;
+		SL_count++;
+		return true;
+	}
 
 	return true;	//don't care
 }
@@ -586,6 +648,13 @@ bool idInteractionTable::Remove(idInteraction *interaction) {
 		int key = (interaction->lightDef->index << 16 ) + interaction->entityDef->index;
 		return SHT_table.Remove(key);
 	}
+	if (useInteractionTable == 3) {
+		int lightIdx = interaction->lightDef->index, entityIdx = interaction->entityDef->index;
+		if (!SL_Remove(lightIdx, entityIdx))
+			return false;
+		SL_count--;
+		return true;
+	}
 	return true;	//don't care
 }
 idStr idInteractionTable::Stats() const {
@@ -599,6 +668,14 @@ idStr idInteractionTable::Stats() const {
 	if (useInteractionTable == 2) {
 		idStr::snPrintf(buff, sizeof(buff), "size = %d/%d", SHT_table.Num(), SHT_table.CellsNum());
 	}
+	if (useInteractionTable == 3) {
+		size_t bytes = SL_lights.Allocated();
+		for (int i = 0; i < SL_lights.Num(); i++)
+			bytes += SL_lights[i].keys.Allocated() + SL_lights[i].inters.Allocated();
+		idStr::snPrintf(buff, sizeof(buff), "size = %d in L%d rows = %d KB",
+			SL_count, SL_lights.Num(), int(bytes >> 10)
+		);
+	}
 	return buff;
 }
 
@@ -1005,6 +1082,39 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal *def ) {
 	return update;
 }
 
+/*
+===================
+R_FinishEntityDefDynamicModel
+
+Adds the overlays to a freshly instantiated dynamic model and makes it the current snapshot
+===================
+*/
+static void R_FinishEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	if ( def->cachedDynamicModel ) {
+
+		// add any overlays to the snapshot of the dynamic model
+		if ( def->overlay && !r_skipOverlays.GetBool() ) {
+			def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
+		} else {
+			idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
+		}
+
+		if ( r_checkBounds.GetBool() ) {
+			idBounds b = def->cachedDynamicModel->Bounds();
+			if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
+					b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
+					b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
+					b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
+					b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
+					b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
+				common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
+			}
+		}
+	}
+	def->dynamicModel = def->cachedDynamicModel;
+	def->dynamicModelFrameCount = tr.frameCount;
+}
+
 /*
 ===================
 R_EntityDefDynamicModel
@@ -1048,29 +1158,7 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 		// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
 		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
 
-		if ( def->cachedDynamicModel ) {
-
-			// add any overlays to the snapshot of the dynamic model
-			if ( def->overlay && !r_skipOverlays.GetBool() ) {
-				def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
-			} else {
-				idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
-			}
-
-			if ( r_checkBounds.GetBool() ) {
-				idBounds b = def->cachedDynamicModel->Bounds();
-				if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
-						b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
-						b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
-						b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
-						b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
-						b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
-					common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
-				}
-			}
-		}
-		def->dynamicModel = def->cachedDynamicModel;
-		def->dynamicModelFrameCount = tr.frameCount;
+		R_FinishEntityDefDynamicModel( def );
 	}
 
 	// set model depth hack value
@@ -1525,19 +1613,25 @@ bool R_CullXray( idRenderEntityLocal& def ) {
 	}
 }
 
-void R_AddSingleModel( viewEntity_t *vEntity ) {
-	idInteraction* inter, * next;
+/*
+===================
+R_AddSingleModelAmbient
+
+Adds the ambient surfaces of the entity.
+Returns false if the interactions of the entity should be skipped.
+===================
+*/
+static bool R_AddSingleModelAmbient( viewEntity_t *vEntity ) {
 	idRenderModel* model;
 
 	idRenderEntityLocal& def = *vEntity->entityDef;
-	TRACE_CPU_SCOPE_TEXT( "R_AddSingleModel", GetTraceLabel(def.parms) )
-		
+
 	if ( ( r_skipModels.GetInteger() == 1 || tr.viewDef->areaNum < 0 ) && ( def.dynamicModel || def.cachedDynamicModel ) ) { // debug filters
-		return;
+		return false;
 	}
 
 	if ( r_skipModels.GetInteger() == 2 && !( def.dynamicModel || def.cachedDynamicModel ) ) {
-		return;
+		return false;
 	}
 
 	if ( r_useEntityScissors.GetBool() ) {
@@ -1567,11 +1661,11 @@ void R_AddSingleModel( viewEntity_t *vEntity ) {
 	}*/
 
 	if ( R_CullXray( def) ) 
-		return;
+		return false;
 
 	// Don't let particle entities re-instantiate their dynamic model during non-visible views (in TDM, the light gem render) -- SteveL #3970
 	if ( tr.viewDef->IsLightGem() && dynamic_cast<const idRenderModelPrt*>( def.parms.hModel ) != NULL ) {
-		return;
+		return false;
 	}
 
 	// add the ambient surface if it has a visible rectangle
@@ -1582,7 +1676,7 @@ void R_AddSingleModel( viewEntity_t *vEntity ) {
 				tr.viewDef->floatTime = oldFloatTime;
 				tr.viewDef->renderView.time = oldTime;
 			}*/
-			return;
+			return false;
 		}
 		R_AddAmbientDrawsurfs( vEntity );
 		tr.pc.c_visibleViewEntities++;
@@ -1590,6 +1684,19 @@ void R_AddSingleModel( viewEntity_t *vEntity ) {
 		tr.pc.c_shadowViewEntities++;
 	}
 
+	return true;
+}
+
+void R_AddSingleModel( viewEntity_t *vEntity ) {
+	idInteraction* inter, * next;
+
+	idRenderEntityLocal& def = *vEntity->entityDef;
+	TRACE_CPU_SCOPE_TEXT( "R_AddSingleModel", GetTraceLabel(def.parms) )
+
+	if ( !R_AddSingleModelAmbient( vEntity ) ) {
+		return;
+	}
+
 	// all empty interactions are at the end of the list so once the
 	// first is encountered all the remaining interactions are empty
 	for ( inter = def.firstInteraction; inter != NULL && !inter->IsEmpty(); inter = next ) {
@@ -1603,11 +1710,140 @@ void R_AddSingleModel( viewEntity_t *vEntity ) {
 		}
 		inter->AddActiveInteraction();
 	}
+}
 
-	/*if ( def.parms.timeGroup ) {
-		tr.viewDef->floatTime = oldFloatTime;
-		tr.viewDef->renderView.time = oldTime;
-	}*/
+/*
+===================
+R_BeginSingleModel
+
+First stage of the per-interaction pipeline: adds the ambient surfaces
+and collects the interactions that still need to be created.
+===================
+*/
+void R_BeginSingleModel( viewEntity_t *vEntity ) {
+	idRenderEntityLocal& def = *vEntity->entityDef;
+	TRACE_CPU_SCOPE_TEXT( "R_BeginSingleModel", GetTraceLabel(def.parms) )
+
+	vEntity->deferredInteractions = NULL;
+	vEntity->numDeferredInteractions = -1;
+
+	if ( !R_AddSingleModelAmbient( vEntity ) ) {
+		return;
+	}
+
+	int numInteractions = 0;
+	for ( idInteraction *inter = def.firstInteraction; inter != NULL && !inter->IsEmpty(); inter = inter->entityNext ) {
+		numInteractions++;
+	}
+
+	vEntity->numDeferredInteractions = 0;
+	if ( numInteractions == 0 ) {
+		return;
+	}
+	vEntity->deferredInteractions = (idInteraction **)R_FrameAlloc( numInteractions * sizeof( idInteraction * ) );
+
+	for ( idInteraction *inter = def.firstInteraction; inter != NULL && !inter->IsEmpty(); inter = inter->entityNext ) {
+		if ( inter->lightDef->viewCount != tr.viewCount ) {
+			continue;
+		}
+		if ( inter->BeginActiveInteraction() ) {
+			vEntity->deferredInteractions[vEntity->numDeferredInteractions++] = inter;
+		}
+	}
+}
+
+struct interactionBatch_t {
+	idInteraction **	interactions;
+	int					numInteractions;
+};
+
+/*
+===================
+R_CreateInteractionBatch
+
+Second stage: builds the light tris and shadow volumes of a batch of interactions,
+which may belong to different entities and lights.
+===================
+*/
+void R_CreateInteractionBatch( interactionBatch_t *batch ) {
+	for ( int i = 0; i < batch->numInteractions; i++ ) {
+		batch->interactions[i]->CreateActiveInteraction();
+	}
+}
+
+/*
+===================
+R_FinishSingleModel
+
+Third stage: prepares the light and shadow surfaces of the visible interactions.
+===================
+*/
+void R_FinishSingleModel( viewEntity_t *vEntity ) {
+	idRenderEntityLocal& def = *vEntity->entityDef;
+	TRACE_CPU_SCOPE_TEXT( "R_FinishSingleModel", GetTraceLabel(def.parms) )
+
+	if ( vEntity->numDeferredInteractions < 0 ) {
+		return;
+	}
+	for ( idInteraction *inter = def.firstInteraction; inter != NULL && !inter->IsEmpty(); inter = inter->entityNext ) {
+		if ( inter->lightDef->viewCount != tr.viewCount ) {
+			continue;
+		}
+		inter->FinishActiveInteraction();
+	}
+}
+
+/*
+===================
+R_AddModelSurfacesPerInteraction
+
+Splits interaction creation out of the per-entity jobs, so that a single entity
+touched by many lights (or a light touching many entities) no longer serializes
+all of its shadow volume generation into one job.
+===================
+*/
+static void R_AddModelSurfacesPerInteraction( void ) {
+	static const int MAX_CREATE_JOBS = 1024;
+
+	viewEntity_t *vEntity;
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		tr.frontEndJobList->AddJob( (jobRun_t)R_BeginSingleModel, vEntity );
+	}
+	tr.frontEndJobList->Submit();
+	tr.frontEndJobList->Wait();
+
+	int numDeferred = 0;
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		numDeferred += Max( vEntity->numDeferredInteractions, 0 );
+	}
+
+	if ( numDeferred > 0 ) {
+		// flatten in entity order, so that the work split is stable between frames
+		idInteraction **deferred = (idInteraction **)R_FrameAlloc( numDeferred * sizeof( idInteraction * ) );
+		int num = 0;
+		for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+			for ( int i = 0; i < vEntity->numDeferredInteractions; i++ ) {
+				deferred[num++] = vEntity->deferredInteractions[i];
+			}
+		}
+
+		const int batchSize = ( numDeferred + MAX_CREATE_JOBS - 1 ) / MAX_CREATE_JOBS;
+		const int numBatches = ( numDeferred + batchSize - 1 ) / batchSize;
+		interactionBatch_t *batches = (interactionBatch_t *)R_FrameAlloc( numBatches * sizeof( interactionBatch_t ) );
+		for ( int i = 0; i < numBatches; i++ ) {
+			batches[i].interactions = deferred + i * batchSize;
+			batches[i].numInteractions = Min( batchSize, numDeferred - i * batchSize );
+			tr.frontEndJobList->AddJob( (jobRun_t)R_CreateInteractionBatch, &batches[i] );
+		}
+		tr.frontEndJobList->Submit();
+		tr.frontEndJobList->Wait();
+	}
+
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		tr.frontEndJobList->AddJob( (jobRun_t)R_FinishSingleModel, vEntity );
+	}
+	tr.frontEndJobList->Submit();
+	tr.frontEndJobList->Wait();
 }
 
 void R_AddPreparedSurfaces( viewEntity_t *vEntity ) {
@@ -1633,6 +1869,152 @@ void R_AddPreparedSurfaces( viewEntity_t *vEntity ) {
 	}
 }
 
+struct skinningBatch_t {
+	md5Skinning_t *skins;
+	int numSkins;
+};
+
+struct skinnedEntity_t {
+	idRenderEntityLocal *def;
+	idRenderModelStatic *model;
+	int firstSkin;
+	int numSkins;
+};
+
+/*
+===================
+R_SkinSurfaceBatch
+
+Deforms a batch of md5 surfaces, which may belong to different entities,
+and uploads the ones that will be drawn to the frame vertex cache.
+===================
+*/
+void R_SkinSurfaceBatch( skinningBatch_t *batch ) {
+	for ( int i = 0; i < batch->numSkins; i++ ) {
+		md5Skinning_t &skin = batch->skins[i];
+		srfTriangles_t *tri = skin.tri;
+
+		skin.mesh->SkinSurface( skin.ent, skin.ent->joints, tri );
+
+		if ( !skin.space || !skin.material->IsDrawn() ) {
+			continue;
+		}
+		if ( R_CullLocalBox( tri->bounds, skin.space->modelMatrix, 5, tr.viewDef->frustum ) ) {
+			continue;
+		}
+		// derives the tangents while the vertexes are still in cache,
+		// if the vertex cache is full R_AddAmbientDrawsurfs will try again
+		R_CreateAmbientCache( tri, skin.material->ReceivesLighting() );
+	}
+}
+
+/*
+===================
+R_SkinDynamicModels
+
+Instantiates the md5 models of all entities that will be added to the view,
+deforming all their meshes together in jobs split by the number of joint weights,
+so that a single heavy entity doesn't serialize the frontend.
+The entity callbacks and the model snapshots are still handled here in order,
+R_EntityDefDynamicModel will find the snapshots already in place.
+===================
+*/
+static void R_SkinDynamicModels( void ) {
+	static const int MIN_SKINNING_BATCH_WEIGHTS = 4096;
+	static const int MAX_SKINNING_JOBS = 256;
+	static idList<md5Skinning_t> skins;
+	static idList<skinnedEntity_t> entities;
+
+	TRACE_CPU_SCOPE( "R_SkinDynamicModels" )
+
+	if ( r_skipModels.GetInteger() != 0 || tr.viewDef->areaNum < 0 ) {
+		return;
+	}
+
+	skins.SetNum( 0, false );
+	entities.SetNum( 0, false );
+
+	for ( viewEntity_t *vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		idRenderEntityLocal &def = *vEntity->entityDef;
+
+		// only models that will be instantiated by R_AddSingleModelAmbient anyway
+		if ( dynamic_cast<idRenderModelMD5 *>( def.parms.hModel ) == NULL || R_CullXray( def ) ) {
+			continue;
+		}
+		const bool visible = !vEntity->scissorRect.IsEmpty();
+		if ( !visible && !R_HasVisibleShadows( vEntity ) ) {
+			continue;
+		}
+
+		bool callbackUpdate = false;
+		if ( def.parms.callback ) {
+			callbackUpdate = R_IssueEntityDefCallback( &def );
+		}
+		if ( callbackUpdate ) {
+			R_ClearEntityDefDynamicModel( &def );
+		}
+
+		// the callback may have switched the model
+		idRenderModelMD5 *model = dynamic_cast<idRenderModelMD5 *>( def.parms.hModel );
+		if ( model == NULL || def.dynamicModel ) {
+			continue;
+		}
+
+		skinnedEntity_t &ent = entities.Alloc();
+		ent.def = &def;
+		ent.firstSkin = skins.Num();
+		ent.model = model->InstantiateSurfaces( &def.parms, tr.viewDef, def.cachedDynamicModel, &skins );
+		ent.numSkins = skins.Num() - ent.firstSkin;
+		def.cachedDynamicModel = ent.model;
+
+		for ( int i = ent.firstSkin; i < skins.Num(); i++ ) {
+			skins[i].space = visible ? vEntity : NULL;
+		}
+	}
+
+	if ( skins.Num() > 0 ) {
+		int totalWeights = 0;
+		for ( int i = 0; i < skins.Num(); i++ ) {
+			totalWeights += skins[i].mesh->NumWeights();
+		}
+		const int batchWeights = Max( MIN_SKINNING_BATCH_WEIGHTS, totalWeights / MAX_SKINNING_JOBS + 1 );
+
+		skinningBatch_t *batches = (skinningBatch_t *)R_FrameAlloc( skins.Num() * sizeof( skinningBatch_t ) );
+		int numBatches = 0;
+		int weights = 0;
+		for ( int i = 0; i < skins.Num(); i++ ) {
+			if ( weights == 0 ) {
+				batches[numBatches].skins = &skins[i];
+				batches[numBatches].numSkins = 0;
+				numBatches++;
+			}
+			batches[numBatches - 1].numSkins++;
+			weights += skins[i].mesh->NumWeights();
+			if ( weights >= batchWeights ) {
+				weights = 0;
+			}
+		}
+
+		for ( int i = 0; i < numBatches; i++ ) {
+			tr.frontEndJobList->AddJob( (jobRun_t)R_SkinSurfaceBatch, &batches[i] );
+		}
+		tr.frontEndJobList->Submit();
+		tr.frontEndJobList->Wait();
+	}
+
+	for ( int i = 0; i < entities.Num(); i++ ) {
+		skinnedEntity_t &ent = entities[i];
+		if ( ent.model ) {
+			for ( int j = 0; j < ent.numSkins; j++ ) {
+				const srfTriangles_t *tri = skins[ent.firstSkin + j].tri;
+				ent.model->bounds.AddPoint( tri->bounds[0] );
+				ent.model->bounds.AddPoint( tri->bounds[1] );
+			}
+		}
+		R_FinishEntityDefDynamicModel( ent.def );
+	}
+}
+
 /*
 ===================
 R_AddModelSurfaces
@@ -1651,7 +2033,13 @@ void R_AddModelSurfaces( void ) {
 	tr.viewDef->numDrawSurfs = 0;
 	tr.viewDef->maxDrawSurfs = 0;	// will be set to INITIAL_DRAWSURFS on R_AddDrawSurf
 
-	if ( r_useParallelAddModels.GetBool() && r_materialOverride.GetString()[0] == '\0' ) {
+	if ( r_useParallelSkinning.GetBool() && r_materialOverride.GetString()[0] == '\0' ) {
+		R_SkinDynamicModels();
+	}
+
+	if ( r_useParallelAddModels.GetBool() && r_materialOverride.GetString()[0] == '\0' && r_useParallelInteractions.GetBool() ) {
+		R_AddModelSurfacesPerInteraction();
+	} else if ( r_useParallelAddModels.GetBool() && r_materialOverride.GetString()[0] == '\0' ) {
 		for ( viewEntity_t *vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
 			tr.frontEndJobList->AddJob( (jobRun_t)R_AddSingleModel, vEntity );
 		}
@@ -1669,6 +2057,10 @@ void R_AddModelSurfaces( void ) {
 }
 
 REGISTER_PARALLEL_JOB( R_AddSingleModel, "R_AddSingleModel" );
+REGISTER_PARALLEL_JOB( R_BeginSingleModel, "R_BeginSingleModel" );
+REGISTER_PARALLEL_JOB( R_CreateInteractionBatch, "R_CreateInteractionBatch" );
+REGISTER_PARALLEL_JOB( R_FinishSingleModel, "R_FinishSingleModel" );
+REGISTER_PARALLEL_JOB( R_SkinSurfaceBatch, "R_SkinSurfaceBatch" );
 
 /*
 =====================
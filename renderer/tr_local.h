@@ -438,6 +438,10 @@ typedef struct viewEntity_s {
 
 	preparedSurf_t		*preparedSurfs;
 
+	// interactions that need to be created this view, -1 if the entity was skipped
+	idInteraction		**deferredInteractions;
+	int					numDeferredInteractions;
+
 	int					drawCalls;				// perf tool
 } viewEntity_t;
 
@@ -631,6 +635,16 @@ typedef struct frameMemoryBlock_s {
 	byte	base[4];	// dynamically allocated as [size]
 } frameMemoryBlock_t;
 
+// threads beyond this share the last slot of the frame allocation statistics
+#define MAX_FRAME_ALLOC_THREADS		16
+
+typedef struct {
+	int					numAllocs;
+	int					bytesAllocated;		// rounded up to the allocation alignment
+	int					numChunks;			// chunks carved from the shared frame memory
+	int					overflowBytes;		// bytes that did not fit into frameMemory anymore
+} frameAllocStats_t;
+
 // all of the information needed by the back end must be
 // contained in a frameData_t.  This entire structure is
 // duplicated so the front and back end can run in parallel
@@ -646,6 +660,13 @@ typedef struct {
 
 	int					memoryHighwater;	// max used on any frame
 
+	// each thread bumps its own chunk of frameMemory, see R_FrameAlloc
+	int					allocGeneration;	// incremented when frameMemoryAllocated is rewound
+	frameMemoryBlock_t	*overflowBlocks;	// used once frameMemory is exhausted
+	int					overflowMemoryAllocated;
+	idSysMutex			overflowMutex;
+	frameAllocStats_t	threadStats[MAX_FRAME_ALLOC_THREADS];
+
 	// the currently building command list
 	// commands can be inserted at the front if needed, as for required
 	// dynamically generated textures
@@ -979,6 +1000,8 @@ extern idCVar r_useOptimizedShadows;	// 1 = use the dmap generated static shadow
 extern idCVar r_useShadowProjectedCull;	// 1 = discard triangles outside light volume before shadowing
 extern idCVar r_useDeferredTangents;	// 1 = don't always calc tangents after deform
 extern idCVar r_useCachedDynamicModels;	// 1 = cache snapshots of dynamic models
+extern idCVar r_binaryProc;				// 1 = load the world geometry from the .bproc written on the first load of the .proc
+extern idCVar r_cookedModels;			// 1 = load ASE, LWO and MD5 models from the .bmesh written on their first load
 extern idCVar r_useScissor;				// 1 = scissor clip as portals and lights are processed
 extern idCVar r_usePortals;				// 1 = use portals to perform area culling, otherwise draw everything
 extern idCVar r_useStateCaching;		// avoid redundant state changes in GL_*() calls
@@ -1572,6 +1595,11 @@ void				R_AllocStaticTriSurfVerts( srfTriangles_t *tri, int numVerts );
 void				R_AllocStaticTriSurfIndexes( srfTriangles_t *tri, int numIndexes );
 void				R_AllocStaticTriSurfShadowVerts( srfTriangles_t *tri, int numVerts );
 void				R_AllocStaticTriSurfPlanes( srfTriangles_t *tri, int numIndexes );
+void				R_AllocStaticTriSurfSilIndexes( srfTriangles_t *tri, int numIndexes );
+void				R_AllocStaticTriSurfSilEdges( srfTriangles_t *tri, int numSilEdges );
+void				R_AllocStaticTriSurfDominantTris( srfTriangles_t *tri, int numVerts );
+void				R_AllocStaticTriSurfMirroredVerts( srfTriangles_t *tri, int numMirroredVerts );
+void				R_AllocStaticTriSurfDupVerts( srfTriangles_t *tri, int numDupVerts );
 void				R_ResizeStaticTriSurfVerts( srfTriangles_t *tri, int numVerts );
 void				R_ResizeStaticTriSurfIndexes( srfTriangles_t *tri, int numIndexes );
 void				R_ResizeStaticTriSurfShadowVerts( srfTriangles_t *tri, int numVerts );
@@ -1663,6 +1691,7 @@ SCENE GENERATION
 void R_InitFrameData( void );
 void R_ShutdownFrameData( void );
 void R_ToggleSmpFrame( void );
+void R_ShowFrameMemory_f( const idCmdArgs &args );
 void *R_FrameAlloc( int bytes );
 void *R_ClearedFrameAlloc( int bytes );
 void R_FrameFree( void *data );
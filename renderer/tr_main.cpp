@@ -27,12 +27,29 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 static const unsigned int NUM_FRAME_DATA = 2;
 static const unsigned int FRAME_ALLOC_ALIGNMENT = 128;
 static const unsigned int MAX_FRAME_MEMORY = 64 * 1024 * 1024;	// larger so that we can noclip on PC for dev purposes
+static const int FRAME_ALLOC_CHUNK_SIZE = 64 * 1024;			// carved from frameMemory by each thread
+static const int FRAME_OVERFLOW_BLOCK_SIZE = 4 * 1024 * 1024;
 
 frameData_t		smpFrameData[NUM_FRAME_DATA];
 frameData_t 	*frameData;
 frameData_t		*backendFrameData;
 unsigned int	smpFrame;
 
+// the part of the current chunk that a thread has not handed out yet
+typedef struct {
+	const frameData_t *	frame;
+	int					generation;
+	byte *				current;
+	byte *				end;
+	int					slot;
+} frameAllocArena_t;
+
+static thread_local frameAllocArena_t frameAllocArena = { NULL, 0, NULL, NULL, -1 };
+static std::atomic<int>	numFrameAllocThreads;
+static uintptr_t		frameAllocThreadIds[MAX_FRAME_ALLOC_THREADS];
+static frameAllocStats_t lastFrameAllocStats[MAX_FRAME_ALLOC_THREADS];
+static frameAllocStats_t highwaterFrameAllocStats[MAX_FRAME_ALLOC_THREADS];
+
 /*
 ======================
 idScreenRect::Clear
@@ -165,6 +182,21 @@ void R_ShowColoredScreenRect( const idScreenRect &rect, int colorIndex ) {
 	}
 }
 
+/*
+====================
+R_FreeFrameOverflowBlocks
+====================
+*/
+static void R_FreeFrameOverflowBlocks( frameData_t *frame ) {
+	frameMemoryBlock_t *next;
+	for ( frameMemoryBlock_t *block = frame->overflowBlocks; block; block = next ) {
+		next = block->next;
+		Mem_Free16( block );
+	}
+	frame->overflowBlocks = NULL;
+	frame->overflowMemoryAllocated = 0;
+}
+
 /*
 ====================
 R_ToggleSmpFrame
@@ -172,8 +204,20 @@ R_ToggleSmpFrame
 */
 void R_ToggleSmpFrame( void ) {
 	// update the highwater mark
-	if ( frameData->frameMemoryAllocated > frameData->memoryHighwater ) {
-		frameData->memoryHighwater = frameData->frameMemoryAllocated;
+	const int totalAllocated = Min<int>( frameData->frameMemoryAllocated, MAX_FRAME_MEMORY ) + frameData->overflowMemoryAllocated;
+	if ( totalAllocated > frameData->memoryHighwater ) {
+		frameData->memoryHighwater = totalAllocated;
+	}
+
+	// keep the per-thread statistics of the finished frame around for R_ShowFrameMemory_f
+	memcpy( lastFrameAllocStats, frameData->threadStats, sizeof( lastFrameAllocStats ) );
+	for ( int i = 0; i < MAX_FRAME_ALLOC_THREADS; i++ ) {
+		frameAllocStats_t &high = highwaterFrameAllocStats[i];
+		const frameAllocStats_t &last = lastFrameAllocStats[i];
+		high.numAllocs = Max( high.numAllocs, last.numAllocs );
+		high.bytesAllocated = Max( high.bytesAllocated, last.bytesAllocated );
+		high.numChunks = Max( high.numChunks, last.numChunks );
+		high.overflowBytes = Max( high.overflowBytes, last.overflowBytes );
 	}
 
 	// switch to the next frame
@@ -183,6 +227,7 @@ void R_ToggleSmpFrame( void ) {
 
 	// reset the memory allocation
 	R_FreeDeferredTriSurfs( frameData );
+	R_FreeFrameOverflowBlocks( frameData );
 
 	// RB: 64 bit fixes, changed unsigned int to uintptr_t
 	const uintptr_t bytesNeededForAlignment = FRAME_ALLOC_ALIGNMENT - ( ( uintptr_t )frameData->frameMemory & ( FRAME_ALLOC_ALIGNMENT - 1 ) );
@@ -190,6 +235,8 @@ void R_ToggleSmpFrame( void ) {
 
 	frameData->frameMemoryAllocated = bytesNeededForAlignment;
 	frameData->frameMemoryUsed = 0;
+	frameData->allocGeneration++;
+	memset( frameData->threadStats, 0, sizeof( frameData->threadStats ) );
 
 	R_ClearCommandChain( frameData );
 }
@@ -208,6 +255,7 @@ void R_ShutdownFrameData( void ) {
 	R_FreeDeferredTriSurfs( frameData );
 	frameData = NULL;
 	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
+		R_FreeFrameOverflowBlocks( &smpFrameData[i] );
 		Mem_Free16( smpFrameData[i].frameMemory );
 		smpFrameData[i].frameMemory = NULL;
 	}
@@ -277,6 +325,60 @@ void R_StaticFree( void *data ) {
 	Mem_Free( data );
 }
 
+/*
+================
+R_FrameAllocOverflow
+
+Called once the frame memory block is exhausted.  The overflow blocks
+are released when the frame data is reused, so a big scene costs some
+extra allocations instead of a fatal error.
+================
+*/
+static byte *R_FrameAllocOverflow( int bytes ) {
+	idScopedCriticalSection lock( frameData->overflowMutex );
+
+	frameMemoryBlock_t *block = frameData->overflowBlocks;
+	if ( block == NULL || block->size - block->used < bytes ) {
+		if ( frameData->overflowBlocks == NULL ) {
+			common->DPrintf( "R_FrameAlloc: frame memory exhausted, allocating overflow blocks\n" );
+		}
+		const int size = Max( bytes, FRAME_OVERFLOW_BLOCK_SIZE ) + FRAME_ALLOC_ALIGNMENT;
+		block = ( frameMemoryBlock_t * )Mem_Alloc16( sizeof( frameMemoryBlock_t ) + size );
+		if ( block == NULL ) {
+			common->FatalError( "R_FrameAlloc failed on %i bytes", bytes );
+		}
+		block->size = size;
+		block->used = FRAME_ALLOC_ALIGNMENT - ( ( uintptr_t )block->base & ( FRAME_ALLOC_ALIGNMENT - 1 ) );
+		block->next = frameData->overflowBlocks;
+		frameData->overflowBlocks = block;
+	}
+	byte *ptr = block->base + block->used;
+	block->used += bytes;
+	frameData->overflowMemoryAllocated += bytes;
+
+	return ptr;
+}
+
+/*
+================
+R_FrameAllocShared
+
+Takes memory directly from the frame block that all threads share.
+================
+*/
+static byte *R_FrameAllocShared( int bytes, frameAllocStats_t &stats ) {
+	// don't keep adding once the block is exhausted, so the counter can't wrap
+	if ( frameData->frameMemoryAllocated <= (int)MAX_FRAME_MEMORY ) {
+		// thread safe add
+		int	end = frameData->frameMemoryAllocated += bytes;
+		if ( end <= (int)MAX_FRAME_MEMORY ) {
+			return frameData->frameMemory + end - bytes;
+		}
+	}
+	stats.overflowBytes += bytes;
+	return R_FrameAllocOverflow( bytes );
+}
+
 /*
 ================
 R_FrameAlloc
@@ -298,22 +400,50 @@ The memory will not move, but it may not be
 contiguous with previous allocations even
 from this frame.
 
+Each thread carves FRAME_ALLOC_CHUNK_SIZE chunks out of the
+frame block and bumps inside its own chunk, so parallel
+front end jobs only touch the shared counter once per chunk.
+
 The memory is NOT zero filled.
-Should part of this be inlined in a macro?
 ================
 */
 void *R_FrameAlloc( int bytes ) {
 	bytes = ( bytes + FRAME_ALLOC_ALIGNMENT - 1 ) & ~( FRAME_ALLOC_ALIGNMENT - 1 );
 
-	// thread safe add
-	int	end = frameData->frameMemoryAllocated += bytes;
+	frameAllocArena_t &arena = frameAllocArena;
+	if ( arena.slot < 0 ) {
+		arena.slot = Min( numFrameAllocThreads++, MAX_FRAME_ALLOC_THREADS - 1 );
+		frameAllocThreadIds[arena.slot] = Sys_GetCurrentThreadID();
+	}
+	// threads beyond MAX_FRAME_ALLOC_THREADS share a slot, so their statistics are approximate
+	frameAllocStats_t &stats = frameData->threadStats[arena.slot];
+	stats.numAllocs++;
+	stats.bytesAllocated += bytes;
+
+	// the chunk is stale if the frame was toggled or rewound since it was carved
+	if ( arena.frame != frameData || arena.generation != frameData->allocGeneration ) {
+		arena.frame = frameData;
+		arena.generation = frameData->allocGeneration;
+		arena.current = arena.end = NULL;
+	}
+
+	if ( arena.end - arena.current >= bytes ) {
+		byte *ptr = arena.current;
+		arena.current += bytes;
+		return ptr;
+	}
 
-	if ( end > MAX_FRAME_MEMORY ) {
-		idLib::Error( "R_FrameAlloc ran out of memory. bytes = %d, end = %d, highWaterAllocated = %d\n", bytes, end, frameData->memoryHighwater );
+	// big allocations would waste most of a chunk
+	if ( bytes > FRAME_ALLOC_CHUNK_SIZE / 4 ) {
+		return R_FrameAllocShared( bytes, stats );
 	}
-	byte *ptr = frameData->frameMemory + end - bytes;
 
-	return ptr;
+	byte *chunk = R_FrameAllocShared( FRAME_ALLOC_CHUNK_SIZE, stats );
+	stats.numChunks++;
+	arena.current = chunk + bytes;
+	arena.end = chunk + FRAME_ALLOC_CHUNK_SIZE;
+
+	return chunk;
 }
 
 /*
@@ -344,6 +474,43 @@ to both alloc and free.
 void R_FrameFree( void *data ) {
 }
 
+/*
+==================
+R_ShowFrameMemory_f
+
+Per-thread frame memory usage of the last completed frame and the highest seen so far.
+==================
+*/
+void R_ShowFrameMemory_f( const idCmdArgs &args ) {
+	if ( args.Argc() > 1 && !idStr::Icmp( args.Argv( 1 ), "reset" ) ) {
+		memset( highwaterFrameAllocStats, 0, sizeof( highwaterFrameAllocStats ) );
+		for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
+			smpFrameData[i].memoryHighwater = 0;
+		}
+		return;
+	}
+
+	int highwater = 0;
+	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
+		highwater = Max( highwater, smpFrameData[i].memoryHighwater );
+	}
+	common->Printf( "%6d kB frame memory block, %d kB highwater\n", MAX_FRAME_MEMORY >> 10, highwater >> 10 );
+	if ( backendFrameData ) {
+		common->Printf( "%6d kB used last frame, %d kB in overflow blocks\n",
+			Min<int>( backendFrameData->frameMemoryAllocated, MAX_FRAME_MEMORY ) >> 10, backendFrameData->overflowMemoryAllocated >> 10 );
+	}
+
+	common->Printf( "slot       thread   allocs       kB   chunks  overflow kB | max allocs   max kB  max overflow kB\n" );
+	const int numSlots = Min<int>( numFrameAllocThreads, MAX_FRAME_ALLOC_THREADS );
+	for ( int i = 0; i < numSlots; i++ ) {
+		const frameAllocStats_t &last = lastFrameAllocStats[i];
+		const frameAllocStats_t &high = highwaterFrameAllocStats[i];
+		common->Printf( "%4d %12llx %8d %8d %8d %12d | %10d %8d %16d\n", i, ( unsigned long long )frameAllocThreadIds[i],
+			last.numAllocs, last.bytesAllocated >> 10, last.numChunks, last.overflowBytes >> 10,
+			high.numAllocs, high.bytesAllocated >> 10, high.overflowBytes >> 10 );
+	}
+}
+
 //==========================================================================
 
 void R_AxisToModelMatrix( const idMat3 &axis, const idVec3 &origin, float modelMatrix[16] ) {
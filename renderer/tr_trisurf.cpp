@@ -608,6 +608,56 @@ void R_AllocStaticTriSurfPlanes( srfTriangles_t *tri, int numIndexes ) {
 	tri->facePlanes = triPlaneAllocator.Alloc( numIndexes / 3 );
 }
 
+/*
+=================
+R_AllocStaticTriSurfSilIndexes
+=================
+*/
+void R_AllocStaticTriSurfSilIndexes( srfTriangles_t *tri, int numIndexes ) {
+	assert( tri->silIndexes == NULL );
+	tri->silIndexes = triSilIndexAllocator.Alloc( numIndexes );
+}
+
+/*
+=================
+R_AllocStaticTriSurfSilEdges
+=================
+*/
+void R_AllocStaticTriSurfSilEdges( srfTriangles_t *tri, int numSilEdges ) {
+	assert( tri->silEdges == NULL );
+	tri->silEdges = triSilEdgeAllocator.Alloc( numSilEdges );
+}
+
+/*
+=================
+R_AllocStaticTriSurfDominantTris
+=================
+*/
+void R_AllocStaticTriSurfDominantTris( srfTriangles_t *tri, int numVerts ) {
+	assert( tri->dominantTris == NULL );
+	tri->dominantTris = triDominantTrisAllocator.Alloc( numVerts );
+}
+
+/*
+=================
+R_AllocStaticTriSurfMirroredVerts
+=================
+*/
+void R_AllocStaticTriSurfMirroredVerts( srfTriangles_t *tri, int numMirroredVerts ) {
+	assert( tri->mirroredVerts == NULL );
+	tri->mirroredVerts = triMirroredVertAllocator.Alloc( numMirroredVerts );
+}
+
+/*
+=================
+R_AllocStaticTriSurfDupVerts
+=================
+*/
+void R_AllocStaticTriSurfDupVerts( srfTriangles_t *tri, int numDupVerts ) {
+	assert( tri->dupVerts == NULL );
+	tri->dupVerts = triDupVertAllocator.Alloc( numDupVerts * 2 );
+}
+
 /*
 =================
 R_ResizeStaticTriSurfVerts
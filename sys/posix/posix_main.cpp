@@ -426,6 +426,30 @@ ID_TIME_T Sys_FileTimeStamp(FILE * fp) {
 	return st.st_mtime;
 }
 
+const byte *Sys_MapFile( const char *path, size_t *length ) {
+	int fd = open( path, O_RDONLY );
+	if ( fd < 0 ) {
+		return NULL;
+	}
+	struct stat st;
+	if ( fstat( fd, &st ) != 0 || st.st_size <= 0 ) {
+		close( fd );
+		return NULL;
+	}
+	// the mapping keeps its own reference to the file
+	void *data = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+	if ( data == MAP_FAILED ) {
+		return NULL;
+	}
+	*length = st.st_size;
+	return (const byte *)data;
+}
+
+void Sys_UnmapFile( const byte *data, size_t length ) {
+	munmap( (void *)data, length );
+}
+
 void Sys_Sleep(int msec) {
 	if ( msec < 20 ) {
 		static int last = 0;
@@ -405,6 +405,9 @@ bool			Sys_GetCurrentMonitorResolution( int &width, int &height );
 
 void			Sys_Mkdir( const char *path );
 ID_TIME_T		Sys_FileTimeStamp( FILE *fp );
+// maps a whole file read-only into memory, returns NULL if that's not possible
+const byte *	Sys_MapFile( const char *path, size_t *length );
+void			Sys_UnmapFile( const byte *data, size_t length );
 // NOTE: do we need to guarantee the same output on all platforms?
 const char *	Sys_TimeStampToStr( ID_TIME_T timeStamp );
 const char *	Sys_DefaultBasePath( void );
@@ -447,6 +447,45 @@ ID_TIME_T Sys_FileTimeStamp( FILE *fp ) {
 	return ( long ) st.st_mtime;
 }
 
+/*
+=================
+Sys_MapFile
+=================
+*/
+const byte *Sys_MapFile( const char *path, size_t *length ) {
+	HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return NULL;
+	}
+	LARGE_INTEGER size;
+	if ( !GetFileSizeEx( file, &size ) || size.QuadPart <= 0 ) {
+		CloseHandle( file );
+		return NULL;
+	}
+	// the view keeps the mapping and the file open
+	HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	CloseHandle( file );
+	if ( mapping == NULL ) {
+		return NULL;
+	}
+	void *data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	CloseHandle( mapping );
+	if ( data == NULL ) {
+		return NULL;
+	}
+	*length = (size_t)size.QuadPart;
+	return (const byte *)data;
+}
+
+/*
+=================
+Sys_UnmapFile
+=================
+*/
+void Sys_UnmapFile( const byte *data, size_t length ) {
+	UnmapViewOfFile( data );
+}
+
 /*
 ==============
 Sys_Cwd